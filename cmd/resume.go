@@ -12,8 +12,10 @@ import (
 	"path/filepath"
 	"time"
 
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
 	"github.com/cwbudde/mayflycirclefit/internal/fit/renderer"
 	"github.com/cwbudde/mayflycirclefit/internal/opt"
+	"github.com/cwbudde/mayflycirclefit/internal/server"
 	"github.com/cwbudde/mayflycirclefit/internal/store"
 	"github.com/spf13/cobra"
 )
@@ -153,7 +155,30 @@ func runResumeLocal(jobID string) error {
 	}
 
 	// Create renderer
-	rend := renderer.NewCPURenderer(ref, checkpoint.Config.Circles)
+	var rend renderer.Renderer
+	if checkpoint.Config.Grayscale {
+		rend = renderer.NewGrayRenderer(ref, checkpoint.Config.Circles)
+	} else {
+		cpu := renderer.NewCPURenderer(ref, checkpoint.Config.Circles)
+
+		// Restore the cost function the checkpoint was optimized with
+		var weights *fit.WeightPlane
+		if checkpoint.Config.WeightMaskPath != "" {
+			weights, err = fit.LoadWeightPlane(checkpoint.Config.WeightMaskPath, bounds.Dx(), bounds.Dy())
+			if err != nil {
+				return err
+			}
+		}
+		costFunc, err := fit.NewCostFunc(checkpoint.Config.Cost, ref, weights)
+		if err != nil {
+			return err
+		}
+		cpu.SetCostFunc(costFunc)
+		rend = cpu
+	}
+	if err := server.ApplyRenderOptions(rend, checkpoint.Config); err != nil {
+		return err
+	}
 
 	// Create optimizer
 	optimizer := opt.NewMayfly(checkpoint.Config.Iters, checkpoint.Config.PopSize, checkpoint.Config.Seed)
@@ -170,20 +195,44 @@ func runResumeLocal(jobID string) error {
 
 	var bestParams []float64
 	var bestCost float64
+	pipeline := checkpoint.Pipeline
+	iterations := checkpoint.Iteration + checkpoint.Config.Iters // Cumulative iterations
 
 	switch checkpoint.Config.Mode {
 	case "joint":
 		lower, upper := rend.Bounds()
-		bestParams, bestCost = resumable.RunWithInitial(
-			checkpoint.BestParams,
-			checkpoint.BestCost,
-			rend.Cost,
-			lower,
-			upper,
-			rend.Dim(),
-		)
+		snapshotter, canSnapshot := optimizer.(opt.SnapshotOptimizer)
+		if canSnapshot && checkpoint.OptimizerState != nil {
+			// Finish the interrupted search exactly where it stopped
+			fmt.Printf("  Continuing the search after generation %d\n", checkpoint.Iteration)
+			bestParams, bestCost, err = snapshotter.RunSnapshots(checkpoint.OptimizerState, rend.Cost, lower, upper, rend.Dim(), nil)
+			if err != nil {
+				slog.Warn("Optimizer state not usable, resuming from best params", "error", err)
+			} else {
+				iterations = checkpoint.Config.Iters
+			}
+		}
+		if bestParams == nil {
+			bestParams, bestCost = resumable.RunWithInitial(
+				checkpoint.BestParams,
+				checkpoint.BestCost,
+				rend.Cost,
+				lower,
+				upper,
+				rend.Dim(),
+			)
+		}
 	case "sequential", "batch":
-		return fmt.Errorf("resume not yet supported for mode: %s", checkpoint.Config.Mode)
+		// Continue the pipeline after the committed circles
+		from := server.ResumePipelineState(checkpoint.Config, checkpoint.BestParams, checkpoint.Pipeline)
+		fmt.Printf("  Continuing after %d committed circle(s)\n", len(checkpoint.BestParams)/checkpoint.Config.ParamsPerCircle())
+		result, err := server.RunPipeline(rend, optimizer, checkpoint.Config, from, func(state renderer.PipelineState) {
+			pipeline = server.CheckpointPipelineState(state, checkpoint.Config.ParamsPerCircle())
+		})
+		if err != nil {
+			return err
+		}
+		bestParams, bestCost = result.BestParams, result.BestCost
 	default:
 		return fmt.Errorf("unknown mode: %s", checkpoint.Config.Mode)
 	}
@@ -214,7 +263,11 @@ func runResumeLocal(jobID string) error {
 		return fmt.Errorf("failed to create output directory: %w", err)
 	}
 
-	// Render and save best image
+	// Render and save best image. A pipeline that converged early (or a batch
+	// pass that overshot Circles) commits a different number of circles.
+	if r, ok := rend.(interface{ SetCircles(k int) }); ok {
+		r.SetCircles(len(bestParams) / renderer.ParamsPerCircle(rend))
+	}
 	bestImg := rend.Render(bestParams)
 	bestPath := filepath.Join(resumeOutputDir, fmt.Sprintf("%s_resumed.png", jobID))
 	if err := saveImage(bestImg, bestPath); err != nil {
@@ -229,9 +282,10 @@ func runResumeLocal(jobID string) error {
 		bestParams,
 		bestCost,
 		checkpoint.InitialCost,
-		checkpoint.Iteration+checkpoint.Config.Iters, // Cumulative iterations
+		iterations,
 		checkpoint.Config,
 	)
+	updatedCheckpoint.Pipeline = pipeline
 
 	if err := checkpointStore.SaveCheckpoint(jobID, updatedCheckpoint); err != nil {
 		slog.Warn("Failed to update checkpoint", "error", err)
@@ -0,0 +1,73 @@
+package cmd
+
+import (
+	"image/color"
+	"os"
+	"path/filepath"
+	"testing"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+	"github.com/cwbudde/mayflycirclefit/internal/store"
+)
+
+// TestRunResumeLocal_ConvergesEarly resumes a sequential checkpoint whose
+// pipeline converges before reaching Circles; the output must be rendered
+// with the committed circles only
+func TestRunResumeLocal_ConvergesEarly(t *testing.T) {
+	dir := t.TempDir()
+	refPath := filepath.Join(dir, "ref.png")
+	writeTestPNG(t, refPath, color.NRGBA{200, 40, 40, 255})
+
+	// runResumeLocal reads checkpoints from ./data
+	wd, err := os.Getwd()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := os.Chdir(dir); err != nil {
+		t.Fatal(err)
+	}
+	defer os.Chdir(wd)
+
+	originalOutputDir := resumeOutputDir
+	resumeOutputDir = filepath.Join(dir, "resumed")
+	defer func() { resumeOutputDir = originalOutputDir }()
+
+	// No relative improvement is ever significant, so the pipeline converges
+	// after its patience instead of adding all 8 circles
+	config := store.JobConfig{
+		RefPath:              refPath,
+		Mode:                 "sequential",
+		Circles:              8,
+		Iters:                3,
+		PopSize:              8,
+		Seed:                 1,
+		ConvergenceEnabled:   true,
+		ConvergencePatience:  1,
+		ConvergenceThreshold: 1e9,
+	}
+	params := make([]float64, fit.ParamsPerCircle)
+	checkpoints, err := store.NewFSStore("./data")
+	if err != nil {
+		t.Fatal(err)
+	}
+	checkpoint := store.NewCheckpoint("early", params, 1, 1, 1, config)
+	checkpoint.Pipeline = &store.PipelineState{Circles: 1, Pass: 1}
+	if err := checkpoints.SaveCheckpoint("early", checkpoint); err != nil {
+		t.Fatal(err)
+	}
+
+	if err := runResumeLocal("early"); err != nil {
+		t.Fatalf("runResumeLocal failed: %v", err)
+	}
+
+	if _, err := os.Stat(filepath.Join(resumeOutputDir, "early_resumed.png")); err != nil {
+		t.Errorf("resumed image not written: %v", err)
+	}
+	updated, err := checkpoints.LoadCheckpoint("early")
+	if err != nil {
+		t.Fatal(err)
+	}
+	if got := len(updated.BestParams) / fit.ParamsPerCircle; got >= config.Circles {
+		t.Fatalf("pipeline committed %d circles, expected it to converge before %d", got, config.Circles)
+	}
+}
@@ -6,10 +6,13 @@ import (
 	"image/png"
 	"log/slog"
 	"os"
+	"path/filepath"
 	"runtime"
 	"runtime/pprof"
+	"strings"
 	"time"
 
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
 	"github.com/cwbudde/mayflycirclefit/internal/fit/renderer"
 	"github.com/cwbudde/mayflycirclefit/internal/opt"
 	"github.com/spf13/cobra"
@@ -18,6 +21,12 @@ import (
 var (
 	refPath           string
 	canvasPath        string
+	weightMaskPath    string
+	costName          string
+	grayscale         bool
+	precisionName     string
+	spanTable         bool
+	antialias         bool
 	outPath           string
 	mode              string
 	backendName       string
@@ -30,21 +39,39 @@ var (
 	threshold         float64
 	cpuProfile        string
 	memProfile        string
+	inputDir          string
+	outputDir         string
+	outputFormat      string
+	fitWorkers        int
+	sequence          bool
+	warmIters         int
+	warmCircles       int
+	warmRadius        float64
 )
 
 var runCmd = &cobra.Command{
 	Use:   "run",
 	Short: "Run single-shot optimization",
-	Long:  `Runs circle fitting optimization and writes output image and parameters.`,
-	RunE:  runOptimization,
+	Long: `Runs circle fitting optimization and writes output image and parameters.
+With --input-dir, every image in the directory is fitted and written to
+--output-dir together with a JSON manifest per image. Adding --sequence treats
+the directory as the frames of an animation: each frame after the first is
+warm-started from the previous frame's circles.`,
+	RunE: runOptimization,
 }
 
 func init() {
-	runCmd.Flags().StringVar(&refPath, "ref", "", "Reference image path (required)")
+	runCmd.Flags().StringVar(&refPath, "ref", "", "Reference image path (required unless --input-dir is set)")
 	runCmd.Flags().StringVar(&canvasPath, "canvas", "", "Canvas image path (optional: start from existing result)")
-	runCmd.Flags().StringVar(&outPath, "out", "out.png", "Output image path")
+	runCmd.Flags().StringVar(&weightMaskPath, "weight-mask", "", "Weight mask image path (optional: grey level = per-pixel importance, CPU backend only)")
+	runCmd.Flags().StringVar(&costName, "cost", fit.DefaultCost, "Cost function: "+strings.Join(fit.CostNames(), ", "))
+	runCmd.Flags().BoolVar(&grayscale, "grayscale", false, "Fit gray circles (X, Y, R, L, Opacity) to the reference luma (CPU backend, MSE cost only)")
+	runCmd.Flags().StringVar(&precisionName, "precision", "float64", "Circle compositing precision: float64, float32 (CPU backends)")
+	runCmd.Flags().BoolVar(&spanTable, "span-table", false, "Rasterize circles through cached span tables, snapping them to 1/8 pixel (CPU backends)")
+	runCmd.Flags().BoolVar(&antialias, "antialias", false, "Anti-aliased circle edges for a smooth cost surface (CPU backends; overrides float32 and span tables)")
+	runCmd.Flags().StringVar(&outPath, "out", "out.png", "Output path: .png image, .svg or .mfc circle list (no rendering)")
 	runCmd.Flags().StringVar(&mode, "mode", "joint", "Optimization mode: joint, sequential, batch")
-	runCmd.Flags().StringVar(&backendName, "backend", "cpu", "Renderer backend to use (cpu, opencl)")
+	runCmd.Flags().StringVar(&backendName, "backend", "cpu", "Renderer backend to use (cpu, planar, opencl)")
 	runCmd.Flags().IntVar(&circles, "circles", 10, "Number of circles")
 	runCmd.Flags().IntVar(&iters, "iters", 100, "Max iterations")
 	runCmd.Flags().IntVar(&popSize, "pop", 30, "Population size")
@@ -55,11 +82,22 @@ func init() {
 	runCmd.Flags().IntVar(&patience, "patience", 3, "Stop after N circles/batches with no significant improvement")
 	runCmd.Flags().Float64Var(&threshold, "threshold", 0.001, "Minimum relative improvement required (0.001 = 0.1%)")
 
+	// Directory mode flags
+	runCmd.Flags().StringVar(&inputDir, "input-dir", "", "Fit every image in this directory instead of --ref")
+	runCmd.Flags().StringVar(&outputDir, "output-dir", "out", "Directory for fitted images and manifests (with --input-dir)")
+	runCmd.Flags().StringVar(&outputFormat, "output-format", "png", "Output format with --input-dir: png, svg, mfc")
+	runCmd.Flags().IntVar(&fitWorkers, "fit-workers", 0, "Images fitted concurrently with --input-dir (default: number of CPUs)")
+
+	// Image sequence flags (with --input-dir)
+	runCmd.Flags().BoolVar(&sequence, "sequence", false, "Fit the --input-dir images in name order as animation frames, warm-starting each from the previous one")
+	runCmd.Flags().IntVar(&warmIters, "warm-iters", 0, "Max iterations per warm-started frame (default: --iters/10)")
+	runCmd.Flags().IntVar(&warmCircles, "warm-circles", renderer.DefaultWarmStartConfig().MaxCircles, "Circles re-optimized per warm-started frame (most changed first)")
+	runCmd.Flags().Float64Var(&warmRadius, "warm-radius", renderer.DefaultWarmStartConfig().Radius, "Warm start search radius as a fraction of each parameter's range")
+
 	// Profiling flags
 	runCmd.Flags().StringVar(&cpuProfile, "cpuprofile", "", "Write CPU profile to file")
 	runCmd.Flags().StringVar(&memProfile, "memprofile", "", "Write memory profile to file")
 
-	runCmd.MarkFlagRequired("ref")
 	rootCmd.AddCommand(runCmd)
 }
 
@@ -78,28 +116,52 @@ func runOptimization(cmd *cobra.Command, args []string) error {
 		slog.Info("CPU profiling enabled", "output", cpuProfile)
 	}
 
-	slog.Info("Starting optimization", "mode", mode, "circles", circles, "iters", iters, "backend", backendName)
-
-	// Load reference image
-	f, err := os.Open(refPath)
-	if err != nil {
-		return fmt.Errorf("failed to open reference: %w", err)
+	if inputDir != "" {
+		if refPath != "" || canvasPath != "" {
+			return fmt.Errorf("--input-dir cannot be combined with --ref or --canvas")
+		}
+		if err := runDirectory(); err != nil {
+			return err
+		}
+	} else {
+		if sequence {
+			return fmt.Errorf("--sequence requires --input-dir")
+		}
+		if refPath == "" {
+			return fmt.Errorf("--ref or --input-dir is required")
+		}
+		if err := runSingle(); err != nil {
+			return err
+		}
 	}
-	defer f.Close()
 
-	img, _, err := image.Decode(f)
-	if err != nil {
-		return fmt.Errorf("failed to decode image: %w", err)
+	// Write memory profile if requested
+	if memProfile != "" {
+		f, err := os.Create(memProfile)
+		if err != nil {
+			return fmt.Errorf("failed to create memory profile: %w", err)
+		}
+		defer f.Close()
+		runtime.GC() // Run GC to get accurate heap stats
+		if err := pprof.WriteHeapProfile(f); err != nil {
+			return fmt.Errorf("failed to write memory profile: %w", err)
+		}
+		slog.Info("Memory profile written", "output", memProfile)
 	}
 
-	// Convert to NRGBA
-	bounds := img.Bounds()
-	ref := image.NewNRGBA(bounds)
-	for y := bounds.Min.Y; y < bounds.Max.Y; y++ {
-		for x := bounds.Min.X; x < bounds.Max.X; x++ {
-			ref.Set(x, y, img.At(x, y))
-		}
+	return nil
+}
+
+// runSingle fits the --ref image and writes the result to --out
+func runSingle() error {
+	slog.Info("Starting optimization", "mode", mode, "circles", circles, "iters", iters, "backend", backendName)
+
+	// Load reference image
+	ref, err := decodeNRGBA(refPath, "reference")
+	if err != nil {
+		return err
 	}
+	bounds := ref.Bounds()
 
 	slog.Info("Loaded reference", "width", bounds.Dx(), "height", bounds.Dy())
 
@@ -130,31 +192,198 @@ func runOptimization(cmd *cobra.Command, args []string) error {
 		slog.Info("Loaded canvas", "width", canvas.Bounds().Dx(), "height", canvas.Bounds().Dy())
 	}
 
+	fitted, err := fitReference(ref, canvas, nil)
+	if err != nil {
+		return err
+	}
+	result := fitted.result
+
+	// Save output
+	if err := fitted.writeResult(outPath, bounds.Dx(), bounds.Dy()); err != nil {
+		return err
+	}
+
+	cps := fitted.circlesPerSecond()
+
+	slog.Info("Optimization complete",
+		"elapsed", fitted.elapsed,
+		"initial_cost", result.InitialCost,
+		"final_cost", result.BestCost,
+		"improvement", result.InitialCost-result.BestCost,
+		"circles_used", fitted.circles,
+		"circles_requested", circles,
+		"circles_per_second", fmt.Sprintf("%.0f", cps),
+		"circles_culled", fitted.culled,
+	)
+
+	if fitted.circles < circles {
+		fmt.Printf("Wrote %s (cost: %.2f -> %.2f, %d/%d circles, %.0f circles/sec) - Converged early!\n",
+			outPath, result.InitialCost, result.BestCost, fitted.circles, circles, cps)
+	} else {
+		fmt.Printf("Wrote %s (cost: %.2f -> %.2f, %d circles, %.0f circles/sec)\n",
+			outPath, result.InitialCost, result.BestCost, fitted.circles, cps)
+	}
+	return nil
+}
+
+// decodeNRGBA loads the image at path as NRGBA; what names it in errors
+func decodeNRGBA(path, what string) (*image.NRGBA, error) {
+	f, err := os.Open(path)
+	if err != nil {
+		return nil, fmt.Errorf("failed to open %s: %w", what, err)
+	}
+	defer f.Close()
+
+	img, _, err := image.Decode(f)
+	if err != nil {
+		return nil, fmt.Errorf("failed to decode image: %w", err)
+	}
+
+	// Convert to NRGBA
+	bounds := img.Bounds()
+	nrgba := image.NewNRGBA(bounds)
+	for y := bounds.Min.Y; y < bounds.Max.Y; y++ {
+		for x := bounds.Min.X; x < bounds.Max.X; x++ {
+			nrgba.Set(x, y, img.At(x, y))
+		}
+	}
+	return nrgba, nil
+}
+
+// fitResult is the outcome of fitting one reference image
+type fitResult struct {
+	result  *renderer.OptimizationResult
+	render  func() *image.NRGBA // Renders the result (vector outputs skip it)
+	ppc     int                 // Parameters per circle of result.BestParams
+	circles int                 // Circles used (fewer than requested on early convergence)
+	culled  uint64              // Circles skipped by occlusion culling
+	warm    bool                // Warm-started from the previous frame
+	elapsed time.Duration
+}
+
+// warmStart is the previous frame's fit in sequence mode
+type warmStart struct {
+	params []float64
+	frame  *image.NRGBA
+}
+
+// writeResult writes f to path as SVG (.svg), a binary circle list (.mfc)
+// or PNG (anything else). Vector formats are streamed from the parameters
+// without rendering.
+func (f *fitResult) writeResult(path string, width, height int) error {
+	out, err := os.Create(path)
+	if err != nil {
+		return fmt.Errorf("failed to create output: %w", err)
+	}
+
+	switch strings.ToLower(filepath.Ext(path)) {
+	case ".svg":
+		err = fit.WriteSVG(out, f.result.BestParams, f.ppc, width, height)
+	case ".mfc":
+		err = fit.WriteCircles(out, f.result.BestParams, f.ppc, width, height)
+	default:
+		err = png.Encode(out, f.render())
+	}
+	if err != nil {
+		out.Close()
+		return fmt.Errorf("failed to encode output: %w", err)
+	}
+	return out.Close()
+}
+
+// circlesPerSecond estimates throughput: each eval renders all circles
+func (f *fitResult) circlesPerSecond() float64 {
+	totalCircles := f.result.Evaluations * f.circles
+	return float64(totalCircles) / f.elapsed.Seconds()
+}
+
+// fitReference runs the optimization configured by the run flags on ref,
+// starting from canvas if not nil. With warm, the previous frame's fit of a
+// same-sized image, only its changed circles are refined instead. It only
+// reads the flags, so directory mode calls it from several goroutines.
+func fitReference(ref, canvas *image.NRGBA, warm *warmStart) (*fitResult, error) {
+	bounds := ref.Bounds()
+	if warm != nil && warm.frame.Bounds().Size() != bounds.Size() {
+		slog.Info("Frame size changed, fitting from scratch",
+			"previous", warm.frame.Bounds().Size(), "current", bounds.Size())
+		warm = nil
+	}
+
 	// Create renderer (with or without canvas)
 	var rend renderer.Renderer
 	var cleanup func()
 
 	if backendName == "cpu" {
-		// CPU renderer supports canvas
-		if canvas != nil {
-			rend = renderer.NewCPURendererWithCanvas(ref, canvas, circles)
+		var weights *fit.WeightPlane
+		if weightMaskPath != "" {
+			var err error
+			weights, err = fit.LoadWeightPlane(weightMaskPath, bounds.Dx(), bounds.Dy())
+			if err != nil {
+				return nil, err
+			}
+			slog.Info("Loaded weight mask", "path", weightMaskPath)
+		}
+		costFunc, err := fit.NewCostFunc(costName, ref, weights)
+		if err != nil {
+			return nil, err
+		}
+
+		// CPU renderer supports canvas; plain MSE on a white background
+		// runs on the planar renderer (identical results, less bandwidth)
+		if grayscale {
+			if canvas != nil || weights != nil || !fit.IsMSECost(costName) {
+				return nil, fmt.Errorf("grayscale mode does not support canvas, weight mask or cost %q", costName)
+			}
+			rend = renderer.NewGrayRenderer(ref, circles)
+		} else if canvas != nil {
+			cpu := renderer.NewCPURendererWithCanvas(ref, canvas, circles)
+			cpu.SetCostFunc(costFunc)
+			rend = cpu
+		} else if weights == nil && fit.IsMSECost(costName) {
+			rend = renderer.NewPlanarRenderer(ref, circles)
 		} else {
-			rend = renderer.NewCPURenderer(ref, circles)
+			cpu := renderer.NewCPURenderer(ref, circles)
+			cpu.SetCostFunc(costFunc)
+			rend = cpu
 		}
 		cleanup = func() {} // No cleanup needed for CPU renderer
 	} else {
-		// Other backends don't support canvas yet
-		if canvas != nil {
-			return fmt.Errorf("canvas loading only supported with CPU backend")
+		// Other backends don't support weight masks yet
+		if weightMaskPath != "" {
+			return nil, fmt.Errorf("weight masks only supported with CPU backend")
+		}
+		if !fit.IsMSECost(costName) {
+			return nil, fmt.Errorf("cost function %q only supported with CPU backend", costName)
+		}
+		if grayscale {
+			return nil, fmt.Errorf("grayscale mode only supported with CPU backend")
 		}
 		var err error
-		rend, cleanup, err = renderer.NewRendererForBackend(backendName, ref, circles)
+		rend, cleanup, err = renderer.NewRendererForBackendWithCanvas(backendName, ref, canvas, circles)
 		if err != nil {
-			return fmt.Errorf("failed to create renderer: %w", err)
+			return nil, fmt.Errorf("failed to create renderer: %w", err)
 		}
 	}
 	defer cleanup()
 
+	precision, err := renderer.ParsePrecision(precisionName)
+	if err != nil {
+		return nil, err
+	}
+	if !renderer.SetPrecision(rend, precision) {
+		return nil, fmt.Errorf("precision %s not supported by backend %s", precision, backendName)
+	}
+	var spans *renderer.SpanTable
+	if spanTable {
+		spans = renderer.DefaultSpanTable()
+		if !renderer.SetSpanTable(rend, spans) {
+			return nil, fmt.Errorf("span tables not supported by backend %s", backendName)
+		}
+	}
+	if !renderer.SetAntialias(rend, antialias) {
+		return nil, fmt.Errorf("anti-aliasing not supported by backend %s", backendName)
+	}
+
 	// Create optimizer
 	optimizer := opt.NewMayfly(iters, popSize, seed)
 
@@ -173,12 +402,21 @@ func runOptimization(cmd *cobra.Command, args []string) error {
 	start := time.Now()
 	var result *renderer.OptimizationResult
 
-	switch mode {
-	case "joint":
+	switch {
+	case warm != nil:
+		warmConfig := renderer.DefaultWarmStartConfig()
+		warmConfig.MaxCircles = warmCircles
+		warmConfig.Radius = warmRadius
+		frameIters := warmIters
+		if frameIters <= 0 {
+			frameIters = max(iters/10, 1)
+		}
+		result = renderer.OptimizeWarmStart(rend, opt.NewMayfly(frameIters, popSize, seed), warm.params, warm.frame, warmConfig)
+	case mode == "joint":
 		result = renderer.OptimizeJoint(rend, optimizer, circles, convergenceConfig)
-	case "sequential":
+	case mode == "sequential":
 		result = renderer.OptimizeSequential(rend, optimizer, circles, convergenceConfig)
-	case "batch":
+	case mode == "batch":
 		batchSize := 5
 		passes := circles / batchSize
 		if circles%batchSize != 0 {
@@ -186,65 +424,37 @@ func runOptimization(cmd *cobra.Command, args []string) error {
 		}
 		result = renderer.OptimizeBatch(rend, optimizer, batchSize, passes, convergenceConfig)
 	default:
-		return fmt.Errorf("unknown mode: %s", mode)
+		return nil, fmt.Errorf("unknown mode: %s", mode)
 	}
 
 	elapsed := time.Since(start)
 
 	// Render final image
 	// Use actual number of circles from result (may be less if convergence detected)
-	actualCircles := len(result.BestParams) / 7
-	finalRenderer := renderer.NewCPURenderer(ref, actualCircles)
-	output := finalRenderer.Render(result.BestParams)
-
-	// Save output
-	outFile, err := os.Create(outPath)
-	if err != nil {
-		return fmt.Errorf("failed to create output: %w", err)
-	}
-	defer outFile.Close()
-
-	if err := png.Encode(outFile, output); err != nil {
-		return fmt.Errorf("failed to encode output: %w", err)
-	}
-
-	// Compute throughput (circles rendered per second)
-	// Each eval renders K circles, estimate total evals ~ iters * popSize
-	totalEvals := iters * popSize
-	totalCircles := totalEvals * actualCircles
-	cps := float64(totalCircles) / elapsed.Seconds()
-
-	slog.Info("Optimization complete",
-		"elapsed", elapsed,
-		"initial_cost", result.InitialCost,
-		"final_cost", result.BestCost,
-		"improvement", result.InitialCost-result.BestCost,
-		"circles_used", actualCircles,
-		"circles_requested", circles,
-		"circles_per_second", fmt.Sprintf("%.0f", cps),
-	)
-
-	if actualCircles < circles {
-		fmt.Printf("Wrote %s (cost: %.2f -> %.2f, %d/%d circles, %.0f circles/sec) - Converged early!\n",
-			outPath, result.InitialCost, result.BestCost, actualCircles, circles, cps)
-	} else {
-		fmt.Printf("Wrote %s (cost: %.2f -> %.2f, %d circles, %.0f circles/sec)\n",
-			outPath, result.InitialCost, result.BestCost, actualCircles, cps)
-	}
-
-	// Write memory profile if requested
-	if memProfile != "" {
-		f, err := os.Create(memProfile)
-		if err != nil {
-			return fmt.Errorf("failed to create memory profile: %w", err)
-		}
-		defer f.Close()
-		runtime.GC() // Run GC to get accurate heap stats
-		if err := pprof.WriteHeapProfile(f); err != nil {
-			return fmt.Errorf("failed to write memory profile: %w", err)
+	ppc := renderer.ParamsPerCircle(rend)
+	actualCircles := len(result.BestParams) / ppc
+	render := func() *image.NRGBA {
+		var final renderer.Renderer
+		if grayscale {
+			final = renderer.NewGrayRenderer(ref, actualCircles)
+		} else if canvas != nil {
+			final = renderer.NewCPURendererWithCanvas(ref, canvas, actualCircles)
+		} else {
+			final = renderer.NewCPURenderer(ref, actualCircles)
 		}
-		slog.Info("Memory profile written", "output", memProfile)
+		renderer.SetPrecision(final, precision)
+		renderer.SetSpanTable(final, spans)
+		renderer.SetAntialias(final, antialias)
+		return final.Render(result.BestParams) // final is not reused
 	}
 
-	return nil
+	return &fitResult{
+		result:  result,
+		render:  render,
+		ppc:     ppc,
+		circles: actualCircles,
+		culled:  renderer.CulledCircles(rend),
+		warm:    warm != nil,
+		elapsed: elapsed,
+	}, nil
 }
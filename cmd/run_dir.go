@@ -0,0 +1,298 @@
+package cmd
+
+import (
+	"encoding/json"
+	"fmt"
+	"image"
+	_ "image/jpeg"
+	"log/slog"
+	"os"
+	"path/filepath"
+	"runtime"
+	"sort"
+	"strings"
+	"sync"
+	"time"
+)
+
+// Directory mode (run --input-dir).
+//
+// Every image in the input directory is fitted with the run flags' settings.
+// The work is a three-stage pipeline connected by bounded channels:
+//
+//	decode (1 goroutine) -> fit (--fit-workers goroutines) -> encode (1 goroutine)
+//
+// so reading and decoding the next images and writing finished ones overlap
+// with the fits. Each channel holds at most one image per fit worker, which
+// bounds memory regardless of the directory size. Failed images are recorded
+// in their manifest and do not stop the run.
+//
+// With --sequence the images are frames of an animation (video containers
+// have to be extracted to numbered images first). A single fit worker takes
+// them in name order and warm-starts each frame from the previous frame's
+// circles (see renderer.OptimizeWarmStart); decoding and encoding still
+// overlap with it. A failed frame makes the next one start from scratch.
+
+// imageExtensions are the input files picked up by directory mode
+var imageExtensions = map[string]bool{".png": true, ".jpg": true, ".jpeg": true}
+
+// outputFormats are the --output-format values (also the file extensions)
+var outputFormats = map[string]bool{"png": true, "svg": true, "mfc": true}
+
+// imageManifest is the per-image result written next to the fitted image
+type imageManifest struct {
+	Input           string    `json:"input"`
+	Output          string    `json:"output,omitempty"`
+	Width           int       `json:"width,omitempty"`
+	Height          int       `json:"height,omitempty"`
+	Mode            string    `json:"mode"`
+	Cost            string    `json:"cost"`
+	Circles         int       `json:"circles"`               // Requested
+	CirclesUsed     int       `json:"circlesUsed,omitempty"` // Fewer on early convergence
+	ParamsPerCircle int       `json:"paramsPerCircle,omitempty"`
+	Iters           int       `json:"iters"`
+	PopSize         int       `json:"popSize"`
+	Seed            int64     `json:"seed"`
+	InitialCost     float64   `json:"initialCost,omitempty"`
+	BestCost        float64   `json:"bestCost,omitempty"`
+	Evaluations     int       `json:"evaluations,omitempty"`
+	WarmStart       bool      `json:"warmStart,omitempty"`      // Refined from the previous frame
+	Elapsed         float64   `json:"elapsedSeconds,omitempty"` // Fit time only
+	Params          []float64 `json:"params,omitempty"`
+	Error           string    `json:"error,omitempty"`
+}
+
+// decodedImage is handed from the decode to the fit stage
+type decodedImage struct {
+	manifest *imageManifest
+	ref      *image.NRGBA
+	stem     string
+}
+
+// fittedImage is handed from the fit to the encode stage
+type fittedImage struct {
+	manifest *imageManifest
+	fitted   *fitResult
+	stem     string
+}
+
+// runDirectory fits every image in --input-dir and writes <name>.<format>
+// and <name>.manifest.json per image plus a manifest.json index to --output-dir
+func runDirectory() error {
+	inputs, err := listImages(inputDir)
+	if err != nil {
+		return err
+	}
+	if len(inputs) == 0 {
+		return fmt.Errorf("no images found in %s", inputDir)
+	}
+	if !outputFormats[outputFormat] {
+		return fmt.Errorf("unknown output format %q (png, svg, mfc)", outputFormat)
+	}
+	if sameDir(inputDir, outputDir) {
+		return fmt.Errorf("--output-dir must differ from --input-dir")
+	}
+	if sequence && (warmCircles < 1 || warmRadius <= 0) {
+		return fmt.Errorf("--warm-circles and --warm-radius must be positive")
+	}
+	if err := os.MkdirAll(outputDir, 0755); err != nil {
+		return fmt.Errorf("failed to create output directory: %w", err)
+	}
+
+	workers := fitWorkers
+	if workers <= 0 {
+		workers = runtime.GOMAXPROCS(0)
+	}
+	workers = min(workers, len(inputs))
+	if sequence {
+		workers = 1 // Each frame needs the previous one's result
+	}
+
+	slog.Info("Starting directory run",
+		"input_dir", inputDir, "output_dir", outputDir, "images", len(inputs),
+		"fit_workers", workers, "mode", mode, "circles", circles, "backend", backendName, "sequence", sequence)
+	start := time.Now()
+
+	// Sequence mode decodes a couple of frames ahead of its single worker
+	decoded := make(chan decodedImage, max(workers, 2))
+	fitted := make(chan fittedImage, workers)
+
+	// Stage 1: read and decode
+	go func() {
+		defer close(decoded)
+		for _, input := range inputs {
+			m := newImageManifest(input)
+			stem := strings.TrimSuffix(filepath.Base(input), filepath.Ext(input))
+			ref, err := decodeNRGBA(input, "reference")
+			if err != nil {
+				m.Error = err.Error()
+			} else {
+				m.Width, m.Height = ref.Bounds().Dx(), ref.Bounds().Dy()
+			}
+			decoded <- decodedImage{manifest: m, ref: ref, stem: stem}
+		}
+	}()
+
+	// Stage 2: fit
+	var wg sync.WaitGroup
+	for w := 0; w < workers; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			var prev *warmStart // Sequence mode only
+			for d := range decoded {
+				out := fittedImage{manifest: d.manifest, stem: d.stem}
+				if d.ref != nil {
+					fitDecodedImage(d, &out, prev)
+				}
+				if sequence {
+					prev = nil
+					if out.fitted != nil {
+						prev = &warmStart{params: out.fitted.result.BestParams, frame: d.ref}
+					}
+				}
+				fitted <- out
+			}
+		}()
+	}
+	go func() {
+		wg.Wait()
+		close(fitted)
+	}()
+
+	// Stage 3: encode and write results (on this goroutine)
+	var manifests []*imageManifest
+	failed := 0
+	for f := range fitted {
+		if f.fitted != nil {
+			f.manifest.Output = filepath.Join(outputDir, f.stem+"."+outputFormat)
+			if err := f.fitted.writeResult(f.manifest.Output, f.manifest.Width, f.manifest.Height); err != nil {
+				f.manifest.Output = ""
+				f.manifest.Error = err.Error()
+			}
+		}
+		if err := writeJSON(filepath.Join(outputDir, f.stem+".manifest.json"), f.manifest); err != nil {
+			f.manifest.Error = err.Error()
+		}
+
+		if f.manifest.Error != "" {
+			failed++
+			slog.Error("Image failed", "input", f.manifest.Input, "error", f.manifest.Error)
+		} else {
+			fmt.Printf("Wrote %s (cost: %.2f -> %.2f, %d circles, %.1fs)\n",
+				f.manifest.Output, f.manifest.InitialCost, f.manifest.BestCost, f.manifest.CirclesUsed, f.manifest.Elapsed)
+		}
+		manifests = append(manifests, f.manifest)
+	}
+
+	// Index of all images (without parameters), in input order
+	sort.Slice(manifests, func(i, j int) bool { return manifests[i].Input < manifests[j].Input })
+	index := make([]imageManifest, len(manifests))
+	for i, m := range manifests {
+		index[i] = *m
+		index[i].Params = nil
+	}
+	if err := writeJSON(filepath.Join(outputDir, "manifest.json"), index); err != nil {
+		return err
+	}
+
+	elapsed := time.Since(start)
+	slog.Info("Directory run complete", "images", len(inputs), "failed", failed, "elapsed", elapsed)
+	fmt.Printf("Fitted %d/%d images in %s\n", len(inputs)-failed, len(inputs), elapsed.Round(time.Millisecond))
+	if failed > 0 {
+		return fmt.Errorf("%d of %d images failed (see %s)", failed, len(inputs), filepath.Join(outputDir, "manifest.json"))
+	}
+	return nil
+}
+
+// fitDecodedImage runs the fit stage for one image, warm-started from prev
+// if not nil
+func fitDecodedImage(d decodedImage, out *fittedImage, prev *warmStart) {
+	// Recover so one bad image (e.g. a renderer panic) does not end the run
+	defer func() {
+		if r := recover(); r != nil {
+			d.manifest.Error = fmt.Sprintf("fit panicked: %v", r)
+			out.fitted = nil
+		}
+	}()
+
+	fitted, err := fitReference(d.ref, nil, prev)
+	if err != nil {
+		d.manifest.Error = err.Error()
+		return
+	}
+	m := d.manifest
+	m.CirclesUsed = fitted.circles
+	m.ParamsPerCircle = fitted.ppc
+	m.InitialCost = fitted.result.InitialCost
+	m.BestCost = fitted.result.BestCost
+	m.Evaluations = fitted.result.Evaluations
+	m.WarmStart = fitted.warm
+	m.Elapsed = fitted.elapsed.Seconds()
+	m.Params = fitted.result.BestParams
+	if outputFormat == "png" {
+		// Rasterize here, in parallel, rather than in the encode stage
+		img := fitted.render()
+		fitted.render = func() *image.NRGBA { return img }
+	}
+	out.fitted = fitted
+}
+
+// newImageManifest records the run settings for input
+func newImageManifest(input string) *imageManifest {
+	return &imageManifest{
+		Input:   input,
+		Mode:    mode,
+		Cost:    costName,
+		Circles: circles,
+		Iters:   iters,
+		PopSize: popSize,
+		Seed:    seed,
+	}
+}
+
+// listImages returns the image files directly inside dir, sorted by name.
+// Inputs whose names differ only in extension would share outputs and are
+// rejected.
+func listImages(dir string) ([]string, error) {
+	entries, err := os.ReadDir(dir)
+	if err != nil {
+		return nil, fmt.Errorf("failed to read input directory: %w", err)
+	}
+
+	var inputs []string
+	stems := make(map[string]string)
+	for _, entry := range entries {
+		ext := strings.ToLower(filepath.Ext(entry.Name()))
+		if entry.IsDir() || !imageExtensions[ext] {
+			continue
+		}
+		stem := strings.TrimSuffix(entry.Name(), filepath.Ext(entry.Name()))
+		if other, exists := stems[stem]; exists {
+			return nil, fmt.Errorf("inputs %s and %s would write the same output", other, entry.Name())
+		}
+		stems[stem] = entry.Name()
+		inputs = append(inputs, filepath.Join(dir, entry.Name()))
+	}
+	sort.Strings(inputs)
+	return inputs, nil
+}
+
+// sameDir reports whether a and b name the same directory
+func sameDir(a, b string) bool {
+	absA, errA := filepath.Abs(a)
+	absB, errB := filepath.Abs(b)
+	return errA == nil && errB == nil && absA == absB
+}
+
+// writeJSON writes v as indented JSON to path
+func writeJSON(path string, v any) error {
+	data, err := json.MarshalIndent(v, "", "  ")
+	if err != nil {
+		return fmt.Errorf("failed to encode manifest: %w", err)
+	}
+	if err := os.WriteFile(path, data, 0644); err != nil {
+		return fmt.Errorf("failed to write manifest: %w", err)
+	}
+	return nil
+}
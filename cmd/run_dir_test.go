@@ -0,0 +1,157 @@
+package cmd
+
+import (
+	"encoding/json"
+	"image"
+	"image/color"
+	"image/png"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+)
+
+// restoreRunFlags resets every run flag the directory tests set when t ends
+func restoreRunFlags(t *testing.T) {
+	origInput, origOutput, origFormat, origWorkers := inputDir, outputDir, outputFormat, fitWorkers
+	origSequence, origWarmIters, origWarmCircles, origWarmRadius := sequence, warmIters, warmCircles, warmRadius
+	origMode, origBackend, origCost, origPrecision := mode, backendName, costName, precisionName
+	origCircles, origIters, origPopSize, origSeed := circles, iters, popSize, seed
+	t.Cleanup(func() {
+		inputDir, outputDir, outputFormat, fitWorkers = origInput, origOutput, origFormat, origWorkers
+		sequence, warmIters, warmCircles, warmRadius = origSequence, origWarmIters, origWarmCircles, origWarmRadius
+		mode, backendName, costName, precisionName = origMode, origBackend, origCost, origPrecision
+		circles, iters, popSize, seed = origCircles, origIters, origPopSize, origSeed
+	})
+}
+
+func writeTestPNG(t *testing.T, path string, c color.NRGBA) {
+	img := image.NewNRGBA(image.Rect(0, 0, 24, 16))
+	for y := 0; y < 16; y++ {
+		for x := 0; x < 24; x++ {
+			if x > 8 && y > 4 {
+				img.Set(x, y, c)
+			} else {
+				img.Set(x, y, color.NRGBA{255, 255, 255, 255})
+			}
+		}
+	}
+	f, err := os.Create(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer f.Close()
+	if err := png.Encode(f, img); err != nil {
+		t.Fatal(err)
+	}
+}
+
+func TestRunDirectory(t *testing.T) {
+	in, out := t.TempDir(), filepath.Join(t.TempDir(), "fitted")
+	writeTestPNG(t, filepath.Join(in, "a.png"), color.NRGBA{200, 0, 0, 255})
+	writeTestPNG(t, filepath.Join(in, "b.png"), color.NRGBA{0, 0, 200, 255})
+	os.WriteFile(filepath.Join(in, "broken.png"), []byte("not an image"), 0644)
+	os.WriteFile(filepath.Join(in, "notes.txt"), []byte("ignored"), 0644)
+
+	restoreRunFlags(t)
+	inputDir, outputDir, fitWorkers = in, out, 2
+	mode, backendName, costName, precisionName = "joint", "cpu", "", "float64"
+	circles, iters, popSize, seed = 2, 5, 8, 1
+
+	err := runDirectory()
+	if err == nil || !strings.Contains(err.Error(), "1 of 3 images failed") {
+		t.Fatalf("expected one failed image, got %v", err)
+	}
+
+	for _, name := range []string{"a", "b"} {
+		if _, err := os.Stat(filepath.Join(out, name+".png")); err != nil {
+			t.Errorf("missing output: %v", err)
+		}
+		data, err := os.ReadFile(filepath.Join(out, name+".manifest.json"))
+		if err != nil {
+			t.Fatalf("missing manifest: %v", err)
+		}
+		var m imageManifest
+		if err := json.Unmarshal(data, &m); err != nil {
+			t.Fatal(err)
+		}
+		if m.Error != "" || m.Width != 24 || len(m.Params) != m.CirclesUsed*m.ParamsPerCircle || m.BestCost > m.InitialCost {
+			t.Errorf("%s: unexpected manifest %+v", name, m)
+		}
+	}
+
+	var index []imageManifest
+	data, _ := os.ReadFile(filepath.Join(out, "manifest.json"))
+	if err := json.Unmarshal(data, &index); err != nil || len(index) != 3 {
+		t.Fatalf("expected 3 index entries, got %d (%v)", len(index), err)
+	}
+	if !strings.HasSuffix(index[2].Input, "broken.png") || index[2].Error == "" || index[0].Params != nil {
+		t.Errorf("unexpected index %+v", index)
+	}
+}
+
+func TestListImagesRejectsSharedStems(t *testing.T) {
+	dir := t.TempDir()
+	writeTestPNG(t, filepath.Join(dir, "a.png"), color.NRGBA{A: 255})
+	writeTestPNG(t, filepath.Join(dir, "a.jpg"), color.NRGBA{A: 255})
+	if _, err := listImages(dir); err == nil {
+		t.Error("expected an error for a.png and a.jpg")
+	}
+}
+
+func TestRunDirectoryVectorOutput(t *testing.T) {
+	in, out := t.TempDir(), t.TempDir()
+	writeTestPNG(t, filepath.Join(in, "a.png"), color.NRGBA{200, 0, 0, 255})
+
+	restoreRunFlags(t)
+	inputDir, outputDir, outputFormat = in, out, "mfc"
+	mode, backendName, costName, precisionName = "joint", "cpu", "", "float64"
+	circles, iters, popSize, seed = 2, 5, 8, 1
+
+	if err := runDirectory(); err != nil {
+		t.Fatal(err)
+	}
+	f, err := os.Open(filepath.Join(out, "a.mfc"))
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer f.Close()
+	params, ppc, width, height, err := fit.ReadCircles(f)
+	if err != nil || ppc != fit.ParamsPerCircle || width != 24 || height != 16 || len(params) != 2*ppc {
+		t.Errorf("unexpected circle list: %d params, ppc %d, %dx%d, %v", len(params), ppc, width, height, err)
+	}
+}
+
+func TestRunDirectorySequence(t *testing.T) {
+	in, out := t.TempDir(), t.TempDir()
+	writeTestPNG(t, filepath.Join(in, "frame1.png"), color.NRGBA{200, 0, 0, 255})
+	writeTestPNG(t, filepath.Join(in, "frame2.png"), color.NRGBA{200, 0, 0, 255})
+	writeTestPNG(t, filepath.Join(in, "frame3.png"), color.NRGBA{150, 40, 0, 255})
+
+	restoreRunFlags(t)
+	inputDir, outputDir, sequence = in, out, true
+	warmIters, warmCircles, warmRadius = 2, 4, 0.1
+	mode, backendName, costName, precisionName = "joint", "cpu", "", "float64"
+	circles, iters, popSize, seed = 3, 20, 8, 1
+
+	if err := runDirectory(); err != nil {
+		t.Fatal(err)
+	}
+
+	var index []imageManifest
+	data, _ := os.ReadFile(filepath.Join(out, "manifest.json"))
+	if err := json.Unmarshal(data, &index); err != nil || len(index) != 3 {
+		t.Fatalf("expected 3 index entries, got %d (%v)", len(index), err)
+	}
+	if index[0].WarmStart || index[0].Evaluations == 0 {
+		t.Errorf("first frame should be fitted from scratch: %+v", index[0])
+	}
+	if !index[1].WarmStart || index[1].Evaluations != 0 || index[1].BestCost != index[0].BestCost {
+		t.Errorf("repeated frame should reuse the previous circles: %+v", index[1])
+	}
+	if !index[2].WarmStart || index[2].BestCost > index[2].InitialCost || index[2].Evaluations >= index[0].Evaluations {
+		t.Errorf("changed frame should be refined with fewer evaluations: %+v", index[2])
+	}
+}
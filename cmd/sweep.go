@@ -0,0 +1,162 @@
+package cmd
+
+import (
+	"context"
+	"encoding/json"
+	"fmt"
+	"os"
+	"os/signal"
+	"syscall"
+	"text/tabwriter"
+	"time"
+
+	"github.com/cwbudde/mayflycirclefit/internal/server"
+	"github.com/spf13/cobra"
+)
+
+var (
+	sweepRefPath     string
+	sweepModes       []string
+	sweepCircles     []int
+	sweepSeeds       []int64
+	sweepCosts       []string
+	sweepIters       int
+	sweepPopSize     int
+	sweepWorkers     int
+	sweepConfigsPath string
+	sweepSummaryPath string
+)
+
+var sweepCmd = &cobra.Command{
+	Use:   "sweep",
+	Short: "Run a parameter sweep on one reference image",
+	Long: `Runs one optimization per combination of --modes, --circles, --seeds and
+--costs (or per entry of a --configs JSON file) concurrently, decoding the
+reference image and building cost functions once for all of them, and prints
+the variants ranked by best cost.`,
+	RunE: runSweep,
+}
+
+func init() {
+	sweepCmd.Flags().StringVar(&sweepRefPath, "ref", "", "Reference image path (required)")
+	sweepCmd.Flags().StringSliceVar(&sweepModes, "modes", []string{"joint"}, "Optimization modes to compare: joint, sequential, batch")
+	sweepCmd.Flags().IntSliceVar(&sweepCircles, "circles", []int{10}, "Circle counts to compare")
+	sweepCmd.Flags().Int64SliceVar(&sweepSeeds, "seeds", []int64{42}, "Random seeds to compare")
+	sweepCmd.Flags().StringSliceVar(&sweepCosts, "costs", []string{""}, "Cost functions to compare (default: fast-mse)")
+	sweepCmd.Flags().IntVar(&sweepIters, "iters", 100, "Max iterations per variant")
+	sweepCmd.Flags().IntVar(&sweepPopSize, "pop", 30, "Population size per variant")
+	sweepCmd.Flags().IntVar(&sweepWorkers, "workers", 0, "Variants run concurrently (default: number of CPUs)")
+	sweepCmd.Flags().StringVar(&sweepConfigsPath, "configs", "", "JSON file with an array of job configs (replaces the sweep flags)")
+	sweepCmd.Flags().StringVar(&sweepSummaryPath, "summary", "", "Write the batch summary as JSON to this path")
+
+	sweepCmd.MarkFlagRequired("ref")
+	rootCmd.AddCommand(sweepCmd)
+}
+
+func runSweep(cmd *cobra.Command, args []string) error {
+	configs, err := sweepConfigs()
+	if err != nil {
+		return err
+	}
+
+	ctx, stop := signal.NotifyContext(context.Background(), os.Interrupt, syscall.SIGTERM)
+	defer stop()
+
+	fmt.Printf("Sweeping %d variant(s) of %s\n", len(configs), sweepRefPath)
+	summary, err := server.RunBatch(ctx, server.NewJobManager(), nil, server.BatchRequest{
+		RefPath: sweepRefPath,
+		Jobs:    configs,
+		Workers: sweepWorkers,
+	})
+	if err != nil {
+		return err
+	}
+
+	printSweepSummary(summary)
+
+	if sweepSummaryPath != "" {
+		data, err := json.MarshalIndent(summary, "", "  ")
+		if err != nil {
+			return fmt.Errorf("failed to encode summary: %w", err)
+		}
+		if err := os.WriteFile(sweepSummaryPath, data, 0644); err != nil {
+			return fmt.Errorf("failed to write summary: %w", err)
+		}
+		fmt.Printf("Summary written to %s\n", sweepSummaryPath)
+	}
+	return ctx.Err()
+}
+
+// sweepConfigs returns the job configs from --configs, or the cartesian
+// product of the sweep flags
+func sweepConfigs() ([]server.JobConfig, error) {
+	if sweepConfigsPath != "" {
+		data, err := os.ReadFile(sweepConfigsPath)
+		if err != nil {
+			return nil, fmt.Errorf("failed to read configs: %w", err)
+		}
+		var configs []server.JobConfig
+		if err := json.Unmarshal(data, &configs); err != nil {
+			return nil, fmt.Errorf("failed to parse configs: %w", err)
+		}
+		return configs, nil
+	}
+
+	var configs []server.JobConfig
+	for _, mode := range sweepModes {
+		for _, circles := range sweepCircles {
+			for _, cost := range sweepCosts {
+				for _, seed := range sweepSeeds {
+					configs = append(configs, server.JobConfig{
+						Mode:    mode,
+						Circles: circles,
+						Cost:    cost,
+						Seed:    seed,
+						Iters:   sweepIters,
+						PopSize: sweepPopSize,
+					})
+				}
+			}
+		}
+	}
+	return configs, nil
+}
+
+// printSweepSummary prints the variants ranked by best cost
+func printSweepSummary(summary *server.BatchSummary) {
+	results := make([]server.BatchResult, 0, len(summary.Results))
+	var unranked []server.BatchResult
+	for _, result := range summary.Results {
+		if result.Rank > 0 {
+			results = append(results, result)
+		} else {
+			unranked = append(unranked, result)
+		}
+	}
+	ranked := make([]server.BatchResult, len(results))
+	for _, result := range results {
+		ranked[result.Rank-1] = result
+	}
+
+	fmt.Println()
+	w := tabwriter.NewWriter(os.Stdout, 0, 0, 2, ' ', tabwriter.AlignRight)
+	fmt.Fprintln(w, "Rank\tMode\tCircles\tCost\tSeed\tInitial\tBest\tImprovement\tElapsed\tState\t")
+	for _, r := range append(ranked, unranked...) {
+		rank := "-"
+		if r.Rank > 0 {
+			rank = fmt.Sprint(r.Rank)
+		}
+		cost := r.Cost
+		if cost == "" {
+			cost = "default"
+		}
+		elapsed := time.Duration(r.Elapsed * float64(time.Second)).Round(time.Millisecond)
+		fmt.Fprintf(w, "%s\t%s\t%d\t%s\t%d\t%.2f\t%.2f\t%.1f%%\t%s\t%s\t\n",
+			rank, r.Mode, r.Circles, cost, r.Seed, r.InitialCost, r.BestCost, r.Improvement, elapsed, r.State)
+	}
+	w.Flush()
+
+	if summary.EndTime != nil {
+		fmt.Printf("\nTotal: %s with %d worker(s)\n", summary.EndTime.Sub(summary.StartTime).Round(time.Millisecond), summary.Workers)
+	}
+}
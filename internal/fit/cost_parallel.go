@@ -0,0 +1,242 @@
+package fit
+
+import (
+	"runtime"
+	"sync"
+	"sync/atomic"
+)
+
+// Row-partitioned parallel cost evaluation.
+//
+// For large references (e.g. 4096x4096) a single SSD/SAD pass is memory-bandwidth
+// bound on one core. Above a configurable pixel-count threshold, FastSSD,
+// FastSAD and the WeightPlane costs split the image into contiguous row bands
+// and evaluate them on a persistent worker pool:
+//
+//   - Bands are a pure function of (height, worker count), so the partition is
+//     identical on every call
+//   - Every band writes its own partial sum; partials are reduced in band order
+//     on the calling goroutine, so results are deterministic (weighted
+//     partials are exact int64 sums, so banding never changes them)
+//   - The caller evaluates band 0 itself, so only (bands-1) tasks are queued
+//   - Workers are started once (lazily) and live for the process lifetime;
+//     no goroutines are spawned per evaluation
+//
+// Below the threshold the single-threaded SIMD kernel is called directly.
+
+// DefaultParallelCostThreshold is the pixel count (1024x1024) above which cost
+// kernels run row-partitioned on the worker pool.
+const DefaultParallelCostThreshold = 1024 * 1024
+
+// minRowsPerBand keeps bands large enough to amortize task hand-off.
+const minRowsPerBand = 16
+
+// parallelCostThreshold is the active threshold (<= 0 disables parallel evaluation).
+var parallelCostThreshold atomic.Int64
+
+func init() {
+	parallelCostThreshold.Store(DefaultParallelCostThreshold)
+}
+
+// SetParallelCostThreshold sets the pixel count at or above which FastSSD,
+// FastSAD and the WeightPlane costs evaluate on the worker pool. A value <= 0 disables parallel evaluation.
+func SetParallelCostThreshold(pixels int) {
+	parallelCostThreshold.Store(int64(pixels))
+}
+
+// ParallelCostThreshold returns the active parallel evaluation threshold.
+func ParallelCostThreshold() int {
+	return int(parallelCostThreshold.Load())
+}
+
+// rowKernel is the low-level signature shared by the SSD and SAD kernels.
+type rowKernel func(a, b []uint8, stride, width, height int) float64
+
+// rowTask is one band of a parallel evaluation. Weighted bands set weighted,
+// w, wStride and sum instead of kernel and out.
+type rowTask struct {
+	kernel   rowKernel
+	weighted weightedKernel
+	a, b     []uint8
+	stride   int
+	w        []uint8
+	wStride  int
+	width    int
+	height   int
+	out      *float64
+	sum      *int64
+	wg       *sync.WaitGroup
+}
+
+// rowPool is a persistent pool of goroutines evaluating row bands.
+type rowPool struct {
+	workers int
+	tasks   chan rowTask
+}
+
+var (
+	costPool     *rowPool
+	costPoolOnce sync.Once
+)
+
+// getCostPool returns the process-wide pool, starting it on first use.
+func getCostPool() *rowPool {
+	costPoolOnce.Do(func() {
+		costPool = newRowPool(runtime.GOMAXPROCS(0))
+	})
+	return costPool
+}
+
+func newRowPool(workers int) *rowPool {
+	if workers < 1 {
+		workers = 1
+	}
+	p := &rowPool{
+		workers: workers,
+		tasks:   make(chan rowTask, workers),
+	}
+	// The caller runs band 0 itself, so workers-1 goroutines saturate all cores.
+	for i := 1; i < workers; i++ {
+		go p.loop()
+	}
+	return p
+}
+
+// close stops the pool's workers once queued tasks are done. The
+// process-wide pool is never closed; pools created by tests are.
+func (p *rowPool) close() {
+	close(p.tasks)
+}
+
+func (p *rowPool) loop() {
+	for t := range p.tasks {
+		if t.weighted != nil {
+			*t.sum = t.weighted(t.a, t.b, t.stride, t.w, t.wStride, t.width, t.height)
+		} else {
+			*t.out = t.kernel(t.a, t.b, t.stride, t.width, t.height)
+		}
+		t.wg.Done()
+	}
+}
+
+// bands returns how many row bands an image of the given height is split into.
+func (p *rowPool) bands(height int) int {
+	n := p.workers
+	if maxBands := height / minRowsPerBand; n > maxBands {
+		n = maxBands
+	}
+	if n < 1 {
+		n = 1
+	}
+	return n
+}
+
+// run evaluates kernel over all rows, split into bands, and reduces the
+// partial sums in band order.
+func (p *rowPool) run(kernel rowKernel, a, b []uint8, stride, width, height int) float64 {
+	n := p.bands(height)
+	if n == 1 {
+		return kernel(a, b, stride, width, height)
+	}
+
+	var partials [64]float64
+	sums := partials[:0]
+	if n <= len(partials) {
+		sums = partials[:n]
+	} else {
+		sums = make([]float64, n)
+	}
+
+	var wg sync.WaitGroup
+	wg.Add(n - 1)
+	for i := 1; i < n; i++ {
+		y0, y1 := i*height/n, (i+1)*height/n
+		p.tasks <- rowTask{
+			kernel: kernel,
+			a:      a[y0*stride:],
+			b:      b[y0*stride:],
+			stride: stride,
+			width:  width,
+			height: y1 - y0,
+			out:    &sums[i],
+			wg:     &wg,
+		}
+	}
+	sums[0] = kernel(a, b, stride, width, height/n)
+	wg.Wait()
+
+	// Deterministic reduction: always band 0, 1, ..., n-1
+	var total float64
+	for _, s := range sums {
+		total += s
+	}
+	return total
+}
+
+// runWeighted is run for the weighted kernels; the weight plane is banded
+// alongside the images.
+func (p *rowPool) runWeighted(kernel weightedKernel, a, b []uint8, stride int, w []uint8, wStride, width, height int) int64 {
+	n := p.bands(height)
+	if n == 1 {
+		return kernel(a, b, stride, w, wStride, width, height)
+	}
+
+	var partials [64]int64
+	sums := partials[:0]
+	if n <= len(partials) {
+		sums = partials[:n]
+	} else {
+		sums = make([]int64, n)
+	}
+
+	var wg sync.WaitGroup
+	wg.Add(n - 1)
+	for i := 1; i < n; i++ {
+		y0, y1 := i*height/n, (i+1)*height/n
+		p.tasks <- rowTask{
+			weighted: kernel,
+			a:        a[y0*stride:],
+			b:        b[y0*stride:],
+			stride:   stride,
+			w:        w[y0*wStride:],
+			wStride:  wStride,
+			width:    width,
+			height:   y1 - y0,
+			sum:      &sums[i],
+			wg:       &wg,
+		}
+	}
+	sums[0] = kernel(a, b, stride, w, wStride, width, height/n)
+	wg.Wait()
+
+	var total int64
+	for _, s := range sums {
+		total += s
+	}
+	return total
+}
+
+// evalRows runs kernel single-threaded below the threshold and on the worker
+// pool at or above it.
+func evalRows(kernel rowKernel, a, b []uint8, stride, width, height int) float64 {
+	threshold := parallelCostThreshold.Load()
+	if threshold <= 0 || int64(width)*int64(height) < threshold {
+		return kernel(a, b, stride, width, height)
+	}
+	return getCostPool().run(kernel, a, b, stride, width, height)
+}
+
+// evalWeightedRows is evalRows for the weighted kernels.
+func evalWeightedRows(kernel weightedKernel, a, b []uint8, stride int, w []uint8, wStride, width, height int) int64 {
+	threshold := parallelCostThreshold.Load()
+	if threshold <= 0 || int64(width)*int64(height) < threshold {
+		return kernel(a, b, stride, w, wStride, width, height)
+	}
+	return getCostPool().runWeighted(kernel, a, b, stride, w, wStride, width, height)
+}
+
+// parallelSSD evaluates the active SSD kernel on the worker pool regardless of
+// the threshold (used by benchmarks and tests).
+func parallelSSD(a, b []uint8, stride, width, height int) float64 {
+	return getCostPool().run(fastSSD, a, b, stride, width, height)
+}
@@ -0,0 +1,199 @@
+package fit
+
+import (
+	"image"
+	"math"
+	"runtime"
+	"sync"
+	"testing"
+	"time"
+)
+
+// TestRowPool_MatchesSerialSSD verifies that banded SSD is bit-identical to the
+// single-threaded kernel (SSD partials are exact integers)
+func TestRowPool_MatchesSerialSSD(t *testing.T) {
+	pool := newRowPool(4)
+	defer pool.close()
+
+	sizes := []struct {
+		width, height int
+	}{
+		{1, 1},
+		{7, 15},    // fewer rows than one band: single band
+		{33, 64},   // exactly 4 bands
+		{100, 67},  // uneven bands
+		{257, 301}, // odd width (kernel tails) and uneven bands
+	}
+
+	for _, sz := range sizes {
+		img1 := randomNRGBA(sz.width, sz.height, 1)
+		img2 := randomNRGBA(sz.width, sz.height, 2)
+
+		want := fastSSD(img1.Pix, img2.Pix, img1.Stride, sz.width, sz.height)
+		got := pool.run(fastSSD, img1.Pix, img2.Pix, img1.Stride, sz.width, sz.height)
+		if got != want {
+			t.Errorf("%dx%d: parallel SSD = %.0f, serial = %.0f", sz.width, sz.height, got, want)
+		}
+	}
+}
+
+// TestRowPool_SADDeterministic verifies that banded SAD is stable across calls
+// and agrees with the serial kernel within rounding
+func TestRowPool_SADDeterministic(t *testing.T) {
+	pool := newRowPool(4)
+	defer pool.close()
+	img1 := randomNRGBA(300, 200, 3)
+	img2 := randomNRGBA(300, 200, 4)
+
+	serial := fastSAD(img1.Pix, img2.Pix, img1.Stride, 300, 200)
+	first := pool.run(fastSAD, img1.Pix, img2.Pix, img1.Stride, 300, 200)
+
+	for i := 0; i < 20; i++ {
+		got := pool.run(fastSAD, img1.Pix, img2.Pix, img1.Stride, 300, 200)
+		if got != first {
+			t.Fatalf("run %d: parallel SAD = %v, first run = %v (not deterministic)", i, got, first)
+		}
+	}
+
+	if rel := math.Abs(first-serial) / serial; rel > 1e-12 {
+		t.Errorf("parallel SAD = %v, serial = %v (rel diff %g)", first, serial, rel)
+	}
+}
+
+// TestRowPool_PaddedStride verifies bands on a sub-image with padded stride
+func TestRowPool_PaddedStride(t *testing.T) {
+	pool := newRowPool(3)
+	defer pool.close()
+	big1 := randomNRGBA(120, 100, 5)
+	big2 := randomNRGBA(120, 100, 6)
+	rect := image.Rect(5, 3, 105, 99)
+	sub1 := big1.SubImage(rect).(*image.NRGBA)
+	sub2 := big2.SubImage(rect).(*image.NRGBA)
+	w, h := rect.Dx(), rect.Dy()
+
+	want := fastSSD_Scalar(sub1.Pix, sub2.Pix, sub1.Stride, w, h)
+	got := pool.run(fastSSD, sub1.Pix, sub2.Pix, sub1.Stride, w, h)
+	if got != want {
+		t.Errorf("parallel SSD on sub-image = %.0f, scalar = %.0f", got, want)
+	}
+}
+
+// TestRowPool_ConcurrentCallers verifies the shared pool under concurrent use
+func TestRowPool_ConcurrentCallers(t *testing.T) {
+	pool := newRowPool(4)
+	defer pool.close()
+	img1 := randomNRGBA(128, 128, 7)
+	img2 := randomNRGBA(128, 128, 8)
+	want := fastSSD(img1.Pix, img2.Pix, img1.Stride, 128, 128)
+
+	var wg sync.WaitGroup
+	errs := make(chan float64, 8)
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := 0; i < 50; i++ {
+				if got := pool.run(fastSSD, img1.Pix, img2.Pix, img1.Stride, 128, 128); got != want {
+					errs <- got
+					return
+				}
+			}
+		}()
+	}
+	wg.Wait()
+	close(errs)
+
+	for got := range errs {
+		t.Errorf("concurrent parallel SSD = %.0f, want %.0f", got, want)
+	}
+}
+
+// TestFastSSD_ParallelThreshold verifies FastSSD results are unchanged by the threshold
+func TestFastSSD_ParallelThreshold(t *testing.T) {
+	old := ParallelCostThreshold()
+	defer SetParallelCostThreshold(old)
+
+	img1 := randomNRGBA(200, 150, 9)
+	img2 := randomNRGBA(200, 150, 10)
+
+	SetParallelCostThreshold(0)
+	if got := ParallelCostThreshold(); got != 0 {
+		t.Fatalf("ParallelCostThreshold() = %d, want 0", got)
+	}
+	serialSSD := FastSSD(img1, img2)
+	serialSAD := FastSAD(img1, img2)
+
+	SetParallelCostThreshold(1)
+	bandedSSD := FastSSD(img1, img2)
+	bandedSAD := FastSAD(img1, img2)
+
+	if bandedSSD != serialSSD {
+		t.Errorf("FastSSD above threshold = %v, below = %v", bandedSSD, serialSSD)
+	}
+	if rel := math.Abs(bandedSAD-serialSAD) / serialSAD; rel > 1e-12 {
+		t.Errorf("FastSAD above threshold = %v, below = %v", bandedSAD, serialSAD)
+	}
+}
+
+// TestRowPool_WeightedMatchesSerial verifies that banded weighted sums are
+// identical to the single-threaded kernels, including padded strides
+func TestRowPool_WeightedMatchesSerial(t *testing.T) {
+	pool := newRowPool(4)
+	defer pool.close()
+
+	big1 := randomNRGBA(120, 100, 11)
+	big2 := randomNRGBA(120, 100, 12)
+	rect := image.Rect(5, 3, 105, 99)
+	sub1 := big1.SubImage(rect).(*image.NRGBA)
+	sub2 := big2.SubImage(rect).(*image.NRGBA)
+	w, h := rect.Dx(), rect.Dy()
+	p := randomWeightPlane(w, h, 13)
+
+	for _, k := range []struct {
+		name   string
+		kernel weightedKernel
+	}{
+		{"SSD", fastWeightedSSD},
+		{"SAD", fastWeightedSAD},
+	} {
+		want := k.kernel(sub1.Pix, sub2.Pix, sub1.Stride, p.Weights, p.Stride, w, h)
+		got := pool.runWeighted(k.kernel, sub1.Pix, sub2.Pix, sub1.Stride, p.Weights, p.Stride, w, h)
+		if got != want {
+			t.Errorf("parallel weighted %s = %d, serial = %d", k.name, got, want)
+		}
+	}
+}
+
+// TestWeightedCost_ParallelThreshold verifies WeightPlane costs are unchanged by the threshold
+func TestWeightedCost_ParallelThreshold(t *testing.T) {
+	old := ParallelCostThreshold()
+	defer SetParallelCostThreshold(old)
+
+	img1 := randomNRGBA(200, 150, 14)
+	img2 := randomNRGBA(200, 150, 15)
+	p := randomWeightPlane(200, 150, 16)
+
+	SetParallelCostThreshold(0)
+	serialSSD := p.SSDCost(img1, img2)
+	serialSAD := p.SADCost(img1, img2)
+
+	SetParallelCostThreshold(1)
+	if got := p.SSDCost(img1, img2); got != serialSSD {
+		t.Errorf("SSDCost above threshold = %v, below = %v", got, serialSSD)
+	}
+	if got := p.SADCost(img1, img2); got != serialSAD {
+		t.Errorf("SADCost above threshold = %v, below = %v", got, serialSAD)
+	}
+}
+
+// TestRowPool_CloseStopsWorkers verifies that close ends the worker goroutines
+func TestRowPool_CloseStopsWorkers(t *testing.T) {
+	before := runtime.NumGoroutine()
+	newRowPool(4).close()
+	for i := 0; runtime.NumGoroutine() > before; i++ {
+		if i == 100 {
+			t.Fatalf("%d goroutines after close, want at most %d", runtime.NumGoroutine(), before)
+		}
+		time.Sleep(time.Millisecond)
+	}
+}
@@ -0,0 +1,166 @@
+package fit
+
+import (
+	"fmt"
+	"image"
+	"sort"
+	"strings"
+	"sync"
+)
+
+// Cost function registry.
+//
+// Jobs and the CLI select a cost function by name (JobConfig.Cost, --cost).
+// Each name maps to a CostFactory, because some costs precompute data from the
+// reference (perceptual planes, SSIM tables) or take a per-pixel weight plane.
+//
+// Built-in costs:
+//
+//	fast-mse  SIMD SSD (FastMSECost), the default
+//	mse       scalar reference implementation (MSECost), same values as fast-mse
+//	sad       SIMD Delphi quadratic SAD (FastSAD)
+//	ycbcr     weighted luma/chroma SSD (PerceptualCost)
+//	lab       approximate CIELAB SSD (PerceptualCost)
+//	ssim      1 - windowed luma SSIM (SSIMCost)
+//
+// mse, fast-mse and sad accept a WeightPlane; the others do not.
+
+// DefaultCost is the cost used when no name is given: the fastest SIMD backend.
+const DefaultCost = "fast-mse"
+
+// CostFactory builds a cost function for a reference image. weights is nil for
+// unweighted fitting; factories that cannot apply weights return an error.
+type CostFactory func(reference *image.NRGBA, weights *WeightPlane) (CostFunc, error)
+
+var (
+	costRegistryMu sync.RWMutex
+	costRegistry   = map[string]CostFactory{}
+)
+
+// RegisterCost adds a named cost factory. Names are case-insensitive.
+// Panics if the name is empty or already registered.
+func RegisterCost(name string, factory CostFactory) {
+	key := strings.ToLower(name)
+	if key == "" || factory == nil {
+		panic("fit.RegisterCost: name and factory are required")
+	}
+
+	costRegistryMu.Lock()
+	defer costRegistryMu.Unlock()
+	if _, exists := costRegistry[key]; exists {
+		panic("fit.RegisterCost: duplicate cost " + key)
+	}
+	costRegistry[key] = factory
+}
+
+// CostNames returns the registered cost names in sorted order.
+func CostNames() []string {
+	costRegistryMu.RLock()
+	defer costRegistryMu.RUnlock()
+
+	names := make([]string, 0, len(costRegistry))
+	for name := range costRegistry {
+		names = append(names, name)
+	}
+	sort.Strings(names)
+	return names
+}
+
+// ValidateCost returns an error if name is neither empty nor a registered cost.
+func ValidateCost(name string) error {
+	_, err := lookupCost(name)
+	return err
+}
+
+// IsMSECost reports whether name selects the unweighted mean squared RGB error
+// ("", "fast-mse" or "mse"), which renderers may evaluate with their own kernels.
+func IsMSECost(name string) bool {
+	switch strings.ToLower(name) {
+	case "", "fast-mse", "mse":
+		return true
+	}
+	return false
+}
+
+// NewCostFunc builds the named cost function for reference ("" selects
+// DefaultCost). weights may be nil.
+func NewCostFunc(name string, reference *image.NRGBA, weights *WeightPlane) (CostFunc, error) {
+	factory, err := lookupCost(name)
+	if err != nil {
+		return nil, err
+	}
+	return factory(reference, weights)
+}
+
+// CanonicalCost returns the registered name that name selects: lower case,
+// with "" resolved to DefaultCost. Names that select the same cost compare
+// equal after canonicalization.
+func CanonicalCost(name string) (string, error) {
+	key := strings.ToLower(name)
+	if key == "" {
+		key = DefaultCost
+	}
+
+	costRegistryMu.RLock()
+	_, ok := costRegistry[key]
+	costRegistryMu.RUnlock()
+	if !ok {
+		return "", fmt.Errorf("unknown cost function %q (available: %s)", name, strings.Join(CostNames(), ", "))
+	}
+	return key, nil
+}
+
+func lookupCost(name string) (CostFactory, error) {
+	key, err := CanonicalCost(name)
+	if err != nil {
+		return nil, err
+	}
+
+	costRegistryMu.RLock()
+	defer costRegistryMu.RUnlock()
+	return costRegistry[key], nil
+}
+
+// unweighted adapts a cost without a weighted variant to CostFactory.
+func unweighted(name string, newCost func(reference *image.NRGBA) (CostFunc, error)) CostFactory {
+	return func(reference *image.NRGBA, weights *WeightPlane) (CostFunc, error) {
+		if weights != nil {
+			return nil, fmt.Errorf("cost function %q does not support weight masks", name)
+		}
+		return newCost(reference)
+	}
+}
+
+func init() {
+	ssd := func(plain CostFunc) CostFactory {
+		return func(_ *image.NRGBA, weights *WeightPlane) (CostFunc, error) {
+			if weights != nil {
+				return weights.SSDCost, nil
+			}
+			return plain, nil
+		}
+	}
+	RegisterCost("fast-mse", ssd(FastMSECost))
+	RegisterCost("mse", ssd(MSECost))
+
+	RegisterCost("sad", func(_ *image.NRGBA, weights *WeightPlane) (CostFunc, error) {
+		if weights != nil {
+			return weights.SADCost, nil
+		}
+		return FastSAD, nil
+	})
+
+	for _, space := range []ColorSpace{ColorSpaceYCbCr, ColorSpaceLab} {
+		RegisterCost(space.String(), unweighted(space.String(), func(reference *image.NRGBA) (CostFunc, error) {
+			return NewPerceptualCost(reference, space).Cost, nil
+		}))
+	}
+
+	RegisterCost("ssim", unweighted("ssim", func(reference *image.NRGBA) (CostFunc, error) {
+		s, err := NewSSIMCost(reference, DefaultSSIMWindow, DefaultSSIMStep)
+		if err != nil {
+			return nil, err
+		}
+		return s.Cost, nil
+	}))
+}
@@ -0,0 +1,78 @@
+package fit
+
+import (
+	"math"
+	"testing"
+)
+
+// TestNewCostFunc_BuiltIns tests that every built-in cost resolves and that
+// identical images cost zero
+func TestNewCostFunc_BuiltIns(t *testing.T) {
+	ref := randomNRGBA(24, 24, 1)
+	cur := randomNRGBA(24, 24, 2)
+
+	for _, name := range []string{"", "fast-mse", "mse", "sad", "ycbcr", "lab", "ssim", "FAST-MSE"} {
+		cost, err := NewCostFunc(name, ref, nil)
+		if err != nil {
+			t.Fatalf("NewCostFunc(%q): %v", name, err)
+		}
+		if got := cost(cloneNRGBA(ref), ref); math.Abs(got) > 1e-12 {
+			t.Errorf("%q: identical images cost %v, want 0", name, got)
+		}
+		if got := cost(cur, ref); got <= 0 {
+			t.Errorf("%q: different images cost %v, want > 0", name, got)
+		}
+	}
+}
+
+// TestNewCostFunc_DefaultMatchesMSE tests that the SIMD default reports the
+// same values as the scalar MSECost
+func TestNewCostFunc_DefaultMatchesMSE(t *testing.T) {
+	ref := randomNRGBA(37, 19, 3)
+	cur := randomNRGBA(37, 19, 4)
+
+	def, err := NewCostFunc("", ref, nil)
+	if err != nil {
+		t.Fatalf("NewCostFunc: %v", err)
+	}
+	if got, want := def(cur, ref), MSECost(cur, ref); math.Abs(got-want) > 1e-9*want {
+		t.Errorf("default cost = %v, MSECost = %v", got, want)
+	}
+}
+
+// TestNewCostFunc_Weights tests weight plane support per cost
+func TestNewCostFunc_Weights(t *testing.T) {
+	ref := randomNRGBA(16, 16, 5)
+	cur := randomNRGBA(16, 16, 6)
+	plane := NewWeightPlane(16, 16, 255)
+
+	for _, name := range []string{"fast-mse", "mse", "sad"} {
+		cost, err := NewCostFunc(name, ref, plane)
+		if err != nil {
+			t.Fatalf("NewCostFunc(%q, weights): %v", name, err)
+		}
+		plain, _ := NewCostFunc(name, ref, nil)
+		if got, want := cost(cur, ref), plain(cur, ref); math.Abs(got-want) > 1e-9*want {
+			t.Errorf("%q: uniform weighted cost = %v, unweighted = %v", name, got, want)
+		}
+	}
+
+	for _, name := range []string{"ycbcr", "lab", "ssim"} {
+		if _, err := NewCostFunc(name, ref, plane); err == nil {
+			t.Errorf("%q with weights should fail", name)
+		}
+	}
+}
+
+// TestNewCostFunc_Unknown tests rejection of unknown names
+func TestNewCostFunc_Unknown(t *testing.T) {
+	if err := ValidateCost("nope"); err == nil {
+		t.Error("ValidateCost(\"nope\") should fail")
+	}
+	if err := ValidateCost(""); err != nil {
+		t.Errorf("ValidateCost(\"\") = %v, want nil", err)
+	}
+	if _, err := NewCostFunc("nope", randomNRGBA(4, 4, 1), nil); err == nil {
+		t.Error("NewCostFunc(\"nope\") should fail")
+	}
+}
@@ -0,0 +1,197 @@
+package fit
+
+import (
+	"bufio"
+	"encoding/binary"
+	"fmt"
+	"io"
+	"math"
+	"strconv"
+)
+
+// Vector export.
+//
+// A fit result is just K circles, so it can be delivered without rasterizing:
+// WriteSVG streams the parameters as an SVG document and WriteCircles as a
+// compact binary circle list. Both read params directly (colour or grayscale
+// layout, selected by paramsPerCircle) and never allocate a canvas.
+//
+// Renderers sample pixel centres at integer coordinates, so SVG circles are
+// shifted by half a pixel to line up with the PNG output. Circles are drawn
+// over a white background; a job's canvas image is not included.
+//
+// Binary circle list (all values little-endian):
+//
+//	magic    [4]byte "MFC1"
+//	width    uint32
+//	height   uint32
+//	count    uint32  number of circles
+//	ppc      uint8   parameters per circle (7 colour, 5 grayscale)
+//	reserved [3]byte
+//	params   count*ppc uint16, quantized per parameter
+//
+// Each parameter is stored as round(v/scale * 65535) with scale = width for
+// X, height for Y, max(width, height) for R and 1 for colour and opacity
+// (the optimizer's bounds, see NewBounds). Positions are thus kept to
+// 1/65535 of the image size, 14 bytes per colour circle.
+
+// circleListMagic identifies the binary circle list format
+var circleListMagic = [4]byte{'M', 'F', 'C', '1'}
+
+// maxListCircles bounds the allocation ReadCircles makes for a header
+const maxListCircles = 1 << 24
+
+// circleListHeader is the fixed-size header of a binary circle list
+type circleListHeader struct {
+	Magic         [4]byte
+	Width, Height uint32
+	Count         uint32
+	PPC           uint8
+	Reserved      [3]byte
+}
+
+// checkLayout validates params against paramsPerCircle
+func checkLayout(params []float64, paramsPerCircle int) error {
+	if paramsPerCircle != ParamsPerCircle && paramsPerCircle != ParamsPerGrayCircle {
+		return fmt.Errorf("unsupported circle layout: %d parameters per circle", paramsPerCircle)
+	}
+	if len(params)%paramsPerCircle != 0 {
+		return fmt.Errorf("parameter count %d is not a multiple of %d", len(params), paramsPerCircle)
+	}
+	return nil
+}
+
+// decodeAny reads circle i in either parameter layout
+func decodeAny(params []float64, paramsPerCircle, i int) Circle {
+	if paramsPerCircle == ParamsPerGrayCircle {
+		return DecodeGrayCircle(params, i)
+	}
+	return (&ParamVector{Data: params}).DecodeCircle(i)
+}
+
+// WriteSVG writes params as a width×height SVG document
+func WriteSVG(w io.Writer, params []float64, paramsPerCircle, width, height int) error {
+	if err := checkLayout(params, paramsPerCircle); err != nil {
+		return err
+	}
+
+	bw := bufio.NewWriter(w)
+	fmt.Fprintf(bw, `<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d" viewBox="0 0 %d %d">`+"\n",
+		width, height, width, height)
+	fmt.Fprintf(bw, `<rect width="%d" height="%d" fill="#fff"/>`+"\n", width, height)
+
+	// One reusable line buffer: circles are streamed, not collected
+	buf := make([]byte, 0, 96)
+	for i := 0; i < len(params)/paramsPerCircle; i++ {
+		c := decodeAny(params, paramsPerCircle, i)
+		if c.Opacity < 0.001 || !(c.R > 0) {
+			continue // Renderers skip these too
+		}
+		buf = append(buf[:0], `<circle cx="`...)
+		buf = appendSVGNumber(buf, c.X+0.5)
+		buf = append(buf, `" cy="`...)
+		buf = appendSVGNumber(buf, c.Y+0.5)
+		buf = append(buf, `" r="`...)
+		buf = appendSVGNumber(buf, c.R)
+		buf = append(buf, `" fill="#`...)
+		for _, v := range [3]float64{c.CR, c.CG, c.CB} {
+			b := uint8(math.Round(clamp(v, 0, 1) * 255))
+			buf = append(buf, hexDigits[b>>4], hexDigits[b&15])
+		}
+		buf = append(buf, '"')
+		if c.Opacity < 1 {
+			buf = append(buf, ` fill-opacity="`...)
+			buf = strconv.AppendFloat(buf, math.Round(c.Opacity*1000)/1000, 'f', -1, 64)
+			buf = append(buf, '"')
+		}
+		buf = append(buf, "/>\n"...)
+		if _, err := bw.Write(buf); err != nil {
+			return err
+		}
+	}
+
+	bw.WriteString("</svg>\n")
+	return bw.Flush()
+}
+
+const hexDigits = "0123456789abcdef"
+
+// appendSVGNumber appends v rounded to 1/100 pixel in its shortest form
+func appendSVGNumber(buf []byte, v float64) []byte {
+	return strconv.AppendFloat(buf, math.Round(v*100)/100, 'f', -1, 64)
+}
+
+// circleScales returns the quantization scale of each parameter
+func circleScales(paramsPerCircle, width, height int) []float64 {
+	scales := make([]float64, paramsPerCircle)
+	scales[0], scales[1], scales[2] = float64(width), float64(height), float64(max(width, height))
+	for j := 3; j < paramsPerCircle; j++ {
+		scales[j] = 1
+	}
+	return scales
+}
+
+// WriteCircles writes params as a binary circle list (see above)
+func WriteCircles(w io.Writer, params []float64, paramsPerCircle, width, height int) error {
+	if err := checkLayout(params, paramsPerCircle); err != nil {
+		return err
+	}
+	if width <= 0 || height <= 0 {
+		return fmt.Errorf("invalid image size %dx%d", width, height)
+	}
+
+	bw := bufio.NewWriter(w)
+	header := circleListHeader{
+		Magic:  circleListMagic,
+		Width:  uint32(width),
+		Height: uint32(height),
+		Count:  uint32(len(params) / paramsPerCircle),
+		PPC:    uint8(paramsPerCircle),
+	}
+	if err := binary.Write(bw, binary.LittleEndian, &header); err != nil {
+		return err
+	}
+
+	scales := circleScales(paramsPerCircle, width, height)
+	var q [2]byte
+	for i, v := range params {
+		s := scales[i%paramsPerCircle]
+		binary.LittleEndian.PutUint16(q[:], uint16(math.Round(clamp(v/s, 0, 1)*65535)))
+		if _, err := bw.Write(q[:]); err != nil {
+			return err
+		}
+	}
+	return bw.Flush()
+}
+
+// ReadCircles reads a binary circle list written by WriteCircles
+func ReadCircles(r io.Reader) (params []float64, paramsPerCircle, width, height int, err error) {
+	br := bufio.NewReader(r)
+	var header circleListHeader
+	if err := binary.Read(br, binary.LittleEndian, &header); err != nil {
+		return nil, 0, 0, 0, fmt.Errorf("failed to read circle list header: %w", err)
+	}
+	if header.Magic != circleListMagic {
+		return nil, 0, 0, 0, fmt.Errorf("not a circle list")
+	}
+	paramsPerCircle = int(header.PPC)
+	width, height = int(header.Width), int(header.Height)
+	if err := checkLayout(nil, paramsPerCircle); err != nil {
+		return nil, 0, 0, 0, err
+	}
+
+	if header.Count > maxListCircles {
+		return nil, 0, 0, 0, fmt.Errorf("circle list too large: %d circles", header.Count)
+	}
+
+	scales := circleScales(paramsPerCircle, width, height)
+	params = make([]float64, int(header.Count)*paramsPerCircle)
+	var q [2]byte
+	for i := range params {
+		if _, err := io.ReadFull(br, q[:]); err != nil {
+			return nil, 0, 0, 0, fmt.Errorf("truncated circle list: %w", err)
+		}
+		params[i] = float64(binary.LittleEndian.Uint16(q[:])) / 65535 * scales[i%paramsPerCircle]
+	}
+	return params, paramsPerCircle, width, height, nil
+}
@@ -0,0 +1,141 @@
+package fit
+
+import (
+	"bytes"
+	"encoding/xml"
+	"math"
+	"math/rand"
+	"strconv"
+	"testing"
+)
+
+// randomCircleParams returns k circles within NewBounds/NewGrayBounds
+func randomCircleParams(k, ppc, width, height int, seed int64) []float64 {
+	rng := rand.New(rand.NewSource(seed))
+	params := make([]float64, k*ppc)
+	for i := 0; i < k; i++ {
+		p := params[i*ppc:]
+		p[0] = rng.Float64() * float64(width)
+		p[1] = rng.Float64() * float64(height)
+		p[2] = 1 + rng.Float64()*float64(max(width, height)-1)
+		for j := 3; j < ppc; j++ {
+			p[j] = rng.Float64()
+		}
+	}
+	return params
+}
+
+func TestCircleListRoundTrip(t *testing.T) {
+	const width, height, k = 640, 480, 200
+	for _, ppc := range []int{ParamsPerCircle, ParamsPerGrayCircle} {
+		params := randomCircleParams(k, ppc, width, height, int64(ppc))
+
+		var buf bytes.Buffer
+		if err := WriteCircles(&buf, params, ppc, width, height); err != nil {
+			t.Fatal(err)
+		}
+		if want := 20 + 2*len(params); buf.Len() != want {
+			t.Errorf("ppc %d: %d bytes, want %d", ppc, buf.Len(), want)
+		}
+
+		got, gotPPC, w, h, err := ReadCircles(&buf)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if gotPPC != ppc || w != width || h != height || len(got) != len(params) {
+			t.Fatalf("ppc %d: header mismatch (%d, %dx%d, %d params)", ppc, gotPPC, w, h, len(got))
+		}
+		scales := circleScales(ppc, width, height)
+		for i := range params {
+			if tol := scales[i%ppc] / 65535; math.Abs(got[i]-params[i]) > tol {
+				t.Fatalf("ppc %d: param %d is %g, want %g ± %g", ppc, i, got[i], params[i], tol)
+			}
+		}
+	}
+}
+
+func TestReadCirclesRejectsInvalidData(t *testing.T) {
+	var buf bytes.Buffer
+	WriteCircles(&buf, randomCircleParams(3, ParamsPerCircle, 10, 10, 1), ParamsPerCircle, 10, 10)
+	data := buf.Bytes()
+
+	for name, input := range map[string][]byte{
+		"empty":     nil,
+		"magic":     append([]byte("PNG!"), data[4:]...),
+		"truncated": data[:len(data)-1],
+	} {
+		if _, _, _, _, err := ReadCircles(bytes.NewReader(input)); err == nil {
+			t.Errorf("%s: expected an error", name)
+		}
+	}
+	if err := WriteCircles(&buf, make([]float64, 6), ParamsPerCircle, 10, 10); err == nil {
+		t.Error("expected an error for a partial circle")
+	}
+}
+
+func TestWriteSVG(t *testing.T) {
+	params := []float64{
+		10, 20, 5.25, 1, 0.5, 0, 1, // Opaque orange
+		3, 4, 2, 0, 0, 1, 0.25, // Translucent blue
+		7, 7, 7, 0, 0, 0, 0, // Invisible: skipped
+	}
+	var buf bytes.Buffer
+	if err := WriteSVG(&buf, params, ParamsPerCircle, 64, 48); err != nil {
+		t.Fatal(err)
+	}
+
+	var doc struct {
+		Width   int `xml:"width,attr"`
+		Height  int `xml:"height,attr"`
+		Circles []struct {
+			CX      float64 `xml:"cx,attr"`
+			CY      float64 `xml:"cy,attr"`
+			R       float64 `xml:"r,attr"`
+			Fill    string  `xml:"fill,attr"`
+			Opacity string  `xml:"fill-opacity,attr"`
+		} `xml:"circle"`
+	}
+	if err := xml.Unmarshal(buf.Bytes(), &doc); err != nil {
+		t.Fatalf("invalid SVG: %v\n%s", err, buf.String())
+	}
+	if doc.Width != 64 || doc.Height != 48 || len(doc.Circles) != 2 {
+		t.Fatalf("unexpected document:\n%s", buf.String())
+	}
+
+	c := doc.Circles[0]
+	if c.CX != 10.5 || c.CY != 20.5 || c.R != 5.25 || c.Fill != "#ff8000" || c.Opacity != "" {
+		t.Errorf("first circle: %+v", c)
+	}
+	if op, _ := strconv.ParseFloat(doc.Circles[1].Opacity, 64); op != 0.25 || doc.Circles[1].Fill != "#0000ff" {
+		t.Errorf("second circle: %+v", doc.Circles[1])
+	}
+
+	// Grayscale layout: luma in all channels
+	buf.Reset()
+	if err := WriteSVG(&buf, []float64{1, 1, 1, 0.2, 1}, ParamsPerGrayCircle, 4, 4); err != nil {
+		t.Fatal(err)
+	}
+	if !bytes.Contains(buf.Bytes(), []byte(`fill="#333333"`)) {
+		t.Errorf("gray circle not exported as gray:\n%s", buf.String())
+	}
+}
+
+func BenchmarkExport(b *testing.B) {
+	params := randomCircleParams(500, ParamsPerCircle, 1024, 768, 1)
+	b.Run("svg", func(b *testing.B) {
+		var buf bytes.Buffer
+		for i := 0; i < b.N; i++ {
+			buf.Reset()
+			WriteSVG(&buf, params, ParamsPerCircle, 1024, 768)
+		}
+		b.ReportMetric(float64(buf.Len()), "bytes")
+	})
+	b.Run("circles", func(b *testing.B) {
+		var buf bytes.Buffer
+		for i := 0; i < b.N; i++ {
+			buf.Reset()
+			WriteCircles(&buf, params, ParamsPerCircle, 1024, 768)
+		}
+		b.ReportMetric(float64(buf.Len()), "bytes")
+	})
+}
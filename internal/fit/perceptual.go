@@ -0,0 +1,321 @@
+package fit
+
+import (
+	"fmt"
+	"image"
+	"log/slog"
+	"math"
+)
+
+// Perceptual colour-space cost kernels.
+//
+// MSECost, FastSSD and FastSAD compare raw sRGB values. PerceptualCost instead
+// compares weighted luma/chroma (YCbCr) or an approximation of CIELAB, without
+// a float conversion per pixel:
+//
+//   - The reference is converted once into three planar int16 buffers
+//   - Canvas pixels go through integer tables only: a per-channel transfer LUT
+//     (identity for YCbCr, sRGB → L* response for Lab) followed by a Q8
+//     fixed-point 3x3 mix into the three components
+//   - The scalar path folds transfer and mix into one table per
+//     (component, channel), so conversion is 9 lookups and adds per pixel
+//   - The AVX2 path gathers the transfer LUT for 8 pixels at once and mixes
+//     with VPMULLD; both paths use the same integers and are bit-identical
+//
+// Components are stored in Q2 (0..1020 for an 8-bit channel), so the cost is
+// reported on the same 0..255² scale as MSECost:
+//
+//	cost = Σ w_k (C_k(current) - C_k(reference))² / (16 × pixels × Σ w_k)
+
+// ColorSpace selects the perceptual space PerceptualCost compares in.
+type ColorSpace int
+
+const (
+	ColorSpaceYCbCr ColorSpace = iota // BT.601 full-range YCbCr, luma weighted 4:1:1
+	ColorSpaceLab                     // CIELAB approximation (L* response per channel, opponent a/b)
+)
+
+func (c ColorSpace) String() string {
+	switch c {
+	case ColorSpaceYCbCr:
+		return "ycbcr"
+	case ColorSpaceLab:
+		return "lab"
+	default:
+		return "unknown"
+	}
+}
+
+// ParseColorSpace converts a name ("ycbcr", "lab") into a ColorSpace.
+func ParseColorSpace(name string) (ColorSpace, error) {
+	switch name {
+	case "ycbcr", "yuv":
+		return ColorSpaceYCbCr, nil
+	case "lab":
+		return ColorSpaceLab, nil
+	default:
+		return 0, fmt.Errorf("unknown color space %q (want ycbcr or lab)", name)
+	}
+}
+
+const (
+	// perceptualTransferMax is the transfer LUT value for a full channel (Q2)
+	perceptualTransferMax = 1020
+
+	// perceptualMixShift is the fixed-point precision of the mix matrix (Q8)
+	perceptualMixShift = 8
+
+	// perceptualFlushIters bounds how many 8-pixel iterations the AVX2 kernel
+	// accumulates in int32 lanes before widening (see TestPerceptualKernel_LaneBound)
+	perceptualFlushIters = 128
+)
+
+// perceptualKernel holds the integer tables for one colour space.
+//
+// The first three fields are read by perceptual_amd64.s at fixed offsets
+// (0, 288, 384); keep their order and sizes in sync with the assembly.
+type perceptualKernel struct {
+	mix    [9][8]int32   // Q8 mix coefficient [k*3+c], broadcast to 8 lanes
+	weight [3][8]int32   // component weight, broadcast to 8 lanes
+	lut    [3][256]int32 // per-channel transfer (Q2)
+
+	// table[k][c][v] = mix[k][c] * lut[c][v], used by the scalar path
+	table [3][3][256]int32
+	// black is the component value of an RGB (0,0,0) pixel (pads reference planes)
+	black   [3]int16
+	weights [3]int64
+	wsum    int64
+}
+
+func newPerceptualKernel(transfer func(v int) int32, mix [3][3]int32, weights [3]int32) *perceptualKernel {
+	k := &perceptualKernel{}
+	for c := 0; c < 3; c++ {
+		for v := 0; v < 256; v++ {
+			k.lut[c][v] = transfer(v)
+		}
+	}
+	for i := 0; i < 3; i++ {
+		for c := 0; c < 3; c++ {
+			for lane := 0; lane < 8; lane++ {
+				k.mix[i*3+c][lane] = mix[i][c]
+			}
+			for v := 0; v < 256; v++ {
+				k.table[i][c][v] = mix[i][c] * k.lut[c][v]
+			}
+		}
+		for lane := 0; lane < 8; lane++ {
+			k.weight[i][lane] = weights[i]
+		}
+		k.weights[i] = int64(weights[i])
+		k.wsum += int64(weights[i])
+	}
+	k.black = k.convert(0, 0, 0)
+	return k
+}
+
+// convert maps one sRGB pixel to its three Q2 components.
+func (k *perceptualKernel) convert(r, g, b uint8) [3]int16 {
+	var out [3]int16
+	for i := 0; i < 3; i++ {
+		s := k.table[i][0][r] + k.table[i][1][g] + k.table[i][2][b]
+		out[i] = int16((s + 1<<(perceptualMixShift-1)) >> perceptualMixShift)
+	}
+	return out
+}
+
+// maxPixelCost is an upper bound on Σ w_k d_k² for a single pixel.
+func (k *perceptualKernel) maxPixelCost() int64 {
+	var total int64
+	for i := 0; i < 3; i++ {
+		var lo, hi int64
+		for c := 0; c < 3; c++ {
+			cmin, cmax := int64(k.table[i][c][0]), int64(k.table[i][c][0])
+			for v := 1; v < 256; v++ {
+				t := int64(k.table[i][c][v])
+				if t < cmin {
+					cmin = t
+				}
+				if t > cmax {
+					cmax = t
+				}
+			}
+			lo += cmin
+			hi += cmax
+		}
+		span := (hi-lo)>>perceptualMixShift + 1
+		total += k.weights[i] * span * span
+	}
+	return total
+}
+
+var (
+	ycbcrKernel = newPerceptualKernel(
+		func(v int) int32 { return int32(v * perceptualTransferMax / 255) },
+		[3][3]int32{
+			{77, 150, 29},    // Y  =  0.299 R + 0.587 G + 0.114 B
+			{-43, -85, 128},  // Cb = -0.169 R - 0.331 G + 0.500 B
+			{128, -107, -21}, // Cr =  0.500 R - 0.419 G - 0.081 B
+		},
+		[3]int32{4, 1, 1},
+	)
+
+	labKernel = newPerceptualKernel(
+		labTransfer,
+		[3][3]int32{
+			{54, 183, 19},    // L ≈ 0.2126 R' + 0.7152 G' + 0.0722 B' (exact on the grey axis)
+			{220, -220, 0},   // a ≈ 0.86 (R' - G')
+			{120, 120, -240}, // b ≈ 0.94 ((R' + G')/2 - B')
+		},
+		[3]int32{1, 1, 1},
+	)
+)
+
+// labTransfer maps an sRGB channel value to the CIELAB lightness response
+// L*(linear(v)) / 100, in Q2.
+func labTransfer(v int) int32 {
+	c := float64(v) / 255
+	if c <= 0.04045 {
+		c /= 12.92
+	} else {
+		c = math.Pow((c+0.055)/1.055, 2.4)
+	}
+	var l float64
+	if c > 216.0/24389.0 {
+		l = 116*math.Cbrt(c) - 16
+	} else {
+		l = 24389.0 / 27.0 * c
+	}
+	return int32(math.Round(l / 100 * perceptualTransferMax))
+}
+
+func kernelFor(space ColorSpace) *perceptualKernel {
+	switch space {
+	case ColorSpaceYCbCr:
+		return ycbcrKernel
+	case ColorSpaceLab:
+		return labKernel
+	default:
+		panic(fmt.Sprintf("perceptual: unknown color space %d", space))
+	}
+}
+
+// perceptualSum is the runtime-dispatched kernel returning the exact weighted
+// sum Σ w_k d_k² (in Q2² units). Set by init() from the SIMD tier.
+var perceptualSum func(k *perceptualKernel, cur []uint8, stride, width, height int, ref []int16, planeStride, planeLen int) int64
+
+func init() {
+	// AVX-512 hosts also run the AVX2 gather kernel; NEON has no port yet
+	if activeSIMDTier >= simdTierAVX2 {
+		perceptualSum = perceptualSum_AVX2
+		slog.Debug("Perceptual kernel initialized", "backend", "AVX2")
+	} else {
+		perceptualSum = perceptualSum_Scalar
+		slog.Debug("Perceptual kernel initialized", "backend", "scalar")
+	}
+}
+
+// PerceptualCost compares images in a perceptual colour space against a
+// reference that was converted once at construction.
+type PerceptualCost struct {
+	space       ColorSpace
+	kernel      *perceptualKernel
+	width       int
+	height      int
+	planeStride int     // elements per plane row (width rounded up to 8)
+	planes      []int16 // 3 planes of planeStride*height components
+}
+
+// NewPerceptualCost pre-converts reference into planar components for space.
+func NewPerceptualCost(reference *image.NRGBA, space ColorSpace) *PerceptualCost {
+	k := kernelFor(space)
+	bounds := reference.Bounds()
+	width, height := bounds.Dx(), bounds.Dy()
+	planeStride := (width + 7) &^ 7
+	planeLen := planeStride * height
+
+	p := &PerceptualCost{
+		space:       space,
+		kernel:      k,
+		width:       width,
+		height:      height,
+		planeStride: planeStride,
+		planes:      make([]int16, 3*planeLen),
+	}
+
+	for y := 0; y < height; y++ {
+		row := y * reference.Stride
+		for x := 0; x < planeStride; x++ {
+			// Padding columns hold the components of black, which is what the
+			// AVX2 kernel's masked tail load produces for missing pixels
+			c := k.black
+			if x < width {
+				i := row + x*4
+				c = k.convert(reference.Pix[i], reference.Pix[i+1], reference.Pix[i+2])
+			}
+			for i := 0; i < 3; i++ {
+				p.planes[i*planeLen+y*planeStride+x] = c[i]
+			}
+		}
+	}
+
+	return p
+}
+
+// Space returns the colour space the cost compares in.
+func (p *PerceptualCost) Space() ColorSpace {
+	return p.space
+}
+
+// Cost implements CostFunc. reference must be the image passed to
+// NewPerceptualCost; only its dimensions are checked, the pre-converted
+// planes are used for the comparison.
+func (p *PerceptualCost) Cost(current, reference *image.NRGBA) float64 {
+	bounds := current.Bounds()
+	width, height := bounds.Dx(), bounds.Dy()
+
+	if width != p.width || height != p.height ||
+		width != reference.Bounds().Dx() || height != reference.Bounds().Dy() {
+		panic("PerceptualCost: image dimensions must match")
+	}
+	if width == 0 || height == 0 {
+		return 0
+	}
+
+	sum := perceptualSum(p.kernel, current.Pix, current.Stride, width, height,
+		p.planes, p.planeStride, p.planeStride*height)
+
+	return float64(sum) / float64(16*int64(width)*int64(height)*p.kernel.wsum)
+}
+
+// perceptualSum_Scalar is the portable reference implementation (LUT only).
+func perceptualSum_Scalar(k *perceptualKernel, cur []uint8, stride, width, height int, ref []int16, planeStride, planeLen int) int64 {
+	const round = 1 << (perceptualMixShift - 1)
+	t0, t1, t2 := &k.table[0], &k.table[1], &k.table[2]
+	w0, w1, w2 := k.weights[0], k.weights[1], k.weights[2]
+	p0, p1, p2 := ref[:planeLen], ref[planeLen:2*planeLen], ref[2*planeLen:3*planeLen]
+
+	var total int64
+	for y := 0; y < height; y++ {
+		row := y * stride
+		prow := y * planeStride
+		for x := 0; x < width; x++ {
+			i := row + x*4
+			r, g, b := cur[i], cur[i+1], cur[i+2]
+
+			d0 := (t0[0][r]+t0[1][g]+t0[2][b]+round)>>perceptualMixShift - int32(p0[prow+x])
+			d1 := (t1[0][r]+t1[1][g]+t1[2][b]+round)>>perceptualMixShift - int32(p1[prow+x])
+			d2 := (t2[0][r]+t2[1][g]+t2[2][b]+round)>>perceptualMixShift - int32(p2[prow+x])
+
+			total += w0*int64(d0*d0) + w1*int64(d1*d1) + w2*int64(d2*d2)
+		}
+	}
+	return total
+}
+
+// perceptualSum_AVX2 runs the AVX2 gather kernel (perceptual_amd64.s).
+func perceptualSum_AVX2(k *perceptualKernel, cur []uint8, stride, width, height int, ref []int16, planeStride, planeLen int) int64 {
+	if len(cur) == 0 || len(ref) == 0 {
+		return 0
+	}
+	return perceptualAVX2(&cur[0], &ref[0], k, stride, width, height, planeStride, planeLen)
+}
@@ -0,0 +1,22 @@
+//go:build amd64
+
+package fit
+
+// perceptualAVX2 computes the exact weighted perceptual sum Σ w_k d_k² using
+// AVX2 gathers for the transfer LUT.
+//
+// Plan9 assembly (perceptual_amd64.s). Per iteration it converts 8 canvas
+// pixels: R, G, B are isolated with VPSRLD/VPAND, the transfer LUT of each
+// channel is gathered with VPGATHERDD, and the Q8 mix is applied with VPMULLD.
+// The pre-converted reference components are loaded with VPMOVSXWD. Row tails
+// use VPMASKMOVD; masked lanes convert black, which matches the reference
+// plane padding, so they contribute 0.
+//
+// Parameters:
+//   - cur:         canvas pixels (NRGBA), stride bytes per row
+//   - ref:         3 planes of planeLen int16 components, planeStride per row
+//   - k:           kernel tables (mix, weight and lut at offsets 0, 288, 384)
+//   - width, height: image size in pixels
+//
+// Returns: Σ w_k d_k² over all pixels (bit-identical to perceptualSum_Scalar)
+func perceptualAVX2(cur *uint8, ref *int16, k *perceptualKernel, stride, width, height, planeStride, planeLen int) int64
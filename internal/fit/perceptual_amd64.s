@@ -0,0 +1,168 @@
+// AVX2 SIMD implementation of the perceptual (YCbCr / Lab) cost kernel
+//
+// Function signature:
+//   func perceptualAVX2(cur *uint8, ref *int16, k *perceptualKernel,
+//                       stride, width, height, planeStride, planeLen int) int64
+//
+// Algorithm (8 canvas pixels per iteration):
+//   - Isolate R, G, B of each dword pixel (VPAND / VPSRLD)
+//   - Gather the per-channel transfer LUT values (VPGATHERDD, 3 per iteration)
+//   - For each component k: C_k = (Σ_c mix[k][c] × lut_c + 128) >> 8 (VPMULLD)
+//   - d_k = C_k - reference plane k (VPMOVSXWD of 8 int16 components)
+//   - Accumulate w_k × d_k² in int32 lanes, widened to int64 (VPMOVZXDQ) once
+//     per row or every PERC_FLUSH_ITERS iterations
+//   - Row tails (width % 8) use VPMASKMOVD; zeroed lanes convert black, which
+//     matches the reference plane padding
+//
+// Lane overflow bound: see TestPerceptualKernel_LaneBound.
+//
+// perceptualKernel layout (perceptual.go):
+//   0:    mix    [9][8]int32
+//   288:  weight [3][8]int32
+//   384:  lut    [3][256]int32
+
+#include "textflag.h"
+
+DATA percByteMask<>+0(SB)/4, $0x000000FF
+GLOBL percByteMask<>(SB), RODATA|NOPTR, $4
+
+DATA percRound<>+0(SB)/4, $128
+GLOBL percRound<>(SB), RODATA|NOPTR, $4
+
+// Tail mask table: 8 dwords of -1 followed by 8 dwords of 0
+DATA percTailMask<>+0(SB)/8, $0xFFFFFFFFFFFFFFFF
+DATA percTailMask<>+8(SB)/8, $0xFFFFFFFFFFFFFFFF
+DATA percTailMask<>+16(SB)/8, $0xFFFFFFFFFFFFFFFF
+DATA percTailMask<>+24(SB)/8, $0xFFFFFFFFFFFFFFFF
+DATA percTailMask<>+32(SB)/8, $0x0000000000000000
+DATA percTailMask<>+40(SB)/8, $0x0000000000000000
+DATA percTailMask<>+48(SB)/8, $0x0000000000000000
+DATA percTailMask<>+56(SB)/8, $0x0000000000000000
+GLOBL percTailMask<>(SB), RODATA|NOPTR, $64
+
+// Must match perceptualFlushIters in perceptual.go
+#define PERC_FLUSH_ITERS $128
+
+// PERC_COMP adds w × d² of one component into Y10.
+// Inputs: Y5/Y6/Y7 = gathered R/G/B transfer values, plane = reference row.
+// Clobbers Y8, Y9.
+#define PERC_COMP(m0, m1, m2, w, plane) \
+    VPMULLD   m0(R12), Y5, Y8 \
+    VPMULLD   m1(R12), Y6, Y9 \
+    VPADDD    Y9, Y8, Y8 \
+    VPMULLD   m2(R12), Y7, Y9 \
+    VPADDD    Y9, Y8, Y8 \
+    VPADDD    Y13, Y8, Y8 \
+    VPSRAD    $8, Y8, Y8 \
+    VPMOVSXWD (plane)(DI*2), Y9 \
+    VPSUBD    Y9, Y8, Y8 \
+    VPMULLD   Y8, Y8, Y8 \
+    VPMULLD   w(R12), Y8, Y8 \
+    VPADDD    Y8, Y10, Y10
+
+// PERC8 converts the 8 pixels in Y0 and accumulates their weighted cost.
+// Clobbers Y1-Y9.
+#define PERC8 \
+    VPAND      Y15, Y0, Y1 \
+    VPSRLD     $8, Y0, Y2 \
+    VPAND      Y15, Y2, Y2 \
+    VPSRLD     $16, Y0, Y3 \
+    VPAND      Y15, Y3, Y3 \
+    VPCMPEQD   Y4, Y4, Y4 \
+    VPGATHERDD Y4, (R11)(Y1*4), Y5 \
+    VPCMPEQD   Y4, Y4, Y4 \
+    VPGATHERDD Y4, 1024(R11)(Y2*4), Y6 \
+    VPCMPEQD   Y4, Y4, Y4 \
+    VPGATHERDD Y4, 2048(R11)(Y3*4), Y7 \
+    PERC_COMP(0, 32, 64, 288, R9) \
+    PERC_COMP(96, 128, 160, 320, R10) \
+    PERC_COMP(192, 224, 256, 352, R13)
+
+// WIDEN adds the 8 int32 lanes of Y10 into the 4 int64 lanes of Y11 and
+// clears Y10. Clobbers Y8, Y9.
+#define WIDEN \
+    VEXTRACTI128 $1, Y10, X8 \
+    VPMOVZXDQ    X10, Y9 \
+    VPMOVZXDQ    X8, Y8 \
+    VPADDQ       Y9, Y11, Y11 \
+    VPADDQ       Y8, Y11, Y11 \
+    VPXOR        Y10, Y10, Y10
+
+// func perceptualAVX2(cur *uint8, ref *int16, k *perceptualKernel, stride, width, height, planeStride, planeLen int) int64
+TEXT ·perceptualAVX2(SB), NOSPLIT, $0-72
+    MOVQ cur+0(FP), R8             // R8 = current canvas row
+    MOVQ ref+8(FP), R9             // R9 = reference row, plane 0
+    MOVQ k+16(FP), R12             // R12 = kernel tables
+    MOVQ width+32(FP), SI
+    MOVQ height+40(FP), AX         // AX = rows remaining
+
+    MOVQ planeLen+56(FP), DX
+    SHLQ $1, DX                    // DX = bytes per plane
+    LEAQ (R9)(DX*1), R10           // R10 = reference row, plane 1
+    LEAQ (R10)(DX*1), R13          // R13 = reference row, plane 2
+    LEAQ 384(R12), R11             // R11 = transfer LUT base
+
+    VPBROADCASTD percByteMask<>(SB), Y15
+    VPBROADCASTD percRound<>(SB), Y13
+    VPXOR Y11, Y11, Y11            // Y11 = int64 accumulator
+    VPXOR Y10, Y10, Y10            // Y10 = int32 accumulator
+
+    // BX = tail pixels, Y14 = dword mask enabling the first BX lanes
+    MOVQ SI, BX
+    ANDQ $7, BX
+    MOVQ $8, CX
+    SUBQ BX, CX
+    LEAQ percTailMask<>(SB), DX
+    VMOVDQU (DX)(CX*4), Y14
+
+    // SI = pixels covered by full 8-pixel blocks
+    ANDQ $-8, SI
+
+    TESTQ AX, AX
+    JLE done
+
+row_loop:
+    XORQ DI, DI                    // DI = pixel index within row
+    MOVQ PERC_FLUSH_ITERS, CX
+    CMPQ DI, SI
+    JGE tail
+
+simd_loop:
+    VMOVDQU (R8)(DI*4), Y0
+    PERC8
+    ADDQ $8, DI
+    DECQ CX
+    JNZ simd_next
+    WIDEN
+    MOVQ PERC_FLUSH_ITERS, CX
+
+simd_next:
+    CMPQ DI, SI
+    JL simd_loop
+
+tail:
+    TESTQ BX, BX
+    JZ row_done
+    VPMASKMOVD (R8)(DI*4), Y14, Y0
+    PERC8
+
+row_done:
+    WIDEN
+    ADDQ stride+24(FP), R8
+    MOVQ planeStride+48(FP), DX
+    LEAQ (R9)(DX*2), R9
+    LEAQ (R10)(DX*2), R10
+    LEAQ (R13)(DX*2), R13
+    DECQ AX
+    JNZ row_loop
+
+done:
+    // Horizontal reduction of the 4 int64 lanes
+    VEXTRACTI128 $1, Y11, X1
+    VPADDQ X1, X11, X1
+    VPSHUFD $0x4E, X1, X2
+    VPADDQ X2, X1, X1
+    VMOVQ X1, AX
+    VZEROUPPER
+    MOVQ AX, ret+64(FP)
+    RET
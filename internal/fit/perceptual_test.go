@@ -0,0 +1,177 @@
+package fit
+
+import (
+	"image"
+	"image/color"
+	"math"
+	"testing"
+	"unsafe"
+)
+
+var perceptualSpaces = []ColorSpace{ColorSpaceYCbCr, ColorSpaceLab}
+
+// TestPerceptualKernel_Layout verifies the field offsets perceptual_amd64.s relies on
+func TestPerceptualKernel_Layout(t *testing.T) {
+	var k perceptualKernel
+	if off := unsafe.Offsetof(k.mix); off != 0 {
+		t.Errorf("mix offset = %d, want 0", off)
+	}
+	if off := unsafe.Offsetof(k.weight); off != 288 {
+		t.Errorf("weight offset = %d, want 288", off)
+	}
+	if off := unsafe.Offsetof(k.lut); off != 384 {
+		t.Errorf("lut offset = %d, want 384", off)
+	}
+}
+
+// TestPerceptualKernel_LaneBound verifies the AVX2 int32 lanes cannot overflow
+// between widenings (flush interval plus the row tail iteration)
+func TestPerceptualKernel_LaneBound(t *testing.T) {
+	for _, space := range perceptualSpaces {
+		bound := kernelFor(space).maxPixelCost() * (perceptualFlushIters + 1)
+		if bound >= math.MaxInt32 {
+			t.Errorf("%s: lane bound %d overflows int32", space, bound)
+		}
+	}
+}
+
+// TestPerceptualCost_IdenticalImages tests that identical images cost zero
+func TestPerceptualCost_IdenticalImages(t *testing.T) {
+	for _, space := range perceptualSpaces {
+		ref := randomNRGBA(61, 37, 1)
+		pc := NewPerceptualCost(ref, space)
+		if got := pc.Cost(cloneNRGBA(ref), ref); got != 0 {
+			t.Errorf("%s: cost of identical images = %v, want 0", space, got)
+		}
+	}
+}
+
+// TestPerceptualCost_GreyAxis verifies Lab lightness and YCbCr luma on greys
+func TestPerceptualCost_GreyAxis(t *testing.T) {
+	for v := 0; v < 256; v++ {
+		lab := labKernel.convert(uint8(v), uint8(v), uint8(v))
+		if lab[1] != 0 || lab[2] != 0 {
+			t.Errorf("Lab grey %d: a=%d b=%d, want 0", v, lab[1], lab[2])
+		}
+		ycc := ycbcrKernel.convert(uint8(v), uint8(v), uint8(v))
+		if ycc[1] != 0 || ycc[2] != 0 {
+			t.Errorf("YCbCr grey %d: Cb=%d Cr=%d, want 0", v, ycc[1], ycc[2])
+		}
+		if want := int16(v * perceptualTransferMax / 255); ycc[0] != want {
+			t.Errorf("YCbCr grey %d: Y=%d, want %d", v, ycc[0], want)
+		}
+	}
+}
+
+// TestPerceptualCost_LumaWeighted verifies YCbCr penalizes luma more than an
+// equal-MSE chroma change
+func TestPerceptualCost_LumaWeighted(t *testing.T) {
+	ref := solidColorNRGBA(32, 32, color.NRGBA{128, 128, 128, 255})
+	luma := solidColorNRGBA(32, 32, color.NRGBA{148, 148, 148, 255})   // +20 on every channel
+	chroma := solidColorNRGBA(32, 32, color.NRGBA{148, 108, 148, 255}) // ±20, ~same luma
+
+	if MSECost(luma, ref) != MSECost(chroma, ref) {
+		t.Fatal("test images should have equal MSE")
+	}
+
+	pc := NewPerceptualCost(ref, ColorSpaceYCbCr)
+	if l, c := pc.Cost(luma, ref), pc.Cost(chroma, ref); l <= c {
+		t.Errorf("luma cost %v should exceed chroma cost %v", l, c)
+	}
+}
+
+// TestPerceptualSum_AVX2MatchesScalar verifies the AVX2 kernel is bit-identical
+// to the scalar reference for every tail length and padded strides
+func TestPerceptualSum_AVX2MatchesScalar(t *testing.T) {
+	if !simdTierSupported(simdTierAVX2) {
+		t.Skip("AVX2 not supported")
+	}
+
+	for _, space := range perceptualSpaces {
+		for width := 1; width <= 40; width++ {
+			for _, padded := range []bool{false, true} {
+				ref := randomNRGBA(width, 5, int64(width))
+				cur := randomNRGBA(width, 5, int64(width)+100)
+				if padded {
+					big := randomNRGBA(width+3, 7, int64(width)+200)
+					cur = big.SubImage(image.Rect(2, 1, width+2, 6)).(*image.NRGBA)
+				}
+
+				pc := NewPerceptualCost(ref, space)
+				planeLen := pc.planeStride * pc.height
+				want := perceptualSum_Scalar(pc.kernel, cur.Pix, cur.Stride, width, 5, pc.planes, pc.planeStride, planeLen)
+				got := perceptualSum_AVX2(pc.kernel, cur.Pix, cur.Stride, width, 5, pc.planes, pc.planeStride, planeLen)
+				if got != want {
+					t.Errorf("%s width=%d padded=%v: AVX2 = %d, scalar = %d", space, width, padded, got, want)
+				}
+			}
+		}
+	}
+}
+
+// TestPerceptualSum_AVX2LongRows verifies widening on rows longer than one flush block
+// with maximal differences
+func TestPerceptualSum_AVX2LongRows(t *testing.T) {
+	if !simdTierSupported(simdTierAVX2) {
+		t.Skip("AVX2 not supported")
+	}
+
+	width := perceptualFlushIters*8*2 + 5
+	for _, space := range perceptualSpaces {
+		ref := solidColorNRGBA(width, 2, color.NRGBA{255, 0, 255, 255})
+		cur := solidColorNRGBA(width, 2, color.NRGBA{0, 255, 0, 255})
+
+		pc := NewPerceptualCost(ref, space)
+		planeLen := pc.planeStride * pc.height
+		want := perceptualSum_Scalar(pc.kernel, cur.Pix, cur.Stride, width, 2, pc.planes, pc.planeStride, planeLen)
+		got := perceptualSum_AVX2(pc.kernel, cur.Pix, cur.Stride, width, 2, pc.planes, pc.planeStride, planeLen)
+		if got != want {
+			t.Errorf("%s: AVX2 = %d, scalar = %d", space, got, want)
+		}
+	}
+}
+
+// TestParseColorSpace tests colour space name parsing
+func TestParseColorSpace(t *testing.T) {
+	for _, space := range perceptualSpaces {
+		got, err := ParseColorSpace(space.String())
+		if err != nil || got != space {
+			t.Errorf("ParseColorSpace(%q) = %v, %v", space.String(), got, err)
+		}
+	}
+	if _, err := ParseColorSpace("hsv"); err == nil {
+		t.Error("ParseColorSpace(\"hsv\") should fail")
+	}
+}
+
+// BenchmarkPerceptualCost compares the perceptual kernels with FastSSD (512x512)
+func BenchmarkPerceptualCost(b *testing.B) {
+	ref := randomNRGBA(512, 512, 1)
+	cur := randomNRGBA(512, 512, 2)
+
+	b.Run("FastSSD", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			FastSSD(cur, ref)
+		}
+		b.ReportMetric(BenchmarkSSDBackend(b.N, 512, 512, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+	})
+
+	for _, space := range perceptualSpaces {
+		pc := NewPerceptualCost(ref, space)
+		planeLen := pc.planeStride * pc.height
+
+		b.Run(space.String()+"_scalar", func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				perceptualSum_Scalar(pc.kernel, cur.Pix, cur.Stride, 512, 512, pc.planes, pc.planeStride, planeLen)
+			}
+			b.ReportMetric(BenchmarkSSDBackend(b.N, 512, 512, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+		})
+
+		b.Run(space.String()+"_active", func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				pc.Cost(cur, ref)
+			}
+			b.ReportMetric(BenchmarkSSDBackend(b.N, 512, 512, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+		})
+	}
+}
@@ -0,0 +1,76 @@
+package fit
+
+import (
+	"image"
+	"log/slog"
+)
+
+// Planar (structure-of-arrays) SSD kernel.
+//
+// Renderers that keep the canvas and the reference as separate R, G and B
+// byte planes without alpha (renderer.PlanarRenderer) compare each channel as
+// one contiguous byte run. There is no alpha to skip and nothing to
+// de-interleave, so the kernel streams 32 bytes per AVX2 iteration and reads a
+// quarter less memory than FastSSD on NRGBA images.
+
+// planeSSD is set by init() from the SIMD tier.
+var planeSSD func(a, b []uint8) uint64
+
+func init() {
+	// AVX-512 hosts run the AVX2 kernel; NEON has no port yet
+	if activeSIMDTier >= simdTierAVX2 {
+		planeSSD = planeSSD_AVX2
+		slog.Debug("Planar SSD kernel initialized", "backend", "AVX2")
+	} else {
+		planeSSD = planeSSD_Scalar
+		slog.Debug("Planar SSD kernel initialized", "backend", "scalar")
+	}
+}
+
+// PlaneSSD returns Σ (a[i] - b[i])² over two equal-length byte planes.
+// The sum is exact; dividing the total over the R, G and B planes by
+// 3 × pixels gives the same value as MSECost.
+func PlaneSSD(a, b []uint8) uint64 {
+	if len(a) != len(b) {
+		panic("PlaneSSD: plane lengths must match")
+	}
+	return planeSSD(a, b)
+}
+
+// planeSSD_Scalar is the portable reference for the planar SSD kernel.
+func planeSSD_Scalar(a, b []uint8) uint64 {
+	b = b[:len(a)]
+	var total uint64
+	for i, av := range a {
+		d := int32(av) - int32(b[i])
+		total += uint64(d * d)
+	}
+	return total
+}
+
+// planeSSD_AVX2 runs the AVX2 kernel (planar_amd64.s) on whole 32-byte blocks
+// and the scalar loop on the remainder.
+func planeSSD_AVX2(a, b []uint8) uint64 {
+	n := len(a) &^ 31
+	var total uint64
+	if n > 0 {
+		total = planeSSDAVX2(&a[0], &b[0], n)
+	}
+	return total + planeSSD_Scalar(a[n:], b[n:len(a)])
+}
+
+// LumaPlane converts an NRGBA image into a contiguous plane of BT.601 luma
+// bytes (the same integer luma used by SSIMCost), ignoring alpha.
+func LumaPlane(img *image.NRGBA) []uint8 {
+	bounds := img.Bounds()
+	width, height := bounds.Dx(), bounds.Dy()
+
+	plane := make([]uint8, width*height)
+	for y := 0; y < height; y++ {
+		row := img.Pix[y*img.Stride:]
+		for x := 0; x < width; x++ {
+			plane[y*width+x] = lumaOf(row[x*4+0], row[x*4+1], row[x*4+2])
+		}
+	}
+	return plane
+}
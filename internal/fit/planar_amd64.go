@@ -0,0 +1,11 @@
+//go:build amd64
+
+package fit
+
+// planeSSDAVX2 computes Σ (a[i] - b[i])² over n bytes using AVX2 instructions.
+//
+// Plan9 assembly (planar_amd64.s). n must be a positive multiple of 32; the
+// caller handles the remainder.
+//
+// Returns: exact sum (bit-identical to planeSSD_Scalar)
+func planeSSDAVX2(a, b *uint8, n int) uint64
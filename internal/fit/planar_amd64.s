@@ -0,0 +1,77 @@
+// AVX2 SIMD implementation of the planar SSD kernel
+//
+// Function signature:
+//   func planeSSDAVX2(a, b *uint8, n int) uint64
+//
+// Processes 32 bytes per iteration:
+//   - |a-b| on bytes via VPMAXUB/VPMINUB/VPSUBB
+//   - even bytes (AND 0x00FF) and odd bytes (shift right 8) as words
+//   - VPMADDWD of each with itself yields d² pairs summed in int32 lanes
+//
+// One iteration adds at most 4 × 255² = 260100 per lane, so the int32
+// accumulator is widened to int64 every PSSD_FLUSH_ITERS iterations.
+
+#include "textflag.h"
+
+DATA pEvenMask<>+0(SB)/4, $0x00FF00FF
+GLOBL pEvenMask<>(SB), RODATA|NOPTR, $4
+
+// 8192 iterations × 260100 < 2^31
+#define PSSD_FLUSH_ITERS $8192
+
+// func planeSSDAVX2(a, b *uint8, n int) uint64
+TEXT ·planeSSDAVX2(SB), NOSPLIT, $0-32
+    MOVQ a+0(FP), SI
+    MOVQ b+8(FP), DI
+    MOVQ n+16(FP), CX
+    SHRQ $5, CX                   // CX = 32-byte blocks remaining
+
+    VPBROADCASTD pEvenMask<>(SB), Y15
+    VPXOR Y12, Y12, Y12           // Y12 = int64 accumulator
+    VPXOR Y0, Y0, Y0              // Y0 = int32 accumulator
+    MOVQ PSSD_FLUSH_ITERS, DX
+
+pssd_loop:
+    VMOVDQU (SI), Y1
+    VMOVDQU (DI), Y2
+    VPMAXUB  Y2, Y1, Y3
+    VPMINUB  Y2, Y1, Y4
+    VPSUBB   Y4, Y3, Y3
+    VPAND    Y15, Y3, Y4
+    VPSRLW   $8, Y3, Y3
+    VPMADDWD Y4, Y4, Y4
+    VPMADDWD Y3, Y3, Y3
+    VPADDD   Y4, Y0, Y0
+    VPADDD   Y3, Y0, Y0
+    ADDQ $32, SI
+    ADDQ $32, DI
+    DECQ DX
+    JNZ pssd_next
+
+    // Widen int32 lanes into the int64 accumulator
+    VEXTRACTI128 $1, Y0, X5
+    VPMOVZXDQ    X0, Y6
+    VPMOVZXDQ    X5, Y5
+    VPADDQ       Y6, Y12, Y12
+    VPADDQ       Y5, Y12, Y12
+    VPXOR        Y0, Y0, Y0
+    MOVQ PSSD_FLUSH_ITERS, DX
+
+pssd_next:
+    DECQ CX
+    JNZ pssd_loop
+
+    VEXTRACTI128 $1, Y0, X5
+    VPMOVZXDQ    X0, Y6
+    VPMOVZXDQ    X5, Y5
+    VPADDQ       Y6, Y12, Y12
+    VPADDQ       Y5, Y12, Y12
+
+    VEXTRACTI128 $1, Y12, X1
+    VPADDQ X1, X12, X1
+    VPSHUFD $0x4E, X1, X2
+    VPADDQ X2, X1, X1
+    VMOVQ X1, AX
+    VZEROUPPER
+    MOVQ AX, ret+24(FP)
+    RET
@@ -0,0 +1,61 @@
+package fit
+
+import (
+	"math/rand"
+	"testing"
+)
+
+// TestPlaneSSD_AVX2MatchesScalar tests bit-exactness for every remainder
+// length and for maximal differences across several flush blocks
+func TestPlaneSSD_AVX2MatchesScalar(t *testing.T) {
+	if !simdTierSupported(simdTierAVX2) {
+		t.Skip("AVX2 not supported")
+	}
+
+	rng := rand.New(rand.NewSource(1))
+	for n := 0; n <= 100; n++ {
+		a := make([]uint8, n)
+		b := make([]uint8, n)
+		rng.Read(a)
+		rng.Read(b)
+		if got, want := planeSSD_AVX2(a, b), planeSSD_Scalar(a, b); got != want {
+			t.Errorf("n=%d: AVX2 = %d, scalar = %d", n, got, want)
+		}
+	}
+
+	n := 8192*32*2 + 45
+	black := make([]uint8, n)
+	white := make([]uint8, n)
+	for i := range white {
+		white[i] = 255
+	}
+	if got, want := planeSSD_AVX2(black, white), uint64(n)*255*255; got != want {
+		t.Errorf("max-diff: AVX2 = %d, want %d", got, want)
+	}
+}
+
+// TestPlaneSSD_MatchesMSECost tests that per-channel planes reproduce MSECost
+func TestPlaneSSD_MatchesMSECost(t *testing.T) {
+	img1 := randomNRGBA(41, 29, 1)
+	img2 := randomNRGBA(41, 29, 2)
+
+	planes := func(pix []uint8) [3][]uint8 {
+		var p [3][]uint8
+		for c := range p {
+			p[c] = make([]uint8, 0, len(pix)/4)
+			for i := c; i < len(pix); i += 4 {
+				p[c] = append(p[c], pix[i])
+			}
+		}
+		return p
+	}
+	a, b := planes(img1.Pix), planes(img2.Pix)
+
+	var sum uint64
+	for c := range a {
+		sum += PlaneSSD(a[c], b[c])
+	}
+	if got, want := float64(sum)/float64(41*29*3), MSECost(img1, img2); got != want {
+		t.Errorf("planar cost = %v, MSECost = %v", got, want)
+	}
+}
@@ -0,0 +1,162 @@
+package renderer
+
+import (
+	"image"
+	"math"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+)
+
+// Anti-aliased coverage rendering.
+//
+// The default rasterizer tests pixel centres against the disc, so the cost is
+// piecewise constant in X, Y and R: moving a circle by a fraction of a pixel
+// changes nothing until a centre crosses the edge. With anti-aliasing enabled
+// a pixel at distance d from the centre is covered by
+//
+//	coverage = clamp(R + 0.5 - d, 0, 1)
+//
+// (the signed-distance approximation of the exact area) and composited with
+// opacity·coverage, so the cost varies continuously with every parameter.
+//
+// Per row, pixels with d <= R-0.5 are fully covered and go through the
+// regular span path (LUT blending on the planar renderers); only the one or
+// two boundary pixels at each end of the span need a square root. Anti-aliased
+// circles are always composited in float64 with exact geometry, so this mode
+// takes precedence over the float32 path and span tables.
+
+// SetAntialias enables or disables anti-aliased circle edges on a renderer.
+// Renderers without anti-aliasing are left unchanged and reported with
+// ok = false.
+func SetAntialias(r Renderer, on bool) (ok bool) {
+	if s, isSetter := r.(interface{ SetAntialias(bool) }); isSetter {
+		s.SetAntialias(on)
+		return true
+	}
+	return !on
+}
+
+// antialiasRows returns the clamped row range [minY, maxY) an anti-aliased
+// circle can touch, or ok = false if it is transparent or off-image.
+func antialiasRows(c fit.Circle, height int) (minY, maxY int, ok bool) {
+	if c.Opacity < 0.001 || !(c.R > -0.5) {
+		return 0, 0, false
+	}
+	minYf := math.Floor(c.Y - c.R - 0.5)
+	maxYf := math.Ceil(c.Y + c.R + 0.5)
+	if maxYf < 0 || minYf >= float64(height) {
+		return 0, 0, false
+	}
+	return max(int(minYf), 0), min(int(maxYf)+1, height), true
+}
+
+// antialiasSpan splits row y of circle c into the touched span [x0, x1) and
+// its fully covered interior [i0, i1), x0 <= i0 <= i1 <= x1, all clamped to
+// [0, width). ok is false if the row misses the circle.
+func antialiasSpan(c fit.Circle, y, width int) (x0, x1, i0, i1 int, ok bool) {
+	dy := float64(y) - c.Y
+	dy2 := dy * dy
+	outer := c.R + 0.5
+	if dy2 >= outer*outer {
+		return 0, 0, 0, 0, false
+	}
+
+	half := math.Sqrt(outer*outer - dy2)
+	x0 = max(int(math.Floor(c.X-half)), 0)
+	x1 = min(int(math.Floor(c.X+half))+1, width)
+	if x0 >= x1 {
+		return 0, 0, 0, 0, false
+	}
+
+	// Interior: d <= R-0.5 gives coverage >= 1
+	i0, i1 = x1, x1
+	if inner := c.R - 0.5; inner > 0 && dy2 <= inner*inner {
+		h := math.Sqrt(inner*inner - dy2)
+		lo := int(math.Ceil(c.X - h))
+		hi := int(math.Floor(c.X+h)) + 1
+		if lo < hi {
+			i0 = min(max(lo, x0), x1)
+			i1 = min(max(hi, i0), x1)
+		}
+	}
+	return x0, x1, i0, i1, true
+}
+
+// edgeCoverage returns the coverage of pixel x on a row at vertical offset dy
+func edgeCoverage(c fit.Circle, x int, dy float64) float64 {
+	dx := float64(x) - c.X
+	return min(max(c.R+0.5-math.Sqrt(dx*dx+dy*dy), 0), 1)
+}
+
+// renderCircleAA composites an anti-aliased circle onto the NRGBA canvas
+func (r *CPURenderer) renderCircleAA(img *image.NRGBA, c fit.Circle) {
+	minY, maxY, ok := antialiasRows(c, r.height)
+	if !ok {
+		return
+	}
+
+	for y := minY; y < maxY; y++ {
+		x0, x1, i0, i1, ok := antialiasSpan(c, y, r.width)
+		if !ok {
+			continue
+		}
+		dy := float64(y) - c.Y
+		for x := x0; x < i0; x++ {
+			if cov := edgeCoverage(c, x, dy); cov > 0 {
+				compositePixel(img, x, y, c.CR, c.CG, c.CB, c.Opacity*cov)
+			}
+		}
+		for x := i0; x < i1; x++ {
+			compositePixel(img, x, y, c.CR, c.CG, c.CB, c.Opacity)
+		}
+		for x := i1; x < x1; x++ {
+			if cov := edgeCoverage(c, x, dy); cov > 0 {
+				compositePixel(img, x, y, c.CR, c.CG, c.CB, c.Opacity*cov)
+			}
+		}
+	}
+}
+
+// compositePlanesAA is compositePlanes with anti-aliased edges. Interior spans
+// use the per-circle blend (or LUT); edge pixels blend with opacity·coverage.
+// The arithmetic mirrors compositePixel over an opaque background, so results
+// are bit-identical to CPURenderer.renderCircleAA.
+func compositePlanesAA(planes [][]uint8, luts [][256]uint8, c fit.Circle, width, height int) {
+	minY, maxY, ok := antialiasRows(c, height)
+	if !ok {
+		return
+	}
+
+	blend := newPlaneBlend(planes, luts, c)
+	bgA := 255 * inv255
+	color := [3]float64{c.CR, c.CG, c.CB}
+
+	edge := func(i, x int, dy float64) {
+		cov := edgeCoverage(c, x, dy)
+		if cov <= 0 {
+			return
+		}
+		alpha := c.Opacity * cov
+		bgBlend := bgA * (1 - alpha)
+		invOutA := 1.0 / (alpha + bgBlend)
+		for ch, plane := range planes {
+			plane[i] = blendChannel(plane[i], color[ch]*alpha, bgBlend, invOutA)
+		}
+	}
+
+	for y := minY; y < maxY; y++ {
+		x0, x1, i0, i1, ok := antialiasSpan(c, y, width)
+		if !ok {
+			continue
+		}
+		row := y * width
+		dy := float64(y) - c.Y
+		for x := x0; x < i0; x++ {
+			edge(row+x, x, dy)
+		}
+		blend.fill(row+i0, row+i1)
+		for x := i1; x < x1; x++ {
+			edge(row+x, x, dy)
+		}
+	}
+}
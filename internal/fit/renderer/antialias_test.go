@@ -0,0 +1,141 @@
+package renderer
+
+import (
+	"bytes"
+	"image"
+	"math"
+	"testing"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+)
+
+// TestAntialiasCoverageArea checks that the summed coverage of an opaque black
+// circle on white matches its area, including sub-pixel radii and centres
+func TestAntialiasCoverageArea(t *testing.T) {
+	const size = 64
+	ref := image.NewNRGBA(image.Rect(0, 0, size, size))
+	r := NewCPURenderer(ref, 1)
+	r.SetAntialias(true)
+
+	for _, c := range []struct{ x, y, radius float64 }{
+		{32, 32, 20},
+		{31.3, 30.8, 12.6},
+		{20.5, 40.25, 5.3},
+		{33.7, 29.1, 1.4},
+	} {
+		img := r.Render([]float64{c.x, c.y, c.radius, 0, 0, 0, 1})
+		var covered float64
+		for i := 0; i < len(img.Pix); i += 4 {
+			covered += float64(255-img.Pix[i]) / 255
+		}
+		area := math.Pi * c.radius * c.radius
+		if math.Abs(covered-area) > 0.02*area+1 {
+			t.Errorf("circle %+v: coverage %.2f, area %.2f", c, covered, area)
+		}
+	}
+}
+
+// TestAntialiasRenderersAgree checks that planar and gray anti-aliased
+// rendering are bit-identical to the NRGBA path
+func TestAntialiasRenderersAgree(t *testing.T) {
+	const width, height, k = 70, 50, 30
+	ref := randomNRGBA(width, height, 6)
+
+	cpu := NewCPURenderer(ref, k)
+	planar := NewPlanarRenderer(ref, k)
+	gray := NewGrayRenderer(ref, k)
+	for _, r := range []Renderer{cpu, planar, gray} {
+		if !SetAntialias(r, true) {
+			t.Fatalf("%T does not support anti-aliasing", r)
+		}
+	}
+
+	for seed := int64(0); seed < 10; seed++ {
+		params := seededParams(k, width, height, seed)
+		if !bytes.Equal(cpu.Render(params).Pix, planar.Render(params).Pix) {
+			t.Fatalf("seed %d: planar anti-aliased render differs from CPU", seed)
+		}
+
+		grayParams := seededGrayParams(k, width, height, seed)
+		colour := make([]float64, 0, k*7)
+		for i := 0; i < k; i++ {
+			p := grayParams[i*fit.ParamsPerGrayCircle:]
+			colour = append(colour, p[0], p[1], p[2], p[3], p[3], p[3], p[4])
+		}
+		if !bytes.Equal(gray.Render(grayParams).Pix, planar.Render(colour).Pix) {
+			t.Fatalf("seed %d: gray anti-aliased render differs from planar", seed)
+		}
+	}
+}
+
+// TestAntialiasSmoothsCost moves a circle by sub-pixel steps: hard edges give
+// a staircase of repeated costs, anti-aliased edges a distinct cost per step
+func TestAntialiasSmoothsCost(t *testing.T) {
+	const width, height, steps = 48, 48, 20
+	ref := randomNRGBA(width, height, 8)
+
+	distinct := func(antialias bool) int {
+		r := NewPlanarRenderer(ref, 1)
+		r.SetAntialias(antialias)
+		seen := map[float64]bool{}
+		for i := 0; i < steps; i++ {
+			shift := float64(i) / (4 * steps) // Up to a quarter pixel
+			seen[r.Cost([]float64{24 + shift, 23.6, 6.2 + shift, 0.2, 0.5, 0.8, 0.9})] = true
+		}
+		return len(seen)
+	}
+
+	hard, smooth := distinct(false), distinct(true)
+	if smooth != steps {
+		t.Errorf("anti-aliased cost took %d distinct values over %d steps, want %d", smooth, steps, steps)
+	}
+	if hard >= smooth {
+		t.Errorf("hard-edged cost took %d distinct values, anti-aliased %d", hard, smooth)
+	}
+}
+
+// TestAntialiasWithOcclusionCulling checks that culling stays exact for
+// anti-aliased circles and that stages inherit the mode
+func TestAntialiasWithOcclusionCulling(t *testing.T) {
+	const width, height, k = 64, 48, 40
+	ref := randomNRGBA(width, height, 3)
+
+	culled, plain := NewCPURenderer(ref, k), NewCPURenderer(ref, k)
+	culled.SetAntialias(true)
+	plain.SetAntialias(true)
+	disableCulling(plain)
+
+	for seed := int64(0); seed < 10; seed++ {
+		params := opaqueParams(k, paramsPerCircle, width, height, seed)
+		if !bytes.Equal(culled.Render(params).Pix, plain.Render(params).Pix) {
+			t.Fatalf("seed %d: culled anti-aliased render differs", seed)
+		}
+	}
+	if culled.CulledCircles() == 0 {
+		t.Error("nothing culled")
+	}
+
+	if stage := stageRenderer(culled, 2).(*CPURenderer); !stage.Antialias() {
+		t.Error("CPU stage lost anti-aliasing")
+	}
+}
+
+func BenchmarkAntialias(b *testing.B) {
+	const width, height, k = 256, 256, 100
+	ref := randomNRGBA(width, height, 1)
+	params := seededParams(k, width, height, 7)
+
+	for _, antialias := range []bool{false, true} {
+		name := "hard"
+		if antialias {
+			name = "antialias"
+		}
+		b.Run("planar/"+name, func(b *testing.B) {
+			r := NewPlanarRenderer(ref, k)
+			r.SetAntialias(antialias)
+			for i := 0; i < b.N; i++ {
+				r.Cost(params)
+			}
+		})
+	}
+}
@@ -12,6 +12,7 @@ type Backend string
 
 const (
 	BackendCPU    Backend = "cpu"
+	BackendPlanar Backend = "planar"
 	BackendOpenCL Backend = "opencl"
 )
 
@@ -29,6 +30,8 @@ func NormalizeBackend(name string) Backend {
 	switch strings.ToLower(strings.TrimSpace(name)) {
 	case "", "cpu":
 		return BackendCPU
+	case "planar", "soa":
+		return BackendPlanar
 	case "gpu", "opencl", "cl":
 		return BackendOpenCL
 	default:
@@ -38,18 +41,32 @@ func NormalizeBackend(name string) Backend {
 
 // SupportedBackends returns the list of backends understood by the factory.
 func SupportedBackends() []Backend {
-	return []Backend{BackendCPU, BackendOpenCL}
+	return []Backend{BackendCPU, BackendPlanar, BackendOpenCL}
 }
 
 // NewRendererForBackend constructs the requested renderer and returns an optional cleanup hook.
 func NewRendererForBackend(name string, reference *image.NRGBA, k int) (Renderer, func(), error) {
+	return NewRendererForBackendWithCanvas(name, reference, nil, k)
+}
+
+// NewRendererForBackendWithCanvas is NewRendererForBackend with an initial
+// canvas (nil = white background). The planar backend only supports white.
+func NewRendererForBackendWithCanvas(name string, reference, canvas *image.NRGBA, k int) (Renderer, func(), error) {
 	backend := NormalizeBackend(name)
 
 	switch backend {
 	case BackendCPU:
+		if canvas != nil {
+			return NewCPURendererWithCanvas(reference, canvas, k), noopCleanup, nil
+		}
 		return NewCPURenderer(reference, k), noopCleanup, nil
+	case BackendPlanar:
+		if canvas != nil {
+			return nil, noopCleanup, fmt.Errorf("%w: canvas with %s backend", ErrBackendNotImplemented, backend)
+		}
+		return NewPlanarRenderer(reference, k), noopCleanup, nil
 	case BackendOpenCL:
-		return NewOpenCLRenderer(reference, k)
+		return NewOpenCLRendererWithCanvas(reference, canvas, k)
 	default:
 		return nil, noopCleanup, fmt.Errorf("%w: %s", ErrUnknownBackend, name)
 	}
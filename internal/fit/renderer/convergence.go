@@ -113,6 +113,37 @@ func (c *ConvergenceTracker) Update(cost float64) bool {
 	return false
 }
 
+// TrackerState is the resumable state of a ConvergenceTracker
+type TrackerState struct {
+	History         []float64 // Costs seen so far
+	LastSignificant float64   // Last significant cost (0 while History is empty)
+	StaleCount      int
+}
+
+// State returns the tracker's state for checkpointing
+func (c *ConvergenceTracker) State() TrackerState {
+	state := TrackerState{History: c.History(), StaleCount: c.staleCount}
+	if len(c.costHistory) > 0 {
+		state.LastSignificant = c.lastSignificant
+	}
+	return state
+}
+
+// RestoreConvergenceTracker creates a tracker that continues from state
+func RestoreConvergenceTracker(config ConvergenceConfig, state TrackerState) *ConvergenceTracker {
+	c := NewConvergenceTracker(config)
+	if len(state.History) == 0 {
+		return c
+	}
+	c.costHistory = append(c.costHistory, state.History...)
+	for _, cost := range state.History {
+		c.bestCost = math.Min(c.bestCost, cost)
+	}
+	c.lastSignificant = state.LastSignificant
+	c.staleCount = state.StaleCount
+	return c
+}
+
 // BestCost returns the best cost seen so far
 func (c *ConvergenceTracker) BestCost() float64 {
 	return c.bestCost
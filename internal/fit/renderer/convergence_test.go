@@ -188,3 +188,26 @@ func TestDisabledConvergenceConfig(t *testing.T) {
 		t.Error("Expected disabled config to not be enabled")
 	}
 }
+
+func TestConvergenceTracker_RestoreState(t *testing.T) {
+	config := ConvergenceConfig{Enabled: true, Patience: 2, Threshold: 0.01}
+	costs := []float64{100, 90, 89.5, 89.4, 80, 79.9, 79.8}
+
+	// Restoring after any prefix must give the same decisions
+	for split := 0; split <= len(costs); split++ {
+		whole, first := NewConvergenceTracker(config), NewConvergenceTracker(config)
+		for _, cost := range costs[:split] {
+			whole.Update(cost)
+			first.Update(cost)
+		}
+		restored := RestoreConvergenceTracker(config, first.State())
+		for _, cost := range costs[split:] {
+			if a, b := whole.Update(cost), restored.Update(cost); a != b {
+				t.Fatalf("split %d: cost %f converged=%v after restore, %v uninterrupted", split, cost, b, a)
+			}
+		}
+		if whole.BestCost() != restored.BestCost() || whole.StaleCount() != restored.StaleCount() {
+			t.Errorf("split %d: restored tracker diverged", split)
+		}
+	}
+}
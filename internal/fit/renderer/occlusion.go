@@ -0,0 +1,180 @@
+package renderer
+
+import (
+	"math"
+	"sync/atomic"
+)
+
+// Occlusion culling.
+//
+// A circle with opacity exactly 1 replaces every pixel it covers: the "over"
+// blend then ignores the background completely. Before compositing, a
+// back-to-front pre-pass marks the tiles that such circles cover entirely and
+// skips every earlier circle whose footprint lies in covered tiles only. The
+// result is bit-identical to compositing all circles.
+//
+// Both tests carry a one-pixel margin (the footprint is grown, the covered
+// disc shrunk), which absorbs the scanline search's centre pixel, span-table
+// snapping and float32 rounding.
+
+// occlusionTileSize is the edge length of the coverage tiles in pixels
+const occlusionTileSize = 8
+
+// occlusionCuller finds circles hidden behind later opaque circles
+type occlusionCuller struct {
+	width, height  int
+	tilesX, tilesY int
+	covered        []bool // Per tile: fully covered by an opaque circle seen so far
+	skip           []bool // Per circle: culled in the last pass
+	culled         *atomic.Uint64
+}
+
+func newOcclusionCuller(width, height int) *occlusionCuller {
+	tilesX := (width + occlusionTileSize - 1) / occlusionTileSize
+	tilesY := (height + occlusionTileSize - 1) / occlusionTileSize
+	return &occlusionCuller{
+		width:   width,
+		height:  height,
+		tilesX:  tilesX,
+		tilesY:  tilesY,
+		covered: make([]bool, tilesX*tilesY),
+		culled:  new(atomic.Uint64),
+	}
+}
+
+// shareCounter makes o add its culled circles to parent's counter, so the
+// stage renderers of a pipeline report into the renderer they were made from.
+func (o *occlusionCuller) shareCounter(parent *occlusionCuller) {
+	if o != nil && parent != nil {
+		o.culled = parent.culled
+	}
+}
+
+// total returns the number of circles culled so far
+func (o *occlusionCuller) total() uint64 {
+	if o == nil {
+		return 0
+	}
+	return o.culled.Load()
+}
+
+// cull returns per-circle skip flags for the first k circles of params (ppc
+// values per circle: X, Y, R first, opacity last), or nil if no circle is
+// hidden. The slice is reused by the next call.
+func (o *occlusionCuller) cull(params []float64, k, ppc int) []bool {
+	if o == nil {
+		return nil
+	}
+
+	// Nothing can be hidden without an opaque circle after the first
+	opaque := false
+	for i := 1; i < k; i++ {
+		if params[i*ppc+ppc-1] == 1 {
+			opaque = true
+			break
+		}
+	}
+	if !opaque {
+		return nil
+	}
+
+	if cap(o.skip) < k {
+		o.skip = make([]bool, k)
+	}
+	skip := o.skip[:k]
+	clear(skip)
+	clear(o.covered)
+
+	culled := 0
+	anyCovered := false
+	for i := k - 1; i >= 0; i-- {
+		base := i * ppc
+		x, y, r := params[base], params[base+1], params[base+2]
+
+		tx0, tx1, ty0, ty1, ok := o.footprint(x, y, r)
+		if !ok {
+			continue // Off-image: the renderers reject it cheaply
+		}
+		if anyCovered && o.allCovered(tx0, tx1, ty0, ty1) {
+			skip[i] = true
+			culled++
+			continue
+		}
+		if params[base+ppc-1] == 1 && o.cover(x, y, r, tx0, tx1, ty0, ty1) {
+			anyCovered = true
+		}
+	}
+
+	if culled == 0 {
+		return nil
+	}
+	o.culled.Add(uint64(culled))
+	return skip
+}
+
+// footprint returns the tiles touched by the circle's bounding box grown by
+// one pixel, or ok = false if it misses the image.
+func (o *occlusionCuller) footprint(x, y, r float64) (tx0, tx1, ty0, ty1 int, ok bool) {
+	if !(r >= 0) {
+		return 0, 0, 0, 0, false // Negative or NaN radius
+	}
+	x0, x1 := math.Floor(x-r-1), math.Floor(x+r+1)
+	y0, y1 := math.Floor(y-r-1), math.Floor(y+r+1)
+	if x1 < 0 || y1 < 0 || x0 >= float64(o.width) || y0 >= float64(o.height) {
+		return 0, 0, 0, 0, false
+	}
+	tx0 = max(int(x0), 0) / occlusionTileSize
+	tx1 = min(int(x1), o.width-1) / occlusionTileSize
+	ty0 = max(int(y0), 0) / occlusionTileSize
+	ty1 = min(int(y1), o.height-1) / occlusionTileSize
+	return tx0, tx1, ty0, ty1, true
+}
+
+func (o *occlusionCuller) allCovered(tx0, tx1, ty0, ty1 int) bool {
+	for ty := ty0; ty <= ty1; ty++ {
+		row := o.covered[ty*o.tilesX:]
+		for tx := tx0; tx <= tx1; tx++ {
+			if !row[tx] {
+				return false
+			}
+		}
+	}
+	return true
+}
+
+// cover marks the tiles of the footprint whose pixel centres all lie at least
+// one pixel inside the circle, reporting whether any tile was marked.
+func (o *occlusionCuller) cover(x, y, r float64, tx0, tx1, ty0, ty1 int) bool {
+	inner := r - 1
+	if inner < occlusionTileSize/2 {
+		return false // Too small to cover a whole tile
+	}
+	inner2 := inner * inner
+
+	marked := false
+	for ty := ty0; ty <= ty1; ty++ {
+		py0 := float64(ty * occlusionTileSize)
+		py1 := float64(min((ty+1)*occlusionTileSize, o.height) - 1)
+		dy := math.Max(math.Abs(py0-y), math.Abs(py1-y))
+		for tx := tx0; tx <= tx1; tx++ {
+			px0 := float64(tx * occlusionTileSize)
+			px1 := float64(min((tx+1)*occlusionTileSize, o.width) - 1)
+			dx := math.Max(math.Abs(px0-x), math.Abs(px1-x))
+			if dx*dx+dy*dy <= inner2 {
+				o.covered[ty*o.tilesX+tx] = true
+				marked = true
+			}
+		}
+	}
+	return marked
+}
+
+// CulledCircles returns the number of circles a renderer (and the pipeline
+// stages derived from it) skipped because later opaque circles hid them, or 0
+// for renderers without occlusion culling.
+func CulledCircles(r Renderer) uint64 {
+	if c, ok := r.(interface{ CulledCircles() uint64 }); ok {
+		return c.CulledCircles()
+	}
+	return 0
+}
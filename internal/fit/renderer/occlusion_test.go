@@ -0,0 +1,160 @@
+package renderer
+
+import (
+	"bytes"
+	"math/rand"
+	"testing"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+)
+
+// opaqueParams creates circle parameters where roughly half of the circles are
+// fully opaque and many are large, so later circles hide earlier ones
+func opaqueParams(k, ppc, width, height int, seed int64) []float64 {
+	rng := rand.New(rand.NewSource(seed))
+	params := make([]float64, k*ppc)
+	for i := 0; i < k; i++ {
+		p := params[i*ppc : (i+1)*ppc]
+		p[0] = rng.Float64()*float64(width+20) - 10
+		p[1] = rng.Float64()*float64(height+20) - 10
+		p[2] = 1 + rng.Float64()*float64(width)/2
+		for j := 3; j < ppc-1; j++ {
+			p[j] = rng.Float64()
+		}
+		p[ppc-1] = rng.Float64()
+		if rng.Intn(2) == 0 {
+			p[ppc-1] = 1
+		}
+	}
+	return params
+}
+
+// TestOcclusionCullingIsExact renders with and without culling for every CPU
+// renderer, precision and span-table setting; pixels must match exactly
+func TestOcclusionCullingIsExact(t *testing.T) {
+	const width, height, k = 70, 50, 40
+	ref := randomNRGBA(width, height, 2)
+	table := NewSpanTable(DefaultSpanSubpixel, DefaultSpanBudget)
+
+	type variant struct {
+		name string
+		ppc  int
+		make func() (Renderer, *occlusionCuller)
+	}
+	variants := []variant{
+		{"cpu", paramsPerCircle, func() (Renderer, *occlusionCuller) {
+			r := NewCPURenderer(ref, k)
+			return r, r.occlusion
+		}},
+		{"cpu-canvas", paramsPerCircle, func() (Renderer, *occlusionCuller) {
+			r := NewCPURendererWithCanvas(ref, randomNRGBA(width, height, 4), k)
+			return r, r.occlusion
+		}},
+		{"planar", paramsPerCircle, func() (Renderer, *occlusionCuller) {
+			r := NewPlanarRenderer(ref, k)
+			return r, r.occlusion
+		}},
+		{"gray", fit.ParamsPerGrayCircle, func() (Renderer, *occlusionCuller) {
+			r := NewGrayRenderer(ref, k)
+			return r, r.occlusion
+		}},
+	}
+
+	for _, v := range variants {
+		for _, precision := range []Precision{PrecisionFloat64, PrecisionFloat32} {
+			for _, spans := range []*SpanTable{nil, table} {
+				culled, _ := v.make()
+				plain, _ := v.make()
+				disableCulling(plain)
+				for _, r := range []Renderer{culled, plain} {
+					SetPrecision(r, precision)
+					SetSpanTable(r, spans)
+				}
+
+				for seed := int64(0); seed < 20; seed++ {
+					params := opaqueParams(k, v.ppc, width, height, seed)
+					if !bytes.Equal(culled.Render(params).Pix, plain.Render(params).Pix) {
+						t.Fatalf("%s/%s/table=%v seed %d: culled render differs", v.name, precision, spans != nil, seed)
+					}
+				}
+				if CulledCircles(culled) == 0 {
+					t.Errorf("%s/%s/table=%v: nothing culled", v.name, precision, spans != nil)
+				}
+			}
+		}
+	}
+}
+
+// disableCulling turns occlusion culling off for a reference render
+func disableCulling(r Renderer) {
+	switch r := r.(type) {
+	case *CPURenderer:
+		r.occlusion = nil
+	case *PlanarRenderer:
+		r.occlusion = nil
+	case *GrayRenderer:
+		r.occlusion = nil
+	}
+}
+
+// TestOcclusionCullingCountsHiddenCircles checks the count for a final opaque
+// circle covering the whole image, and that translucent circles hide nothing
+func TestOcclusionCullingCountsHiddenCircles(t *testing.T) {
+	const width, height, k = 64, 64, 10
+	ref := randomNRGBA(width, height, 1)
+	params := seededParams(k, width, height, 3)
+	cover := params[(k-1)*paramsPerCircle:]
+	cover[0], cover[1], cover[2], cover[6] = 32, 32, 50, 1
+
+	r := NewPlanarRenderer(ref, k)
+	r.Cost(params)
+	if got := r.CulledCircles(); got != k-1 {
+		t.Errorf("culled %d circles, want %d", got, k-1)
+	}
+
+	cover[6] = 0.999
+	r.Cost(params)
+	if got := r.CulledCircles(); got != k-1 {
+		t.Errorf("translucent cover culled circles: total %d, want %d", got, k-1)
+	}
+}
+
+// TestOcclusionCullingStagesShareCounter checks that pipeline stages report
+// culled circles to the renderer they were derived from
+func TestOcclusionCullingStagesShareCounter(t *testing.T) {
+	ref := randomNRGBA(32, 32, 1)
+	params := make([]float64, 2*paramsPerCircle)
+	params[0], params[1], params[2], params[6] = 16, 16, 4, 0.5
+	params[7], params[8], params[9], params[13] = 16, 16, 40, 1
+
+	for _, parent := range []Renderer{NewCPURenderer(ref, 2), NewPlanarRenderer(ref, 2)} {
+		stage := stageRenderer(parent, 2)
+		stage.Cost(params)
+		if got := CulledCircles(parent); got != 1 {
+			t.Errorf("%T: parent reports %d culled circles, want 1", parent, got)
+		}
+	}
+}
+
+func BenchmarkOcclusionCulling(b *testing.B) {
+	const width, height, k = 256, 256, 100
+	ref := randomNRGBA(width, height, 1)
+	params := opaqueParams(k, paramsPerCircle, width, height, 7)
+
+	for _, culling := range []bool{false, true} {
+		name := "off"
+		if culling {
+			name = "on"
+		}
+		b.Run(name, func(b *testing.B) {
+			r := NewPlanarRenderer(ref, k)
+			if !culling {
+				disableCulling(r)
+			}
+			for i := 0; i < b.N; i++ {
+				r.Cost(params)
+			}
+			b.ReportMetric(float64(r.CulledCircles())/float64(b.N), "culled/op")
+		})
+	}
+}
@@ -0,0 +1,45 @@
+package renderer
+
+import (
+	"crypto/sha256"
+	"encoding/hex"
+	"os"
+	"path/filepath"
+)
+
+// openCLCacheEnv overrides the compiled-kernel cache directory ("off"
+// disables the cache).
+const openCLCacheEnv = "MAYFLY_OPENCL_CACHE"
+
+// openCLCacheDir returns the directory for cached OpenCL program binaries,
+// or "" if caching is disabled or no cache directory is available.
+func openCLCacheDir() string {
+	if dir, ok := os.LookupEnv(openCLCacheEnv); ok {
+		if dir == "off" {
+			return ""
+		}
+		return dir
+	}
+	base, err := os.UserCacheDir()
+	if err != nil {
+		return ""
+	}
+	return filepath.Join(base, "mayflycirclefit", "opencl")
+}
+
+// openCLBinaryCachePath returns the cache file for a program built from
+// source on the device described by deviceIDs (platform/device name, vendor,
+// driver version), or "" if dir is empty. Any change to the source or the
+// driver yields a new file.
+func openCLBinaryCachePath(dir, source string, deviceIDs ...string) string {
+	if dir == "" {
+		return ""
+	}
+	h := sha256.New()
+	h.Write([]byte(source))
+	for _, id := range deviceIDs {
+		h.Write([]byte{0})
+		h.Write([]byte(id))
+	}
+	return filepath.Join(dir, hex.EncodeToString(h.Sum(nil)[:16])+".bin")
+}
@@ -0,0 +1,252 @@
+//go:build gpu
+
+package renderer
+
+/*
+#cgo LDFLAGS: -lOpenCL
+#define CL_TARGET_OPENCL_VERSION 120
+#define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+#include <CL/cl.h>
+#include <stdlib.h>
+*/
+import "C"
+
+import (
+	"fmt"
+	"log/slog"
+	"os"
+	"path/filepath"
+	"sync"
+	"unsafe"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit/gpu"
+)
+
+// openCLResidentLimit is the number of unreferenced image buffers (references,
+// canvases) kept on the device for reuse by later renderers.
+const openCLResidentLimit = 8
+
+// openCLDevice is the process-wide OpenCL context shared by all OpenCL
+// renderers: one runtime (context and queue), one program built from
+// openclKernelSource — loaded from the on-disk binary cache when possible —
+// and a cache of resident read-only image buffers keyed by content.
+//
+// It lives for the rest of the process once created, so creating a renderer
+// (per job, per pipeline stage) no longer compiles kernels or re-uploads a
+// reference that is already on the device.
+type openCLDevice struct {
+	runtime  *gpu.Runtime
+	context  C.cl_context
+	queue    C.cl_command_queue
+	device   C.cl_device_id
+	program  C.cl_program
+	resident *residentCache[C.cl_mem]
+}
+
+var (
+	openCLDeviceMu     sync.Mutex
+	sharedOpenCLDevice *openCLDevice
+)
+
+// acquireOpenCLDevice returns the shared device context, creating it on first use.
+func acquireOpenCLDevice() (*openCLDevice, error) {
+	openCLDeviceMu.Lock()
+	defer openCLDeviceMu.Unlock()
+
+	if sharedOpenCLDevice != nil {
+		return sharedOpenCLDevice, nil
+	}
+
+	rt, err := gpu.InitOpenCL()
+	if err != nil {
+		return nil, fmt.Errorf("%w: %v", ErrBackendUnavailable, err)
+	}
+
+	d := &openCLDevice{
+		runtime: rt,
+		context: C.cl_context(rt.ContextPtr()),
+		queue:   C.cl_command_queue(rt.QueuePtr()),
+		device:  C.cl_device_id(rt.DevicePtr()),
+		resident: newResidentCache(openCLResidentLimit, func(mem C.cl_mem) {
+			C.clReleaseMemObject(mem)
+		}),
+	}
+	if d.context == nil || d.queue == nil {
+		rt.Close()
+		return nil, fmt.Errorf("%w: failed to access OpenCL context/queue", ErrBackendUnavailable)
+	}
+
+	if err := d.buildProgram(openclKernelSource); err != nil {
+		rt.Close()
+		return nil, err
+	}
+
+	slog.Info("OpenCL backend initialised",
+		"device", rt.Device.Name,
+		"vendor", rt.Device.Vendor,
+		"compute_units", rt.Device.MaxComputeUnits,
+	)
+
+	sharedOpenCLDevice = d
+	return d, nil
+}
+
+// buildProgram loads the program from the binary cache, or compiles source
+// and stores the binary for the next process.
+func (d *openCLDevice) buildProgram(source string) error {
+	path := openCLBinaryCachePath(openCLCacheDir(), source,
+		d.runtime.Platform.Name, d.runtime.Platform.Version,
+		d.runtime.Device.Name, d.runtime.Device.Vendor, d.runtime.Device.Version)
+
+	if path != "" {
+		if binary, err := os.ReadFile(path); err == nil {
+			if err := d.buildFromBinary(binary); err == nil {
+				slog.Debug("OpenCL program loaded from cache", "path", path)
+				return nil
+			}
+			slog.Warn("Discarding unusable OpenCL program cache", "path", path, "error", err)
+			_ = os.Remove(path)
+		}
+	}
+
+	if err := d.buildFromSource(source); err != nil {
+		return err
+	}
+
+	if path != "" {
+		if err := d.saveBinary(path); err != nil {
+			slog.Warn("Failed to cache OpenCL program", "path", path, "error", err)
+		}
+	}
+	return nil
+}
+
+func (d *openCLDevice) buildFromSource(source string) error {
+	csource := C.CString(source)
+	defer C.free(unsafe.Pointer(csource))
+
+	var status C.cl_int
+	d.program = C.clCreateProgramWithSource(d.context, 1, &csource, nil, &status)
+	if status != C.CL_SUCCESS {
+		d.program = nil
+		return clStatusError("clCreateProgramWithSource", status)
+	}
+
+	status = C.clBuildProgram(d.program, 1, &d.device, nil, nil, nil)
+	if status != C.CL_SUCCESS {
+		d.dumpBuildLog()
+		C.clReleaseProgram(d.program)
+		d.program = nil
+		return clStatusError("clBuildProgram", status)
+	}
+	return nil
+}
+
+func (d *openCLDevice) buildFromBinary(binary []byte) error {
+	if len(binary) == 0 {
+		return fmt.Errorf("empty program binary")
+	}
+
+	cbinary := (*C.uchar)(C.CBytes(binary))
+	defer C.free(unsafe.Pointer(cbinary))
+	length := C.size_t(len(binary))
+
+	var status, binaryStatus C.cl_int
+	program := C.clCreateProgramWithBinary(d.context, 1, &d.device, &length, &cbinary, &binaryStatus, &status)
+	if status != C.CL_SUCCESS || binaryStatus != C.CL_SUCCESS {
+		if program != nil {
+			C.clReleaseProgram(program)
+		}
+		return clStatusError("clCreateProgramWithBinary", min(status, binaryStatus))
+	}
+
+	status = C.clBuildProgram(program, 1, &d.device, nil, nil, nil)
+	if status != C.CL_SUCCESS {
+		C.clReleaseProgram(program)
+		return clStatusError("clBuildProgram(binary)", status)
+	}
+
+	d.program = program
+	return nil
+}
+
+// saveBinary writes the built program's device binary to path atomically
+func (d *openCLDevice) saveBinary(path string) error {
+	var size C.size_t
+	status := C.clGetProgramInfo(d.program, C.CL_PROGRAM_BINARY_SIZES, C.size_t(unsafe.Sizeof(size)), unsafe.Pointer(&size), nil)
+	if status != C.CL_SUCCESS {
+		return clStatusError("clGetProgramInfo(CL_PROGRAM_BINARY_SIZES)", status)
+	}
+	if size == 0 {
+		return fmt.Errorf("driver returned an empty program binary")
+	}
+
+	cbinary := (*C.uchar)(C.malloc(size))
+	defer C.free(unsafe.Pointer(cbinary))
+	status = C.clGetProgramInfo(d.program, C.CL_PROGRAM_BINARIES, C.size_t(unsafe.Sizeof(cbinary)), unsafe.Pointer(&cbinary), nil)
+	if status != C.CL_SUCCESS {
+		return clStatusError("clGetProgramInfo(CL_PROGRAM_BINARIES)", status)
+	}
+	binary := C.GoBytes(unsafe.Pointer(cbinary), C.int(size))
+
+	if err := os.MkdirAll(filepath.Dir(path), 0o755); err != nil {
+		return err
+	}
+	tmp, err := os.CreateTemp(filepath.Dir(path), "kernel-*.tmp")
+	if err != nil {
+		return err
+	}
+	if _, err := tmp.Write(binary); err != nil {
+		tmp.Close()
+		os.Remove(tmp.Name())
+		return err
+	}
+	if err := tmp.Close(); err != nil {
+		os.Remove(tmp.Name())
+		return err
+	}
+	return os.Rename(tmp.Name(), path)
+}
+
+func (d *openCLDevice) dumpBuildLog() {
+	if d.program == nil || d.device == nil {
+		return
+	}
+
+	var logSize C.size_t
+	if status := C.clGetProgramBuildInfo(d.program, d.device, C.CL_PROGRAM_BUILD_LOG, 0, nil, &logSize); status != C.CL_SUCCESS {
+		slog.Error("OpenCL: failed to fetch build log size", "err", status)
+		return
+	}
+	if logSize == 0 {
+		return
+	}
+
+	buf := make([]byte, int(logSize))
+	if status := C.clGetProgramBuildInfo(d.program, d.device, C.CL_PROGRAM_BUILD_LOG, logSize, unsafe.Pointer(&buf[0]), nil); status != C.CL_SUCCESS {
+		slog.Error("OpenCL: failed to fetch build log", "err", status)
+		return
+	}
+
+	slog.Error("OpenCL build log", "log", string(buf))
+}
+
+// acquireImage returns a resident read-only float4 buffer for key, uploading
+// pixels() on first use. Return it with releaseImage.
+func (d *openCLDevice) acquireImage(key uint64, pixels func() []float32) (C.cl_mem, error) {
+	return d.resident.acquire(key, func() (C.cl_mem, error) {
+		data := pixels()
+		var status C.cl_int
+		mem := C.clCreateBuffer(d.context, C.CL_MEM_READ_ONLY|C.CL_MEM_COPY_HOST_PTR,
+			C.size_t(len(data)*int(unsafe.Sizeof(float32(0)))), unsafe.Pointer(&data[0]), &status)
+		if status != C.CL_SUCCESS {
+			return nil, clStatusError("clCreateBuffer(image)", status)
+		}
+		return mem, nil
+	})
+}
+
+// releaseImage returns a buffer taken with acquireImage
+func (d *openCLDevice) releaseImage(key uint64) {
+	d.resident.release(key)
+}
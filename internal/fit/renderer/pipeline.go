@@ -3,7 +3,6 @@ package renderer
 import (
 	"log/slog"
 
-	"github.com/cwbudde/mayflycirclefit/internal/fit"
 	"github.com/cwbudde/mayflycirclefit/internal/opt"
 )
 
@@ -13,6 +12,128 @@ type OptimizationResult struct {
 	BestCost    float64
 	InitialCost float64
 	Iterations  int
+	Evaluations int // Objective evaluations made by the optimizer
+}
+
+// PipelineState is the progress of a sequential or batch pipeline after a
+// completed step. Pipelines report it through PipelineHooks.OnStep and can
+// continue from it, so a checkpointed job resumes where it stopped rather
+// than as one joint search over all circles.
+type PipelineState struct {
+	Params    []float64 // Committed circles (shared, must not be modified)
+	Cost      float64   // Cost of the committed circles
+	Pass      int       // Completed steps: circles (sequential) or batches (batch)
+	Converged bool      // Convergence detection stopped the pipeline
+	Tracker   TrackerState
+}
+
+// PipelineHooks connect a pipeline to checkpointing
+type PipelineHooks struct {
+	From   *PipelineState      // Continue from this state (nil = start from scratch)
+	OnStep func(PipelineState) // Called after every committed step (optional)
+}
+
+// start returns the committed circles and tracker to continue from
+func (h PipelineHooks) start(config ConvergenceConfig) ([]float64, int, *ConvergenceTracker) {
+	if h.From == nil {
+		return nil, 0, NewConvergenceTracker(config)
+	}
+	return append([]float64(nil), h.From.Params...), h.From.Pass, RestoreConvergenceTracker(config, h.From.Tracker)
+}
+
+// report passes the state after a step to OnStep
+func (h PipelineHooks) report(params []float64, cost float64, pass int, converged bool, tracker *ConvergenceTracker) {
+	if h.OnStep != nil {
+		h.OnStep(PipelineState{
+			Params:    params[:len(params):len(params)],
+			Cost:      cost,
+			Pass:      pass,
+			Converged: converged,
+			Tracker:   tracker.State(),
+		})
+	}
+}
+
+// countEvals wraps eval to count its calls in *n
+func countEvals(eval func([]float64) float64, n *int) func([]float64) float64 {
+	return func(params []float64) float64 {
+		*n++
+		return eval(params)
+	}
+}
+
+// stageRenderer creates a renderer for k circles of parent's reference.
+// Planar and grayscale parents yield stages of the same kind sharing the
+// reference planes, and OpenCL parents stages sharing their device state;
+// otherwise a CPURenderer is created. A CPURenderer parent passes on its cost
+// function (e.g. a weighted cost), precision, span table and anti-aliasing,
+// so every pipeline stage optimizes the same objective. Stages report culled
+// circles to their parent's counter.
+func stageRenderer(parent Renderer, k int) Renderer {
+	switch p := parent.(type) {
+	case *PlanarRenderer:
+		return p.WithCircles(k)
+	case *GrayRenderer:
+		return p.WithCircles(k)
+	case interface{ WithCircles(k int) Renderer }:
+		return p.WithCircles(k)
+	}
+
+	r := NewCPURenderer(parent.Reference(), k)
+	if cpu, ok := parent.(*CPURenderer); ok {
+		r.SetCostFunc(cpu.CostFunc())
+		r.SetPrecision(cpu.Precision())
+		r.SetSpanTable(cpu.SpanTable())
+		r.SetAntialias(cpu.Antialias())
+		r.occlusion.shareCounter(cpu.occlusion)
+	}
+	return r
+}
+
+// resizeStage sets stage to k circles. Renderers with SetCircles keep their
+// buffers, so a pipeline allocates its canvases once instead of per step.
+func resizeStage(stage, parent Renderer, k int) Renderer {
+	if r, ok := stage.(interface{ SetCircles(k int) }); ok {
+		r.SetCircles(k)
+		return stage
+	}
+	return stageRenderer(parent, k)
+}
+
+// backgroundStage is implemented by stage renderers that composite circles
+// into the background every render starts from (CPU, planar and gray). The
+// sequential and batch pipelines compose committed circles in once per stage
+// and evaluate candidates with only the stage's new circles instead of
+// redrawing the whole prefix. Circles composite one after another onto byte
+// canvases, so costs are unchanged. OpenCL composites on a float device
+// canvas and keeps redrawing the prefix.
+type backgroundStage interface {
+	ComposeBackground(params []float64)
+	SetCircles(k int)
+}
+
+// stageCandidate sizes stage for a step adding n circles after committed and
+// returns the candidate vector the step evaluates: the committed circles
+// followed by the new ones, or only the new ones on a background stage.
+// newParams is the new circles' part of candidate.
+func stageCandidate(stage, parent Renderer, committed, combined []float64, n int) (Renderer, []float64, []float64) {
+	perCircle := ParamsPerCircle(parent)
+	if bg, ok := stage.(backgroundStage); ok {
+		bg.SetCircles(n)
+		candidate := combined[:n*perCircle]
+		return stage, candidate, candidate
+	}
+	stage = resizeStage(stage, parent, len(committed)/perCircle+n)
+	candidate := combined[:len(committed)+n*perCircle]
+	copy(candidate, committed)
+	return stage, candidate, candidate[len(committed):]
+}
+
+// commitStage composites newly committed circles into a background stage
+func commitStage(stage Renderer, params []float64) {
+	if bg, ok := stage.(backgroundStage); ok && len(params) > 0 {
+		bg.ComposeBackground(params)
+	}
 }
 
 // OptimizeJoint optimizes all K circles simultaneously
@@ -20,14 +141,13 @@ type OptimizationResult struct {
 func OptimizeJoint(rend Renderer, optimizer opt.Optimizer, k int, _ ConvergenceConfig) *OptimizationResult {
 	slog.Info("Starting joint optimization", "circles", k)
 
-	dim := k * 7
+	dim := k * ParamsPerCircle(rend)
 	lower, upper := rend.Bounds()
 
 	// Ensure bounds match dimension
 	if len(lower) < dim || len(upper) < dim {
 		// Extend bounds if needed (renderer created with fewer circles)
-		newRenderer := NewCPURenderer(rend.Reference(), k)
-		rend = newRenderer
+		rend = stageRenderer(rend, k)
 		lower, upper = rend.Bounds()
 	}
 
@@ -39,8 +159,23 @@ func OptimizeJoint(rend Renderer, optimizer opt.Optimizer, k int, _ ConvergenceC
 	initialParams := make([]float64, dim)
 	initialCost := rend.Cost(initialParams)
 
-	// Run optimizer
-	bestParams, bestCost := optimizer.Run(rend.Cost, lower, upper, dim)
+	// Run optimizer. Optimizers whose snapshot search is their own algorithm
+	// (opt.SnapshotSearch; standard Mayfly, not its variants) run it for every
+	// joint job, so checkpointed server jobs (which publish its snapshots) and
+	// runs without checkpoints such as cmd/run follow the same search.
+	// Populations are evaluated in batches (one launch each on OpenCL).
+	evals := 0
+	var bestParams []float64
+	var bestCost float64
+	if snapshotter, ok := opt.SnapshotSearch(optimizer); ok {
+		evalBatch := func(population [][]float64, costs []float64) {
+			evals += len(population)
+			CostBatch(rend, population, costs)
+		}
+		bestParams, bestCost, _ = opt.RunSnapshotsBatch(snapshotter, nil, evalBatch, lower, upper, dim, nil) // No snapshot to reject
+	} else {
+		bestParams, bestCost = optimizer.Run(countEvals(rend.Cost, &evals), lower, upper, dim)
+	}
 
 	slog.Info("Joint optimization complete", "initial_cost", initialCost, "best_cost", bestCost)
 
@@ -48,11 +183,18 @@ func OptimizeJoint(rend Renderer, optimizer opt.Optimizer, k int, _ ConvergenceC
 		BestParams:  bestParams,
 		BestCost:    bestCost,
 		InitialCost: initialCost,
+		Evaluations: evals,
 	}
 }
 
 // OptimizeSequential optimizes circles one at a time (greedy) with adaptive convergence
 func OptimizeSequential(renderer Renderer, optimizer opt.Optimizer, totalK int, convergenceConfig ConvergenceConfig) *OptimizationResult {
+	return OptimizeSequentialFrom(renderer, optimizer, totalK, convergenceConfig, PipelineHooks{})
+}
+
+// OptimizeSequentialFrom is OptimizeSequential continuing from hooks.From
+// (whose committed circles stay fixed) and reporting every circle
+func OptimizeSequentialFrom(renderer Renderer, optimizer opt.Optimizer, totalK int, convergenceConfig ConvergenceConfig, hooks PipelineHooks) *OptimizationResult {
 	slog.Info("Starting sequential optimization",
 		"total_circles", totalK,
 		"convergence_enabled", convergenceConfig.Enabled,
@@ -60,45 +202,53 @@ func OptimizeSequential(renderer Renderer, optimizer opt.Optimizer, totalK int,
 		"threshold", convergenceConfig.Threshold,
 	)
 
-	ref := renderer.Reference()
-	allParams := []float64{}
-
-	initialCost := fit.MSECost(
-		NewCPURenderer(ref, 0).Render([]float64{}),
-		ref,
-	)
-
-	// Create convergence tracker
-	tracker := NewConvergenceTracker(convergenceConfig)
-
-	actualK := 0
-	for k := 1; k <= totalK; k++ {
+	perCircle := ParamsPerCircle(renderer)
+	committed, _, tracker := hooks.start(convergenceConfig)
+	allParams := append(make([]float64, 0, max(totalK*perCircle, len(committed))), committed...)
+
+	// One stage renderer for the whole run, resized per circle, with the
+	// committed circles in its background where supported
+	stage := stageRenderer(renderer, 0)
+	initialCost := stage.Cost([]float64{})
+	commitStage(stage, allParams)
+
+	// Bounds of the new circle (the same for every step)
+	dim := perCircle
+	bounds := circleBounds(renderer, 1)
+	lower := append([]float64(nil), bounds.Lower...)
+	upper := append([]float64(nil), bounds.Upper...)
+
+	// Candidate vector: previous circles followed by the new circle
+	combined := make([]float64, cap(allParams)+dim)
+
+	evals := 0
+	actualK := len(allParams) / perCircle
+	if actualK > 0 {
+		slog.Info("Resuming sequential optimization", "circles_committed", actualK)
+	}
+	for k := actualK + 1; k <= totalK && !(hooks.From != nil && hooks.From.Converged); k++ {
 		slog.Info("Optimizing circle", "index", k, "of", totalK)
 
-		// Create renderer with k circles
-		currentRenderer := NewCPURenderer(ref, k)
-
 		// Objective: optimize only the new circle, keeping previous ones fixed
-		dim := 7
-		lower := make([]float64, dim)
-		upper := make([]float64, dim)
-		bounds := fit.NewBounds(1, ref.Bounds().Dx(), ref.Bounds().Dy())
-		copy(lower, bounds.Lower)
-		copy(upper, bounds.Upper)
+		var candidate, newCircle []float64
+		stage, candidate, newCircle = stageCandidate(stage, renderer, allParams, combined, 1)
 
 		evalFunc := func(newCircleParams []float64) float64 {
-			// Combine previous circles + new circle
-			combined := append(append([]float64{}, allParams...), newCircleParams...)
-			return currentRenderer.Cost(combined)
+			copy(newCircle, newCircleParams)
+			return stage.Cost(candidate)
 		}
 
-		bestNew, _ := optimizer.Run(evalFunc, lower, upper, dim)
+		bestNew, _ := optimizer.Run(countEvals(evalFunc, &evals), lower, upper, dim)
 		allParams = append(allParams, bestNew...)
 		actualK = k
 
 		// Check convergence
-		finalCost := currentRenderer.Cost(allParams)
-		if tracker.Update(finalCost) {
+		copy(newCircle, bestNew)
+		finalCost := stage.Cost(candidate)
+		commitStage(stage, bestNew)
+		converged := tracker.Update(finalCost)
+		hooks.report(allParams, finalCost, actualK, converged, tracker)
+		if converged {
 			slog.Info("Convergence detected - stopping early",
 				"circles_used", actualK,
 				"circles_requested", totalK,
@@ -108,8 +258,8 @@ func OptimizeSequential(renderer Renderer, optimizer opt.Optimizer, totalK int,
 		}
 	}
 
-	finalRenderer := NewCPURenderer(ref, actualK)
-	finalCost := finalRenderer.Cost(allParams)
+	stage, candidate, _ := stageCandidate(stage, renderer, allParams, combined, 0)
+	finalCost := stage.Cost(candidate)
 
 	slog.Info("Sequential optimization complete",
 		"initial_cost", initialCost,
@@ -122,11 +272,18 @@ func OptimizeSequential(renderer Renderer, optimizer opt.Optimizer, totalK int,
 		BestParams:  allParams,
 		BestCost:    finalCost,
 		InitialCost: initialCost,
+		Evaluations: evals,
 	}
 }
 
 // OptimizeBatch adds batchK circles per pass for multiple passes with adaptive convergence
 func OptimizeBatch(renderer Renderer, optimizer opt.Optimizer, batchK, passes int, convergenceConfig ConvergenceConfig) *OptimizationResult {
+	return OptimizeBatchFrom(renderer, optimizer, batchK, passes, convergenceConfig, PipelineHooks{})
+}
+
+// OptimizeBatchFrom is OptimizeBatch continuing from hooks.From (whose
+// committed circles stay fixed) and reporting every pass
+func OptimizeBatchFrom(renderer Renderer, optimizer opt.Optimizer, batchK, passes int, convergenceConfig ConvergenceConfig, hooks PipelineHooks) *OptimizationResult {
 	slog.Info("Starting batch optimization",
 		"batch_size", batchK,
 		"passes", passes,
@@ -135,46 +292,52 @@ func OptimizeBatch(renderer Renderer, optimizer opt.Optimizer, batchK, passes in
 		"threshold", convergenceConfig.Threshold,
 	)
 
-	ref := renderer.Reference()
-	allParams := []float64{}
+	perCircle := ParamsPerCircle(renderer)
+	committed, actualPasses, tracker := hooks.start(convergenceConfig)
+	allParams := append(make([]float64, 0, max(batchK*passes*perCircle, len(committed))), committed...)
 
-	initialCost := fit.MSECost(
-		NewCPURenderer(ref, 0).Render([]float64{}),
-		ref,
-	)
+	// One stage renderer for the whole run, resized per pass, with the
+	// committed circles in its background where supported
+	stage := stageRenderer(renderer, 0)
+	initialCost := stage.Cost([]float64{})
+	commitStage(stage, allParams)
 
-	// Create convergence tracker
-	tracker := NewConvergenceTracker(convergenceConfig)
+	// Bounds of one batch (the same for every pass)
+	dim := batchK * perCircle
+	bounds := circleBounds(renderer, batchK)
+	lower := append([]float64(nil), bounds.Lower...)
+	upper := append([]float64(nil), bounds.Upper...)
 
-	actualPasses := 0
-	for pass := 0; pass < passes; pass++ {
-		slog.Info("Batch pass", "pass", pass+1, "of", passes)
+	// Candidate vector: previous circles followed by the new batch
+	combined := make([]float64, cap(allParams)+dim)
 
-		currentK := len(allParams) / 7
-		newK := currentK + batchK
+	evals := 0
+	if actualPasses > 0 {
+		slog.Info("Resuming batch optimization", "passes_completed", actualPasses, "circles_committed", len(allParams)/perCircle)
+	}
+	for pass := actualPasses; pass < passes && !(hooks.From != nil && hooks.From.Converged); pass++ {
+		slog.Info("Batch pass", "pass", pass+1, "of", passes)
 
 		// Optimize batch of circles jointly
-		batchRenderer := NewCPURenderer(ref, newK)
-
-		dim := batchK * 7
-		lower := make([]float64, dim)
-		upper := make([]float64, dim)
-		bounds := fit.NewBounds(batchK, ref.Bounds().Dx(), ref.Bounds().Dy())
-		copy(lower, bounds.Lower)
-		copy(upper, bounds.Upper)
+		var candidate, newBatch []float64
+		stage, candidate, newBatch = stageCandidate(stage, renderer, allParams, combined, batchK)
 
 		evalFunc := func(newBatchParams []float64) float64 {
-			combined := append(append([]float64{}, allParams...), newBatchParams...)
-			return batchRenderer.Cost(combined)
+			copy(newBatch, newBatchParams)
+			return stage.Cost(candidate)
 		}
 
-		bestBatch, _ := optimizer.Run(evalFunc, lower, upper, dim)
+		bestBatch, _ := optimizer.Run(countEvals(evalFunc, &evals), lower, upper, dim)
 		allParams = append(allParams, bestBatch...)
 		actualPasses = pass + 1
 
 		// Check convergence
-		finalCost := batchRenderer.Cost(allParams)
-		if tracker.Update(finalCost) {
+		copy(newBatch, bestBatch)
+		finalCost := stage.Cost(candidate)
+		commitStage(stage, bestBatch)
+		converged := tracker.Update(finalCost)
+		hooks.report(allParams, finalCost, actualPasses, converged, tracker)
+		if converged {
 			slog.Info("Convergence detected - stopping early",
 				"passes_used", actualPasses,
 				"passes_requested", passes,
@@ -184,9 +347,9 @@ func OptimizeBatch(renderer Renderer, optimizer opt.Optimizer, batchK, passes in
 		}
 	}
 
-	totalK := len(allParams) / 7
-	finalRenderer := NewCPURenderer(ref, totalK)
-	finalCost := finalRenderer.Cost(allParams)
+	totalK := len(allParams) / perCircle
+	stage, candidate, _ := stageCandidate(stage, renderer, allParams, combined, 0)
+	finalCost := stage.Cost(candidate)
 
 	slog.Info("Batch optimization complete",
 		"total_circles", totalK,
@@ -199,5 +362,6 @@ func OptimizeBatch(renderer Renderer, optimizer opt.Optimizer, batchK, passes in
 		BestParams:  allParams,
 		BestCost:    finalCost,
 		InitialCost: initialCost,
+		Evaluations: evals,
 	}
 }
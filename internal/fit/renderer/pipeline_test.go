@@ -3,6 +3,7 @@ package renderer
 import (
 	"image"
 	"image/color"
+	"runtime"
 	"testing"
 
 	"github.com/cwbudde/mayflycirclefit/internal/opt"
@@ -86,3 +87,214 @@ func TestOptimizeBatch(t *testing.T) {
 		t.Errorf("Expected 28 parameters for 4 circles, got %d", len(result.BestParams))
 	}
 }
+
+// midpointOptimizer evaluates the centre of the bounds a few times and
+// returns it, so pipeline tests can measure the pipeline's own allocations
+type midpointOptimizer struct{ evals int }
+
+func (m midpointOptimizer) Run(eval func([]float64) float64, lower, upper []float64, dim int) ([]float64, float64) {
+	x := make([]float64, dim)
+	for i := range x {
+		x[i] = (lower[i] + upper[i]) / 2
+	}
+	var cost float64
+	for i := 0; i < m.evals; i++ {
+		cost = eval(x)
+	}
+	return x, cost
+}
+
+// TestPipelinesReuseStageRenderer checks that pipelines do not allocate a
+// canvas per circle or per evaluation
+func TestPipelinesReuseStageRenderer(t *testing.T) {
+	const size, circles = 128, 20
+	ref := randomNRGBA(size, size, 7)
+	canvasBytes := float64(size * size * 4)
+
+	run := map[string]func(Renderer){
+		"sequential": func(r Renderer) {
+			OptimizeSequential(r, midpointOptimizer{evals: 10}, circles, DisabledConvergenceConfig())
+		},
+		"batch": func(r Renderer) {
+			OptimizeBatch(r, midpointOptimizer{evals: 10}, 2, circles/2, DisabledConvergenceConfig())
+		},
+	}
+	for name, fn := range run {
+		for _, r := range []Renderer{NewCPURenderer(ref, circles), NewPlanarRenderer(ref, circles)} {
+			var before, after runtime.MemStats
+			runtime.ReadMemStats(&before)
+			fn(r)
+			runtime.ReadMemStats(&after)
+			allocated := after.TotalAlloc - before.TotalAlloc
+
+			// One stage renderer (at most two NRGBA-sized buffers plus an
+			// output image) regardless of the circle count
+			if float64(allocated) > 4*canvasBytes {
+				t.Errorf("%s with %T allocated %d bytes per run, want < %.0f", name, r, allocated, 4*canvasBytes)
+			}
+		}
+	}
+}
+
+// TestSetCirclesMatchesFreshRenderer checks resizing gives the same costs
+// and bounds as a renderer created for that circle count
+func TestSetCirclesMatchesFreshRenderer(t *testing.T) {
+	ref := randomNRGBA(40, 30, 8)
+	params := seededParams(6, 40, 30, 3)
+
+	resized := []Renderer{NewCPURenderer(ref, 1), NewPlanarRenderer(ref, 1)}
+	fresh := []Renderer{NewCPURenderer(ref, 6), NewPlanarRenderer(ref, 6)}
+	for i, r := range resized {
+		r.(interface{ SetCircles(int) }).SetCircles(6)
+		if got, want := r.Cost(params), fresh[i].Cost(params); got != want {
+			t.Errorf("%T: cost after SetCircles %f, fresh %f", r, got, want)
+		}
+		lower, _ := r.Bounds()
+		if len(lower) != 6*7 || r.Dim() != 6*7 {
+			t.Errorf("%T: bounds/dim not resized (%d, %d)", r, len(lower), r.Dim())
+		}
+	}
+
+	gray := NewGrayRenderer(ref, 1)
+	gray.SetCircles(6)
+	grayParams := seededGrayParams(6, 40, 30, 3)
+	if got, want := gray.Cost(grayParams), NewGrayRenderer(ref, 6).Cost(grayParams); got != want {
+		t.Errorf("gray: cost after SetCircles %f, fresh %f", got, want)
+	}
+}
+
+// TestPipelinesResumeFromState checks that a pipeline resumed from a
+// reported state ends exactly like the uninterrupted run
+func TestPipelinesResumeFromState(t *testing.T) {
+	ref := randomNRGBA(24, 18, 3)
+	convergence := ConvergenceConfig{Enabled: true, Patience: 50, Threshold: 0.001}
+
+	run := map[string]func(PipelineHooks) *OptimizationResult{
+		"sequential": func(hooks PipelineHooks) *OptimizationResult {
+			return OptimizeSequentialFrom(NewCPURenderer(ref, 6), opt.NewMayfly(5, 20, 3), 6, convergence, hooks)
+		},
+		"batch": func(hooks PipelineHooks) *OptimizationResult {
+			return OptimizeBatchFrom(NewPlanarRenderer(ref, 6), opt.NewMayfly(5, 20, 3), 2, 3, convergence, hooks)
+		},
+	}
+	for name, fn := range run {
+		var states []PipelineState
+		full := fn(PipelineHooks{OnStep: func(s PipelineState) { states = append(states, s) }})
+		if len(states) != 3 && len(states) != 6 {
+			t.Fatalf("%s: %d steps reported", name, len(states))
+		}
+		if last := states[len(states)-1]; last.Cost != full.BestCost || len(last.Params) != len(full.BestParams) {
+			t.Errorf("%s: last state (cost %f) does not match the result (cost %f)", name, last.Cost, full.BestCost)
+		}
+
+		from := states[1]
+		var resumedSteps int
+		resumed := fn(PipelineHooks{From: &from, OnStep: func(PipelineState) { resumedSteps++ }})
+		if resumedSteps != len(states)-2 {
+			t.Errorf("%s: resumed run took %d steps, want %d", name, resumedSteps, len(states)-2)
+		}
+		if resumed.BestCost != full.BestCost {
+			t.Errorf("%s: resumed cost %f, uninterrupted %f", name, resumed.BestCost, full.BestCost)
+		}
+		for i := range full.BestParams {
+			if resumed.BestParams[i] != full.BestParams[i] {
+				t.Fatalf("%s: resumed params differ at %d", name, i)
+			}
+		}
+
+		// A converged state is final
+		done := states[1]
+		done.Converged = true
+		if r := fn(PipelineHooks{From: &done}); r.Evaluations != 0 || r.BestCost != done.Cost {
+			t.Errorf("%s: converged state was re-optimized (%d evaluations)", name, r.Evaluations)
+		}
+	}
+}
+
+// TestComposeBackgroundMatchesRedraw checks that circles composed into the
+// background give the same costs as redrawing them in front of the new ones
+func TestComposeBackgroundMatchesRedraw(t *testing.T) {
+	const width, height, committed, added = 40, 30, 5, 2
+	ref := randomNRGBA(width, height, 9)
+	params := seededParams(committed+added, width, height, 4)
+	params[3*7+6] = 1 // Opaque circles let the occlusion culler skip some
+	params[6*7+6] = 1
+	grayParams := seededGrayParams(committed+added, width, height, 4)
+
+	type options interface {
+		SetPrecision(Precision)
+		SetSpanTable(*SpanTable)
+		SetAntialias(bool)
+	}
+	type option struct {
+		name  string
+		apply func(options)
+	}
+	for _, o := range []option{
+		{"exact", func(options) {}},
+		{"float32+spans", func(r options) {
+			r.SetPrecision(PrecisionFloat32)
+			r.SetSpanTable(NewSpanTable(4, 1<<20))
+		}},
+		{"antialias", func(r options) {
+			r.SetAntialias(true)
+		}},
+	} {
+		cases := []struct {
+			full, baked Renderer
+			params      []float64
+		}{
+			{NewCPURenderer(ref, committed+added), NewCPURenderer(ref, added), params},
+			{NewPlanarRenderer(ref, committed+added), NewPlanarRenderer(ref, added), params},
+			{NewGrayRenderer(ref, committed+added), NewGrayRenderer(ref, added), grayParams},
+		}
+		for _, c := range cases {
+			o.apply(c.full.(options))
+			o.apply(c.baked.(options))
+			perCircle := len(c.params) / (committed + added)
+			split := committed * perCircle
+
+			// Compose in two steps, like a pipeline committing stages
+			bg := c.baked.(backgroundStage)
+			bg.ComposeBackground(c.params[:2*perCircle])
+			bg.ComposeBackground(c.params[2*perCircle : split])
+			if got, want := c.baked.Cost(c.params[split:]), c.full.Cost(c.params); got != want {
+				t.Errorf("%s %T: cost on composed background %v, redrawn %v", o.name, c.full, got, want)
+			}
+		}
+	}
+}
+
+// redrawRenderer hides the background stage of the CPU renderer it wraps,
+// so pipelines redraw committed circles for every evaluation
+type redrawRenderer struct{ Renderer }
+
+func (r redrawRenderer) WithCircles(k int) Renderer {
+	return redrawRenderer{NewCPURenderer(r.Reference(), k)}
+}
+
+// TestPipelinesBackgroundMatchesRedraw checks that pipelines on a background
+// stage end exactly like pipelines redrawing the committed circles
+func TestPipelinesBackgroundMatchesRedraw(t *testing.T) {
+	ref := randomNRGBA(24, 18, 5)
+	run := map[string]func(Renderer) *OptimizationResult{
+		"sequential": func(r Renderer) *OptimizationResult {
+			return OptimizeSequential(r, opt.NewMayfly(5, 20, 3), 4, DisabledConvergenceConfig())
+		},
+		"batch": func(r Renderer) *OptimizationResult {
+			return OptimizeBatch(r, opt.NewMayfly(5, 20, 3), 2, 2, DisabledConvergenceConfig())
+		},
+	}
+	for name, fn := range run {
+		baked, redrawn := fn(NewCPURenderer(ref, 4)), fn(redrawRenderer{NewCPURenderer(ref, 4)})
+		if baked.BestCost != redrawn.BestCost || baked.Evaluations != redrawn.Evaluations {
+			t.Errorf("%s: background stage cost %v (%d evals), redrawn %v (%d evals)",
+				name, baked.BestCost, baked.Evaluations, redrawn.BestCost, redrawn.Evaluations)
+		}
+		for i := range redrawn.BestParams {
+			if baked.BestParams[i] != redrawn.BestParams[i] {
+				t.Fatalf("%s: params differ at %d", name, i)
+			}
+		}
+	}
+}
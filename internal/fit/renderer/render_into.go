@@ -0,0 +1,84 @@
+package renderer
+
+import (
+	"image"
+	"sync"
+)
+
+// Render output ownership.
+//
+// Render returns an image owned by the renderer: it is valid until the next
+// Render or Cost call on the same renderer, which overwrites it. Callers that
+// keep an image render into a buffer of their own with RenderInto, typically
+// a frame borrowed from a FramePool, and own it until they return it.
+
+// IntoRenderer is implemented by renderers that composite directly into a
+// caller-owned image instead of their internal canvas.
+type IntoRenderer interface {
+	// RenderInto renders params into dst, which must have the reference's
+	// dimensions. dst is owned by the caller; the renderer keeps no reference.
+	RenderInto(dst *image.NRGBA, params []float64)
+}
+
+// RenderInto renders params into dst. Renderers without a direct path render
+// to their own canvas, which is then copied.
+func RenderInto(r Renderer, dst *image.NRGBA, params []float64) {
+	if ir, ok := r.(IntoRenderer); ok {
+		ir.RenderInto(dst, params)
+		return
+	}
+	copyImage(dst, r.Render(params))
+}
+
+// checkFrame panics if dst does not match a width×height renderer, like
+// NewCPURendererWithCanvas does for mismatched canvases.
+func checkFrame(dst *image.NRGBA, width, height int) {
+	if b := dst.Bounds(); b.Dx() != width || b.Dy() != height {
+		panic("render target dimensions must match reference image")
+	}
+}
+
+// copyImage copies src into dst row by row (strides may differ)
+func copyImage(dst, src *image.NRGBA) {
+	b := src.Bounds()
+	checkFrame(dst, b.Dx(), b.Dy())
+	rowBytes := b.Dx() * 4
+	for y := 0; y < b.Dy(); y++ {
+		copy(dst.Pix[y*dst.Stride:y*dst.Stride+rowBytes], src.Pix[y*src.Stride:y*src.Stride+rowBytes])
+	}
+}
+
+// FramePool recycles width×height NRGBA frames for RenderInto, so callers
+// that render on demand (HTTP handlers, checkpoint artifacts) do not allocate
+// a full canvas per call. A frame returned by Get belongs to the caller until
+// it is handed back with Put. It is safe for concurrent use.
+type FramePool struct {
+	width, height int
+	pool          sync.Pool
+}
+
+// NewFramePool creates a pool of width×height frames
+func NewFramePool(width, height int) *FramePool {
+	p := &FramePool{width: width, height: height}
+	p.pool.New = func() any {
+		return image.NewNRGBA(image.Rect(0, 0, width, height))
+	}
+	return p
+}
+
+// Get borrows a frame. Its contents are undefined until rendered into.
+func (p *FramePool) Get() *image.NRGBA {
+	return p.pool.Get().(*image.NRGBA)
+}
+
+// Put returns a frame to the pool. The caller must not use it afterwards.
+// Frames of other sizes are dropped.
+func (p *FramePool) Put(frame *image.NRGBA) {
+	if frame == nil {
+		return
+	}
+	if b := frame.Bounds(); b.Dx() != p.width || b.Dy() != p.height {
+		return
+	}
+	p.pool.Put(frame)
+}
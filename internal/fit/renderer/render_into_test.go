@@ -0,0 +1,97 @@
+package renderer
+
+import (
+	"bytes"
+	"image"
+	"testing"
+)
+
+// TestRenderInto checks that RenderInto matches Render for every CPU
+// renderer, leaves the internal canvas alone and honours sub-image strides
+func TestRenderInto(t *testing.T) {
+	const width, height, k = 40, 30, 12
+	ref := randomNRGBA(width, height, 4)
+	params := seededParams(k, width, height, 1)
+	other := seededParams(k, width, height, 2)
+
+	for _, r := range []Renderer{NewCPURenderer(ref, k), NewPlanarRenderer(ref, k), NewGrayRenderer(ref, k)} {
+		p, q := params, other
+		if ParamsPerCircle(r) != paramsPerCircle {
+			p, q = seededGrayParams(k, width, height, 1), seededGrayParams(k, width, height, 2)
+		}
+		want := append([]uint8(nil), r.Render(p).Pix...)
+
+		// Rendering into a caller frame must not disturb the renderer's image
+		canvas := r.Render(q)
+		before := append([]uint8(nil), canvas.Pix...)
+		dst := image.NewNRGBA(image.Rect(0, 0, width, height))
+		RenderInto(r, dst, p)
+		if !bytes.Equal(dst.Pix, want) {
+			t.Errorf("%T: RenderInto differs from Render", r)
+		}
+		if _, isCPU := r.(*CPURenderer); isCPU && !bytes.Equal(canvas.Pix, before) {
+			t.Errorf("%T: RenderInto overwrote the internal canvas", r)
+		}
+
+		// Sub-image of a larger frame: stride != width*4
+		big := image.NewNRGBA(image.Rect(0, 0, width+7, height+3))
+		sub := big.SubImage(image.Rect(3, 2, width+3, height+2)).(*image.NRGBA)
+		RenderInto(r, sub, p)
+		for y := 0; y < height; y++ {
+			row := sub.Pix[y*sub.Stride : y*sub.Stride+width*4]
+			if !bytes.Equal(row, want[y*width*4:(y+1)*width*4]) {
+				t.Fatalf("%T: sub-image row %d differs", r, y)
+			}
+		}
+	}
+}
+
+// TestFramePool checks frame reuse and that foreign sizes are dropped
+func TestFramePool(t *testing.T) {
+	pool := NewFramePool(8, 4)
+	frame := pool.Get()
+	if b := frame.Bounds(); b.Dx() != 8 || b.Dy() != 4 {
+		t.Fatalf("frame size %v, want 8x4", b)
+	}
+	pool.Put(frame)
+	pool.Put(image.NewNRGBA(image.Rect(0, 0, 3, 3)))
+	for i := 0; i < 4; i++ {
+		if b := pool.Get().Bounds(); b.Dx() != 8 || b.Dy() != 4 {
+			t.Fatalf("pool returned a %v frame", b)
+		}
+	}
+}
+
+// TestRenderIntoSizeMismatch checks that mismatched targets are rejected
+func TestRenderIntoSizeMismatch(t *testing.T) {
+	r := NewCPURenderer(randomNRGBA(10, 10, 1), 1)
+	defer func() {
+		if recover() == nil {
+			t.Error("expected panic for mismatched target")
+		}
+	}()
+	r.RenderInto(image.NewNRGBA(image.Rect(0, 0, 5, 5)), make([]float64, 7))
+}
+
+func BenchmarkRenderInto(b *testing.B) {
+	const width, height, k = 256, 256, 50
+	ref := randomNRGBA(width, height, 1)
+	params := seededParams(k, width, height, 3)
+
+	b.Run("new-renderer", func(b *testing.B) {
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			NewCPURenderer(ref, k).Render(params)
+		}
+	})
+	b.Run("pooled-frame", func(b *testing.B) {
+		b.ReportAllocs()
+		r := NewCPURenderer(ref, k)
+		pool := NewFramePool(width, height)
+		for i := 0; i < b.N; i++ {
+			frame := pool.Get()
+			r.RenderInto(frame, params)
+			pool.Put(frame)
+		}
+	})
+}
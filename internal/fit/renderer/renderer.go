@@ -1,10 +1,16 @@
 package renderer
 
-import "image"
+import (
+	"image"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+)
 
 // Renderer renders circles to an image and computes cost
 type Renderer interface {
-	// Render creates an image from parameter vector
+	// Render creates an image from parameter vector. The image belongs to
+	// the renderer and is only valid until the next Render or Cost call;
+	// use RenderInto to keep it.
 	Render(params []float64) *image.NRGBA
 
 	// Cost computes error between params and reference
@@ -20,5 +26,50 @@ type Renderer interface {
 	Reference() *image.NRGBA
 }
 
+// BatchCoster is implemented by renderers that evaluate a whole population
+// at once (the OpenCL renderer: one kernel launch, one float read back per
+// candidate).
+type BatchCoster interface {
+	// CostBatch stores Cost(population[i]) in costs[i]
+	CostBatch(population [][]float64, costs []float64)
+}
+
+// CostBatch evaluates every candidate of population into costs, using r's
+// batched path when it implements BatchCoster.
+func CostBatch(r Renderer, population [][]float64, costs []float64) {
+	if b, ok := r.(BatchCoster); ok {
+		b.CostBatch(population, costs)
+		return
+	}
+	costBatchSerial(r, population, costs)
+}
+
+func costBatchSerial(r Renderer, population [][]float64, costs []float64) {
+	for i, params := range population {
+		costs[i] = r.Cost(params)
+	}
+}
+
 // noopCleanup is a no-op cleanup function used when no cleanup is needed
 var noopCleanup = func() {}
+
+// paramsPerCircle is the parameter count of a colour circle
+const paramsPerCircle = fit.ParamsPerCircle
+
+// ParamsPerCircle returns the number of parameters per circle used by r:
+// fit.ParamsPerGrayCircle for grayscale renderers, fit.ParamsPerCircle otherwise.
+func ParamsPerCircle(r Renderer) int {
+	if g, ok := r.(interface{ ParamsPerCircle() int }); ok {
+		return g.ParamsPerCircle()
+	}
+	return paramsPerCircle
+}
+
+// circleBounds returns parameter bounds for k circles in r's parameter layout
+func circleBounds(r Renderer, k int) *fit.Bounds {
+	bounds := r.Reference().Bounds()
+	if ParamsPerCircle(r) == fit.ParamsPerGrayCircle {
+		return fit.NewGrayBounds(k, bounds.Dx(), bounds.Dy())
+	}
+	return fit.NewBounds(k, bounds.Dx(), bounds.Dy())
+}
@@ -104,6 +104,26 @@ func TestCPURenderer_SetCostFunc(t *testing.T) {
 	}
 }
 
+// TestCostBatch_SerialFallback verifies CostBatch on a renderer without a
+// batched path matches per-candidate Cost
+func TestCostBatch_SerialFallback(t *testing.T) {
+	ref := randomNRGBA(32, 24, 5)
+	r := NewPlanarRenderer(ref, 4)
+
+	population := make([][]float64, 5)
+	for i := range population {
+		population[i] = seededParams(4, 32, 24, int64(i))
+	}
+	costs := make([]float64, len(population))
+	CostBatch(r, population, costs)
+
+	for i, params := range population {
+		if want := r.Cost(params); costs[i] != want {
+			t.Errorf("candidate %d: CostBatch = %f, Cost = %f", i, costs[i], want)
+		}
+	}
+}
+
 // BenchmarkCPURenderer_Cost_MSE benchmarks rendering with default MSECost
 func BenchmarkCPURenderer_Cost_MSE(b *testing.B) {
 	ref := randomNRGBA(128, 128, 42)
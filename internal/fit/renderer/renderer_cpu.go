@@ -16,25 +16,35 @@ type CPURenderer struct {
 	width     int
 	height    int
 	// Buffer pooling to reduce allocations
-	canvas     *image.NRGBA // Reusable render buffer
-	initialBg  []byte       // Precomputed initial background (white or custom canvas)
+	canvas      *image.NRGBA // Reusable render buffer
+	initialBg   []byte       // Precomputed initial background (white or custom canvas)
+	ownsBg      bool         // initialBg is private (ComposeBackground draws in place)
+	precision   Precision    // Compositing precision (float64 by default)
+	spans       *SpanTable   // Optional span table (nil = exact circles)
+	spanScratch []spanRow    // Span rows of circles the table cannot cache
+	occlusion   *occlusionCuller
+	antialias   bool // Anti-aliased circle edges (float64, exact geometry)
 }
 
 // NewCPURenderer creates a CPU-based renderer with a white background
 func NewCPURenderer(reference *image.NRGBA, k int) *CPURenderer {
 	bounds := reference.Bounds()
+
+	// Precompute white background (NRGBA: 255,255,255,255 repeated)
+	whiteBg := whitePlane(bounds.Dx() * bounds.Dy() * 4)
+
+	return newCPURenderer(reference, whiteBg, k)
+}
+
+// newCPURenderer creates a CPU renderer resetting to initialBg, which is
+// only read and may be shared between renderers
+func newCPURenderer(reference *image.NRGBA, initialBg []byte, k int) *CPURenderer {
+	bounds := reference.Bounds()
 	width, height := bounds.Dx(), bounds.Dy()
 
 	// Allocate reusable canvas buffer
 	canvas := image.NewNRGBA(image.Rect(0, 0, width, height))
 
-	// Precompute white background (NRGBA: 255,255,255,255 repeated)
-	pixelCount := width * height * 4 // 4 bytes per pixel (RGBA)
-	whiteBg := make([]byte, pixelCount)
-	for i := 0; i < pixelCount; i++ {
-		whiteBg[i] = 255
-	}
-
 	return &CPURenderer{
 		reference: reference,
 		k:         k,
@@ -43,7 +53,8 @@ func NewCPURenderer(reference *image.NRGBA, k int) *CPURenderer {
 		width:     width,
 		height:    height,
 		canvas:    canvas,
-		initialBg: whiteBg,
+		initialBg: initialBg,
+		occlusion: newOcclusionCuller(width, height),
 	}
 }
 
@@ -79,22 +90,86 @@ func NewCPURendererWithCanvas(reference *image.NRGBA, canvas *image.NRGBA, k int
 		height:    height,
 		canvas:    canvasCopy,
 		initialBg: initialBg,
+		occlusion: newOcclusionCuller(width, height),
 	}
 }
 
-// Render creates an image from parameter vector
+// Render creates an image from parameter vector. The image is the renderer's
+// canvas: it is overwritten by the next Render or Cost call (see RenderInto).
 func (r *CPURenderer) Render(params []float64) *image.NRGBA {
+	r.renderTo(r.canvas, params)
+	return r.canvas
+}
+
+// RenderInto renders params into the caller-owned image dst, which must have
+// the reference's dimensions. The renderer's canvas is left untouched.
+func (r *CPURenderer) RenderInto(dst *image.NRGBA, params []float64) {
+	checkFrame(dst, r.width, r.height)
+	r.renderTo(dst, params)
+}
+
+// renderTo resets img to the initial background and composites all circles
+func (r *CPURenderer) renderTo(img *image.NRGBA, params []float64) {
 	// Reset canvas to initial background using fast copy (avoids allocation)
-	copy(r.canvas.Pix, r.initialBg)
+	if rowBytes := r.width * 4; img.Stride == rowBytes {
+		copy(img.Pix, r.initialBg)
+	} else {
+		for y := 0; y < r.height; y++ {
+			copy(img.Pix[y*img.Stride:y*img.Stride+rowBytes], r.initialBg[y*rowBytes:])
+		}
+	}
+
+	r.composite(img, params, r.k)
+}
+
+// composite draws the first k circles of params onto img
+func (r *CPURenderer) composite(img *image.NRGBA, params []float64, k int) {
+	// Skip circles hidden behind later opaque circles
+	skip := r.occlusion.cull(params, k, paramsPerCircle)
 
 	// Decode and render each circle (using hybrid/scanline algorithm)
-	pv := &fit.ParamVector{Data: params, K: r.k, Width: r.width, Height: r.height}
-	for i := 0; i < r.k; i++ {
+	if r.precision == PrecisionFloat32 && !r.antialias {
+		for i := 0; i < k; i++ {
+			if skip != nil && skip[i] {
+				continue
+			}
+			if r.spans != nil {
+				r.compositeSpanTable32(img, fit.DecodeCircle32(params, i))
+			} else {
+				r.renderCircle32(img, fit.DecodeCircle32(params, i))
+			}
+		}
+		return
+	}
+
+	pv := &fit.ParamVector{Data: params, K: k, Width: r.width, Height: r.height}
+	for i := 0; i < k; i++ {
+		if skip != nil && skip[i] {
+			continue
+		}
 		circle := pv.DecodeCircle(i)
-		r.renderCircleHybrid(r.canvas, circle)
+		if r.antialias {
+			r.renderCircleAA(img, circle)
+		} else if r.spans != nil {
+			r.compositeSpanTable(img, circle)
+		} else {
+			r.renderCircleHybrid(img, circle)
+		}
 	}
+}
 
-	return r.canvas
+// ComposeBackground composites the circles in params onto the background
+// every render starts from, so Render and Cost only draw their own k
+// circles on top. Images are identical to rendering params in front of the
+// circles (see backgroundStage).
+func (r *CPURenderer) ComposeBackground(params []float64) {
+	// The background may be shared (see newCPURenderer), so draw on a copy
+	if !r.ownsBg {
+		r.initialBg = append([]byte(nil), r.initialBg...)
+		r.ownsBg = true
+	}
+	bg := &image.NRGBA{Pix: r.initialBg, Stride: r.width * 4, Rect: image.Rect(0, 0, r.width, r.height)}
+	r.composite(bg, params, len(params)/paramsPerCircle)
 }
 
 // Cost computes error between params and reference
@@ -110,9 +185,22 @@ func (r *CPURenderer) Dim() int {
 
 // Bounds returns lower and upper bounds for parameters
 func (r *CPURenderer) Bounds() (lower, upper []float64) {
+	if r.bounds == nil {
+		r.bounds = fit.NewBounds(r.k, r.width, r.height)
+	}
 	return r.bounds.Lower, r.bounds.Upper
 }
 
+// SetCircles changes the number of circles rendered per call while keeping
+// the canvas buffers, so pipelines resize one stage renderer instead of
+// allocating one per circle. Bounds are rebuilt on demand.
+func (r *CPURenderer) SetCircles(k int) {
+	if k != r.k {
+		r.k = k
+		r.bounds = nil
+	}
+}
+
 // Reference returns the reference image
 func (r *CPURenderer) Reference() *image.NRGBA {
 	return r.reference
@@ -123,6 +211,47 @@ func (r *CPURenderer) SetCostFunc(costFunc fit.CostFunc) {
 	r.costFunc = costFunc
 }
 
+// CostFunc returns the cost function used for evaluation
+func (r *CPURenderer) CostFunc() fit.CostFunc {
+	return r.costFunc
+}
+
+// SetPrecision selects float64 (default) or float32 circle compositing
+func (r *CPURenderer) SetPrecision(p Precision) {
+	r.precision = p
+}
+
+// Precision returns the compositing precision
+func (r *CPURenderer) Precision() Precision {
+	return r.precision
+}
+
+// SetSpanTable rasterizes circles through span table t, snapping them to its
+// sub-pixel grid (nil restores exact circles)
+func (r *CPURenderer) SetSpanTable(t *SpanTable) {
+	r.spans = t
+}
+
+// SpanTable returns the span table in use, or nil
+func (r *CPURenderer) SpanTable() *SpanTable {
+	return r.spans
+}
+
+// SetAntialias enables coverage-based anti-aliased circle edges
+func (r *CPURenderer) SetAntialias(on bool) {
+	r.antialias = on
+}
+
+// Antialias reports whether anti-aliased edges are enabled
+func (r *CPURenderer) Antialias() bool {
+	return r.antialias
+}
+
+// CulledCircles returns the number of circles skipped by occlusion culling
+func (r *CPURenderer) CulledCircles() uint64 {
+	return r.occlusion.total()
+}
+
 // UseFastCost enables SIMD-accelerated cost computation (AVX2/NEON)
 // This provides 1.5-2x speedup over the default MSECost implementation
 func (r *CPURenderer) UseFastCost() {
@@ -213,52 +342,63 @@ func (r *CPURenderer) renderCircleScanline(img *image.NRGBA, c fit.Circle) {
 
 	// Scanline algorithm: for each row, compute horizontal span
 	for y := minY; y < maxY; y++ {
-		// Calculate distance from row to circle center
-		dy := float64(y) - c.Y
-		dy2 := dy * dy
-
-		// Check if row intersects circle
-		if dy2 > r2 {
+		xStart, xEnd, ok := scanlineSpan(c, r2, y, r.width)
+		if !ok {
 			continue // Row entirely outside circle
 		}
 
-		// Find horizontal extent by searching from center
-		// This avoids sqrt() and guarantees correctness
-		r2_minus_dy2 := r2 - dy2
-		cx := int(c.X + 0.5)
-
-		// Find xStart by searching left
-		xStart := cx
-		for xStart > 0 {
-			dx := float64(xStart-1) - c.X
-			if dx*dx > r2_minus_dy2 {
-				break
-			}
-			xStart--
-		}
-		if xStart < 0 {
-			xStart = 0
-		}
-
-		// Find xEnd by searching right
-		xEnd := cx + 1
-		for xEnd < r.width {
-			dx := float64(xEnd) - c.X
-			if dx*dx > r2_minus_dy2 {
-				break
-			}
-			xEnd++
-		}
-		if xEnd > r.width {
-			xEnd = r.width
-		}
-
 		// Composite all pixels in span
 		for x := xStart; x < xEnd; x++ {
 			compositePixel(img, x, y, c.CR, c.CG, c.CB, c.Opacity)
 		}
+	}
+}
+
+// scanlineSpan returns the pixel span [xStart, xEnd) covered by circle c (with
+// squared radius r2) on row y, clamped to [0, width). ok is false if the row
+// does not intersect the circle.
+func scanlineSpan(c fit.Circle, r2 float64, y, width int) (xStart, xEnd int, ok bool) {
+	// Calculate distance from row to circle center
+	dy := float64(y) - c.Y
+	dy2 := dy * dy
+
+	// Check if row intersects circle
+	if dy2 > r2 {
+		return 0, 0, false
+	}
+
+	// Find horizontal extent by searching from center
+	// This avoids sqrt() and guarantees correctness
+	r2_minus_dy2 := r2 - dy2
+	cx := int(c.X + 0.5)
+
+	// Find xStart by searching left
+	xStart = cx
+	for xStart > 0 {
+		dx := float64(xStart-1) - c.X
+		if dx*dx > r2_minus_dy2 {
+			break
+		}
+		xStart--
+	}
+	if xStart < 0 {
+		xStart = 0
+	}
 
+	// Find xEnd by searching right
+	xEnd = cx + 1
+	for xEnd < width {
+		dx := float64(xEnd) - c.X
+		if dx*dx > r2_minus_dy2 {
+			break
+		}
+		xEnd++
 	}
+	if xEnd > width {
+		xEnd = width
+	}
+
+	return xStart, xEnd, true
 }
 
 // renderCircleHybrid uses bounding box for small circles and scanline for large ones
@@ -0,0 +1,166 @@
+package renderer
+
+import (
+	"math"
+	"testing"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+)
+
+// precisionStats compares float32 and float64 renders of the same parameters
+type precisionStats struct {
+	pixels      int     // pixels compared
+	differing   int     // pixels with any channel difference
+	maxDiff     int     // largest per-channel difference
+	maxCostRel  float64 // largest relative cost difference
+	largeDiffPx int     // pixels differing by more than one level
+}
+
+func (s *precisionStats) add(a, b []uint8, cost64, cost32 float64) {
+	for i := 0; i < len(a); i += 4 {
+		s.pixels++
+		worst := 0
+		for c := 0; c < 3; c++ {
+			d := int(a[i+c]) - int(b[i+c])
+			if d < 0 {
+				d = -d
+			}
+			worst = max(worst, d)
+		}
+		if worst > 0 {
+			s.differing++
+		}
+		if worst > 1 {
+			s.largeDiffPx++
+		}
+		s.maxDiff = max(s.maxDiff, worst)
+	}
+	if cost64 != 0 {
+		s.maxCostRel = math.Max(s.maxCostRel, math.Abs(cost32-cost64)/cost64)
+	}
+}
+
+// TestFloat32PrecisionStudy measures how far the float32 path deviates from
+// float64 for every renderer, over random circle sets crossing the borders.
+// Differences come from blend rounding (one level) and from edge pixels whose
+// float32 distance test flips (the only source of larger differences).
+func TestFloat32PrecisionStudy(t *testing.T) {
+	type variant struct {
+		name string
+		make func(k int) (r64, r32 Renderer)
+		gray bool
+	}
+
+	ref := randomNRGBA(128, 96, 11)
+	variants := []variant{
+		{"cpu", func(k int) (Renderer, Renderer) {
+			a, b := NewCPURenderer(ref, k), NewCPURenderer(ref, k)
+			b.SetPrecision(PrecisionFloat32)
+			return a, b
+		}, false},
+		{"planar", func(k int) (Renderer, Renderer) {
+			a, b := NewPlanarRenderer(ref, k), NewPlanarRenderer(ref, k)
+			b.SetPrecision(PrecisionFloat32)
+			return a, b
+		}, false},
+		{"gray", func(k int) (Renderer, Renderer) {
+			a, b := NewGrayRenderer(ref, k), NewGrayRenderer(ref, k)
+			b.SetPrecision(PrecisionFloat32)
+			return a, b
+		}, true},
+	}
+
+	for _, v := range variants {
+		var stats precisionStats
+		for _, k := range []int{1, 10, 50} {
+			r64, r32 := v.make(k)
+			for seed := int64(0); seed < 10; seed++ {
+				var params []float64
+				if v.gray {
+					params = seededGrayParams(k, 128, 96, seed)
+				} else {
+					params = seededParams(k, 128, 96, seed)
+				}
+				img64 := append([]uint8(nil), r64.Render(params).Pix...)
+				img32 := r32.Render(params).Pix
+				stats.add(img64, img32, r64.Cost(params), r32.Cost(params))
+			}
+		}
+
+		t.Logf("%-6s differing pixels %.4f%% (>1 level: %.5f%%), max channel diff %d, max relative cost diff %.2e",
+			v.name,
+			100*float64(stats.differing)/float64(stats.pixels),
+			100*float64(stats.largeDiffPx)/float64(stats.pixels),
+			stats.maxDiff, stats.maxCostRel)
+
+		if frac := float64(stats.differing) / float64(stats.pixels); frac > 0.01 {
+			t.Errorf("%s: %.3f%% of pixels differ, want < 1%%", v.name, 100*frac)
+		}
+		if frac := float64(stats.largeDiffPx) / float64(stats.pixels); frac > 1e-4 {
+			t.Errorf("%s: %.4f%% of pixels differ by more than one level, want < 0.01%%", v.name, 100*frac)
+		}
+		if stats.maxCostRel > 1e-3 {
+			t.Errorf("%s: relative cost difference %.2e, want < 1e-3", v.name, stats.maxCostRel)
+		}
+	}
+}
+
+// TestParsePrecision tests precision name parsing
+func TestParsePrecision(t *testing.T) {
+	for name, want := range map[string]Precision{
+		"": PrecisionFloat64, "float64": PrecisionFloat64, "F32": PrecisionFloat32, "float32": PrecisionFloat32,
+	} {
+		got, err := ParsePrecision(name)
+		if err != nil || got != want {
+			t.Errorf("ParsePrecision(%q) = %v, %v; want %v", name, got, err, want)
+		}
+	}
+	if _, err := ParsePrecision("float16"); err == nil {
+		t.Error("ParsePrecision(\"float16\") should fail")
+	}
+}
+
+// TestFloat32StagesInheritPrecision tests that pipeline stages keep float32
+func TestFloat32StagesInheritPrecision(t *testing.T) {
+	ref := randomNRGBA(8, 8, 1)
+
+	cpu := NewCPURenderer(ref, 1)
+	cpu.SetPrecision(PrecisionFloat32)
+	if stage := stageRenderer(cpu, 2).(*CPURenderer); stage.Precision() != PrecisionFloat32 {
+		t.Error("CPU stage renderer should inherit float32 precision")
+	}
+
+	planar := NewPlanarRenderer(ref, 1)
+	planar.SetPrecision(PrecisionFloat32)
+	if stage := stageRenderer(planar, 2).(*PlanarRenderer); stage.precision != PrecisionFloat32 {
+		t.Error("planar stage renderer should inherit float32 precision")
+	}
+
+	if !SetPrecision(NewGrayRenderer(ref, 1), PrecisionFloat32) {
+		t.Error("SetPrecision should succeed for GrayRenderer")
+	}
+}
+
+// BenchmarkFloat32Compositing compares float64 and float32 render+cost
+func BenchmarkFloat32Compositing(b *testing.B) {
+	ref := randomNRGBA(256, 256, 42)
+	params := seededParams(50, 256, 256, 7)
+
+	for _, p := range []Precision{PrecisionFloat64, PrecisionFloat32} {
+		b.Run("CPU_"+p.String(), func(b *testing.B) {
+			r := NewCPURenderer(ref, 50)
+			r.SetCostFunc(fit.FastMSECost)
+			r.SetPrecision(p)
+			for i := 0; i < b.N; i++ {
+				_ = r.Cost(params)
+			}
+		})
+		b.Run("Planar_"+p.String(), func(b *testing.B) {
+			r := NewPlanarRenderer(ref, 50)
+			r.SetPrecision(p)
+			for i := 0; i < b.N; i++ {
+				_ = r.Cost(params)
+			}
+		})
+	}
+}
@@ -4,13 +4,54 @@ package renderer
 
 import (
 	"image"
-	"math/rand"
 	"testing"
-	"time"
-
-	"github.com/cwbudde/mayflycirclefit/internal/fit"
 )
 
+// BenchmarkRendererCostBatch evaluates a population of 32 candidates per
+// iteration: serially on the CPU, one launch per candidate through Cost, and
+// one batched launch through CostBatch.
+func BenchmarkRendererCostBatch(b *testing.B) {
+	ref := image.NewNRGBA(image.Rect(0, 0, 256, 256))
+	for i := range ref.Pix {
+		ref.Pix[i] = 255
+	}
+
+	const circles = 64
+	population := make([][]float64, 32)
+	for i := range population {
+		population[i] = randomParams(circles, ref.Bounds().Dx(), ref.Bounds().Dy())
+	}
+	costs := make([]float64, len(population))
+
+	b.Run("CPU", func(b *testing.B) {
+		rend := NewCPURenderer(ref, circles)
+		for i := 0; i < b.N; i++ {
+			CostBatch(rend, population, costs)
+		}
+	})
+
+	rend, cleanup, err := NewRendererForBackend("opencl", ref, circles)
+	if err != nil {
+		b.Skipf("GPU backend unavailable: %v", err)
+	}
+	defer cleanup()
+
+	b.Run("OpenCL_PerCandidate", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			for j, params := range population {
+				params[0] += 1e-9 // defeat the single-entry cost cache
+				costs[j] = rend.Cost(params)
+			}
+		}
+	})
+
+	b.Run("OpenCL_Batch", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			CostBatch(rend, population, costs)
+		}
+	})
+}
+
 func BenchmarkRendererCost(b *testing.B) {
 	ref := image.NewNRGBA(image.Rect(0, 0, 256, 256))
 	for i := range ref.Pix {
@@ -45,19 +86,3 @@ func BenchmarkRendererCost(b *testing.B) {
 		}
 	})
 }
-
-func randomParams(k, width, height int) []float64 {
-	r := rand.New(rand.NewSource(time.Now().UnixNano()))
-	params := make([]float64, k*paramsPerCircle)
-	for i := 0; i < k; i++ {
-		offset := i * paramsPerCircle
-		params[offset+0] = r.Float64() * float64(width)
-		params[offset+1] = r.Float64() * float64(height)
-		params[offset+2] = 5 + r.Float64()*float64(width/4)
-		params[offset+3] = r.Float64()
-		params[offset+4] = r.Float64()
-		params[offset+5] = r.Float64()
-		params[offset+6] = 0.5 + 0.5*r.Float64()
-	}
-	return params
-}
@@ -0,0 +1,206 @@
+package renderer
+
+import (
+	"image"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+)
+
+// GrayRenderer fits grayscale circles (X, Y, R, L, Opacity) to the luma of a
+// reference image.
+//
+// Canvas and reference are single byte planes (BT.601 luma, see
+// fit.LumaPlane), so each evaluation moves a quarter of the bytes of the
+// NRGBA path, and the optimizer searches 5 instead of 7 dimensions per
+// circle. Compositing and cost share the planar kernels (compositePlanes,
+// fit.PlaneSSD). Cost is the mean squared luma error; Render returns the
+// canvas as an opaque gray NRGBA image.
+type GrayRenderer struct {
+	reference *image.NRGBA
+	k         int
+	bounds    *fit.Bounds
+	width     int
+	height    int
+
+	refLuma []uint8 // Reference luma (shared between stage renderers)
+	white   []uint8 // Initial background plane (shared, read-only)
+	bg      []uint8 // Composed background (nil = white, see ComposeBackground)
+	canvas  []uint8 // Working luma canvas
+	output  *image.NRGBA
+	lut     [1][256]uint8
+
+	precision Precision
+	spans     *SpanTable // Optional span table (nil = exact circles)
+	scratch   []spanRow  // Span rows of circles the table cannot cache
+	occlusion *occlusionCuller
+	antialias bool // Anti-aliased circle edges (float64, exact geometry)
+}
+
+// NewGrayRenderer creates a grayscale renderer with a white background
+func NewGrayRenderer(reference *image.NRGBA, k int) *GrayRenderer {
+	refLuma := fit.LumaPlane(reference)
+	return newGrayRenderer(reference, refLuma, whitePlane(len(refLuma)), k)
+}
+
+func newGrayRenderer(reference *image.NRGBA, refLuma, white []uint8, k int) *GrayRenderer {
+	bounds := reference.Bounds()
+	width, height := bounds.Dx(), bounds.Dy()
+
+	return &GrayRenderer{
+		reference: reference,
+		k:         k,
+		bounds:    fit.NewGrayBounds(k, width, height),
+		width:     width,
+		height:    height,
+		refLuma:   refLuma,
+		white:     white,
+		canvas:    make([]uint8, width*height),
+		output:    image.NewNRGBA(image.Rect(0, 0, width, height)),
+		occlusion: newOcclusionCuller(width, height),
+	}
+}
+
+// WithCircles returns a renderer for k circles that shares this renderer's
+// reference luma (used by the sequential and batch pipelines).
+func (r *GrayRenderer) WithCircles(k int) *GrayRenderer {
+	stage := newGrayRenderer(r.reference, r.refLuma, r.white, k)
+	stage.precision = r.precision
+	stage.spans = r.spans
+	stage.antialias = r.antialias
+	stage.occlusion.shareCounter(r.occlusion)
+	return stage
+}
+
+// CulledCircles returns the number of circles skipped by occlusion culling
+func (r *GrayRenderer) CulledCircles() uint64 {
+	return r.occlusion.total()
+}
+
+// SetAntialias enables coverage-based anti-aliased circle edges
+func (r *GrayRenderer) SetAntialias(on bool) {
+	r.antialias = on
+}
+
+// SetSpanTable rasterizes circles through span table t (nil = exact circles)
+func (r *GrayRenderer) SetSpanTable(t *SpanTable) {
+	r.spans = t
+}
+
+// SetPrecision selects float64 (default) or float32 circle compositing
+func (r *GrayRenderer) SetPrecision(p Precision) {
+	r.precision = p
+}
+
+// renderCanvas resets the luma canvas and composites all circles
+func (r *GrayRenderer) renderCanvas(params []float64) {
+	if r.bg != nil {
+		copy(r.canvas, r.bg)
+	} else {
+		copy(r.canvas, r.white)
+	}
+	r.composite(r.canvas, params, r.k)
+}
+
+// composite draws the first k circles of params onto the luma plane canvas
+func (r *GrayRenderer) composite(canvas []uint8, params []float64, k int) {
+	planes := [][]uint8{canvas}
+	skip := r.occlusion.cull(params, k, fit.ParamsPerGrayCircle)
+	for i := 0; i < k; i++ {
+		if skip != nil && skip[i] {
+			continue
+		}
+		switch {
+		case r.antialias:
+			compositePlanesAA(planes, r.lut[:], fit.DecodeGrayCircle(params, i), r.width, r.height)
+		case r.precision == PrecisionFloat32 && r.spans != nil:
+			compositePlanesTable32(planes, r.lut[:], fit.DecodeGrayCircle32(params, i), r.width, r.height, r.spans, &r.scratch)
+		case r.precision == PrecisionFloat32:
+			compositePlanes32(planes, r.lut[:], fit.DecodeGrayCircle32(params, i), r.width, r.height)
+		case r.spans != nil:
+			compositePlanesTable(planes, r.lut[:], fit.DecodeGrayCircle(params, i), r.width, r.height, r.spans, &r.scratch)
+		default:
+			compositePlanes(planes, r.lut[:], fit.DecodeGrayCircle(params, i), r.width, r.height)
+		}
+	}
+}
+
+// ComposeBackground composites the circles in params onto the background
+// plane (see CPURenderer.ComposeBackground)
+func (r *GrayRenderer) ComposeBackground(params []float64) {
+	if r.bg == nil {
+		r.bg = append([]uint8(nil), r.white...)
+	}
+	r.composite(r.bg, params, len(params)/fit.ParamsPerGrayCircle)
+}
+
+// Render creates an image from parameter vector. The image is owned by the
+// renderer and overwritten by the next Render call (see RenderInto).
+func (r *GrayRenderer) Render(params []float64) *image.NRGBA {
+	r.renderCanvas(params)
+	r.expand(r.output)
+	return r.output
+}
+
+// RenderInto renders params into the caller-owned image dst, which must have
+// the reference's dimensions.
+func (r *GrayRenderer) RenderInto(dst *image.NRGBA, params []float64) {
+	checkFrame(dst, r.width, r.height)
+	r.renderCanvas(params)
+	r.expand(dst)
+}
+
+// expand writes the luma canvas into img as opaque gray
+func (r *GrayRenderer) expand(img *image.NRGBA) {
+	for y := 0; y < r.height; y++ {
+		pix := img.Pix[y*img.Stride:]
+		row := r.canvas[y*r.width : (y+1)*r.width]
+		for x, v := range row {
+			pix[x*4+0] = v
+			pix[x*4+1] = v
+			pix[x*4+2] = v
+			pix[x*4+3] = 255
+		}
+	}
+}
+
+// Cost computes the mean squared luma error between params and reference
+func (r *GrayRenderer) Cost(params []float64) float64 {
+	r.renderCanvas(params)
+
+	if len(r.canvas) == 0 {
+		return 0
+	}
+	return float64(fit.PlaneSSD(r.canvas, r.refLuma)) / float64(len(r.canvas))
+}
+
+// Dim returns the dimensionality of the parameter space
+func (r *GrayRenderer) Dim() int {
+	return r.k * fit.ParamsPerGrayCircle
+}
+
+// Bounds returns lower and upper bounds for parameters
+func (r *GrayRenderer) Bounds() (lower, upper []float64) {
+	if r.bounds == nil {
+		r.bounds = fit.NewGrayBounds(r.k, r.width, r.height)
+	}
+	return r.bounds.Lower, r.bounds.Upper
+}
+
+// SetCircles changes the number of circles rendered per call, keeping the
+// luma canvas (see CPURenderer.SetCircles)
+func (r *GrayRenderer) SetCircles(k int) {
+	if k != r.k {
+		r.k = k
+		r.bounds = nil
+	}
+}
+
+// Reference returns the reference image
+func (r *GrayRenderer) Reference() *image.NRGBA {
+	return r.reference
+}
+
+// ParamsPerCircle returns the number of parameters per grayscale circle
+func (r *GrayRenderer) ParamsPerCircle() int {
+	return fit.ParamsPerGrayCircle
+}
@@ -0,0 +1,89 @@
+package renderer
+
+import (
+	"bytes"
+	"testing"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+	"github.com/cwbudde/mayflycirclefit/internal/opt"
+)
+
+// seededGrayParams creates reproducible grayscale circle parameters
+func seededGrayParams(k, width, height int, seed int64) []float64 {
+	color := seededParams(k, width, height, seed)
+	params := make([]float64, 0, k*fit.ParamsPerGrayCircle)
+	for i := 0; i < k; i++ {
+		c := color[i*7:]
+		params = append(params, c[0], c[1], c[2], c[3], c[6])
+	}
+	return params
+}
+
+// TestGrayRenderer_MatchesCPURenderer tests that gray circles render exactly
+// like colour circles with CR = CG = CB = L
+func TestGrayRenderer_MatchesCPURenderer(t *testing.T) {
+	ref := randomNRGBA(57, 33, 1)
+	const k = 12
+	gray := NewGrayRenderer(ref, k)
+	cpu := NewCPURenderer(ref, k)
+
+	if gray.Dim() != k*fit.ParamsPerGrayCircle {
+		t.Fatalf("Dim = %d, want %d", gray.Dim(), k*fit.ParamsPerGrayCircle)
+	}
+	if lower, _ := gray.Bounds(); len(lower) != gray.Dim() {
+		t.Fatalf("bounds length = %d, want %d", len(lower), gray.Dim())
+	}
+
+	for seed := int64(0); seed < 5; seed++ {
+		params := seededGrayParams(k, 57, 33, seed)
+		want := cpu.Render(fit.GrayToColorParams(params))
+		got := gray.Render(params)
+		if !bytes.Equal(got.Pix, want.Pix) {
+			t.Fatalf("seed %d: gray render differs from CPURenderer", seed)
+		}
+	}
+}
+
+// TestGrayRenderer_Cost tests the mean squared luma error
+func TestGrayRenderer_Cost(t *testing.T) {
+	ref := randomNRGBA(20, 10, 2)
+	gray := NewGrayRenderer(ref, 2)
+	params := seededGrayParams(2, 20, 10, 3)
+
+	rendered := fit.LumaPlane(gray.Render(params))
+	refLuma := fit.LumaPlane(ref)
+	var sum float64
+	for i := range rendered {
+		d := float64(rendered[i]) - float64(refLuma[i])
+		sum += d * d
+	}
+
+	if got, want := gray.Cost(params), sum/float64(len(rendered)); got != want {
+		t.Errorf("Cost = %v, want %v", got, want)
+	}
+}
+
+// TestGrayRenderer_Pipelines tests that the pipelines keep the 5-parameter layout
+func TestGrayRenderer_Pipelines(t *testing.T) {
+	ref := randomNRGBA(16, 16, 4)
+	gray := NewGrayRenderer(ref, 2)
+
+	if ParamsPerCircle(gray) != fit.ParamsPerGrayCircle || ParamsPerCircle(NewCPURenderer(ref, 1)) != fit.ParamsPerCircle {
+		t.Fatal("ParamsPerCircle should report 5 for gray and 7 for colour renderers")
+	}
+
+	seq := OptimizeSequential(gray, opt.NewMayfly(5, 10, 42), 2, DisabledConvergenceConfig())
+	if len(seq.BestParams) != 2*fit.ParamsPerGrayCircle {
+		t.Errorf("sequential: got %d params, want %d", len(seq.BestParams), 2*fit.ParamsPerGrayCircle)
+	}
+
+	batch := OptimizeBatch(gray, opt.NewMayfly(5, 10, 42), 2, 2, DisabledConvergenceConfig())
+	if len(batch.BestParams) != 4*fit.ParamsPerGrayCircle {
+		t.Errorf("batch: got %d params, want %d", len(batch.BestParams), 4*fit.ParamsPerGrayCircle)
+	}
+
+	joint := OptimizeJoint(gray, opt.NewMayfly(5, 10, 42), 3, DisabledConvergenceConfig())
+	if len(joint.BestParams) != 3*fit.ParamsPerGrayCircle {
+		t.Errorf("joint: got %d params, want %d", len(joint.BestParams), 3*fit.ParamsPerGrayCircle)
+	}
+}
@@ -50,32 +50,36 @@ import (
 	"unsafe"
 
 	"github.com/cwbudde/mayflycirclefit/internal/fit"
-	"github.com/cwbudde/mayflycirclefit/internal/fit/gpu"
 )
 
+// openclKernelSource holds the renderer's kernels:
+//
+//   - render_image composites one parameter vector into a float4 image (Render)
+//   - render_cost_batch evaluates a whole population per launch: dimension 1
+//     selects the candidate, work-groups along dimension 0 stride over the
+//     pixels and reduce their squared errors in local memory to one partial
+//     sum per group; no image is written
+//   - reduce_partials sums each candidate's partials into its final cost
+//
+// Pixels start from the uploaded canvas (white by default) and only test the
+// circles binned to their TILE_SIZE×TILE_SIZE tile (see tileBinner), so the
+// per-pixel loop runs over the local overlap instead of all k circles. Both
+// render kernels composite through composite_pixel, so Render and Cost agree
+// exactly.
 const openclKernelSource = `
-__kernel void render_cost(
-    __global const float *params,
-    const int circleCount,
-    const int width,
-    const int height,
-    __global const float4 *reference,
-    __global float4 *outImage,
-    __global float *outError) {
-
-    const int idx = get_global_id(0);
-    const int pixelCount = width * height;
-    if (idx >= pixelCount) {
-        return;
-    }
-
-    const int x = idx % width;
-    const int y = idx / width;
+#define TILE_SIZE 16
 
-    float4 color = (float4)(1.0f, 1.0f, 1.0f, 1.0f);
-
-    for (int i = 0; i < circleCount; ++i) {
-        const int base = i * 7;
+float4 composite_pixel(
+    __global const float *params,
+    __global const int *tileCircles,
+    const int first,
+    const int last,
+    float4 color,
+    const int x,
+    const int y) {
+
+    for (int j = first; j < last; ++j) {
+        const int base = tileCircles[j] * 7;
         const float cx = params[base + 0];
         const float cy = params[base + 1];
         const float radius = params[base + 2];
@@ -101,221 +105,472 @@ __kernel void render_cost(
         color.w = fg.w + color.w * invOpacity;
     }
 
-    color.xyz = clamp(color.xyz, 0.0f, 1.0f);
-    color.w = clamp(color.w, 0.0f, 1.0f);
+    return clamp(color, 0.0f, 1.0f);
+}
+
+__kernel void render_image(
+    __global const float *params,
+    __global const int *tileOffsets,
+    __global const int *tileCircles,
+    const int width,
+    const int height,
+    const int tilesX,
+    __global const float4 *canvas,
+    __global float4 *outImage) {
 
-    outImage[idx] = color;
+    const int idx = get_global_id(0);
+    if (idx >= width * height) {
+        return;
+    }
+
+    const int x = idx % width;
+    const int y = idx / width;
+    const int tile = (y / TILE_SIZE) * tilesX + x / TILE_SIZE;
 
-    const float4 ref = reference[idx];
-    const float dr = (color.x - ref.x) * 255.0f;
-    const float dg = (color.y - ref.y) * 255.0f;
-    const float db = (color.z - ref.z) * 255.0f;
-    outError[idx] = dr * dr + dg * dg + db * db;
+    outImage[idx] = composite_pixel(params, tileCircles, tileOffsets[tile], tileOffsets[tile + 1], canvas[idx], x, y);
+}
+
+__kernel void render_cost_batch(
+    __global const float *params,
+    __global const int *tileOffsets,
+    __global const int *tileCircles,
+    const int circleCount,
+    const int width,
+    const int height,
+    const int tilesX,
+    __global const float4 *canvas,
+    __global const float4 *reference,
+    __global float *partials,
+    __local float *scratch) {
+
+    const int candidate = get_global_id(1);
+    const int lid = get_local_id(0);
+    const int pixelCount = width * height;
+    const int tileCount = tilesX * ((height + TILE_SIZE - 1) / TILE_SIZE);
+    __global const float *candidateParams = params + candidate * circleCount * 7;
+    __global const int *candidateTiles = tileOffsets + candidate * (tileCount + 1);
+
+    float sum = 0.0f;
+    for (int idx = get_global_id(0); idx < pixelCount; idx += get_global_size(0)) {
+        const int x = idx % width;
+        const int y = idx / width;
+        const int tile = (y / TILE_SIZE) * tilesX + x / TILE_SIZE;
+
+        const float4 color = composite_pixel(candidateParams, tileCircles,
+            candidateTiles[tile], candidateTiles[tile + 1], canvas[idx], x, y);
+        const float4 ref = reference[idx];
+        const float dr = (color.x - ref.x) * 255.0f;
+        const float dg = (color.y - ref.y) * 255.0f;
+        const float db = (color.z - ref.z) * 255.0f;
+        sum += dr * dr + dg * dg + db * db;
+    }
+
+    scratch[lid] = sum;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int s = get_local_size(0) / 2; s > 0; s >>= 1) {
+        if (lid < s) {
+            scratch[lid] += scratch[lid + s];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    if (lid == 0) {
+        partials[candidate * get_num_groups(0) + get_group_id(0)] = scratch[0];
+    }
+}
+
+__kernel void reduce_partials(
+    __global const float *partials,
+    const int partialCount,
+    const float scale,
+    __global float *costs,
+    __local float *scratch) {
+
+    const int candidate = get_group_id(0);
+    const int lid = get_local_id(0);
+
+    float sum = 0.0f;
+    for (int i = lid; i < partialCount; i += get_local_size(0)) {
+        sum += partials[candidate * partialCount + i];
+    }
+
+    scratch[lid] = sum;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int s = get_local_size(0) / 2; s > 0; s >>= 1) {
+        if (lid < s) {
+            scratch[lid] += scratch[lid + s];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    if (lid == 0) {
+        costs[candidate] = scratch[0] * scale;
+    }
 }
 `
 
-type openCLRenderer struct {
-	runtime    *gpu.Runtime
-	fallback   *CPURenderer
-	reference  *image.NRGBA
-	bounds     *fit.Bounds
-	width      int
-	height     int
-	pixelCount int
-
-	context C.cl_context
-	queue   C.cl_command_queue
-	device  C.cl_device_id
-	program C.cl_program
-	kernel  C.cl_kernel
-
-	paramsBuffer    C.cl_mem
+const (
+	// openclLocalSize is the work-group size of the batch kernels (power of two)
+	openclLocalSize = 64
+	// openclMaxGroupsPerCandidate caps the partial sums per candidate; larger
+	// images are covered by each work-item striding over several pixels.
+	openclMaxGroupsPerCandidate = 64
+	// openclTileSize is the circle-binning tile edge; must match TILE_SIZE in
+	// openclKernelSource.
+	openclTileSize = 16
+)
+
+// kernelArg names one kernel argument slot
+type kernelArg struct {
+	kernel *C.cl_kernel
+	index  int
+}
+
+// deviceBuffer is a growable device buffer that is rebound to its kernel
+// arguments whenever it is reallocated.
+type deviceBuffer struct {
+	mem      C.cl_mem
+	size     int // Bytes
+	flags    C.cl_mem_flags
+	name     string
+	bindings []kernelArg
+}
+
+// openCLKernels is the kernel and buffer state of an OpenCL renderer. The
+// renderer returned by NewOpenCLRendererWithCanvas owns it; its pipeline
+// stages (WithCircles) share it, since all stages run on one goroutine.
+type openCLKernels struct {
+	dev *openCLDevice
+
+	imageKernel  C.cl_kernel
+	batchKernel  C.cl_kernel
+	reduceKernel C.cl_kernel
+
+	referenceKey    uint64 // Resident buffer keys (see openCLDevice.acquireImage)
+	canvasKey       uint64
 	referenceBuffer C.cl_mem
+	canvasBuffer    C.cl_mem
 	outputBuffer    C.cl_mem
-	errorBuffer     C.cl_mem
+	params          deviceBuffer
+	tileOffsets     deviceBuffer
+	tileCircles     deviceBuffer
+	partials        deviceBuffer
+	costs           deviceBuffer
+
+	width              int
+	height             int
+	pixelCount         int
+	groupsPerCandidate int
+	binner             *tileBinner
+
+	paramsScratch  []float32
+	offsetsScratch []int32
+	circlesScratch []int32
+	imageScratch   []float32
+	costsScratch   []float32
+
+	// imageScratch holds the image of the params hashed here, whichever
+	// stage rendered them, so the cache key lives next to the buffer
+	lastImageHash  uint64
+	lastImageValid bool
 
-	paramsScratch []float32
-	imageScratch  []float32
-	errorScratch  []float32
+	degraded bool
+}
 
-	renderImage *image.NRGBA
+type openCLRenderer struct {
+	*openCLKernels
 
-	lastHash  uint64
-	lastCost  float64
-	lastValid bool
+	fallback  *CPURenderer
+	reference *image.NRGBA
+	canvas    *image.NRGBA // Initial canvas (nil = white)
+	k         int
+	bounds    *fit.Bounds // Built on demand (nil after SetCircles)
 
-	degraded bool
+	renderImage *image.NRGBA
+
+	lastCostHash  uint64
+	lastCost      float64
+	lastCostValid bool
 }
 
 // NewOpenCLRenderer creates an OpenCL GPU-based renderer
 func NewOpenCLRenderer(reference *image.NRGBA, k int) (Renderer, func(), error) {
-	rt, err := gpu.InitOpenCL()
+	return NewOpenCLRendererWithCanvas(reference, nil, k)
+}
+
+// NewOpenCLRendererWithCanvas creates an OpenCL renderer whose pixels start
+// from canvas instead of white (nil = white). The canvas must match the
+// reference dimensions.
+//
+// The OpenCL context and compiled program are shared process-wide, and the
+// reference and canvas stay resident on the device, so only the first
+// renderer pays for kernel compilation and uploads.
+func NewOpenCLRendererWithCanvas(reference, canvas *image.NRGBA, k int) (Renderer, func(), error) {
+	width, height := reference.Bounds().Dx(), reference.Bounds().Dy()
+	if canvas != nil && (canvas.Bounds().Dx() != width || canvas.Bounds().Dy() != height) {
+		return nil, noopCleanup, fmt.Errorf("canvas dimensions %dx%d must match reference %dx%d",
+			canvas.Bounds().Dx(), canvas.Bounds().Dy(), width, height)
+	}
+
+	dev, err := acquireOpenCLDevice()
 	if err != nil {
-		return nil, noopCleanup, fmt.Errorf("%w: %v", ErrBackendUnavailable, err)
+		return nil, noopCleanup, err
 	}
 
-	r := &openCLRenderer{
-		runtime:       rt,
-		fallback:      NewCPURenderer(reference, k),
-		reference:     reference,
-		bounds:        fit.NewBounds(k, reference.Bounds().Dx(), reference.Bounds().Dy()),
-		width:         reference.Bounds().Dx(),
-		height:        reference.Bounds().Dy(),
-		pixelCount:    reference.Bounds().Dx() * reference.Bounds().Dy(),
-		paramsScratch: make([]float32, k*7), // 7 params per circle
-		imageScratch:  make([]float32, reference.Bounds().Dx()*reference.Bounds().Dy()*4),
-		errorScratch:  make([]float32, reference.Bounds().Dx()*reference.Bounds().Dy()),
-		renderImage:   image.NewNRGBA(reference.Bounds()),
-	}
+	pixelCount := width * height
+	groups := (pixelCount + openclLocalSize - 1) / openclLocalSize
+	groups = max(min(groups, openclMaxGroupsPerCandidate), 1)
 
-	if err := r.init(); err != nil {
-		rt.Close()
-		return nil, noopCleanup, err
+	kernels := &openCLKernels{
+		dev:                dev,
+		width:              width,
+		height:             height,
+		pixelCount:         pixelCount,
+		groupsPerCandidate: groups,
+		binner:             newTileBinner(width, height, openclTileSize),
+		imageScratch:       make([]float32, pixelCount*4),
 	}
-
-	cleanup := func() {
-		r.release()
+	if err := kernels.init(reference, canvas); err != nil {
+		kernels.release()
+		return nil, noopCleanup, err
 	}
 
-	return r, cleanup, nil
+	r := newOpenCLStage(kernels, reference, canvas, k)
+	return r, kernels.release, nil
 }
 
-func (r *openCLRenderer) init() error {
-	r.context = C.cl_context(r.runtime.ContextPtr())
-	r.queue = C.cl_command_queue(r.runtime.QueuePtr())
-	r.device = C.cl_device_id(r.runtime.DevicePtr())
+// newOpenCLStage creates a renderer for k circles on shared kernel state
+func newOpenCLStage(kernels *openCLKernels, reference, canvas *image.NRGBA, k int) *openCLRenderer {
+	fallback := NewCPURenderer(reference, k)
+	if canvas != nil {
+		fallback = NewCPURendererWithCanvas(reference, canvas, k)
+	}
 
-	if r.context == nil || r.queue == nil {
-		return fmt.Errorf("%w: failed to access OpenCL context/queue", ErrBackendUnavailable)
+	return &openCLRenderer{
+		openCLKernels: kernels,
+		fallback:      fallback,
+		reference:     reference,
+		canvas:        canvas,
+		k:             k,
+		renderImage:   image.NewNRGBA(reference.Bounds()),
 	}
+}
 
-	source := C.CString(openclKernelSource)
-	defer C.free(unsafe.Pointer(source))
+// WithCircles returns a renderer for k circles that shares this renderer's
+// kernels and device buffers (used by the sequential and batch pipelines).
+// Only the cleanup of the original renderer releases them.
+func (r *openCLRenderer) WithCircles(k int) Renderer {
+	return newOpenCLStage(r.openCLKernels, r.reference, r.canvas, k)
+}
 
-	var status C.cl_int
-	r.program = C.clCreateProgramWithSource(r.context, 1, &source, nil, &status)
-	if status != C.CL_SUCCESS {
-		return r.clError("clCreateProgramWithSource", status)
+func (r *openCLKernels) init(reference, canvas *image.NRGBA) error {
+	var err error
+	if r.imageKernel, err = r.createKernel("render_image"); err != nil {
+		return err
 	}
-
-	status = C.clBuildProgram(r.program, 1, &r.device, nil, nil, nil)
-	if status != C.CL_SUCCESS {
-		r.dumpBuildLog()
-		return r.clError("clBuildProgram", status)
+	if r.batchKernel, err = r.createKernel("render_cost_batch"); err != nil {
+		return err
 	}
-
-	kernelName := C.CString("render_cost")
-	defer C.free(unsafe.Pointer(kernelName))
-	r.kernel = C.clCreateKernel(r.program, kernelName, &status)
-	if status != C.CL_SUCCESS {
-		return r.clError("clCreateKernel", status)
+	if r.reduceKernel, err = r.createKernel("reduce_partials"); err != nil {
+		return err
 	}
 
+	var status C.cl_int
 	bytePixels := C.size_t(r.pixelCount * 4 * int(unsafe.Sizeof(float32(0))))
-	byteErrors := C.size_t(r.pixelCount * int(unsafe.Sizeof(float32(0))))
-	byteParams := C.size_t(len(r.paramsScratch) * int(unsafe.Sizeof(float32(0))))
-
-	r.outputBuffer = C.clCreateBuffer(r.context, C.CL_MEM_READ_WRITE, bytePixels, nil, &status)
-	if status != C.CL_SUCCESS {
-		return r.clError("clCreateBuffer(output)", status)
-	}
-
-	r.errorBuffer = C.clCreateBuffer(r.context, C.CL_MEM_READ_WRITE, byteErrors, nil, &status)
+	r.outputBuffer = C.clCreateBuffer(r.dev.context, C.CL_MEM_WRITE_ONLY, bytePixels, nil, &status)
 	if status != C.CL_SUCCESS {
-		return r.clError("clCreateBuffer(error)", status)
+		return clStatusError("clCreateBuffer(output)", status)
 	}
 
-	r.paramsBuffer = C.clCreateBuffer(r.context, C.CL_MEM_READ_ONLY, byteParams, nil, &status)
-	if status != C.CL_SUCCESS {
-		return r.clError("clCreateBuffer(params)", status)
+	referenceKey := contentKey("reference", r.width, r.height, reference.Pix)
+	if r.referenceBuffer, err = r.dev.acquireImage(referenceKey, func() []float32 { return nrgbaToFloat4(reference) }); err != nil {
+		return err
 	}
+	r.referenceKey = referenceKey
 
-	refFloats := make([]float32, r.pixelCount*4)
-	for i := 0; i < r.pixelCount; i++ {
-		offset := i * 4
-		refFloats[offset+0] = float32(r.reference.Pix[offset+0]) / 255.0
-		refFloats[offset+1] = float32(r.reference.Pix[offset+1]) / 255.0
-		refFloats[offset+2] = float32(r.reference.Pix[offset+2]) / 255.0
-		refFloats[offset+3] = float32(r.reference.Pix[offset+3]) / 255.0
+	canvasKey := contentKey("white", r.width, r.height, nil)
+	canvasPixels := func() []float32 {
+		white := make([]float32, r.pixelCount*4)
+		for i := range white {
+			white[i] = 1.0
+		}
+		return white
 	}
-
-	r.referenceBuffer = C.clCreateBuffer(r.context, C.CL_MEM_READ_ONLY|C.CL_MEM_COPY_HOST_PTR, bytePixels, unsafe.Pointer(&refFloats[0]), &status)
-	if status != C.CL_SUCCESS {
-		return r.clError("clCreateBuffer(reference)", status)
+	if canvas != nil {
+		canvasKey = contentKey("canvas", r.width, r.height, canvas.Pix)
+		canvasPixels = func() []float32 { return nrgbaToFloat4(canvas) }
 	}
-
-	if err := r.setStaticKernelArgs(); err != nil {
+	if r.canvasBuffer, err = r.dev.acquireImage(canvasKey, canvasPixels); err != nil {
 		return err
 	}
+	r.canvasKey = canvasKey
 
-	slog.Info("OpenCL backend initialised",
-		"device", r.runtime.Device.Name,
-		"vendor", r.runtime.Device.Vendor,
-		"compute_units", r.runtime.Device.MaxComputeUnits,
-	)
+	r.params = deviceBuffer{flags: C.CL_MEM_READ_ONLY, name: "params",
+		bindings: []kernelArg{{&r.imageKernel, 0}, {&r.batchKernel, 0}}}
+	r.tileOffsets = deviceBuffer{flags: C.CL_MEM_READ_ONLY, name: "tileOffsets",
+		bindings: []kernelArg{{&r.imageKernel, 1}, {&r.batchKernel, 1}}}
+	r.tileCircles = deviceBuffer{flags: C.CL_MEM_READ_ONLY, name: "tileCircles",
+		bindings: []kernelArg{{&r.imageKernel, 2}, {&r.batchKernel, 2}}}
+	r.partials = deviceBuffer{flags: C.CL_MEM_READ_WRITE, name: "partials",
+		bindings: []kernelArg{{&r.batchKernel, 9}, {&r.reduceKernel, 0}}}
+	r.costs = deviceBuffer{flags: C.CL_MEM_WRITE_ONLY, name: "costs",
+		bindings: []kernelArg{{&r.reduceKernel, 3}}}
 
-	return nil
+	return r.setStaticKernelArgs()
 }
 
-func (r *openCLRenderer) setStaticKernelArgs() error {
-	var status C.cl_int
+// nrgbaToFloat4 converts an NRGBA image to normalized float4 pixels
+func nrgbaToFloat4(img *image.NRGBA) []float32 {
+	width, height := img.Bounds().Dx(), img.Bounds().Dy()
+	out := make([]float32, width*height*4)
+	for y := 0; y < height; y++ {
+		row := img.Pix[y*img.Stride:]
+		for x := 0; x < width*4; x++ {
+			out[y*width*4+x] = float32(row[x]) / 255.0
+		}
+	}
+	return out
+}
 
-	width := C.cl_int(r.width)
-	height := C.cl_int(r.height)
+func (r *openCLKernels) createKernel(name string) (C.cl_kernel, error) {
+	kernelName := C.CString(name)
+	defer C.free(unsafe.Pointer(kernelName))
 
-	status = C.clSetKernelArg(r.kernel, 2, C.size_t(unsafe.Sizeof(width)), unsafe.Pointer(&width))
+	var status C.cl_int
+	kernel := C.clCreateKernel(r.dev.program, kernelName, &status)
 	if status != C.CL_SUCCESS {
-		return r.clError("clSetKernelArg(width)", status)
+		return nil, clStatusError("clCreateKernel("+name+")", status)
 	}
+	return kernel, nil
+}
 
-	status = C.clSetKernelArg(r.kernel, 3, C.size_t(unsafe.Sizeof(height)), unsafe.Pointer(&height))
+// setKernelArg sets one kernel argument; value points to the argument (nil
+// with a size allocates __local memory).
+func (r *openCLKernels) setKernelArg(kernel C.cl_kernel, index int, size uintptr, value unsafe.Pointer, name string) error {
+	status := C.clSetKernelArg(kernel, C.cl_uint(index), C.size_t(size), value)
 	if status != C.CL_SUCCESS {
-		return r.clError("clSetKernelArg(height)", status)
+		return clStatusError("clSetKernelArg("+name+")", status)
 	}
+	return nil
+}
 
-	status = C.clSetKernelArg(r.kernel, 4, C.size_t(unsafe.Sizeof(r.referenceBuffer)), unsafe.Pointer(&r.referenceBuffer))
-	if status != C.CL_SUCCESS {
-		return r.clError("clSetKernelArg(reference)", status)
+func (r *openCLKernels) setStaticKernelArgs() error {
+	width := C.cl_int(r.width)
+	height := C.cl_int(r.height)
+	tilesX := C.cl_int(r.binner.tilesX)
+	partialCount := C.cl_int(r.groupsPerCandidate)
+	scale := C.cl_float(1.0 / float64(max(r.pixelCount*3, 1)))
+	localBytes := uintptr(openclLocalSize * unsafe.Sizeof(float32(0)))
+
+	args := []struct {
+		kernel C.cl_kernel
+		index  int
+		size   uintptr
+		value  unsafe.Pointer
+		name   string
+	}{
+		{r.imageKernel, 3, unsafe.Sizeof(width), unsafe.Pointer(&width), "width"},
+		{r.imageKernel, 4, unsafe.Sizeof(height), unsafe.Pointer(&height), "height"},
+		{r.imageKernel, 5, unsafe.Sizeof(tilesX), unsafe.Pointer(&tilesX), "tilesX"},
+		{r.imageKernel, 6, unsafe.Sizeof(r.canvasBuffer), unsafe.Pointer(&r.canvasBuffer), "canvas"},
+		{r.imageKernel, 7, unsafe.Sizeof(r.outputBuffer), unsafe.Pointer(&r.outputBuffer), "output"},
+
+		{r.batchKernel, 4, unsafe.Sizeof(width), unsafe.Pointer(&width), "width"},
+		{r.batchKernel, 5, unsafe.Sizeof(height), unsafe.Pointer(&height), "height"},
+		{r.batchKernel, 6, unsafe.Sizeof(tilesX), unsafe.Pointer(&tilesX), "tilesX"},
+		{r.batchKernel, 7, unsafe.Sizeof(r.canvasBuffer), unsafe.Pointer(&r.canvasBuffer), "canvas"},
+		{r.batchKernel, 8, unsafe.Sizeof(r.referenceBuffer), unsafe.Pointer(&r.referenceBuffer), "reference"},
+		{r.batchKernel, 10, localBytes, nil, "scratch"},
+
+		{r.reduceKernel, 1, unsafe.Sizeof(partialCount), unsafe.Pointer(&partialCount), "partialCount"},
+		{r.reduceKernel, 2, unsafe.Sizeof(scale), unsafe.Pointer(&scale), "scale"},
+		{r.reduceKernel, 4, localBytes, nil, "scratch"},
+	}
+	for _, a := range args {
+		if err := r.setKernelArg(a.kernel, a.index, a.size, a.value, a.name); err != nil {
+			return err
+		}
 	}
 
-	status = C.clSetKernelArg(r.kernel, 5, C.size_t(unsafe.Sizeof(r.outputBuffer)), unsafe.Pointer(&r.outputBuffer))
-	if status != C.CL_SUCCESS {
-		return r.clError("clSetKernelArg(output)", status)
+	return nil
+}
+
+// reserve grows b to at least bytes (doubling to amortize growth) and rebinds
+// it to its kernel arguments.
+func (r *openCLKernels) reserve(b *deviceBuffer, bytes int) error {
+	bytes = max(bytes, 4)
+	if bytes <= b.size {
+		return nil
+	}
+	bytes = max(bytes, 2*b.size)
+
+	if b.mem != nil {
+		C.clReleaseMemObject(b.mem)
+		b.mem = nil
+		b.size = 0
 	}
 
-	status = C.clSetKernelArg(r.kernel, 6, C.size_t(unsafe.Sizeof(r.errorBuffer)), unsafe.Pointer(&r.errorBuffer))
+	var status C.cl_int
+	b.mem = C.clCreateBuffer(r.dev.context, b.flags, C.size_t(bytes), nil, &status)
 	if status != C.CL_SUCCESS {
-		return r.clError("clSetKernelArg(error)", status)
+		return clStatusError("clCreateBuffer("+b.name+")", status)
 	}
+	b.size = bytes
 
+	for _, arg := range b.bindings {
+		if err := r.setKernelArg(*arg.kernel, arg.index, unsafe.Sizeof(b.mem), unsafe.Pointer(&b.mem), b.name); err != nil {
+			return err
+		}
+	}
 	return nil
 }
 
-func (r *openCLRenderer) clError(prefix string, status C.cl_int) error {
-	return fmt.Errorf("%s: %s (%d)", prefix, C.GoString(C.mayfly_gpu_renderer_error_string(status)), int(status))
-}
-
-func (r *openCLRenderer) dumpBuildLog() {
-	if r.program == nil || r.device == nil {
-		return
+// upload grows b as needed and copies bytes from data (blocking, so the Go
+// memory is not referenced after the call returns).
+func (r *openCLKernels) upload(b *deviceBuffer, data unsafe.Pointer, bytes int) error {
+	if err := r.reserve(b, bytes); err != nil {
+		return err
 	}
-
-	var logSize C.size_t
-	if status := C.clGetProgramBuildInfo(r.program, r.device, C.CL_PROGRAM_BUILD_LOG, 0, nil, &logSize); status != C.CL_SUCCESS {
-		slog.Error("OpenCL: failed to fetch build log size", "err", status)
-		return
+	if bytes == 0 {
+		return nil
 	}
-	if logSize == 0 {
-		return
+	status := C.clEnqueueWriteBuffer(r.dev.queue, b.mem, C.CL_TRUE, 0, C.size_t(bytes), data, 0, nil, nil)
+	if status != C.CL_SUCCESS {
+		return clStatusError("clEnqueueWriteBuffer("+b.name+")", status)
 	}
+	return nil
+}
 
-	buf := make([]byte, int(logSize))
-	if status := C.clGetProgramBuildInfo(r.program, r.device, C.CL_PROGRAM_BUILD_LOG, logSize, unsafe.Pointer(&buf[0]), nil); status != C.CL_SUCCESS {
-		slog.Error("OpenCL: failed to fetch build log", "err", status)
-		return
+// uploadCandidates packs population into float32 parameters and tile lists
+// and uploads both. All candidates must have circleCount circles.
+func (r *openCLKernels) uploadCandidates(population [][]float64, circleCount int) error {
+	stride := circleCount * paramsPerCircle
+	r.paramsScratch = r.paramsScratch[:0]
+	r.offsetsScratch = r.offsetsScratch[:0]
+	r.circlesScratch = r.circlesScratch[:0]
+	for _, params := range population {
+		for _, v := range params[:stride] {
+			r.paramsScratch = append(r.paramsScratch, float32(v))
+		}
+		r.offsetsScratch, r.circlesScratch = r.binner.bin(params, circleCount, r.offsetsScratch, r.circlesScratch)
+	}
+
+	const word = int(unsafe.Sizeof(int32(0)))
+	uploads := []struct {
+		buf   *deviceBuffer
+		count int
+		data  unsafe.Pointer
+	}{
+		{&r.params, len(r.paramsScratch), unsafe.Pointer(unsafe.SliceData(r.paramsScratch))},
+		{&r.tileOffsets, len(r.offsetsScratch), unsafe.Pointer(unsafe.SliceData(r.offsetsScratch))},
+		{&r.tileCircles, len(r.circlesScratch), unsafe.Pointer(unsafe.SliceData(r.circlesScratch))},
+	}
+	for _, u := range uploads {
+		if err := r.upload(u.buf, u.data, u.count*word); err != nil {
+			return err
+		}
 	}
-
-	slog.Error("OpenCL build log", "log", string(buf))
+	return nil
 }
 
 func (r *openCLRenderer) Render(params []float64) *image.NRGBA {
@@ -323,7 +578,7 @@ func (r *openCLRenderer) Render(params []float64) *image.NRGBA {
 		return r.fallback.Render(params)
 	}
 
-	if err := r.ensure(params); err != nil {
+	if err := r.renderImageBuffer(params); err != nil {
 		slog.Warn("OpenCL renderer degraded to CPU", "reason", err)
 		r.degraded = true
 		return r.fallback.Render(params)
@@ -351,154 +606,194 @@ func clampToByte(v float32) uint8 {
 	return uint8(v + 0.5)
 }
 
+// Cost evaluates a single candidate through the batch kernel: no image is
+// written and only one float is read back.
 func (r *openCLRenderer) Cost(params []float64) float64 {
+	hash := hashParams(params)
+	if r.lastCostValid && r.lastCostHash == hash {
+		return r.lastCost
+	}
+
+	var costs [1]float64
+	r.CostBatch([][]float64{params}, costs[:])
+
+	r.lastCost = costs[0]
+	r.lastCostHash = hash
+	r.lastCostValid = true
+	return costs[0]
+}
+
+// CostBatch evaluates all candidates of population with one render_cost_batch
+// launch and one reduce_partials launch, reading back one float per
+// candidate. Candidates must share the same length; mixed populations are
+// evaluated one by one.
+func (r *openCLRenderer) CostBatch(population [][]float64, costs []float64) {
 	if r.degraded {
-		return r.fallback.Cost(params)
+		costBatchSerial(r.fallback, population, costs)
+		return
 	}
 
-	if err := r.ensure(params); err != nil {
+	for _, params := range population[1:] {
+		if len(params) != len(population[0]) {
+			for i, params := range population {
+				costs[i] = r.Cost(params)
+			}
+			return
+		}
+	}
+
+	if err := r.costBatch(population, costs); err != nil {
 		slog.Warn("OpenCL renderer degraded to CPU", "reason", err)
 		r.degraded = true
-		return r.fallback.Cost(params)
+		costBatchSerial(r.fallback, population, costs)
 	}
-
-	return r.lastCost
 }
 
-func (r *openCLRenderer) ensure(params []float64) error {
-	hash := hashParams(params)
-	if r.lastValid && r.lastHash == hash {
+func (r *openCLRenderer) costBatch(population [][]float64, costs []float64) error {
+	n := len(population)
+	if n == 0 {
 		return nil
 	}
 
-	circleCount := len(params) / paramsPerCircle
-	if circleCount == 0 {
-		// Reset image to white and zero cost.
-		for i := 0; i < len(r.imageScratch); i += 4 {
-			r.imageScratch[i+0] = 1.0
-			r.imageScratch[i+1] = 1.0
-			r.imageScratch[i+2] = 1.0
-			r.imageScratch[i+3] = 1.0
-		}
-		for i := range r.errorScratch {
-			r.errorScratch[i] = 0
-		}
-		r.lastCost = 0
-		r.lastHash = hash
-		r.lastValid = true
-		return nil
+	circleCount := len(population[0]) / paramsPerCircle
+	if circleCount > r.k {
+		return fmt.Errorf("parameter count %d exceeds renderer capacity %d", circleCount, r.k)
 	}
 
-	if circleCount*paramsPerCircle > len(r.paramsScratch) {
-		return fmt.Errorf("parameter count %d exceeds renderer capacity %d", circleCount, len(r.paramsScratch)/paramsPerCircle)
+	if err := r.uploadCandidates(population, circleCount); err != nil {
+		return err
 	}
-
-	for i := 0; i < circleCount*paramsPerCircle; i++ {
-		r.paramsScratch[i] = float32(params[i])
+	const word = int(unsafe.Sizeof(float32(0)))
+	if err := r.reserve(&r.partials, n*r.groupsPerCandidate*word); err != nil {
+		return err
 	}
-
-	var status C.cl_int
-	if len(r.paramsScratch) > 0 {
-		byteParams := C.size_t(circleCount * paramsPerCircle * int(unsafe.Sizeof(float32(0))))
-		status = C.clEnqueueWriteBuffer(r.queue, r.paramsBuffer, C.CL_TRUE, 0, byteParams, unsafe.Pointer(&r.paramsScratch[0]), 0, nil, nil)
-		if status != C.CL_SUCCESS {
-			return r.clError("clEnqueueWriteBuffer(params)", status)
-		}
+	if err := r.reserve(&r.costs, n*word); err != nil {
+		return err
 	}
 
 	cc := C.cl_int(circleCount)
-	status = C.clSetKernelArg(r.kernel, 0, C.size_t(unsafe.Sizeof(r.paramsBuffer)), unsafe.Pointer(&r.paramsBuffer))
-	if status != C.CL_SUCCESS {
-		return r.clError("clSetKernelArg(params)", status)
+	if err := r.setKernelArg(r.batchKernel, 3, unsafe.Sizeof(cc), unsafe.Pointer(&cc), "circleCount"); err != nil {
+		return err
 	}
 
-	status = C.clSetKernelArg(r.kernel, 1, C.size_t(unsafe.Sizeof(cc)), unsafe.Pointer(&cc))
+	batchGlobal := [2]C.size_t{C.size_t(r.groupsPerCandidate * openclLocalSize), C.size_t(n)}
+	batchLocal := [2]C.size_t{openclLocalSize, 1}
+	status := C.clEnqueueNDRangeKernel(r.dev.queue, r.batchKernel, 2, nil, &batchGlobal[0], &batchLocal[0], 0, nil, nil)
 	if status != C.CL_SUCCESS {
-		return r.clError("clSetKernelArg(circleCount)", status)
+		return clStatusError("clEnqueueNDRangeKernel(render_cost_batch)", status)
 	}
 
-	global := C.size_t(r.pixelCount)
-	status = C.clEnqueueNDRangeKernel(r.queue, r.kernel, 1, nil, &global, nil, 0, nil, nil)
+	reduceGlobal := C.size_t(n * openclLocalSize)
+	reduceLocal := C.size_t(openclLocalSize)
+	status = C.clEnqueueNDRangeKernel(r.dev.queue, r.reduceKernel, 1, nil, &reduceGlobal, &reduceLocal, 0, nil, nil)
 	if status != C.CL_SUCCESS {
-		return r.clError("clEnqueueNDRangeKernel", status)
+		return clStatusError("clEnqueueNDRangeKernel(reduce_partials)", status)
 	}
 
-	status = C.clFinish(r.queue)
+	// Blocking read of n floats; the in-order queue orders it after both kernels
+	if cap(r.costsScratch) < n {
+		r.costsScratch = make([]float32, n)
+	}
+	r.costsScratch = r.costsScratch[:n]
+	status = C.clEnqueueReadBuffer(r.dev.queue, r.costs.mem, C.CL_TRUE, 0, C.size_t(n*word), unsafe.Pointer(&r.costsScratch[0]), 0, nil, nil)
 	if status != C.CL_SUCCESS {
-		return r.clError("clFinish", status)
+		return clStatusError("clEnqueueReadBuffer(costs)", status)
 	}
 
-	if len(r.imageScratch) > 0 {
-		bytePixels := C.size_t(len(r.imageScratch) * int(unsafe.Sizeof(float32(0))))
-		status = C.clEnqueueReadBuffer(r.queue, r.outputBuffer, C.CL_TRUE, 0, bytePixels, unsafe.Pointer(&r.imageScratch[0]), 0, nil, nil)
-		if status != C.CL_SUCCESS {
-			return r.clError("clEnqueueReadBuffer(output)", status)
-		}
+	for i := 0; i < n; i++ {
+		costs[i] = float64(r.costsScratch[i])
+	}
+	return nil
+}
+
+// renderImageBuffer runs render_image for params and reads the float4 image
+// back into imageScratch.
+func (r *openCLRenderer) renderImageBuffer(params []float64) error {
+	hash := hashParams(params)
+	if r.lastImageValid && r.lastImageHash == hash {
+		return nil
 	}
 
-	if len(r.errorScratch) > 0 {
-		byteErrors := C.size_t(len(r.errorScratch) * int(unsafe.Sizeof(float32(0))))
-		status = C.clEnqueueReadBuffer(r.queue, r.errorBuffer, C.CL_TRUE, 0, byteErrors, unsafe.Pointer(&r.errorScratch[0]), 0, nil, nil)
-		if status != C.CL_SUCCESS {
-			return r.clError("clEnqueueReadBuffer(error)", status)
-		}
+	circleCount := len(params) / paramsPerCircle
+	if circleCount > r.k {
+		return fmt.Errorf("parameter count %d exceeds renderer capacity %d", circleCount, r.k)
 	}
 
-	var sum float64
-	for _, v := range r.errorScratch {
-		sum += float64(v)
+	if err := r.uploadCandidates([][]float64{params}, circleCount); err != nil {
+		return err
 	}
 
-	r.lastCost = sum / float64(r.pixelCount*3)
-	r.lastHash = hash
-	r.lastValid = true
+	global := C.size_t(r.pixelCount)
+	status := C.clEnqueueNDRangeKernel(r.dev.queue, r.imageKernel, 1, nil, &global, nil, 0, nil, nil)
+	if status != C.CL_SUCCESS {
+		return clStatusError("clEnqueueNDRangeKernel(render_image)", status)
+	}
+
+	bytePixels := C.size_t(len(r.imageScratch) * int(unsafe.Sizeof(float32(0))))
+	status = C.clEnqueueReadBuffer(r.dev.queue, r.outputBuffer, C.CL_TRUE, 0, bytePixels, unsafe.Pointer(&r.imageScratch[0]), 0, nil, nil)
+	if status != C.CL_SUCCESS {
+		return clStatusError("clEnqueueReadBuffer(output)", status)
+	}
 
+	r.lastImageHash = hash
+	r.lastImageValid = true
 	return nil
 }
 
 func (r *openCLRenderer) Dim() int {
-	return r.bounds.K * paramsPerCircle
+	return r.k * paramsPerCircle
 }
 
 func (r *openCLRenderer) Bounds() (lower, upper []float64) {
+	if r.bounds == nil {
+		r.bounds = fit.NewBounds(r.k, r.width, r.height)
+	}
 	return r.bounds.Lower, r.bounds.Upper
 }
 
+// SetCircles changes the number of circles per call; device buffers grow on
+// demand (see CPURenderer.SetCircles)
+func (r *openCLRenderer) SetCircles(k int) {
+	if k != r.k {
+		r.k = k
+		r.bounds = nil
+		r.fallback.SetCircles(k)
+	}
+}
+
 func (r *openCLRenderer) Reference() *image.NRGBA {
 	return r.reference
 }
 
-func (r *openCLRenderer) release() {
-	if r.paramsBuffer != nil {
-		C.clReleaseMemObject(r.paramsBuffer)
-		r.paramsBuffer = nil
+// release frees the renderer's kernels and buffers and returns its resident
+// images to the device cache; the shared device context stays alive.
+func (r *openCLKernels) release() {
+	for _, buf := range []*C.cl_mem{&r.outputBuffer, &r.params.mem, &r.tileOffsets.mem, &r.tileCircles.mem, &r.partials.mem, &r.costs.mem} {
+		if *buf != nil {
+			C.clReleaseMemObject(*buf)
+			*buf = nil
+		}
 	}
 	if r.referenceBuffer != nil {
-		C.clReleaseMemObject(r.referenceBuffer)
+		r.dev.releaseImage(r.referenceKey)
 		r.referenceBuffer = nil
 	}
-	if r.outputBuffer != nil {
-		C.clReleaseMemObject(r.outputBuffer)
-		r.outputBuffer = nil
-	}
-	if r.errorBuffer != nil {
-		C.clReleaseMemObject(r.errorBuffer)
-		r.errorBuffer = nil
+	if r.canvasBuffer != nil {
+		r.dev.releaseImage(r.canvasKey)
+		r.canvasBuffer = nil
 	}
-	if r.kernel != nil {
-		C.clReleaseKernel(r.kernel)
-		r.kernel = nil
-	}
-	if r.program != nil {
-		C.clReleaseProgram(r.program)
-		r.program = nil
-	}
-	if r.runtime != nil {
-		r.runtime.Close()
-		r.runtime = nil
+	for _, kernel := range []*C.cl_kernel{&r.imageKernel, &r.batchKernel, &r.reduceKernel} {
+		if *kernel != nil {
+			C.clReleaseKernel(*kernel)
+			*kernel = nil
+		}
 	}
 }
 
+func clStatusError(prefix string, status C.cl_int) error {
+	return fmt.Errorf("%s: %s (%d)", prefix, C.GoString(C.mayfly_gpu_renderer_error_string(status)), int(status))
+}
+
 func hashParams(params []float64) uint64 {
 	hasher := fnv.New64a()
 	buf := make([]byte, 8)
@@ -46,6 +46,145 @@ func TestOpenCLRendererMatchesCPU(t *testing.T) {
 	assertNRGBAWithin(t, cpuImage, gpuImage, 2)
 }
 
+func TestOpenCLCostBatchMatchesCPU(t *testing.T) {
+	ref := randomNRGBA(48, 40, 3)
+
+	const circles = 8
+	population := make([][]float64, 13) // not a multiple of the work-group size
+	for i := range population {
+		population[i] = seededParams(circles, 48, 40, int64(i))
+	}
+	population[0] = make([]float64, circles*7) // all-transparent candidate
+
+	gpuRenderer, cleanup, err := NewRendererForBackend("opencl", ref, circles)
+	if err != nil {
+		t.Skipf("GPU backend unavailable: %v", err)
+	}
+	defer cleanup()
+
+	if _, ok := gpuRenderer.(BatchCoster); !ok {
+		t.Fatal("OpenCL renderer should implement BatchCoster")
+	}
+
+	cpu := NewCPURenderer(ref, circles)
+	costs := make([]float64, len(population))
+	CostBatch(gpuRenderer, population, costs)
+
+	for i, params := range population {
+		want := cpu.Cost(params)
+		if diff := math.Abs(costs[i] - want); diff > 1e-3*want+1e-3 {
+			t.Errorf("candidate %d: batch cost %f, cpu cost %f", i, costs[i], want)
+		}
+		if single := gpuRenderer.Cost(params); math.Abs(single-costs[i]) > 1e-3*want+1e-3 {
+			t.Errorf("candidate %d: batch cost %f, single cost %f", i, costs[i], single)
+		}
+	}
+
+	// A larger population grows the device buffers
+	population = append(population, population...)
+	costs = make([]float64, len(population))
+	CostBatch(gpuRenderer, population, costs)
+	for i := range population {
+		if math.Abs(costs[i]-costs[i%13]) > 1e-6*costs[i]+1e-6 {
+			t.Errorf("candidate %d: cost %f after growing, want %f", i, costs[i], costs[i%13])
+		}
+	}
+}
+
+// TestOpenCLCanvasTilesMatchCPU warm-starts from a random canvas with enough
+// circles that most tiles see only part of them
+func TestOpenCLCanvasTilesMatchCPU(t *testing.T) {
+	const width, height, circles = 70, 45, 40
+	ref := randomNRGBA(width, height, 4)
+	canvas := randomNRGBA(width, height, 5)
+	for i := 3; i < len(canvas.Pix); i += 4 {
+		canvas.Pix[i] = 255
+	}
+
+	gpuRenderer, cleanup, err := NewRendererForBackendWithCanvas("opencl", ref, canvas, circles)
+	if err != nil {
+		t.Skipf("GPU backend unavailable: %v", err)
+	}
+	defer cleanup()
+
+	cpu := NewCPURendererWithCanvas(ref, canvas, circles)
+	for seed := int64(0); seed < 4; seed++ {
+		params := seededParams(circles, width, height, seed)
+
+		want := cpu.Cost(params)
+		if got := gpuRenderer.Cost(params); math.Abs(got-want) > 1e-3*want+1e-3 {
+			t.Errorf("seed %d: cost mismatch (cpu=%f gpu=%f)", seed, want, got)
+		}
+		assertNRGBAWithin(t, cpu.Render(params), gpuRenderer.Render(params), 2)
+	}
+
+	// Transparent circles: the cost is the canvas against the reference
+	empty := make([]float64, circles*7)
+	if got, want := gpuRenderer.Cost(empty), cpu.Cost(empty); math.Abs(got-want) > 1e-3*want+1e-3 {
+		t.Errorf("transparent circles: cost mismatch (cpu=%f gpu=%f)", want, got)
+	}
+}
+
+// TestOpenCLSharedDeviceState checks that renderers share the device
+// context and resident reference, and that pipeline stages stay on the device
+func TestOpenCLSharedDeviceState(t *testing.T) {
+	ref := randomNRGBA(40, 30, 6)
+
+	first, cleanupFirst, err := NewRendererForBackend("opencl", ref, 4)
+	if err != nil {
+		t.Skipf("GPU backend unavailable: %v", err)
+	}
+	defer cleanupFirst()
+	second, cleanupSecond, err := NewRendererForBackend("opencl", ref, 8)
+	if err != nil {
+		t.Fatalf("second renderer: %v", err)
+	}
+	defer cleanupSecond()
+
+	a, b := first.(*openCLRenderer), second.(*openCLRenderer)
+	if a.dev != b.dev {
+		t.Error("renderers should share the device context")
+	}
+	if a.referenceBuffer != b.referenceBuffer {
+		t.Error("renderers on the same reference should share the resident buffer")
+	}
+
+	stage, ok := stageRenderer(first, 6).(*openCLRenderer)
+	if !ok {
+		t.Fatalf("stage renderer is %T, want *openCLRenderer", stageRenderer(first, 6))
+	}
+	if stage.openCLKernels != a.openCLKernels {
+		t.Error("stage should share the parent's kernels")
+	}
+
+	params := seededParams(6, 40, 30, 9)
+	want := NewCPURenderer(ref, 6).Cost(params)
+	if got := stage.Cost(params); math.Abs(got-want) > 1e-3*want+1e-3 {
+		t.Errorf("stage cost mismatch (cpu=%f gpu=%f)", want, got)
+	}
+}
+
+// TestOpenCLStagesShareImageCache renders on two stages in turn: the
+// image buffer is shared, so a stage must not reuse it after another stage
+// rendered different params into it
+func TestOpenCLStagesShareImageCache(t *testing.T) {
+	ref := randomNRGBA(40, 30, 7)
+
+	parent, cleanup, err := NewRendererForBackend("opencl", ref, 4)
+	if err != nil {
+		t.Skipf("GPU backend unavailable: %v", err)
+	}
+	defer cleanup()
+
+	stageA, stageB := stageRenderer(parent, 4), stageRenderer(parent, 4)
+	p, q := seededParams(4, 40, 30, 1), seededParams(4, 40, 30, 2)
+	cpu := NewCPURenderer(ref, 4)
+
+	stageA.Render(p)
+	stageB.Render(q)
+	assertNRGBAWithin(t, cpu.Render(p), stageA.Render(p), 2)
+}
+
 func assertNRGBAWithin(t *testing.T, a, b *image.NRGBA, tolerance uint8) {
 	t.Helper()
 
@@ -1,3 +1,5 @@
+//go:build !gpu
+
 package renderer
 
 import (
@@ -9,3 +11,8 @@ import (
 func NewOpenCLRenderer(_ *image.NRGBA, _ int) (Renderer, func(), error) {
 	return nil, noopCleanup, fmt.Errorf("%w: build without GPU tag", ErrBackendUnavailable)
 }
+
+// NewOpenCLRendererWithCanvas creates an OpenCL renderer with an initial canvas (stub for non-GPU builds)
+func NewOpenCLRendererWithCanvas(_, _ *image.NRGBA, _ int) (Renderer, func(), error) {
+	return nil, noopCleanup, fmt.Errorf("%w: build without GPU tag", ErrBackendUnavailable)
+}
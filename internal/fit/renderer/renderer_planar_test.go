@@ -0,0 +1,134 @@
+package renderer
+
+import (
+	"bytes"
+	"errors"
+	"math/rand"
+	"testing"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+	"github.com/cwbudde/mayflycirclefit/internal/opt"
+)
+
+// seededParams creates reproducible circle parameters, including circles that
+// cross the image border and both small (direct) and large (LUT) circles
+func seededParams(k, width, height int, seed int64) []float64 {
+	rng := rand.New(rand.NewSource(seed))
+	params := make([]float64, k*7)
+	for i := 0; i < k; i++ {
+		p := params[i*7:]
+		p[0] = rng.Float64()*float64(width+20) - 10
+		p[1] = rng.Float64()*float64(height+20) - 10
+		p[2] = 1 + rng.Float64()*float64(width/2)
+		p[3] = rng.Float64()
+		p[4] = rng.Float64()
+		p[5] = rng.Float64()
+		p[6] = rng.Float64()
+	}
+	return params
+}
+
+// TestPlanarRenderer_MatchesCPURenderer tests that planar rendering and cost
+// are bit-identical to the NRGBA renderer
+func TestPlanarRenderer_MatchesCPURenderer(t *testing.T) {
+	for _, size := range []struct{ width, height, k int }{
+		{13, 7, 3},
+		{64, 48, 20},
+		{100, 100, 40},
+	} {
+		ref := randomNRGBA(size.width, size.height, 1)
+		cpu := NewCPURenderer(ref, size.k)
+		planar := NewPlanarRenderer(ref, size.k)
+
+		for seed := int64(0); seed < 5; seed++ {
+			params := seededParams(size.k, size.width, size.height, seed)
+
+			want := cpu.Render(params)
+			got := planar.Render(params)
+			if !bytes.Equal(got.Pix, want.Pix) {
+				t.Fatalf("%dx%d seed %d: planar render differs from CPURenderer",
+					size.width, size.height, seed)
+			}
+
+			if got, want := planar.Cost(params), cpu.Cost(params); got != want {
+				t.Errorf("%dx%d seed %d: planar cost = %v, CPURenderer cost = %v",
+					size.width, size.height, seed, got, want)
+			}
+		}
+	}
+}
+
+// TestPlanarRenderer_WithCircles tests that stage renderers share the
+// reference planes and keep the planar layout through the pipelines
+func TestPlanarRenderer_WithCircles(t *testing.T) {
+	ref := randomNRGBA(24, 24, 2)
+	planar := NewPlanarRenderer(ref, 1)
+
+	stage := stageRenderer(planar, 3)
+	p, ok := stage.(*PlanarRenderer)
+	if !ok {
+		t.Fatalf("stage renderer is %T, want *PlanarRenderer", stage)
+	}
+	if p.Dim() != 21 || &p.refPlanes[0][0] != &planar.refPlanes[0][0] {
+		t.Error("stage renderer should have 3 circles and share the reference planes")
+	}
+
+	result := OptimizeSequential(planar, opt.NewMayfly(5, 10, 42), 2, DisabledConvergenceConfig())
+	if len(result.BestParams) != 14 {
+		t.Errorf("Expected 14 parameters for 2 circles, got %d", len(result.BestParams))
+	}
+	if result.BestCost > result.InitialCost {
+		t.Errorf("final cost %v exceeds initial cost %v", result.BestCost, result.InitialCost)
+	}
+}
+
+// BenchmarkPlanarRenderer_Cost compares planar and NRGBA render+cost
+func BenchmarkPlanarRenderer_Cost(b *testing.B) {
+	sizes := []struct {
+		name    string
+		width   int
+		height  int
+		circles int
+	}{
+		{"128x128_20circles", 128, 128, 20},
+		{"256x256_50circles", 256, 256, 50},
+		{"512x512_100circles", 512, 512, 100},
+	}
+
+	for _, sz := range sizes {
+		ref := randomNRGBA(sz.width, sz.height, 42)
+		params := seededParams(sz.circles, sz.width, sz.height, 7)
+
+		b.Run(sz.name+"/CPU_FastMSE", func(b *testing.B) {
+			r := NewCPURenderer(ref, sz.circles)
+			r.SetCostFunc(fit.FastMSECost)
+			for i := 0; i < b.N; i++ {
+				_ = r.Cost(params)
+			}
+		})
+		b.Run(sz.name+"/Planar", func(b *testing.B) {
+			r := NewPlanarRenderer(ref, sz.circles)
+			for i := 0; i < b.N; i++ {
+				_ = r.Cost(params)
+			}
+		})
+	}
+}
+
+func TestNewRendererForBackendWithCanvas(t *testing.T) {
+	ref := randomNRGBA(16, 16, 1)
+	canvas := randomNRGBA(16, 16, 2)
+
+	if _, _, err := NewRendererForBackendWithCanvas("planar", ref, canvas, 2); !errors.Is(err, ErrBackendNotImplemented) {
+		t.Errorf("planar with canvas: got %v, want ErrBackendNotImplemented", err)
+	}
+
+	rend, cleanup, err := NewRendererForBackendWithCanvas("cpu", ref, canvas, 2)
+	if err != nil {
+		t.Fatalf("cpu with canvas: %v", err)
+	}
+	defer cleanup()
+	if img := rend.Render(make([]float64, 2*7)); !bytes.Equal(img.Pix, canvas.Pix) {
+		t.Error("cpu renderer should start from the canvas")
+	}
+}
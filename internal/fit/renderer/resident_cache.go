@@ -0,0 +1,100 @@
+package renderer
+
+import (
+	"encoding/binary"
+	"hash/fnv"
+	"sync"
+)
+
+// residentCache keeps reference-counted device resources keyed by content
+// hash. Released entries stay resident (up to limit idle entries, least
+// recently released evicted first), so renderers created later for the same
+// reference — pipeline stages, the next job — reuse the upload.
+type residentCache[T any] struct {
+	mu      sync.Mutex
+	limit   int
+	entries map[uint64]*residentEntry[T]
+	idle    []uint64 // Unreferenced keys, oldest first
+	free    func(T)
+}
+
+type residentEntry[T any] struct {
+	value T
+	refs  int
+}
+
+func newResidentCache[T any](limit int, free func(T)) *residentCache[T] {
+	return &residentCache[T]{
+		limit:   limit,
+		entries: make(map[uint64]*residentEntry[T]),
+		free:    free,
+	}
+}
+
+// acquire returns the resource for key, creating it on first use, and takes
+// a reference that must be returned with release.
+func (c *residentCache[T]) acquire(key uint64, create func() (T, error)) (T, error) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+
+	if e, ok := c.entries[key]; ok {
+		if e.refs == 0 {
+			c.removeIdle(key)
+		}
+		e.refs++
+		return e.value, nil
+	}
+
+	value, err := create()
+	if err != nil {
+		return value, err
+	}
+	c.entries[key] = &residentEntry[T]{value: value, refs: 1}
+	return value, nil
+}
+
+// release drops a reference taken by acquire. Unreferenced entries beyond
+// the idle limit are freed.
+func (c *residentCache[T]) release(key uint64) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+
+	e, ok := c.entries[key]
+	if !ok || e.refs == 0 {
+		return
+	}
+	e.refs--
+	if e.refs > 0 {
+		return
+	}
+
+	c.idle = append(c.idle, key)
+	for len(c.idle) > c.limit {
+		oldest := c.idle[0]
+		c.idle = c.idle[1:]
+		c.free(c.entries[oldest].value)
+		delete(c.entries, oldest)
+	}
+}
+
+func (c *residentCache[T]) removeIdle(key uint64) {
+	for i, k := range c.idle {
+		if k == key {
+			c.idle = append(c.idle[:i], c.idle[i+1:]...)
+			return
+		}
+	}
+}
+
+// contentKey hashes a tagged width×height pixel buffer (pix may be nil for
+// generated content such as a white canvas).
+func contentKey(tag string, width, height int, pix []uint8) uint64 {
+	h := fnv.New64a()
+	_, _ = h.Write([]byte(tag))
+	var dims [16]byte
+	binary.LittleEndian.PutUint64(dims[0:], uint64(width))
+	binary.LittleEndian.PutUint64(dims[8:], uint64(height))
+	_, _ = h.Write(dims[:])
+	_, _ = h.Write(pix)
+	return h.Sum64()
+}
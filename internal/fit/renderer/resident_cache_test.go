@@ -0,0 +1,85 @@
+package renderer
+
+import (
+	"errors"
+	"testing"
+)
+
+func TestResidentCache_SharesAndRetains(t *testing.T) {
+	var created, freed []int
+	next := 0
+	create := func() (int, error) {
+		next++
+		created = append(created, next)
+		return next, nil
+	}
+	c := newResidentCache(1, func(v int) { freed = append(freed, v) })
+
+	a, _ := c.acquire(1, create)
+	b, _ := c.acquire(1, create)
+	if a != b || len(created) != 1 {
+		t.Fatalf("same key should share one resource, created %v", created)
+	}
+
+	// Released entries stay resident and are reused
+	c.release(1)
+	c.release(1)
+	if v, _ := c.acquire(1, create); v != a || len(created) != 1 {
+		t.Fatalf("idle entry should be reused, got %d (created %v)", v, created)
+	}
+	c.release(1)
+
+	// A second idle entry evicts the oldest (limit 1)
+	c.acquire(2, create)
+	c.release(2)
+	if len(freed) != 1 || freed[0] != a {
+		t.Fatalf("expected key 1 to be evicted, freed %v", freed)
+	}
+	if v, _ := c.acquire(2, create); v != 2 {
+		t.Errorf("key 2 should still be resident, got %d", v)
+	}
+
+	// Extra releases are ignored
+	c.release(2)
+	c.release(2)
+	c.release(99)
+	if len(freed) != 1 {
+		t.Errorf("unexpected frees %v", freed)
+	}
+}
+
+func TestResidentCache_CreateError(t *testing.T) {
+	c := newResidentCache(1, func(int) {})
+	if _, err := c.acquire(1, func() (int, error) { return 0, errors.New("boom") }); err == nil {
+		t.Fatal("expected create error")
+	}
+	if v, err := c.acquire(1, func() (int, error) { return 7, nil }); err != nil || v != 7 {
+		t.Errorf("failed create should not be cached, got %d, %v", v, err)
+	}
+}
+
+func TestContentKeyAndBinaryCachePath(t *testing.T) {
+	if contentKey("ref", 2, 1, []uint8{1, 2, 3, 4, 5, 6, 7, 8}) == contentKey("canvas", 2, 1, []uint8{1, 2, 3, 4, 5, 6, 7, 8}) {
+		t.Error("content keys should depend on the tag")
+	}
+	if contentKey("white", 4, 2, nil) == contentKey("white", 2, 4, nil) {
+		t.Error("content keys should depend on the dimensions")
+	}
+
+	a := openCLBinaryCachePath("/cache", "src", "pocl", "cpu")
+	if a == "" || a == openCLBinaryCachePath("/cache", "src", "pocl", "gpu") || a == openCLBinaryCachePath("/cache", "src2", "pocl", "cpu") {
+		t.Errorf("cache path should depend on source and device, got %q", a)
+	}
+	if openCLBinaryCachePath("", "src") != "" {
+		t.Error("empty cache dir should disable the cache")
+	}
+
+	t.Setenv(openCLCacheEnv, "off")
+	if dir := openCLCacheDir(); dir != "" {
+		t.Errorf("cache should be disabled, got %q", dir)
+	}
+	t.Setenv(openCLCacheEnv, "/tmp/kernels")
+	if dir := openCLCacheDir(); dir != "/tmp/kernels" {
+		t.Errorf("cache dir = %q, want override", dir)
+	}
+}
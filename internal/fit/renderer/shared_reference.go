@@ -0,0 +1,72 @@
+package renderer
+
+import (
+	"image"
+	"sync"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+)
+
+// SharedReference holds the read-only data derived from one reference image
+// (planar channels, luma plane, white backgrounds) so that many independent
+// fits of the same image - a batch or parameter sweep - decode and split it
+// once. Each planar representation is built on first use.
+//
+// It is safe for concurrent use. The renderers it creates are independent
+// (own canvases and culling counters) and, like every renderer, are not.
+type SharedReference struct {
+	reference *image.NRGBA
+
+	planarOnce sync.Once
+	refPlanes  [3][]uint8
+	white      []uint8
+
+	grayOnce sync.Once
+	refLuma  []uint8
+
+	bgOnce  sync.Once
+	whiteBg []byte
+}
+
+// NewSharedReference wraps reference, which must not be modified afterwards
+func NewSharedReference(reference *image.NRGBA) *SharedReference {
+	return &SharedReference{reference: reference}
+}
+
+// Reference returns the shared reference image (read-only)
+func (s *SharedReference) Reference() *image.NRGBA {
+	return s.reference
+}
+
+// whitePlane returns the shared white plane, building it once
+func (s *SharedReference) whitePlane() []uint8 {
+	s.planarOnce.Do(func() {
+		s.refPlanes = referencePlanes(s.reference)
+		s.white = whitePlane(len(s.refPlanes[0]))
+	})
+	return s.white
+}
+
+// NewCPURenderer creates a CPU renderer sharing the white background
+func (s *SharedReference) NewCPURenderer(k int) *CPURenderer {
+	s.bgOnce.Do(func() {
+		bounds := s.reference.Bounds()
+		s.whiteBg = whitePlane(bounds.Dx() * bounds.Dy() * 4)
+	})
+	return newCPURenderer(s.reference, s.whiteBg, k)
+}
+
+// NewPlanarRenderer creates a planar renderer sharing the reference planes
+func (s *SharedReference) NewPlanarRenderer(k int) *PlanarRenderer {
+	white := s.whitePlane()
+	return newPlanarRenderer(s.reference, s.refPlanes, white, k)
+}
+
+// NewGrayRenderer creates a grayscale renderer sharing the luma plane
+func (s *SharedReference) NewGrayRenderer(k int) *GrayRenderer {
+	white := s.whitePlane()
+	s.grayOnce.Do(func() {
+		s.refLuma = fit.LumaPlane(s.reference)
+	})
+	return newGrayRenderer(s.reference, s.refLuma, white, k)
+}
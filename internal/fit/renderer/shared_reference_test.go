@@ -0,0 +1,71 @@
+package renderer
+
+import (
+	"bytes"
+	"sync"
+	"testing"
+)
+
+// TestSharedReferenceRenderersMatch checks that renderers built from a
+// SharedReference share its planes and render like independent renderers
+func TestSharedReferenceRenderersMatch(t *testing.T) {
+	const width, height, k = 40, 30, 12
+	ref := randomNRGBA(width, height, 5)
+	shared := NewSharedReference(ref)
+
+	a, b := shared.NewPlanarRenderer(k), shared.NewPlanarRenderer(k)
+	if &a.refPlanes[0][0] != &b.refPlanes[0][0] || &a.white[0] != &b.white[0] {
+		t.Error("planar renderers do not share the reference planes")
+	}
+	ga, gb := shared.NewGrayRenderer(k), shared.NewGrayRenderer(k)
+	if &ga.refLuma[0] != &gb.refLuma[0] || &ga.white[0] != &a.white[0] {
+		t.Error("gray renderers do not share the luma plane")
+	}
+	if &shared.NewCPURenderer(k).initialBg[0] != &shared.NewCPURenderer(k).initialBg[0] {
+		t.Error("CPU renderers do not share the background")
+	}
+
+	params := seededParams(k, width, height, 3)
+	pairs := []struct {
+		name             string
+		shared, separate Renderer
+	}{
+		{"cpu", shared.NewCPURenderer(k), NewCPURenderer(ref, k)},
+		{"planar", a, NewPlanarRenderer(ref, k)},
+	}
+	for _, p := range pairs {
+		if !bytes.Equal(p.shared.Render(params).Pix, p.separate.Render(params).Pix) {
+			t.Errorf("%s: shared renderer differs", p.name)
+		}
+		if p.shared.Cost(params) != p.separate.Cost(params) {
+			t.Errorf("%s: shared renderer cost differs", p.name)
+		}
+	}
+	grayParams := seededGrayParams(k, width, height, 3)
+	if ga.Cost(grayParams) != NewGrayRenderer(ref, k).Cost(grayParams) {
+		t.Error("gray: shared renderer cost differs")
+	}
+}
+
+// TestSharedReferenceConcurrent creates and uses renderers from many
+// goroutines (run with -race)
+func TestSharedReferenceConcurrent(t *testing.T) {
+	const width, height, k = 32, 32, 8
+	shared := NewSharedReference(randomNRGBA(width, height, 2))
+	params := seededParams(k, width, height, 1)
+	want := NewPlanarRenderer(shared.Reference(), k).Cost(params)
+
+	var wg sync.WaitGroup
+	for i := 0; i < 8; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			r := shared.NewPlanarRenderer(k)
+			shared.NewGrayRenderer(k)
+			if got := r.Cost(params); got != want {
+				t.Errorf("cost %g, want %g", got, want)
+			}
+		}()
+	}
+	wg.Wait()
+}
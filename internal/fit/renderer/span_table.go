@@ -0,0 +1,263 @@
+package renderer
+
+import (
+	"image"
+	"math"
+	"sync"
+	"sync/atomic"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+)
+
+// Precomputed circle span tables.
+//
+// Radii and sub-pixel centre offsets repeat heavily within and across
+// optimizer generations. With a SpanTable a renderer snaps each circle to a
+// 1/subpixel pixel grid (radius and centre fraction) and looks up the per-row
+// pixel spans of that snapped disc instead of searching them with distance
+// tests. Rasterization then reduces to a table lookup plus clipping per row.
+//
+// Spans are computed in exact integer arithmetic, so a snapped circle covers
+// exactly the pixels whose centres lie inside it. Tables are immutable once
+// published and shared by all renderers (and goroutines) holding the same
+// SpanTable. Memory is bounded by a byte budget: once it is spent, missing
+// tables are built into per-renderer scratch instead of being cached, which
+// costs time but never changes the rendered pixels.
+
+const (
+	DefaultSpanSubpixel = 8        // Centre and radius resolution: 1/8 pixel
+	DefaultSpanBudget   = 16 << 20 // Bytes of cached span rows
+)
+
+// spanRow is the pixel span [lo, hi) of one row, relative to the circle's
+// integer centre column. lo >= hi marks a row without covered pixels.
+type spanRow struct {
+	lo, hi int32
+}
+
+const spanRowBytes = 8
+
+// spanEntry holds the spans of one snapped disc; row j is image row iy+top+j.
+type spanEntry struct {
+	top  int
+	rows []spanRow
+}
+
+// SpanTable caches span entries keyed by quantized radius and fractional
+// centre offset. It is safe for concurrent use.
+type SpanTable struct {
+	subpixel int
+	budget   int64
+	used     atomic.Int64
+	entries  sync.Map // uint64 key -> *spanEntry
+}
+
+// NewSpanTable creates a span table with the given sub-pixel resolution
+// (1..256) and cache budget in bytes.
+func NewSpanTable(subpixel int, budget int64) *SpanTable {
+	subpixel = min(max(subpixel, 1), 256)
+	return &SpanTable{subpixel: subpixel, budget: budget}
+}
+
+var (
+	defaultSpanTable     *SpanTable
+	defaultSpanTableOnce sync.Once
+)
+
+// DefaultSpanTable returns the process-wide span table shared by all jobs
+func DefaultSpanTable() *SpanTable {
+	defaultSpanTableOnce.Do(func() {
+		defaultSpanTable = NewSpanTable(DefaultSpanSubpixel, DefaultSpanBudget)
+	})
+	return defaultSpanTable
+}
+
+// Subpixel returns the grid resolution circles are snapped to
+func (t *SpanTable) Subpixel() int {
+	return t.subpixel
+}
+
+// CachedBytes returns the memory held by cached span rows
+func (t *SpanTable) CachedBytes() int64 {
+	return t.used.Load()
+}
+
+// SetSpanTable enables span-table rasterization on a renderer (nil restores
+// exact circles). Renderers without table support are left unchanged and
+// reported with ok = false.
+func SetSpanTable(r Renderer, t *SpanTable) (ok bool) {
+	if s, isSetter := r.(interface{ SetSpanTable(*SpanTable) }); isSetter {
+		s.SetSpanTable(t)
+		return true
+	}
+	return t == nil
+}
+
+// snap quantizes a circle centre and radius to the table grid: the centre
+// becomes (ix + fx/q, iy + fy/q) with 0 <= fx, fy < q and the radius rq/q.
+func (t *SpanTable) snap(x, y, r float64) (ix, iy, fx, fy, rq int) {
+	q := float64(t.subpixel)
+	ix, fx = snapCoord(x, q, t.subpixel)
+	iy, fy = snapCoord(y, q, t.subpixel)
+	rq = int(math.Round(r * q))
+	return ix, iy, fx, fy, max(rq, 0)
+}
+
+func snapCoord(v, q float64, subpixel int) (whole, frac int) {
+	fl := math.Floor(v)
+	whole = int(fl)
+	frac = int(math.Round((v - fl) * q))
+	if frac == subpixel {
+		whole++
+		frac = 0
+	}
+	return whole, frac
+}
+
+// lookup returns the row spans of circle (x, y, r) snapped to the grid, the
+// integer centre column ix and the image row of rows[0]. Entries that do not
+// fit the budget are built into *scratch.
+func (t *SpanTable) lookup(x, y, r float64, scratch *[]spanRow) (rows []spanRow, ix, top int) {
+	ix, iy, fx, fy, rq := t.snap(x, y, r)
+	key := uint64(rq)<<16 | uint64(fx)<<8 | uint64(fy)
+
+	if e, ok := t.entries.Load(key); ok {
+		entry := e.(*spanEntry)
+		return entry.rows, ix, iy + entry.top
+	}
+
+	top, n := t.rowRange(fy, rq)
+	size := int64(n) * spanRowBytes
+	if t.used.Add(size) <= t.budget {
+		entry := &spanEntry{top: top, rows: t.build(make([]spanRow, 0, n), fx, fy, rq)}
+		if e, loaded := t.entries.LoadOrStore(key, entry); loaded {
+			t.used.Add(-size) // Another goroutine published it first
+			entry = e.(*spanEntry)
+		}
+		return entry.rows, ix, iy + entry.top
+	}
+	t.used.Add(-size)
+
+	*scratch = t.build((*scratch)[:0], fx, fy, rq)
+	return *scratch, ix, iy + top
+}
+
+// rowRange returns the first row offset and the row count of a snapped disc:
+// the rows dy with |q*dy - fy| <= rq.
+func (t *SpanTable) rowRange(fy, rq int) (top, n int) {
+	top = ceilDiv(fy-rq, t.subpixel)
+	bottom := floorDiv(fy+rq, t.subpixel)
+	return top, bottom - top + 1
+}
+
+// build appends the spans of the snapped disc to rows. Pixel (dx, dy) relative
+// to the integer centre is covered iff (q*dx-fx)² + (q*dy-fy)² <= rq².
+func (t *SpanTable) build(rows []spanRow, fx, fy, rq int) []spanRow {
+	q := t.subpixel
+	top, n := t.rowRange(fy, rq)
+	r2 := int64(rq) * int64(rq)
+	for j := 0; j < n; j++ {
+		dy := int64(q*(top+j) - fy)
+		s := isqrt(r2 - dy*dy) // Largest s with s² <= rq² - dy²
+		lo := ceilDiv(fx-s, q)
+		hi := floorDiv(fx+s, q) + 1
+		rows = append(rows, spanRow{lo: int32(lo), hi: int32(hi)})
+	}
+	return rows
+}
+
+// isqrt returns floor(sqrt(v)) for v >= 0
+func isqrt(v int64) int {
+	s := int64(math.Sqrt(float64(v)))
+	for s*s > v {
+		s--
+	}
+	for (s+1)*(s+1) <= v {
+		s++
+	}
+	return int(s)
+}
+
+func floorDiv(a, b int) int {
+	d := a / b
+	if a%b != 0 && a < 0 {
+		d--
+	}
+	return d
+}
+
+func ceilDiv(a, b int) int {
+	return -floorDiv(-a, b)
+}
+
+// clippedRows returns the index range [j0, j1) of rows (starting at image row
+// top) that fall inside an image of the given height.
+func clippedRows(rows []spanRow, top, height int) (j0, j1 int) {
+	return max(-top, 0), min(len(rows), height-top)
+}
+
+// clip returns the row's pixel span for integer centre column ix, clipped to
+// [0, width); lo >= hi if nothing is covered.
+func (s spanRow) clip(ix, width int) (lo, hi int) {
+	return max(ix+int(s.lo), 0), min(ix+int(s.hi), width)
+}
+
+// compositeSpanTable composites circle c onto the NRGBA canvas through the
+// span table (float64 blending).
+func (r *CPURenderer) compositeSpanTable(img *image.NRGBA, c fit.Circle) {
+	if c.Opacity < 0.001 {
+		return
+	}
+	rows, ix, top := r.spans.lookup(c.X, c.Y, c.R, &r.spanScratch)
+	j0, j1 := clippedRows(rows, top, r.height)
+	for j := j0; j < j1; j++ {
+		lo, hi := rows[j].clip(ix, r.width)
+		for x := lo; x < hi; x++ {
+			compositePixel(img, x, top+j, c.CR, c.CG, c.CB, c.Opacity)
+		}
+	}
+}
+
+// compositeSpanTable32 is compositeSpanTable with float32 blending
+func (r *CPURenderer) compositeSpanTable32(img *image.NRGBA, c fit.Circle32) {
+	if c.Opacity < 0.001 {
+		return
+	}
+	rows, ix, top := r.spans.lookup(float64(c.X), float64(c.Y), float64(c.R), &r.spanScratch)
+	j0, j1 := clippedRows(rows, top, r.height)
+	for j := j0; j < j1; j++ {
+		lo, hi := rows[j].clip(ix, r.width)
+		for x := lo; x < hi; x++ {
+			compositePixel32(img, x, top+j, c.CR, c.CG, c.CB, c.Opacity)
+		}
+	}
+}
+
+// compositePlanesTable is compositePlanes with spans taken from a span table
+func compositePlanesTable(planes [][]uint8, luts [][256]uint8, c fit.Circle, width, height int, t *SpanTable, scratch *[]spanRow) {
+	if c.Opacity < 0.001 {
+		return
+	}
+	blend := newPlaneBlend(planes, luts, c)
+	blend.fillTable(t, c.X, c.Y, c.R, width, height, scratch)
+}
+
+// compositePlanesTable32 is compositePlanesTable with float32 blending
+func compositePlanesTable32(planes [][]uint8, luts [][256]uint8, c fit.Circle32, width, height int, t *SpanTable, scratch *[]spanRow) {
+	if c.Opacity < 0.001 {
+		return
+	}
+	blend := newPlaneBlend32(planes, luts, c)
+	blend.fillTable(t, float64(c.X), float64(c.Y), float64(c.R), width, height, scratch)
+}
+
+// fillTable composites the spans of circle (x, y, r) snapped to t
+func (b *planeBlend) fillTable(t *SpanTable, x, y, r float64, width, height int, scratch *[]spanRow) {
+	rows, ix, top := t.lookup(x, y, r, scratch)
+	j0, j1 := clippedRows(rows, top, height)
+	for j := j0; j < j1; j++ {
+		lo, hi := rows[j].clip(ix, width)
+		base := (top + j) * width
+		b.fill(base+lo, base+hi)
+	}
+}
@@ -0,0 +1,193 @@
+package renderer
+
+import (
+	"bytes"
+	"math"
+	"sync"
+	"testing"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+)
+
+// snapParams rounds circle centres and radii to the span table grid, so exact
+// rendering and table rendering cover the same disc
+func snapParams(params []float64, ppc, subpixel int) []float64 {
+	q := float64(subpixel)
+	snapped := append([]float64(nil), params...)
+	for i := 0; i+ppc <= len(snapped); i += ppc {
+		for j := 0; j < 3; j++ {
+			snapped[i+j] = math.Round(snapped[i+j]*q) / q
+		}
+	}
+	return snapped
+}
+
+// TestSpanTableMatchesPixelTest checks table spans against the per-pixel
+// distance test of renderCircle for circles already on the table grid
+func TestSpanTableMatchesPixelTest(t *testing.T) {
+	const width, height = 61, 47
+	table := NewSpanTable(DefaultSpanSubpixel, DefaultSpanBudget)
+	ref := randomNRGBA(width, height, 3)
+
+	exact := NewCPURenderer(ref, 1)
+	tabled := NewCPURenderer(ref, 1)
+	tabled.SetSpanTable(table)
+
+	for seed := int64(0); seed < 300; seed++ {
+		params := snapParams(seededParams(1, width, height, seed), 7, DefaultSpanSubpixel)
+		params[6] = 0.5 + params[6]/2
+
+		copy(exact.canvas.Pix, exact.initialBg)
+		pv := &fit.ParamVector{Data: params, K: 1, Width: width, Height: height}
+		exact.renderCircle(exact.canvas, pv.DecodeCircle(0))
+		got := tabled.Render(params)
+
+		if !bytes.Equal(got.Pix, exact.canvas.Pix) {
+			t.Fatalf("seed %d: span table coverage differs from pixel test for circle %v", seed, params[:3])
+		}
+	}
+}
+
+// TestSpanTableRenderersAgree checks that CPU, planar and gray rendering
+// through a span table agree, as they do on the exact path
+func TestSpanTableRenderersAgree(t *testing.T) {
+	const width, height, k = 80, 60, 30
+	ref := randomNRGBA(width, height, 5)
+	table := NewSpanTable(DefaultSpanSubpixel, DefaultSpanBudget)
+
+	cpu := NewCPURenderer(ref, k)
+	planar := NewPlanarRenderer(ref, k)
+	cpu.SetSpanTable(table)
+	planar.SetSpanTable(table)
+
+	for seed := int64(0); seed < 10; seed++ {
+		params := seededParams(k, width, height, seed)
+		if a, b := cpu.Cost(params), planar.Cost(params); a != b {
+			t.Fatalf("seed %d: planar cost %v != cpu cost %v", seed, b, a)
+		}
+	}
+
+	// Gray: a gray circle is a colour circle with CR = CG = CB = L, so its luma
+	// plane must equal the planar renderer's channels
+	gray := NewGrayRenderer(ref, k)
+	gray.SetSpanTable(table)
+	for seed := int64(0); seed < 10; seed++ {
+		grayParams := seededGrayParams(k, width, height, seed)
+		colour := make([]float64, 0, k*7)
+		for i := 0; i < k; i++ {
+			p := grayParams[i*fit.ParamsPerGrayCircle:]
+			colour = append(colour, p[0], p[1], p[2], p[3], p[3], p[3], p[4])
+		}
+		if !bytes.Equal(gray.Render(grayParams).Pix, planar.Render(colour).Pix) {
+			t.Fatalf("seed %d: gray span table render differs from planar render", seed)
+		}
+	}
+}
+
+// TestSpanTableBudget checks that the cache stays within its budget and that
+// uncached (scratch-built) spans render the same pixels
+func TestSpanTableBudget(t *testing.T) {
+	const width, height, k = 64, 64, 40
+	ref := randomNRGBA(width, height, 9)
+
+	small := NewSpanTable(DefaultSpanSubpixel, 1024)
+	large := NewSpanTable(DefaultSpanSubpixel, DefaultSpanBudget)
+	a, b := NewCPURenderer(ref, k), NewCPURenderer(ref, k)
+	a.SetSpanTable(small)
+	b.SetSpanTable(large)
+
+	for seed := int64(0); seed < 5; seed++ {
+		params := seededParams(k, width, height, seed)
+		if !bytes.Equal(a.Render(params).Pix, b.Render(params).Pix) {
+			t.Fatalf("seed %d: budget-limited table renders differently", seed)
+		}
+	}
+	if used := small.CachedBytes(); used > 1024 {
+		t.Errorf("cached %d bytes, budget 1024", used)
+	}
+	if large.CachedBytes() == 0 {
+		t.Error("large table cached nothing")
+	}
+}
+
+// TestSpanTableConcurrentUse renders from several goroutines sharing one
+// table; every goroutine must see the same pixels
+func TestSpanTableConcurrentUse(t *testing.T) {
+	const width, height, k = 64, 48, 25
+	ref := randomNRGBA(width, height, 13)
+	table := NewSpanTable(DefaultSpanSubpixel, DefaultSpanBudget)
+	params := seededParams(k, width, height, 21)
+
+	want := NewCPURenderer(ref, k)
+	want.SetSpanTable(NewSpanTable(DefaultSpanSubpixel, DefaultSpanBudget))
+	expected := append([]uint8(nil), want.Render(params).Pix...)
+
+	var wg sync.WaitGroup
+	errs := make(chan int, 8)
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func(g int) {
+			defer wg.Done()
+			r := NewPlanarRenderer(ref, k)
+			r.SetSpanTable(table)
+			for i := 0; i < 20; i++ {
+				if !bytes.Equal(r.Render(params).Pix, expected) {
+					errs <- g
+					return
+				}
+			}
+		}(g)
+	}
+	wg.Wait()
+	close(errs)
+	for g := range errs {
+		t.Errorf("goroutine %d rendered different pixels", g)
+	}
+}
+
+// TestSpanTableStagesInheritTable checks that pipeline stages keep the table
+func TestSpanTableStagesInheritTable(t *testing.T) {
+	ref := randomNRGBA(16, 16, 1)
+	table := NewSpanTable(DefaultSpanSubpixel, DefaultSpanBudget)
+
+	cpu := NewCPURenderer(ref, 4)
+	cpu.SetSpanTable(table)
+	if stage := stageRenderer(cpu, 1).(*CPURenderer); stage.SpanTable() != table {
+		t.Error("CPU stage lost the span table")
+	}
+
+	planar := NewPlanarRenderer(ref, 4)
+	planar.SetSpanTable(table)
+	if stage := stageRenderer(planar, 1).(*PlanarRenderer); stage.spans != table {
+		t.Error("planar stage lost the span table")
+	}
+}
+
+func BenchmarkSpanTable(b *testing.B) {
+	const width, height, k = 256, 256, 100
+	ref := randomNRGBA(width, height, 1)
+	params := seededParams(k, width, height, 7)
+
+	for _, tc := range []struct {
+		name  string
+		table *SpanTable
+	}{
+		{"exact", nil},
+		{"table", NewSpanTable(DefaultSpanSubpixel, DefaultSpanBudget)},
+	} {
+		b.Run("cpu/"+tc.name, func(b *testing.B) {
+			r := NewCPURenderer(ref, k)
+			r.SetSpanTable(tc.table)
+			for i := 0; i < b.N; i++ {
+				r.Render(params)
+			}
+		})
+		b.Run("planar/"+tc.name, func(b *testing.B) {
+			r := NewPlanarRenderer(ref, k)
+			r.SetSpanTable(tc.table)
+			for i := 0; i < b.N; i++ {
+				r.Cost(params)
+			}
+		})
+	}
+}
@@ -0,0 +1,127 @@
+package renderer
+
+// tileBinner builds per-tile circle lists for the OpenCL kernels.
+//
+// The image is split into tileSize×tileSize tiles. For one parameter vector
+// bin appends a CSR index: tiles+1 offsets into a circle-index array, where
+// tile t lists, in compositing order, every visible circle whose disc may
+// touch a pixel of t. Pixels then only test the circles of their own tile, so
+// per-pixel work follows the local overlap instead of k.
+//
+// The overlap test is conservative by one pixel (float64 on the host, float32
+// in the kernel); extra entries cost a distance test, never a wrong pixel.
+type tileBinner struct {
+	tileSize int
+	tilesX   int
+	tilesY   int
+	cursor   []int32 // Fill position per tile (scratch)
+}
+
+func newTileBinner(width, height, tileSize int) *tileBinner {
+	tilesX := (width + tileSize - 1) / tileSize
+	tilesY := (height + tileSize - 1) / tileSize
+	return &tileBinner{
+		tileSize: tileSize,
+		tilesX:   tilesX,
+		tilesY:   tilesY,
+		cursor:   make([]int32, tilesX*tilesY),
+	}
+}
+
+// tileCount returns the number of tiles
+func (b *tileBinner) tileCount() int {
+	return b.tilesX * b.tilesY
+}
+
+// bin appends the tile index of the first circleCount circles of params:
+// tileCount()+1 entries to offsets (absolute positions in indices) and the
+// circle indices of every tile to indices.
+func (b *tileBinner) bin(params []float64, circleCount int, offsets, indices []int32) ([]int32, []int32) {
+	tiles := b.tileCount()
+	base := len(offsets)
+	for i := 0; i <= tiles; i++ {
+		offsets = append(offsets, 0)
+	}
+	counts := offsets[base+1:]
+
+	// Pass 1: count circles per tile
+	for i := 0; i < circleCount; i++ {
+		tx0, tx1, ty0, ty1, ok := b.tileRange(params, i)
+		if !ok {
+			continue
+		}
+		for ty := ty0; ty <= ty1; ty++ {
+			for tx := tx0; tx <= tx1; tx++ {
+				if b.overlaps(params, i, tx, ty) {
+					counts[ty*b.tilesX+tx]++
+				}
+			}
+		}
+	}
+
+	// Prefix sum: offsets[base+t] becomes the start of tile t
+	offsets[base] = int32(len(indices))
+	for t := 0; t < tiles; t++ {
+		offsets[base+t+1] += offsets[base+t]
+	}
+	total := int(offsets[base+tiles]) - len(indices)
+	copy(b.cursor, offsets[base:base+tiles])
+	for i := 0; i < total; i++ {
+		indices = append(indices, 0)
+	}
+
+	// Pass 2: fill in circle order, so each tile lists circles in compositing order
+	for i := 0; i < circleCount; i++ {
+		tx0, tx1, ty0, ty1, ok := b.tileRange(params, i)
+		if !ok {
+			continue
+		}
+		for ty := ty0; ty <= ty1; ty++ {
+			for tx := tx0; tx <= tx1; tx++ {
+				if b.overlaps(params, i, tx, ty) {
+					t := ty*b.tilesX + tx
+					indices[b.cursor[t]] = int32(i)
+					b.cursor[t]++
+				}
+			}
+		}
+	}
+
+	return offsets, indices
+}
+
+// tileRange returns the inclusive tile rectangle covered by circle i's
+// bounding box (grown by one pixel), or ok = false if the circle is invisible
+// or off-image. The visibility test matches the kernel's.
+func (b *tileBinner) tileRange(params []float64, i int) (tx0, tx1, ty0, ty1 int, ok bool) {
+	base := i * paramsPerCircle
+	cx, cy, r := params[base+0], params[base+1], params[base+2]
+	if params[base+6] < 0.001 || r <= 0 {
+		return 0, 0, 0, 0, false
+	}
+
+	size := float64(b.tileSize)
+	fx0, fx1 := (cx-r-1)/size, (cx+r+1)/size
+	fy0, fy1 := (cy-r-1)/size, (cy+r+1)/size
+	if fx1 < 0 || fy1 < 0 || fx0 >= float64(b.tilesX) || fy0 >= float64(b.tilesY) {
+		return 0, 0, 0, 0, false
+	}
+
+	tx0, tx1 = max(int(fx0), 0), min(int(fx1), b.tilesX-1)
+	ty0, ty1 = max(int(fy0), 0), min(int(fy1), b.tilesY-1)
+	return tx0, tx1, ty0, ty1, true
+}
+
+// overlaps reports whether circle i, grown by one pixel, intersects the pixel
+// centres of tile (tx, ty).
+func (b *tileBinner) overlaps(params []float64, i, tx, ty int) bool {
+	base := i * paramsPerCircle
+	cx, cy, r := params[base+0], params[base+1], params[base+2]
+
+	x0, y0 := float64(tx*b.tileSize), float64(ty*b.tileSize)
+	x1, y1 := x0+float64(b.tileSize-1), y0+float64(b.tileSize-1)
+
+	dx := cx - min(max(cx, x0), x1)
+	dy := cy - min(max(cy, y0), y1)
+	return dx*dx+dy*dy <= (r+1)*(r+1)
+}
@@ -0,0 +1,76 @@
+package renderer
+
+import (
+	"testing"
+)
+
+// TestTileBinner_CoversEveryCircle checks that every pixel covered by a
+// visible circle finds that circle in its tile list, in compositing order
+func TestTileBinner_CoversEveryCircle(t *testing.T) {
+	const width, height, k = 70, 45, 40
+
+	for _, tileSize := range []int{8, 16} {
+		b := newTileBinner(width, height, tileSize)
+
+		var offsets, indices []int32
+		population := [][]float64{seededParams(k, width, height, 1), seededParams(k, width, height, 2)}
+		for _, params := range population {
+			offsets, indices = b.bin(params, k, offsets, indices)
+		}
+		if len(offsets) != len(population)*(b.tileCount()+1) {
+			t.Fatalf("tile size %d: got %d offsets, want %d", tileSize, len(offsets), len(population)*(b.tileCount()+1))
+		}
+
+		for c, params := range population {
+			tileOffsets := offsets[c*(b.tileCount()+1):]
+			for tile := 0; tile < b.tileCount(); tile++ {
+				list := indices[tileOffsets[tile]:tileOffsets[tile+1]]
+				for j := 1; j < len(list); j++ {
+					if list[j] <= list[j-1] {
+						t.Fatalf("tile size %d: tile %d list not in circle order: %v", tileSize, tile, list)
+					}
+				}
+			}
+
+			for y := 0; y < height; y++ {
+				for x := 0; x < width; x++ {
+					tile := (y/tileSize)*b.tilesX + x/tileSize
+					list := indices[tileOffsets[tile]:tileOffsets[tile+1]]
+					for i := 0; i < k; i++ {
+						base := i * paramsPerCircle
+						dx, dy, r := float32(x)-float32(params[base]), float32(y)-float32(params[base+1]), float32(params[base+2])
+						if float32(params[base+6]) < 0.001 || r <= 0 || dx*dx+dy*dy > r*r {
+							continue
+						}
+						if !containsInt32(list, int32(i)) {
+							t.Fatalf("tile size %d: circle %d covers (%d,%d) but is missing from tile %d", tileSize, i, x, y, tile)
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+// TestTileBinner_SkipsInvisibleCircles checks transparent and off-image circles are not binned
+func TestTileBinner_SkipsInvisibleCircles(t *testing.T) {
+	b := newTileBinner(32, 32, 16)
+	params := []float64{
+		16, 16, 10, 1, 0, 0, 0, // transparent
+		-50, 16, 10, 1, 0, 0, 1, // off-image
+		16, 16, 0, 1, 0, 0, 1, // zero radius
+	}
+	_, indices := b.bin(params, 3, nil, nil)
+	if len(indices) != 0 {
+		t.Errorf("expected no binned circles, got %v", indices)
+	}
+}
+
+func containsInt32(list []int32, v int32) bool {
+	for _, x := range list {
+		if x == v {
+			return true
+		}
+	}
+	return false
+}
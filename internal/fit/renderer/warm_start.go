@@ -0,0 +1,188 @@
+package renderer
+
+import (
+	"image"
+	"log/slog"
+	"math"
+	"sort"
+
+	"github.com/cwbudde/mayflycirclefit/internal/opt"
+)
+
+// Temporal warm start.
+//
+// Consecutive frames of an animation differ little, so frame N+1 starts from
+// frame N's circles instead of a white canvas. A frame-difference map
+// (mean absolute RGB change per pixel, as a summed-area table) scores every
+// circle by how much its bounding box changed; only the most changed circles
+// are re-optimized, jointly, while the others stay fixed in place (their
+// compositing order is kept). The search is a trust region around the
+// previous values: each parameter may move by Radius of its range, so the
+// optimizer's population is a cloud of perturbations of frame N's solution
+// rather than random circles. Unchanged frames cost no evaluations at all.
+
+// WarmStartConfig controls OptimizeWarmStart
+type WarmStartConfig struct {
+	MaxCircles int     // Circles re-optimized per frame (most changed first)
+	Radius     float64 // Trust region half-width as a fraction of each parameter's range
+	MinChange  float64 // Circles whose mean frame difference (0..1) is below this stay fixed
+}
+
+// DefaultWarmStartConfig returns the defaults: 16 circles, ±10% of each
+// range, and a change threshold of 1/255
+func DefaultWarmStartConfig() WarmStartConfig {
+	return WarmStartConfig{
+		MaxCircles: 16,
+		Radius:     0.1,
+		MinChange:  1.0 / 255,
+	}
+}
+
+// OptimizeWarmStart refines prevParams, the circles fitted to prevFrame, for
+// rend's reference (the next frame, of the same size). rend must accept
+// len(prevParams)/ParamsPerCircle(rend) circles. The result is never worse
+// than prevParams on the new frame.
+func OptimizeWarmStart(rend Renderer, optimizer opt.Optimizer, prevParams []float64, prevFrame *image.NRGBA, config WarmStartConfig) *OptimizationResult {
+	perCircle := ParamsPerCircle(rend)
+	k := len(prevParams) / perCircle
+
+	stage := rend
+	if rend.Dim() != len(prevParams) {
+		stage = stageRenderer(rend, k)
+	}
+	params := append([]float64(nil), prevParams...)
+	initialCost := stage.Cost(params)
+
+	changed := changedCircles(params, perCircle, prevFrame, rend.Reference(), config)
+	slog.Info("Starting warm-started optimization", "circles", k, "changed", len(changed))
+	if len(changed) == 0 {
+		return &OptimizationResult{BestParams: params, BestCost: initialCost, InitialCost: initialCost}
+	}
+
+	// Trust region around the previous values of the changed circles
+	bounds := circleBounds(rend, 1)
+	dim := len(changed) * perCircle
+	initial := make([]float64, 0, dim)
+	lower := make([]float64, 0, dim)
+	upper := make([]float64, 0, dim)
+	for _, i := range changed {
+		for j := 0; j < perCircle; j++ {
+			v := params[i*perCircle+j]
+			lo, hi := bounds.Lower[j], bounds.Upper[j]
+			delta := config.Radius * (hi - lo)
+			initial = append(initial, v)
+			lower = append(lower, math.Max(lo, v-delta))
+			upper = append(upper, math.Min(hi, v+delta))
+		}
+	}
+
+	// Objective: the changed circles in place, all others fixed
+	candidate := append([]float64(nil), params...)
+	evals := 0
+	eval := func(x []float64) float64 {
+		evals++
+		for n, i := range changed {
+			copy(candidate[i*perCircle:(i+1)*perCircle], x[n*perCircle:(n+1)*perCircle])
+		}
+		return stage.Cost(candidate)
+	}
+
+	var best []float64
+	var bestCost float64
+	if resumable, ok := optimizer.(opt.ResumableOptimizer); ok {
+		best, bestCost = resumable.RunWithInitial(initial, initialCost, eval, lower, upper, dim)
+	} else {
+		best, bestCost = optimizer.Run(eval, lower, upper, dim)
+	}
+	if bestCost < initialCost {
+		for n, i := range changed {
+			copy(params[i*perCircle:(i+1)*perCircle], best[n*perCircle:(n+1)*perCircle])
+		}
+	} else {
+		bestCost = initialCost
+	}
+
+	slog.Info("Warm-started optimization complete",
+		"initial_cost", initialCost, "best_cost", bestCost, "evaluations", evals)
+
+	return &OptimizationResult{
+		BestParams:  params,
+		BestCost:    bestCost,
+		InitialCost: initialCost,
+		Evaluations: evals,
+	}
+}
+
+// changedCircles returns the indices of the circles whose bounding boxes
+// changed most between prev and next, most changed first, in at most
+// config.MaxCircles entries
+func changedCircles(params []float64, perCircle int, prev, next *image.NRGBA, config WarmStartConfig) []int {
+	diff := newDiffTable(prev, next)
+
+	type scored struct {
+		index int
+		score float64
+	}
+	var candidates []scored
+	for i := 0; i < len(params)/perCircle; i++ {
+		p := params[i*perCircle:]
+		if score := diff.mean(p[0]-p[2], p[1]-p[2], p[0]+p[2], p[1]+p[2]); score >= config.MinChange {
+			candidates = append(candidates, scored{i, score})
+		}
+	}
+	sort.SliceStable(candidates, func(a, b int) bool { return candidates[a].score > candidates[b].score })
+
+	n := min(len(candidates), config.MaxCircles)
+	changed := make([]int, n)
+	for i := range changed {
+		changed[i] = candidates[i].index
+	}
+	sort.Ints(changed) // Parameter order
+	return changed
+}
+
+// diffTable is a summed-area table of the per-pixel frame difference
+type diffTable struct {
+	width, height int
+	sum           []float64 // (width+1)×(height+1), row-major
+}
+
+// newDiffTable builds the table of mean absolute RGB differences in [0, 1]
+func newDiffTable(prev, next *image.NRGBA) *diffTable {
+	b := next.Bounds()
+	w, h := b.Dx(), b.Dy()
+	t := &diffTable{width: w, height: h, sum: make([]float64, (w+1)*(h+1))}
+	for y := 0; y < h; y++ {
+		prow := prev.Pix[y*prev.Stride:]
+		nrow := next.Pix[y*next.Stride:]
+		var rowSum float64
+		for x := 0; x < w; x++ {
+			d := 0
+			for c := 0; c < 3; c++ {
+				v := int(prow[x*4+c]) - int(nrow[x*4+c])
+				if v < 0 {
+					v = -v
+				}
+				d += v
+			}
+			rowSum += float64(d) / (3 * 255)
+			t.sum[(y+1)*(w+1)+x+1] = t.sum[y*(w+1)+x+1] + rowSum
+		}
+	}
+	return t
+}
+
+// mean returns the mean difference over the box [x0, x1]×[y0, y1] clipped to
+// the image (0 if the box misses it)
+func (t *diffTable) mean(x0, y0, x1, y1 float64) float64 {
+	ix0 := max(int(math.Floor(x0)), 0)
+	iy0 := max(int(math.Floor(y0)), 0)
+	ix1 := min(int(math.Ceil(x1))+1, t.width)
+	iy1 := min(int(math.Ceil(y1))+1, t.height)
+	if ix0 >= ix1 || iy0 >= iy1 {
+		return 0
+	}
+	w := t.width + 1
+	s := t.sum[iy1*w+ix1] - t.sum[iy0*w+ix1] - t.sum[iy1*w+ix0] + t.sum[iy0*w+ix0]
+	return s / float64((ix1-ix0)*(iy1-iy0))
+}
@@ -0,0 +1,124 @@
+package renderer
+
+import (
+	"image"
+	"math"
+	"testing"
+
+	"github.com/cwbudde/mayflycirclefit/internal/opt"
+)
+
+// renderFrame renders params to a new image (renderers reuse their canvas)
+func renderFrame(width, height int, params []float64) *image.NRGBA {
+	blank := image.NewNRGBA(image.Rect(0, 0, width, height))
+	img := NewCPURenderer(blank, len(params)/7).Render(params)
+	frame := image.NewNRGBA(img.Bounds())
+	copy(frame.Pix, img.Pix)
+	return frame
+}
+
+// TestOptimizeWarmStart fits a frame in which one circle moved, starting
+// from the previous frame's circles
+func TestOptimizeWarmStart(t *testing.T) {
+	const width, height, k = 48, 36, 10
+	prevParams := seededParams(k, width, height, 11)
+	for i := 0; i < k; i++ {
+		prevParams[i*7+6] = 0.5 + prevParams[i*7+6]/2 // Visible circles
+	}
+	prevFrame := renderFrame(width, height, prevParams)
+
+	nextParams := append([]float64(nil), prevParams...)
+	nextParams[4*7] += 3
+	nextParams[4*7+1] -= 2
+	nextFrame := renderFrame(width, height, nextParams)
+
+	rend := NewCPURenderer(nextFrame, k)
+	result := OptimizeWarmStart(rend, opt.NewMayfly(20, 20, 1), prevParams, prevFrame, DefaultWarmStartConfig())
+
+	if result.InitialCost != rend.Cost(prevParams) {
+		t.Errorf("initial cost = %f, want the previous circles' cost %f", result.InitialCost, rend.Cost(prevParams))
+	}
+	if result.BestCost >= result.InitialCost {
+		t.Errorf("warm start did not improve: initial=%f, best=%f", result.InitialCost, result.BestCost)
+	}
+	if got := rend.Cost(result.BestParams); got != result.BestCost {
+		t.Errorf("BestCost = %f, but BestParams cost %f", result.BestCost, got)
+	}
+	if result.Evaluations == 0 {
+		t.Error("no evaluations counted")
+	}
+
+	// Circles outside the changed region must stay where they were
+	changed := changedCircles(prevParams, 7, prevFrame, nextFrame, DefaultWarmStartConfig())
+	isChanged := make(map[int]bool)
+	for _, i := range changed {
+		isChanged[i] = true
+	}
+	if !isChanged[4] {
+		t.Errorf("moved circle 4 not selected, changed = %v", changed)
+	}
+	for i := 0; i < k; i++ {
+		if isChanged[i] {
+			continue
+		}
+		for j := 0; j < 7; j++ {
+			if result.BestParams[i*7+j] != prevParams[i*7+j] {
+				t.Fatalf("unchanged circle %d was modified", i)
+			}
+		}
+	}
+}
+
+// TestOptimizeWarmStartUnchangedFrame checks that a repeated frame is not
+// re-optimized
+func TestOptimizeWarmStartUnchangedFrame(t *testing.T) {
+	const width, height, k = 32, 24, 6
+	params := seededParams(k, width, height, 2)
+	frame := renderFrame(width, height, params)
+
+	result := OptimizeWarmStart(NewCPURenderer(frame, k), opt.NewMayfly(20, 20, 1), params, frame, DefaultWarmStartConfig())
+	if result.Evaluations != 0 {
+		t.Errorf("unchanged frame took %d evaluations, want 0", result.Evaluations)
+	}
+	if result.BestCost != result.InitialCost {
+		t.Errorf("BestCost = %f, want InitialCost %f", result.BestCost, result.InitialCost)
+	}
+}
+
+// TestDiffTableMean checks box means against direct summation
+func TestDiffTableMean(t *testing.T) {
+	const width, height = 17, 11
+	prev, next := randomNRGBA(width, height, 3), randomNRGBA(width, height, 4)
+	table := newDiffTable(prev, next)
+
+	pixel := func(x, y int) float64 {
+		d := 0.0
+		for c := 0; c < 3; c++ {
+			d += math.Abs(float64(prev.Pix[y*prev.Stride+x*4+c]) - float64(next.Pix[y*next.Stride+x*4+c]))
+		}
+		return d / (3 * 255)
+	}
+
+	for _, box := range [][4]float64{
+		{0, 0, 16, 10},
+		{2.5, 3.2, 7.9, 4},
+		{-5, -5, 3, 2},
+		{15, 9, 40, 40},
+	} {
+		x0, y0 := max(int(math.Floor(box[0])), 0), max(int(math.Floor(box[1])), 0)
+		x1, y1 := min(int(math.Ceil(box[2]))+1, width), min(int(math.Ceil(box[3]))+1, height)
+		sum := 0.0
+		for y := y0; y < y1; y++ {
+			for x := x0; x < x1; x++ {
+				sum += pixel(x, y)
+			}
+		}
+		want := sum / float64((x1-x0)*(y1-y0))
+		if got := table.mean(box[0], box[1], box[2], box[3]); math.Abs(got-want) > 1e-9 {
+			t.Errorf("mean%v = %f, want %f", box, got, want)
+		}
+	}
+	if got := table.mean(-10, -10, -5, -5); got != 0 {
+		t.Errorf("box outside the image: mean = %f, want 0", got)
+	}
+}
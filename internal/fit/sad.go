@@ -3,8 +3,6 @@ package fit
 import (
 	"image"
 	"log/slog"
-
-	"golang.org/x/sys/cpu"
 )
 
 // SAD (Sum of Absolute Differences) with Quadratic Weighting kernel.
@@ -20,6 +18,7 @@ import (
 // giving more importance to larger differences (more visually noticeable).
 //
 // Architecture-specific implementations:
+//   - sad_avx512_amd64.s: AVX-512BW with opmask loads (processes 16 pixels/iteration)
 //   - sad_amd64.s:     AVX2 with VPSADBW (processes 8 pixels/iteration)
 //   - sad_arm64.s:     NEON (processes 4 pixels/iteration)
 //   - sad_scalar.go:   Portable fallback
@@ -31,10 +30,13 @@ const (
 	SADBackendScalar SADBackend = iota
 	SADBackendAVX2
 	SADBackendNEON
+	SADBackendAVX512
 )
 
 func (b SADBackend) String() string {
 	switch b {
+	case SADBackendAVX512:
+		return "AVX-512"
 	case SADBackendAVX2:
 		return "AVX2"
 	case SADBackendNEON:
@@ -53,16 +55,21 @@ var ActiveSADBackend SADBackend
 var fastSAD func(a, b []uint8, stride, width, height int) float64
 
 func init() {
-	// Detect CPU features and select best SAD implementation
-	if cpu.X86.HasAVX2 {
+	// Select SAD implementation for the detected (or MAYFLY_SIMD-capped) tier
+	switch activeSIMDTier {
+	case simdTierAVX512:
+		ActiveSADBackend = SADBackendAVX512
+		fastSAD = fastSAD_AVX512
+		slog.Debug("SAD kernel initialized", "backend", "AVX-512")
+	case simdTierAVX2:
 		ActiveSADBackend = SADBackendAVX2
 		fastSAD = fastSAD_AVX2
 		slog.Debug("SAD kernel initialized", "backend", "AVX2", "instruction", "VPSADBW")
-	} else if cpu.ARM64.HasASIMD {
+	case simdTierNEON:
 		ActiveSADBackend = SADBackendNEON
 		fastSAD = fastSAD_NEON
 		slog.Debug("SAD kernel initialized", "backend", "NEON")
-	} else {
+	default:
 		ActiveSADBackend = SADBackendScalar
 		fastSAD = fastSAD_Scalar
 		slog.Debug("SAD kernel initialized", "backend", "scalar")
@@ -78,6 +85,9 @@ func init() {
 // The quadratic weighting emphasizes larger differences, which are more
 // perceptually significant.
 //
+// Images at or above ParallelCostThreshold pixels are evaluated in row bands
+// on the cost worker pool.
+//
 // Returns: Total weighted cost (not normalized)
 func FastSAD(current, reference *image.NRGBA) float64 {
 	bounds := current.Bounds()
@@ -88,7 +98,7 @@ func FastSAD(current, reference *image.NRGBA) float64 {
 		panic("FastSAD: image dimensions must match")
 	}
 
-	return fastSAD(current.Pix, reference.Pix, current.Stride, width, height)
+	return evalRows(fastSAD, current.Pix, reference.Pix, current.Stride, width, height)
 }
 
 // fastSAD_AVX2 computes SAD using AVX2 VPSADBW instruction.
@@ -115,6 +125,17 @@ func fastSAD_AVX2(a, b []uint8, stride, width, height int) float64 {
 	return sadAVX2(&a[0], &b[0], stride, width, height)
 }
 
+// fastSAD_AVX512 computes SAD using AVX-512BW (16 pixels per iteration).
+//
+// Alpha and row tails are handled with opmask loads, and the weighted values
+// are accumulated in integers, so the result matches fastSAD_Scalar exactly.
+func fastSAD_AVX512(a, b []uint8, stride, width, height int) float64 {
+	if len(a) == 0 || len(b) == 0 {
+		return 0.0
+	}
+	return sadAVX512(&a[0], &b[0], stride, width, height)
+}
+
 // fastSAD_NEON computes SAD using NEON SIMD (ARM64)
 func fastSAD_NEON(a, b []uint8, stride, width, height int) float64 {
 	// Placeholder: Will be implemented in Task 10.5
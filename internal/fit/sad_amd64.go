@@ -26,3 +26,13 @@ package fit
 // Returns:
 //   - float64: total weighted cost (scaled)
 func sadAVX2(a, b *uint8, stride, width, height int) float64
+
+// sadAVX512 computes SAD with quadratic weighting using AVX-512BW instructions.
+//
+// Plan9 assembly (sad_avx512_amd64.s) based on prototypes/sad_avx512.c. It
+// processes 16 pixels per iteration with opmask loads for the alpha channel
+// and row tails, and accumulates the weighted values exactly in integers, so
+// the result is bit-identical to the scalar reference.
+//
+// Parameters and return value are identical to sadAVX2.
+func sadAVX512(a, b *uint8, stride, width, height int) float64
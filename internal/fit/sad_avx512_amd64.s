@@ -0,0 +1,142 @@
+// Code generated from prototypes/sad_avx512.c - DO NOT EDIT (except for tuning)
+// SAD (Sum of Absolute Differences) with Quadratic Weighting - AVX-512BW Implementation
+//
+// Function signature: func sadAVX512(a, b *uint8, stride, width, height int) float64
+//
+// Algorithm (16 pixels per iteration):
+//   - Zero-masking byte loads (K1 = 0x7777...) drop the alpha channel;
+//     row tails load through K2 = K1 & tail mask
+//   - |a-b| via VPMAXUB / VPMINUB / VPSUBB
+//   - VPMADDUBSW (ones) + VPMADDWD (ones): value = |dR|+|dG|+|dB| per int32 lane
+//   - value × (255 + 9×value) in int32 (max 5,462,100), accumulated exactly
+//   - int32 lanes widened to int64 once per row or every 256 iterations
+//     (256 * 5,462,100 < 2^31)
+//   - One horizontal reduction and one multiply by CScale per image
+
+#include "textflag.h"
+
+DATA sadOnesB<>+0(SB)/1, $1
+GLOBL sadOnesB<>(SB), RODATA|NOPTR, $1
+
+DATA sadOnesW<>+0(SB)/2, $1
+GLOBL sadOnesW<>(SB), RODATA|NOPTR, $2
+
+DATA sad255<>+0(SB)/4, $255
+GLOBL sad255<>(SB), RODATA|NOPTR, $4
+
+#define SAD_FLUSH_ITERS $256
+
+// SAD16 accumulates the weighted per-pixel SAD of the pixels in Z1 (a) and
+// Z2 (b), alpha already zeroed, into the int32 lanes of Z0. Clobbers Z1-Z4.
+#define SAD16 \
+    VPMAXUB    Z2, Z1, Z3 \
+    VPMINUB    Z2, Z1, Z1 \
+    VPSUBB     Z1, Z3, Z3 \
+    VPMADDUBSW Z14, Z3, Z3 \
+    VPMADDWD   Z15, Z3, Z3 \
+    VPSLLD     $3, Z3, Z4 \
+    VPADDD     Z3, Z4, Z4 \
+    VPADDD     Z11, Z4, Z4 \
+    VPMULLD    Z4, Z3, Z3 \
+    VPADDD     Z3, Z0, Z0
+
+// WIDEN512 adds the 16 int32 lanes of Z0 into the 8 int64 lanes of Z12 and
+// clears Z0. Clobbers Z5, Z6.
+#define WIDEN512 \
+    VEXTRACTI64X4 $1, Z0, Y5 \
+    VPMOVZXDQ     Y0, Z6 \
+    VPMOVZXDQ     Y5, Z5 \
+    VPADDQ        Z6, Z12, Z12 \
+    VPADDQ        Z5, Z12, Z12 \
+    VPXORD        Z0, Z0, Z0
+
+// func sadAVX512(a, b *uint8, stride, width, height int) float64
+TEXT ·sadAVX512(SB), NOSPLIT, $0-48
+    MOVQ a+0(FP), R8          // R8 = current row of a
+    MOVQ b+8(FP), R9          // R9 = current row of b
+    MOVQ stride+16(FP), R10   // R10 = stride
+    MOVQ width+24(FP), R11    // R11 = width
+    MOVQ height+32(FP), R12   // R12 = rows remaining
+
+    VPBROADCASTB sadOnesB<>(SB), Z14   // Z14 = 64 x int8(1)
+    VPBROADCASTW sadOnesW<>(SB), Z15   // Z15 = 32 x int16(1)
+    VPBROADCASTD sad255<>(SB), Z11     // Z11 = 16 x int32(255)
+    VPXORD Z12, Z12, Z12               // Z12 = int64 accumulator
+    VPXORD Z0, Z0, Z0                  // Z0 = int32 accumulator
+
+    // K1 = RGB byte mask (alpha is bit 3 of every nibble)
+    MOVQ $0x7777777777777777, AX
+    KMOVQ AX, K1
+
+    // SI = bytes covered by full 16-pixel blocks = (width &^ 15) * 4
+    MOVQ R11, SI
+    ANDQ $-16, SI
+    SHLQ $2, SI
+
+    // BX = tail pixels, K2 = K1 & ((1 << (BX*4)) - 1)
+    MOVQ R11, BX
+    ANDQ $15, BX
+    LEAQ (BX*4), CX
+    NEGQ CX
+    ADDQ $64, CX
+    MOVQ $-1, DX
+    SHRQ CX, DX
+    ANDQ AX, DX
+    KMOVQ DX, K2
+
+    TESTQ R12, R12
+    JLE done
+
+row_loop:
+    XORQ DI, DI               // DI = byte offset within row
+    MOVQ SAD_FLUSH_ITERS, CX  // CX = iterations until next widening
+    CMPQ DI, SI
+    JGE tail
+
+simd_loop:
+    VMOVDQU8.Z (R8)(DI*1), K1, Z1   // 16 pixels from a, alpha zeroed
+    VMOVDQU8.Z (R9)(DI*1), K1, Z2   // 16 pixels from b, alpha zeroed
+    SAD16
+    ADDQ $64, DI
+    DECQ CX
+    JNZ simd_next
+    WIDEN512
+    MOVQ SAD_FLUSH_ITERS, CX
+
+simd_next:
+    CMPQ DI, SI
+    JL simd_loop
+
+tail:
+    TESTQ BX, BX
+    JZ row_done
+    VMOVDQU8.Z (R8)(DI*1), K2, Z1   // remaining pixels from a
+    VMOVDQU8.Z (R9)(DI*1), K2, Z2   // remaining pixels from b
+    SAD16
+
+row_done:
+    WIDEN512
+    ADDQ R10, R8
+    ADDQ R10, R9
+    DECQ R12
+    JNZ row_loop
+
+done:
+    // Horizontal reduction of the 8 int64 lanes (once per image)
+    VEXTRACTI64X4 $1, Z12, Y1
+    VPADDQ Y1, Y12, Y1
+    VEXTRACTI128 $1, Y1, X2
+    VPADDQ X2, X1, X1
+    VPSHUFD $0x4E, X1, X2
+    VPADDQ X2, X1, X1
+    VMOVQ X1, AX
+    VZEROUPPER
+
+    // Convert exact integer total to float64 and apply CScale
+    CVTSQ2SD AX, X0
+    MOVQ $0x3EB9CD1A00809A4E, AX
+    MOVQ AX, X1
+    MULSD X1, X0
+
+    MOVSD X0, ret+40(FP)
+    RET
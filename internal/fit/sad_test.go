@@ -129,8 +129,8 @@ func TestSAD_AlphaIgnored(t *testing.T) {
 // TestSAD_AVX2_BatchBoundaries tests AVX2 batch processing with various widths
 // AVX2 processes 8 pixels per batch, so we test exact multiples and remainders
 func TestSAD_AVX2_BatchBoundaries(t *testing.T) {
-	if ActiveSADBackend != SADBackendAVX2 {
-		t.Skipf("Skipping AVX2 batch boundary test: active backend is %s, not AVX2", ActiveSADBackend)
+	if !simdTierSupported(simdTierAVX2) {
+		t.Skipf("Skipping AVX2 batch boundary test: CPU does not support AVX2")
 	}
 
 	// Test widths that are multiples of 8 (exact batches) and non-multiples (with remainders)
@@ -142,8 +142,8 @@ func TestSAD_AVX2_BatchBoundaries(t *testing.T) {
 			img1 := randomNRGBA(width, height, 300)
 			img2 := randomNRGBA(width, height, 400)
 
-			// Compute with AVX2 backend
-			avx2Result := fastSAD(img1.Pix, img2.Pix, img1.Stride, width, height)
+			// Compute with AVX2 backend (called directly, AVX-512 may be active)
+			avx2Result := fastSAD_AVX2(img1.Pix, img2.Pix, img1.Stride, width, height)
 
 			// Compute with scalar reference
 			scalarResult := fastSAD_Scalar(img1.Pix, img2.Pix, img1.Stride, width, height)
@@ -160,6 +160,50 @@ func TestSAD_AVX2_BatchBoundaries(t *testing.T) {
 	}
 }
 
+// TestSAD_AVX512_BatchBoundaries tests AVX-512 batch processing with various widths
+// AVX-512 accumulates exactly in integers, so it must match scalar bit-for-bit
+func TestSAD_AVX512_BatchBoundaries(t *testing.T) {
+	if !simdTierSupported(simdTierAVX512) {
+		t.Skipf("Skipping AVX-512 batch boundary test: CPU does not support AVX-512BW")
+	}
+
+	widths := []int{1, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 4095, 4096, 4097}
+	height := 10
+
+	for _, width := range widths {
+		t.Run(fmt.Sprintf("width_%d", width), func(t *testing.T) {
+			img1 := randomNRGBA(width, height, 300)
+			img2 := randomNRGBA(width, height, 400)
+
+			avx512Result := fastSAD_AVX512(img1.Pix, img2.Pix, img1.Stride, width, height)
+			scalarResult := fastSAD_Scalar(img1.Pix, img2.Pix, img1.Stride, width, height)
+
+			if avx512Result != scalarResult {
+				t.Errorf("AVX-512 batch boundary error: width=%d, avx512=%.12f, scalar=%.12f",
+					width, avx512Result, scalarResult)
+			}
+		})
+	}
+}
+
+// TestSAD_AVX512_MaxDifference tests the int32 lane flush with worst-case per-pixel values
+func TestSAD_AVX512_MaxDifference(t *testing.T) {
+	if !simdTierSupported(simdTierAVX512) {
+		t.Skipf("Skipping AVX-512 max difference test: CPU does not support AVX-512BW")
+	}
+
+	// 256 iterations * 16 pixels per flush block; cover several blocks plus a tail
+	width, height := 256*16*3+5, 2
+	black := solidColorNRGBA(width, height, color.NRGBA{0, 0, 0, 255})
+	white := solidColorNRGBA(width, height, color.NRGBA{255, 255, 255, 0})
+
+	got := fastSAD_AVX512(black.Pix, white.Pix, black.Stride, width, height)
+	want := fastSAD_Scalar(black.Pix, white.Pix, black.Stride, width, height)
+	if got != want {
+		t.Errorf("AVX-512 max difference error: avx512=%.12f, scalar=%.12f", got, want)
+	}
+}
+
 // TestSAD_NEON_BatchBoundaries tests NEON batch processing with various widths
 // NEON processes 4 pixels per batch (128-bit registers), so we test multiples of 4
 func TestSAD_NEON_BatchBoundaries(t *testing.T) {
@@ -267,6 +311,9 @@ func TestSAD_PerformanceBaseline(t *testing.T) {
 	var backendName string
 
 	switch ActiveSADBackend {
+	case SADBackendAVX512:
+		expectedMin = 2000 // 2 Gpixels/sec minimum
+		backendName = "AVX-512"
 	case SADBackendAVX2:
 		expectedMin = 1000 // 1 Gpixels/sec minimum (lower than SSD due to quadratic formula)
 		backendName = "AVX2"
@@ -387,8 +434,11 @@ func TestSAD_BackendSelection(t *testing.T) {
 	t.Logf("Active SAD backend: %s", ActiveSADBackend)
 
 	// Verify backend is consistent with CPU features
+	if ActiveSADBackend == SADBackendAVX512 && !(cpu.X86.HasAVX512F && cpu.X86.HasAVX512BW) {
+		t.Errorf("AVX-512 backend selected but CPU doesn't support AVX-512BW")
+	}
 	if cpu.X86.HasAVX2 {
-		if ActiveSADBackend != SADBackendAVX2 {
+		if ActiveSADBackend != SADBackendAVX2 && ActiveSADBackend != SADBackendAVX512 {
 			t.Logf("Note: AVX2 available but backend is %s (may be disabled via GODEBUG)", ActiveSADBackend)
 		} else {
 			t.Logf("AVX2 backend correctly selected")
@@ -475,6 +525,35 @@ func BenchmarkSAD_HighLevel(b *testing.B) {
 	b.ReportMetric(mpixels, "Mpixels/sec")
 }
 
+// BenchmarkSAD_Tiers benchmarks every SIMD tier supported by this CPU side-by-side
+func BenchmarkSAD_Tiers(b *testing.B) {
+	tiers := []struct {
+		tier simdTier
+		fn   func(a, b []uint8, stride, width, height int) float64
+	}{
+		{simdTierScalar, fastSAD_Scalar},
+		{simdTierAVX2, fastSAD_AVX2},
+		{simdTierAVX512, fastSAD_AVX512},
+	}
+
+	img1 := randomNRGBA(512, 512, 100)
+	img2 := randomNRGBA(512, 512, 200)
+
+	for _, tc := range tiers {
+		if !simdTierSupported(tc.tier) {
+			continue
+		}
+		b.Run(tc.tier.String(), func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				tc.fn(img1.Pix, img2.Pix, img1.Stride, 512, 512)
+			}
+			elapsed := b.Elapsed().Seconds()
+			mpixels := float64(b.N*512*512) / 1e6 / elapsed
+			b.ReportMetric(mpixels, "Mpixels/sec")
+		})
+	}
+}
+
 // BenchmarkSADvsSSD compares SAD and SSD implementations
 func BenchmarkSADvsSSD(b *testing.B) {
 	img1 := randomNRGBA(256, 256, 100)
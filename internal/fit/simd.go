@@ -0,0 +1,102 @@
+package fit
+
+import (
+	"log/slog"
+	"os"
+	"strings"
+
+	"golang.org/x/sys/cpu"
+)
+
+// SIMD tier selection shared by the SSD and SAD kernels.
+//
+// Dispatch order is AVX-512 → AVX2 → scalar on x86-64 and NEON → scalar on
+// ARM64. The MAYFLY_SIMD environment variable caps the tier so every kernel
+// can be benchmarked and tested on the same machine:
+//
+//	MAYFLY_SIMD=avx512  AVX-512BW if available (same as auto on x86-64)
+//	MAYFLY_SIMD=avx2    AVX2 even on AVX-512 hardware
+//	MAYFLY_SIMD=neon    NEON if available
+//	MAYFLY_SIMD=scalar  Portable scalar kernels only
+//	MAYFLY_SIMD=auto    Best available tier (default when unset)
+//
+// A requested tier the CPU does not support falls back to the next lower tier
+// the CPU does support, with a warning: on ARM64, avx512 and avx2 select NEON.
+
+// SIMDEnvVar is the environment variable that overrides kernel selection.
+const SIMDEnvVar = "MAYFLY_SIMD"
+
+// simdTier orders kernel implementations from slowest to fastest.
+type simdTier int
+
+const (
+	simdTierScalar simdTier = iota
+	simdTierNEON
+	simdTierAVX2
+	simdTierAVX512
+)
+
+func (t simdTier) String() string {
+	switch t {
+	case simdTierAVX512:
+		return "avx512"
+	case simdTierAVX2:
+		return "avx2"
+	case simdTierNEON:
+		return "neon"
+	default:
+		return "scalar"
+	}
+}
+
+// activeSIMDTier is resolved once, before any init() selects its kernel.
+var activeSIMDTier = selectSIMDTier(os.Getenv(SIMDEnvVar))
+
+// simdTierSupported reports whether the CPU (and OS) can run the given tier.
+func simdTierSupported(t simdTier) bool {
+	switch t {
+	case simdTierAVX512:
+		return cpu.X86.HasAVX512F && cpu.X86.HasAVX512BW
+	case simdTierAVX2:
+		return cpu.X86.HasAVX2
+	case simdTierNEON:
+		return cpu.ARM64.HasASIMD
+	default:
+		return true
+	}
+}
+
+// selectSIMDTier resolves an override value (empty = auto) to a supported tier.
+func selectSIMDTier(override string) simdTier {
+	var requested simdTier
+	switch strings.ToLower(strings.TrimSpace(override)) {
+	case "", "auto":
+		requested = simdTierAVX512
+		if !simdTierSupported(simdTierAVX512) && !simdTierSupported(simdTierAVX2) {
+			requested = simdTierNEON
+		}
+	case "avx512", "avx-512":
+		requested = simdTierAVX512
+	case "avx2":
+		requested = simdTierAVX2
+	case "neon":
+		requested = simdTierNEON
+	case "scalar", "none", "off":
+		requested = simdTierScalar
+	default:
+		slog.Warn("Unknown SIMD override, using auto", "env", SIMDEnvVar, "value", override)
+		return selectSIMDTier("")
+	}
+
+	// Step down one tier at a time, so a cap of avx2 on ARM64 still selects NEON
+	tier := requested
+	for !simdTierSupported(tier) {
+		tier--
+	}
+
+	if override != "" && tier != requested {
+		slog.Warn("Requested SIMD tier not supported, falling back",
+			"env", SIMDEnvVar, "requested", requested, "selected", tier)
+	}
+	return tier
+}
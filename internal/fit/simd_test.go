@@ -0,0 +1,56 @@
+package fit
+
+import "testing"
+
+// TestSelectSIMDTier_Override tests MAYFLY_SIMD parsing and fallback to supported tiers
+func TestSelectSIMDTier_Override(t *testing.T) {
+	best := selectSIMDTier("")
+
+	tests := []struct {
+		override string
+		want     simdTier
+	}{
+		{"", best},
+		{"auto", best},
+		{"AUTO", best},
+		{"scalar", simdTierScalar},
+		{"off", simdTierScalar},
+		{"bogus", best},
+	}
+
+	for _, tt := range tests {
+		if got := selectSIMDTier(tt.override); got != tt.want {
+			t.Errorf("selectSIMDTier(%q) = %s, want %s", tt.override, got, tt.want)
+		}
+	}
+
+	// Requested tiers never exceed the request and are always supported
+	for _, override := range []string{"avx512", "avx2", "neon", "scalar"} {
+		got := selectSIMDTier(override)
+		if !simdTierSupported(got) {
+			t.Errorf("selectSIMDTier(%q) = %s, which is not supported", override, got)
+		}
+	}
+
+	if simdTierSupported(simdTierAVX2) {
+		if got := selectSIMDTier("avx2"); got != simdTierAVX2 {
+			t.Errorf("selectSIMDTier(avx2) = %s, want avx2 on AVX2 hardware", got)
+		}
+	}
+	if simdTierSupported(simdTierAVX512) {
+		if best != simdTierAVX512 {
+			t.Errorf("auto selected %s, want avx512 on AVX-512BW hardware", best)
+		}
+	} else if got := selectSIMDTier("avx512"); got == simdTierAVX512 {
+		t.Errorf("selectSIMDTier(avx512) selected AVX-512 on unsupported hardware")
+	}
+}
+
+// TestActiveBackends_MatchTier tests that SSD and SAD dispatch follow the same tier
+func TestActiveBackends_MatchTier(t *testing.T) {
+	t.Logf("Active SIMD tier: %s (SSD=%s, SAD=%s)", activeSIMDTier, ActiveSSDBackend, ActiveSADBackend)
+
+	if ActiveSSDBackend.String() != ActiveSADBackend.String() {
+		t.Errorf("SSD backend %s and SAD backend %s differ", ActiveSSDBackend, ActiveSADBackend)
+	}
+}
@@ -3,8 +3,6 @@ package fit
 import (
 	"image"
 	"log/slog"
-
-	"golang.org/x/sys/cpu"
 )
 
 // SSD (Sum of Squared Differences) kernel interface for SIMD-accelerated cost computation.
@@ -14,6 +12,7 @@ import (
 // or scalar fallback.
 //
 // Architecture-specific implementations:
+//   - ssd_avx512_amd64.s: AVX-512BW implementation (512-bit, processes 16 pixels/iteration)
 //   - ssd_amd64.s:      AVX2 implementation (256-bit, processes 8 pixels/iteration)
 //   - ssd_arm64.s:      NEON implementation (128-bit, processes 4 pixels/iteration)
 //   - ssd_generic.go:   Scalar fallback (all other platforms)
@@ -30,10 +29,13 @@ const (
 	SSDBackendScalar SSDBackend = iota // Scalar fallback (no SIMD)
 	SSDBackendAVX2                     // AVX2 (x86-64, 256-bit)
 	SSDBackendNEON                     // NEON (ARM64, 128-bit)
+	SSDBackendAVX512                   // AVX-512BW (x86-64, 512-bit)
 )
 
 func (b SSDBackend) String() string {
 	switch b {
+	case SSDBackendAVX512:
+		return "AVX-512"
 	case SSDBackendAVX2:
 		return "AVX2"
 	case SSDBackendNEON:
@@ -53,19 +55,24 @@ var ActiveSSDBackend SSDBackend
 var fastSSD func(a, b []uint8, stride, width, height int) float64
 
 func init() {
-	// Detect CPU features and select best SSD implementation
-	if cpu.X86.HasAVX2 {
+	// Select SSD implementation for the detected (or MAYFLY_SIMD-capped) tier
+	switch activeSIMDTier {
+	case simdTierAVX512:
+		ActiveSSDBackend = SSDBackendAVX512
+		fastSSD = fastSSD_AVX512
+		slog.Debug("SSD kernel initialized", "backend", "AVX-512", "width", "512-bit")
+	case simdTierAVX2:
 		ActiveSSDBackend = SSDBackendAVX2
 		fastSSD = fastSSD_AVX2
 		slog.Debug("SSD kernel initialized", "backend", "AVX2", "width", "256-bit")
-	} else if cpu.ARM64.HasASIMD {
+	case simdTierNEON:
 		ActiveSSDBackend = SSDBackendNEON
 		fastSSD = fastSSD_NEON
 		slog.Debug("SSD kernel initialized", "backend", "NEON", "width", "128-bit")
-	} else {
+	default:
 		ActiveSSDBackend = SSDBackendScalar
 		fastSSD = fastSSD_Scalar
-		slog.Debug("SSD kernel initialized", "backend", "scalar", "reason", "no SIMD support")
+		slog.Debug("SSD kernel initialized", "backend", "scalar", "reason", "no SIMD support or override")
 	}
 }
 
@@ -78,7 +85,8 @@ func init() {
 //
 // Returns: MSE = sum(squared differences) / (width * height * 3)
 //
-// Performance: Uses runtime-dispatched SIMD kernel (AVX2/NEON/scalar).
+// Performance: Uses runtime-dispatched SIMD kernel (AVX-512/AVX2/NEON/scalar),
+// multi-threaded for images at or above ParallelCostThreshold pixels.
 func FastSSD(current, reference *image.NRGBA) float64 {
 	bounds := current.Bounds()
 	width := bounds.Dx()
@@ -88,8 +96,9 @@ func FastSSD(current, reference *image.NRGBA) float64 {
 		panic("FastSSD: image dimensions must match")
 	}
 
-	// Call low-level kernel (operates on raw pixel buffers)
-	sum := fastSSD(current.Pix, reference.Pix, current.Stride, width, height)
+	// Call low-level kernel (operates on raw pixel buffers); large images are
+	// split into row bands on the cost worker pool (see cost_parallel.go)
+	sum := evalRows(fastSSD, current.Pix, reference.Pix, current.Stride, width, height)
 
 	// Return mean over pixels and channels (3 channels: RGB)
 	return sum / float64(width*height*3)
@@ -99,15 +108,18 @@ func FastSSD(current, reference *image.NRGBA) float64 {
 
 // fastSSD_AVX2 computes SSD using AVX2 SIMD instructions (256-bit).
 //
-// Implementation: ssd_amd64.s (hand-written Plan9 assembly or GoAT-generated)
+// Implementation: ssd_amd64.s (hand-written Plan9 assembly from prototypes/ssd_avx2_v3.c)
 //
 // Algorithm (per iteration):
 //   1. Load 8 RGBA pixels from `a` (32 bytes)
 //   2. Load 8 RGBA pixels from `b` (32 bytes)
-//   3. Extract RGB bytes (ignore alpha): de-interleave or mask
-//   4. Compute per-channel differences: dr = a.r - b.r, dg = a.g - b.g, db = a.b - b.b
-//   5. Square differences: dr^2, dg^2, db^2
-//   6. Accumulate into running sum (horizontal add reduction at end)
+//   3. Clear alpha with VPAND (mask 0x00FFFFFF per pixel)
+//   4. Widen to int16 and compute per-channel differences (VPUNPCK*BW, VPSUBW)
+//   5. Square and pair-sum into int32 lanes (VPMADDWD)
+//   6. Widen int32 lanes to int64 once per row (or every 4096 iterations)
+//
+// Row tails use a masked load (VPMASKMOVD), and the horizontal reduction runs
+// once per image, so there is no scalar code in the kernel at all.
 //
 // Performance target: 4-6x speedup over scalar (processes 8 pixels per iteration)
 //
@@ -129,6 +141,20 @@ func fastSSD_AVX2(a, b []uint8, stride, width, height int) float64 {
 	return ssdAVX2(&a[0], &b[0], stride, width, height)
 }
 
+// fastSSD_AVX512 computes SSD using AVX-512BW SIMD instructions (512-bit).
+//
+// Implementation: ssd_avx512_amd64.s (hand-written Plan9 assembly from prototypes/ssd_avx512.c)
+//
+// Same algorithm as fastSSD_AVX2 on 16 pixels per iteration. The alpha channel
+// and row tails are both handled by zero-masking byte loads (opmask registers),
+// so no VPAND or separate tail path is needed.
+func fastSSD_AVX512(a, b []uint8, stride, width, height int) float64 {
+	if len(a) == 0 || len(b) == 0 {
+		return 0.0
+	}
+	return ssdAVX512(&a[0], &b[0], stride, width, height)
+}
+
 // fastSSD_NEON computes SSD using NEON SIMD instructions (128-bit).
 //
 // Implementation: ssd_arm64.s (hand-written Plan9 assembly or GoAT-generated)
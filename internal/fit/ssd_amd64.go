@@ -1,4 +1,4 @@
-// Code generated from prototypes/ssd_avx2.c - DO NOT EDIT
+// Code generated from prototypes/ssd_avx2_v3.c and prototypes/ssd_avx512.c - DO NOT EDIT
 
 //go:build amd64
 
@@ -6,8 +6,8 @@ package fit
 
 // ssdAVX2 computes sum of squared RGB differences using AVX2 SIMD instructions.
 //
-// This is a hand-written Plan9 assembly implementation based on the C prototype
-// in prototypes/ssd_avx2.c. It processes 8 pixels at a time using 256-bit AVX2
+// Plan9 assembly (ssd_amd64.s) based on the fully vectorized C prototype in
+// prototypes/ssd_avx2_v3.c. It processes 8 pixels at a time using 256-bit AVX2
 // registers for improved performance over the scalar baseline.
 //
 // Parameters:
@@ -21,3 +21,12 @@ package fit
 //
 // Performance: Targets 4-6× speedup over scalar implementation.
 func ssdAVX2(a, b *uint8, stride, width, height int) float64
+
+// ssdAVX512 computes sum of squared RGB differences using AVX-512BW instructions.
+//
+// Plan9 assembly (ssd_avx512_amd64.s) based on prototypes/ssd_avx512.c. It
+// processes 16 pixels per iteration and uses opmask registers both to drop the
+// alpha channel and to load row tails without a scalar loop.
+//
+// Parameters and return value are identical to ssdAVX2.
+func ssdAVX512(a, b *uint8, stride, width, height int) float64
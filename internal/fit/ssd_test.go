@@ -281,8 +281,8 @@ func TestFastSSD_DimensionMismatch(t *testing.T) {
 // TestFastSSD_AVX2_BatchBoundaries tests AVX2 batch processing with various widths
 // AVX2 processes 8 pixels per batch, so we test exact multiples and remainders
 func TestFastSSD_AVX2_BatchBoundaries(t *testing.T) {
-	if ActiveSSDBackend != SSDBackendAVX2 {
-		t.Skipf("Skipping AVX2 batch boundary test: active backend is %s, not AVX2", ActiveSSDBackend)
+	if !simdTierSupported(simdTierAVX2) {
+		t.Skipf("Skipping AVX2 batch boundary test: CPU does not support AVX2")
 	}
 
 	// Test widths that are multiples of 8 (exact batches) and non-multiples (with remainders)
@@ -294,8 +294,8 @@ func TestFastSSD_AVX2_BatchBoundaries(t *testing.T) {
 			img1 := randomNRGBA(width, height, 100)
 			img2 := randomNRGBA(width, height, 200)
 
-			// Compute with AVX2 backend
-			avx2Result := fastSSD(img1.Pix, img2.Pix, img1.Stride, width, height)
+			// Compute with AVX2 backend (called directly, AVX-512 may be active)
+			avx2Result := fastSSD_AVX2(img1.Pix, img2.Pix, img1.Stride, width, height)
 
 			// Compute with scalar reference
 			scalarResult := fastSSD_Scalar(img1.Pix, img2.Pix, img1.Stride, width, height)
@@ -312,6 +312,106 @@ func TestFastSSD_AVX2_BatchBoundaries(t *testing.T) {
 	}
 }
 
+// TestFastSSD_AVX2_LaneWidening tests rows long enough to trigger the periodic
+// int32 -> int64 widening inside a row, using worst-case (0 vs 255) differences
+func TestFastSSD_AVX2_LaneWidening(t *testing.T) {
+	if !simdTierSupported(simdTierAVX2) {
+		t.Skipf("Skipping AVX2 lane widening test: CPU does not support AVX2")
+	}
+
+	// 4096 iterations * 8 pixels per widening block; cover 0, 1 and 2 blocks plus tails
+	widths := []int{32767, 32768, 32769, 65541}
+	height := 3
+
+	for _, width := range widths {
+		t.Run(fmt.Sprintf("width_%d", width), func(t *testing.T) {
+			black := solidColorNRGBA(width, height, color.NRGBA{0, 0, 0, 0})
+			white := solidColorNRGBA(width, height, color.NRGBA{255, 255, 255, 255})
+
+			avx2Result := fastSSD_AVX2(black.Pix, white.Pix, black.Stride, width, height)
+			expected := float64(width*height) * 3 * 255 * 255
+
+			if avx2Result != expected {
+				t.Errorf("AVX2 lane widening error: width=%d, avx2=%f, expected=%f", width, avx2Result, expected)
+			}
+		})
+	}
+}
+
+// TestFastSSD_AVX512_BatchBoundaries tests AVX-512 batch processing with various widths
+// AVX-512 processes 16 pixels per batch; tails go through the opmask load
+func TestFastSSD_AVX512_BatchBoundaries(t *testing.T) {
+	if !simdTierSupported(simdTierAVX512) {
+		t.Skipf("Skipping AVX-512 batch boundary test: CPU does not support AVX-512BW")
+	}
+
+	widths := []int{1, 7, 8, 15, 16, 17, 31, 32, 33, 47, 48, 49, 63, 64, 65, 255, 256, 257}
+	height := 10
+
+	for _, width := range widths {
+		t.Run(fmt.Sprintf("width_%d", width), func(t *testing.T) {
+			img1 := randomNRGBA(width, height, 100)
+			img2 := randomNRGBA(width, height, 200)
+
+			avx512Result := fastSSD_AVX512(img1.Pix, img2.Pix, img1.Stride, width, height)
+			scalarResult := fastSSD_Scalar(img1.Pix, img2.Pix, img1.Stride, width, height)
+
+			if avx512Result != scalarResult {
+				t.Errorf("AVX-512 batch boundary error: width=%d, avx512=%f, scalar=%f",
+					width, avx512Result, scalarResult)
+			}
+		})
+	}
+}
+
+// TestFastSSD_AVX512_LaneWidening tests rows that trigger the in-row int32 -> int64 widening
+func TestFastSSD_AVX512_LaneWidening(t *testing.T) {
+	if !simdTierSupported(simdTierAVX512) {
+		t.Skipf("Skipping AVX-512 lane widening test: CPU does not support AVX-512BW")
+	}
+
+	// 4096 iterations * 16 pixels per widening block
+	widths := []int{65535, 65536, 65537, 131077}
+	height := 2
+
+	for _, width := range widths {
+		t.Run(fmt.Sprintf("width_%d", width), func(t *testing.T) {
+			black := solidColorNRGBA(width, height, color.NRGBA{0, 0, 0, 0})
+			white := solidColorNRGBA(width, height, color.NRGBA{255, 255, 255, 255})
+
+			result := fastSSD_AVX512(black.Pix, white.Pix, black.Stride, width, height)
+			expected := float64(width*height) * 3 * 255 * 255
+
+			if result != expected {
+				t.Errorf("AVX-512 lane widening error: width=%d, avx512=%f, expected=%f", width, result, expected)
+			}
+		})
+	}
+}
+
+// TestFastSSD_AVX512_PaddedStride tests that padding bytes between rows are ignored
+func TestFastSSD_AVX512_PaddedStride(t *testing.T) {
+	if !simdTierSupported(simdTierAVX512) {
+		t.Skipf("Skipping AVX-512 padded stride test: CPU does not support AVX-512BW")
+	}
+
+	width, height := 21, 9
+	stride := width*4 + 44
+	a := make([]uint8, stride*height)
+	b := make([]uint8, stride*height)
+	rng := rand.New(rand.NewSource(7))
+	for i := range a {
+		a[i] = uint8(rng.Intn(256))
+		b[i] = uint8(rng.Intn(256))
+	}
+
+	got := fastSSD_AVX512(a, b, stride, width, height)
+	want := fastSSD_Scalar(a, b, stride, width, height)
+	if got != want {
+		t.Errorf("AVX-512 padded stride error: avx512=%f, scalar=%f", got, want)
+	}
+}
+
 // TestFastSSD_NEON_BatchBoundaries tests NEON batch processing with various widths
 // NEON processes 4 pixels per batch (128-bit registers), so we test multiples of 4
 func TestFastSSD_NEON_BatchBoundaries(t *testing.T) {
@@ -418,6 +518,9 @@ func TestFastSSD_PerformanceBaseline(t *testing.T) {
 	var backendName string
 
 	switch ActiveSSDBackend {
+	case SSDBackendAVX512:
+		expectedMin = 2500 // 2.5 Gpixels/sec minimum
+		backendName = "AVX-512"
 	case SSDBackendAVX2:
 		expectedMin = 1500 // 1.5 Gpixels/sec minimum
 		backendName = "AVX2"
@@ -538,8 +641,11 @@ func TestFastSSD_BackendSelection(t *testing.T) {
 	t.Logf("Active SSD backend: %s", ActiveSSDBackend)
 
 	// Verify backend is consistent with CPU features
+	if ActiveSSDBackend == SSDBackendAVX512 && !(cpu.X86.HasAVX512F && cpu.X86.HasAVX512BW) {
+		t.Errorf("AVX-512 backend selected but CPU doesn't support AVX-512BW")
+	}
 	if cpu.X86.HasAVX2 {
-		if ActiveSSDBackend != SSDBackendAVX2 {
+		if ActiveSSDBackend != SSDBackendAVX2 && ActiveSSDBackend != SSDBackendAVX512 {
 			t.Logf("Note: AVX2 available but backend is %s (may be disabled via GODEBUG)", ActiveSSDBackend)
 		} else {
 			t.Logf("AVX2 backend correctly selected")
@@ -626,7 +732,8 @@ func BenchmarkFastSSD_HighLevel(b *testing.B) {
 	b.ReportMetric(mpixelsPerSec, "Mpixels/sec")
 }
 
-// BenchmarkFastSSD_Comparison benchmarks scalar vs active backend side-by-side
+// BenchmarkFastSSD_Comparison benchmarks scalar vs active backend side-by-side,
+// plus the active backend row-partitioned on the cost worker pool
 func BenchmarkFastSSD_Comparison(b *testing.B) {
 	sizes := []struct {
 		name          string
@@ -636,6 +743,8 @@ func BenchmarkFastSSD_Comparison(b *testing.B) {
 		{"128x128", 128, 128},
 		{"256x256", 256, 256},
 		{"512x512", 512, 512},
+		{"2048x2048", 2048, 2048},
+		{"4096x4096", 4096, 4096},
 	}
 
 	for _, sz := range sizes {
@@ -660,6 +769,44 @@ func BenchmarkFastSSD_Comparison(b *testing.B) {
 			mpixelsPerSec := BenchmarkSSDBackend(b.N, sz.width, sz.height, b.Elapsed().Nanoseconds())
 			b.ReportMetric(mpixelsPerSec, "Mpixels/sec")
 		})
+
+		b.Run(sz.name+"_parallel", func(b *testing.B) {
+			b.Logf("Active backend: %s, bands: %d", ActiveSSDBackend, getCostPool().bands(sz.height))
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				parallelSSD(img1.Pix, img2.Pix, img1.Stride, sz.width, sz.height)
+			}
+			mpixelsPerSec := BenchmarkSSDBackend(b.N, sz.width, sz.height, b.Elapsed().Nanoseconds())
+			b.ReportMetric(mpixelsPerSec, "Mpixels/sec")
+		})
+	}
+}
+
+// BenchmarkFastSSD_Tiers benchmarks every SIMD tier supported by this CPU side-by-side
+// (use MAYFLY_SIMD to change which tier FastSSD itself dispatches to)
+func BenchmarkFastSSD_Tiers(b *testing.B) {
+	tiers := []struct {
+		tier simdTier
+		fn   func(a, b []uint8, stride, width, height int) float64
+	}{
+		{simdTierScalar, fastSSD_Scalar},
+		{simdTierAVX2, fastSSD_AVX2},
+		{simdTierAVX512, fastSSD_AVX512},
+	}
+
+	img1 := randomNRGBA(512, 512, 1)
+	img2 := randomNRGBA(512, 512, 2)
+
+	for _, tc := range tiers {
+		if !simdTierSupported(tc.tier) {
+			continue
+		}
+		b.Run(tc.tier.String(), func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				tc.fn(img1.Pix, img2.Pix, img1.Stride, 512, 512)
+			}
+			b.ReportMetric(BenchmarkSSDBackend(b.N, 512, 512, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+		})
 	}
 }
 
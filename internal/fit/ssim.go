@@ -0,0 +1,252 @@
+package fit
+
+import (
+	"fmt"
+	"image"
+	"sync"
+)
+
+// Windowed SSIM cost using summed-area tables.
+//
+// SSIMCost is 1 - mean SSIM over w×w windows of the luma channel, sampled every
+// `step` pixels. It is cheap enough to serve as the optimizer objective:
+//
+//   - Reference luma and its per-window sums Σr, Σr² are computed once
+//   - Each evaluation builds summed-area tables of Σc, Σc² and Σc·r for the
+//     canvas in one pass, then reads every window sum from 4 table corners.
+//     Rows are accumulated into per-column running sums; only the table rows
+//     a window starts or ends on are materialized (a fraction 2/step at most)
+//   - Tables are uint32 and rely on wrap-around arithmetic: a window sum is
+//     exact modulo 2^32 and the true value is below 2^32 (w ≤ MaxSSIMWindow),
+//     so whole-image overflow does not matter and memory traffic is halved
+//   - The SSIM formula is evaluated on the integer sums directly, with the n²
+//     factors cancelling, so each window costs one division
+//
+// Luma is the integer BT.601 approximation Y = (77R + 150G + 29B + 128) >> 8.
+
+const (
+	// DefaultSSIMWindow is the window edge length in pixels
+	DefaultSSIMWindow = 8
+	// DefaultSSIMStep is the distance between window origins (half-overlapping)
+	DefaultSSIMStep = 4
+	// MaxSSIMWindow keeps every window sum of c² below 2^32
+	MaxSSIMWindow = 256
+)
+
+// SSIM stabilizing constants for 8-bit data: (0.01×255)² and (0.03×255)²
+const (
+	ssimC1 = (0.01 * 255) * (0.01 * 255)
+	ssimC2 = (0.03 * 255) * (0.03 * 255)
+)
+
+// SSIMCost evaluates 1 - mean SSIM against a pre-processed reference.
+type SSIMCost struct {
+	width, height int
+	window, step  int
+
+	refLuma []uint8 // width*height reference luma
+
+	// satSlot maps a table row (0..height) to its slot in the compact canvas
+	// tables, or -1 when no window starts or ends on it
+	satSlot []int
+	slots   int
+
+	// Per-window reference terms, in window order
+	refSum []float64 // Σr
+	refVar []float64 // n·Σr² - (Σr)²
+
+	scratch sync.Pool // *ssimScratch, so one SSIMCost can be shared across goroutines
+}
+
+// ssimScratch holds the canvas summed-area tables of one evaluation.
+type ssimScratch struct {
+	colC, colCC, colCR []uint32 // running column sums, width
+	sumC, sumCC, sumCR []uint32 // compact tables, slots*(width+1)
+}
+
+// NewSSIMCost pre-processes reference for window×window SSIM sampled every step
+// pixels. The window is clamped to the image size.
+func NewSSIMCost(reference *image.NRGBA, window, step int) (*SSIMCost, error) {
+	bounds := reference.Bounds()
+	width, height := bounds.Dx(), bounds.Dy()
+
+	if window < 1 || window > MaxSSIMWindow {
+		return nil, fmt.Errorf("SSIM window must be in [1, %d], got %d", MaxSSIMWindow, window)
+	}
+	if step < 1 {
+		return nil, fmt.Errorf("SSIM step must be positive, got %d", step)
+	}
+	if width == 0 || height == 0 {
+		return nil, fmt.Errorf("SSIM reference must not be empty")
+	}
+	window = min(window, min(width, height))
+
+	s := &SSIMCost{
+		width:   width,
+		height:  height,
+		window:  window,
+		step:    step,
+		refLuma: make([]uint8, width*height),
+	}
+	stride := width + 1
+
+	s.satSlot = make([]int, height+1)
+	for i := range s.satSlot {
+		s.satSlot[i] = -1
+	}
+	for y := 0; y+window <= height; y += step {
+		for _, row := range []int{y, y + window} {
+			if s.satSlot[row] < 0 {
+				s.satSlot[row] = 0
+			}
+		}
+	}
+	for i, used := range s.satSlot {
+		if used == 0 {
+			s.satSlot[i] = s.slots
+			s.slots++
+		}
+	}
+
+	s.scratch.New = func() any {
+		n := s.slots * stride
+		return &ssimScratch{
+			colC:  make([]uint32, width),
+			colCC: make([]uint32, width),
+			colCR: make([]uint32, width),
+			sumC:  make([]uint32, n),
+			sumCC: make([]uint32, n),
+			sumCR: make([]uint32, n),
+		}
+	}
+
+	for y := 0; y < height; y++ {
+		row := y * reference.Stride
+		for x := 0; x < width; x++ {
+			i := row + x*4
+			s.refLuma[y*width+x] = lumaOf(reference.Pix[i], reference.Pix[i+1], reference.Pix[i+2])
+		}
+	}
+
+	// Reference tables are only needed once, to derive the per-window terms
+	sumR := make([]uint32, stride*(height+1))
+	sumRR := make([]uint32, stride*(height+1))
+	for y := 0; y < height; y++ {
+		var rowR, rowRR uint32
+		for x := 0; x < width; x++ {
+			r := uint32(s.refLuma[y*width+x])
+			rowR += r
+			rowRR += r * r
+			i := (y+1)*stride + x + 1
+			sumR[i] = sumR[i-stride] + rowR
+			sumRR[i] = sumRR[i-stride] + rowRR
+		}
+	}
+
+	n := float64(window * window)
+	for y := 0; y+window <= height; y += step {
+		for x := 0; x+window <= width; x += step {
+			top, bottom := y*stride, (y+window)*stride
+			r := float64(boxSum(sumR, top, bottom, x, window))
+			rr := float64(boxSum(sumRR, top, bottom, x, window))
+			s.refSum = append(s.refSum, r)
+			s.refVar = append(s.refVar, n*rr-r*r)
+		}
+	}
+
+	return s, nil
+}
+
+// lumaOf returns the integer BT.601 luma of an sRGB pixel.
+func lumaOf(r, g, b uint8) uint8 {
+	return uint8((77*uint32(r) + 150*uint32(g) + 29*uint32(b) + 128) >> 8)
+}
+
+// boxSum reads the window [x, x+w) between two summed-area table rows
+// (given as offsets of their first element).
+func boxSum(sat []uint32, top, bottom, x, w int) uint32 {
+	top += x
+	bottom += x
+	return sat[bottom+w] - sat[bottom] - sat[top+w] + sat[top]
+}
+
+// Cost implements CostFunc: 1 - mean SSIM (0 for identical images). reference
+// must be the image passed to NewSSIMCost; only its dimensions are checked.
+func (s *SSIMCost) Cost(current, reference *image.NRGBA) float64 {
+	bounds := current.Bounds()
+	width, height := bounds.Dx(), bounds.Dy()
+
+	if width != s.width || height != s.height ||
+		width != reference.Bounds().Dx() || height != reference.Bounds().Dy() {
+		panic("SSIMCost: image dimensions must match")
+	}
+
+	return 1 - s.meanSSIM(current)
+}
+
+// meanSSIM returns the mean SSIM of current over all sampled windows.
+func (s *SSIMCost) meanSSIM(current *image.NRGBA) float64 {
+	sc := s.scratch.Get().(*ssimScratch)
+	defer s.scratch.Put(sc)
+
+	width, height, stride := s.width, s.height, s.width+1
+	colC, colCC, colCR := sc.colC, sc.colCC, sc.colCR
+	sumC, sumCC, sumCR := sc.sumC, sc.sumCC, sc.sumCR
+	clear(colC)
+	clear(colCC)
+	clear(colCR)
+
+	// One pass: canvas luma into column sums; table rows are prefix sums of
+	// the column sums, built only where a window boundary needs them
+	for y := 0; y < height; y++ {
+		pix := current.Pix[y*current.Stride:]
+		ref := s.refLuma[y*width : (y+1)*width]
+		for x, r := range ref {
+			c := uint32(lumaOf(pix[x*4], pix[x*4+1], pix[x*4+2]))
+			colC[x] += c
+			colCC[x] += c * c
+			colCR[x] += c * uint32(r)
+		}
+
+		slot := s.satSlot[y+1]
+		if slot < 0 {
+			continue
+		}
+		row := slot * stride
+		var accC, accCC, accCR uint32
+		for x := 0; x < width; x++ {
+			accC += colC[x]
+			accCC += colCC[x]
+			accCR += colCR[x]
+			sumC[row+x+1] = accC
+			sumCC[row+x+1] = accCC
+			sumCR[row+x+1] = accCR
+		}
+	}
+
+	// SSIM = (2μcμr + C1)(2σcr + C2) / ((μc² + μr² + C1)(σc² + σr² + C2)),
+	// written on window sums with every factor scaled by n²
+	w := s.window
+	n := float64(w * w)
+	nnC1 := n * n * ssimC1
+	nnC2 := n * n * ssimC2
+
+	var total float64
+	i := 0
+	for y := 0; y+w <= height; y += s.step {
+		top, bottom := s.satSlot[y]*stride, s.satSlot[y+w]*stride
+		for x := 0; x+w <= width; x += s.step {
+			c := float64(boxSum(sumC, top, bottom, x, w))
+			cc := float64(boxSum(sumCC, top, bottom, x, w))
+			cr := float64(boxSum(sumCR, top, bottom, x, w))
+			r := s.refSum[i]
+
+			num := (2*c*r + nnC1) * (2*(n*cr-c*r) + nnC2)
+			den := (c*c + r*r + nnC1) * (n*cc - c*c + s.refVar[i] + nnC2)
+			total += num / den
+			i++
+		}
+	}
+
+	return total / float64(i)
+}
@@ -0,0 +1,212 @@
+package fit
+
+import (
+	"fmt"
+	"image"
+	"image/color"
+	"math"
+	"sync"
+	"testing"
+)
+
+// bruteForceSSIM computes mean windowed luma SSIM directly from the definition
+func bruteForceSSIM(a, b *image.NRGBA, window, step int) float64 {
+	width, height := a.Bounds().Dx(), a.Bounds().Dy()
+	window = min(window, min(width, height))
+	n := float64(window * window)
+
+	luma := func(img *image.NRGBA, x, y int) float64 {
+		i := img.PixOffset(img.Bounds().Min.X+x, img.Bounds().Min.Y+y)
+		return float64(lumaOf(img.Pix[i], img.Pix[i+1], img.Pix[i+2]))
+	}
+
+	var total float64
+	count := 0
+	for y := 0; y+window <= height; y += step {
+		for x := 0; x+window <= width; x += step {
+			var muA, muB float64
+			for dy := 0; dy < window; dy++ {
+				for dx := 0; dx < window; dx++ {
+					muA += luma(a, x+dx, y+dy)
+					muB += luma(b, x+dx, y+dy)
+				}
+			}
+			muA /= n
+			muB /= n
+
+			var varA, varB, cov float64
+			for dy := 0; dy < window; dy++ {
+				for dx := 0; dx < window; dx++ {
+					da := luma(a, x+dx, y+dy) - muA
+					db := luma(b, x+dx, y+dy) - muB
+					varA += da * da
+					varB += db * db
+					cov += da * db
+				}
+			}
+			varA /= n
+			varB /= n
+			cov /= n
+
+			total += ((2*muA*muB + ssimC1) * (2*cov + ssimC2)) /
+				((muA*muA + muB*muB + ssimC1) * (varA + varB + ssimC2))
+			count++
+		}
+	}
+	return total / float64(count)
+}
+
+// TestSSIMCost_MatchesBruteForce compares the summed-area table evaluation with
+// the direct definition
+func TestSSIMCost_MatchesBruteForce(t *testing.T) {
+	cases := []struct {
+		width, height, window, step int
+	}{
+		{16, 16, 8, 4},
+		{37, 23, 8, 4},
+		{40, 40, 7, 3},
+		{20, 30, 11, 1},
+		{5, 9, 8, 4}, // window clamped to the image
+	}
+
+	for _, tc := range cases {
+		ref := randomNRGBA(tc.width, tc.height, 1)
+		cur := randomNRGBA(tc.width, tc.height, 2)
+
+		s, err := NewSSIMCost(ref, tc.window, tc.step)
+		if err != nil {
+			t.Fatalf("NewSSIMCost: %v", err)
+		}
+
+		want := 1 - bruteForceSSIM(cur, ref, tc.window, tc.step)
+		got := s.Cost(cur, ref)
+		if math.Abs(got-want) > 1e-9 {
+			t.Errorf("%dx%d w=%d step=%d: cost = %.12f, brute force = %.12f",
+				tc.width, tc.height, tc.window, tc.step, got, want)
+		}
+	}
+}
+
+// TestSSIMCost_LargeImageWrapAround verifies window sums stay exact once the
+// whole-image uint32 tables wrap around
+func TestSSIMCost_LargeImageWrapAround(t *testing.T) {
+	// 300x300 white: Σc² over the image is 5.8e9 > 2^32
+	ref := solidColorNRGBA(300, 300, color.NRGBA{255, 255, 255, 255})
+	cur := solidColorNRGBA(300, 300, color.NRGBA{250, 250, 250, 255})
+
+	s, err := NewSSIMCost(ref, DefaultSSIMWindow, DefaultSSIMStep)
+	if err != nil {
+		t.Fatalf("NewSSIMCost: %v", err)
+	}
+
+	want := 1 - bruteForceSSIM(cur, ref, DefaultSSIMWindow, 50)
+	if got := s.Cost(cur, ref); math.Abs(got-want) > 1e-9 {
+		t.Errorf("cost = %.12f, want %.12f", got, want)
+	}
+}
+
+// TestSSIMCost_IdenticalAndOrdering tests zero cost for identical images and
+// that more distortion costs more
+func TestSSIMCost_IdenticalAndOrdering(t *testing.T) {
+	ref := randomNRGBA(64, 64, 3)
+	s, err := NewSSIMCost(ref, DefaultSSIMWindow, DefaultSSIMStep)
+	if err != nil {
+		t.Fatalf("NewSSIMCost: %v", err)
+	}
+
+	if got := s.Cost(cloneNRGBA(ref), ref); math.Abs(got) > 1e-12 {
+		t.Errorf("identical images: cost = %v, want 0", got)
+	}
+
+	blend := func(amount uint8) *image.NRGBA {
+		img := cloneNRGBA(ref)
+		for i := range img.Pix {
+			img.Pix[i] = uint8((int(img.Pix[i])*int(255-amount) + 128*int(amount)) / 255)
+		}
+		return img
+	}
+
+	prev := 0.0
+	for _, amount := range []uint8{32, 96, 192} {
+		got := s.Cost(blend(amount), ref)
+		if got <= prev {
+			t.Errorf("blend %d: cost %v should exceed %v", amount, got, prev)
+		}
+		prev = got
+	}
+}
+
+// TestSSIMCost_Concurrent verifies one SSIMCost can be shared across goroutines
+func TestSSIMCost_Concurrent(t *testing.T) {
+	ref := randomNRGBA(48, 48, 4)
+	cur := randomNRGBA(48, 48, 5)
+	s, err := NewSSIMCost(ref, DefaultSSIMWindow, DefaultSSIMStep)
+	if err != nil {
+		t.Fatalf("NewSSIMCost: %v", err)
+	}
+	want := s.Cost(cur, ref)
+
+	var wg sync.WaitGroup
+	for g := 0; g < 4; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := 0; i < 20; i++ {
+				if got := s.Cost(cur, ref); got != want {
+					t.Errorf("concurrent cost = %v, want %v", got, want)
+					return
+				}
+			}
+		}()
+	}
+	wg.Wait()
+}
+
+// TestNewSSIMCost_InvalidArgs tests argument validation
+func TestNewSSIMCost_InvalidArgs(t *testing.T) {
+	ref := randomNRGBA(16, 16, 1)
+	if _, err := NewSSIMCost(ref, 0, 4); err == nil {
+		t.Error("window 0 should fail")
+	}
+	if _, err := NewSSIMCost(ref, MaxSSIMWindow+1, 4); err == nil {
+		t.Error("window above MaxSSIMWindow should fail")
+	}
+	if _, err := NewSSIMCost(ref, 8, 0); err == nil {
+		t.Error("step 0 should fail")
+	}
+}
+
+// BenchmarkSSIMCost compares SSIM evaluation with FastSSD and the scalar MSECost
+// at optimizer sizes
+func BenchmarkSSIMCost(b *testing.B) {
+	for _, size := range []int{128, 256, 512} {
+		ref := randomNRGBA(size, size, 1)
+		cur := randomNRGBA(size, size, 2)
+		s, err := NewSSIMCost(ref, DefaultSSIMWindow, DefaultSSIMStep)
+		if err != nil {
+			b.Fatalf("NewSSIMCost: %v", err)
+		}
+
+		b.Run(fmt.Sprintf("%dx%d_FastSSD", size, size), func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				FastSSD(cur, ref)
+			}
+			b.ReportMetric(BenchmarkSSDBackend(b.N, size, size, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+		})
+
+		b.Run(fmt.Sprintf("%dx%d_MSECost", size, size), func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				MSECost(cur, ref)
+			}
+			b.ReportMetric(BenchmarkSSDBackend(b.N, size, size, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+		})
+
+		b.Run(fmt.Sprintf("%dx%d_SSIM", size, size), func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				s.Cost(cur, ref)
+			}
+			b.ReportMetric(BenchmarkSSDBackend(b.N, size, size, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+		})
+	}
+}
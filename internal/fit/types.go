@@ -9,6 +9,13 @@ type Circle struct {
 	Opacity    float64 // Opacity in [0,1]
 }
 
+// Circle32 is the float32 form of Circle used by the float32 compositing path
+type Circle32 struct {
+	X, Y, R    float32 // Position and radius
+	CR, CG, CB float32 // Color in [0,1]
+	Opacity    float32 // Opacity in [0,1]
+}
+
 // ParamVector encodes K circles as a flat float64 slice
 type ParamVector struct {
 	Data   []float64
@@ -19,6 +26,13 @@ type ParamVector struct {
 
 const paramsPerCircle = 7
 
+// Parameters per circle for colour (X, Y, R, CR, CG, CB, Opacity) and
+// grayscale (X, Y, R, L, Opacity) fitting.
+const (
+	ParamsPerCircle     = paramsPerCircle
+	ParamsPerGrayCircle = 5
+)
+
 // NewParamVector creates a parameter vector for K circles
 func NewParamVector(k, width, height int) *ParamVector {
 	return &ParamVector{
@@ -55,6 +69,61 @@ func (pv *ParamVector) DecodeCircle(i int) Circle {
 	}
 }
 
+// DecodeGrayCircle reads grayscale circle i (X, Y, R, L, Opacity) from params.
+// The luma L is returned in all three colour channels.
+func DecodeGrayCircle(params []float64, i int) Circle {
+	p := params[i*ParamsPerGrayCircle : (i+1)*ParamsPerGrayCircle]
+	return Circle{
+		X:       p[0],
+		Y:       p[1],
+		R:       p[2],
+		CR:      p[3],
+		CG:      p[3],
+		CB:      p[3],
+		Opacity: p[4],
+	}
+}
+
+// DecodeCircle32 reads colour circle i from params, rounded to float32.
+func DecodeCircle32(params []float64, i int) Circle32 {
+	p := params[i*paramsPerCircle : (i+1)*paramsPerCircle]
+	return Circle32{
+		X:       float32(p[0]),
+		Y:       float32(p[1]),
+		R:       float32(p[2]),
+		CR:      float32(p[3]),
+		CG:      float32(p[4]),
+		CB:      float32(p[5]),
+		Opacity: float32(p[6]),
+	}
+}
+
+// DecodeGrayCircle32 reads grayscale circle i from params, rounded to float32.
+func DecodeGrayCircle32(params []float64, i int) Circle32 {
+	p := params[i*ParamsPerGrayCircle : (i+1)*ParamsPerGrayCircle]
+	l := float32(p[3])
+	return Circle32{
+		X:       float32(p[0]),
+		Y:       float32(p[1]),
+		R:       float32(p[2]),
+		CR:      l,
+		CG:      l,
+		CB:      l,
+		Opacity: float32(p[4]),
+	}
+}
+
+// GrayToColorParams expands grayscale parameters into colour parameters
+// (CR = CG = CB = L), e.g. for exporters that only understand colour circles.
+func GrayToColorParams(params []float64) []float64 {
+	k := len(params) / ParamsPerGrayCircle
+	pv := NewParamVector(k, 0, 0)
+	for i := 0; i < k; i++ {
+		pv.EncodeCircle(i, DecodeGrayCircle(params, i))
+	}
+	return pv.Data
+}
+
 // Bounds defines valid parameter ranges
 type Bounds struct {
 	Lower []float64
@@ -94,6 +163,28 @@ func NewBounds(k, width, height int) *Bounds {
 	}
 }
 
+// NewGrayBounds creates bounds for K grayscale circles in a WxH image:
+// the same position and radius ranges as NewBounds, luma and opacity in [0, 1].
+func NewGrayBounds(k, width, height int) *Bounds {
+	color := NewBounds(1, width, height)
+
+	lower := make([]float64, k*ParamsPerGrayCircle)
+	upper := make([]float64, k*ParamsPerGrayCircle)
+	for i := 0; i < k; i++ {
+		offset := i * ParamsPerGrayCircle
+		copy(lower[offset:offset+3], color.Lower[:3])
+		copy(upper[offset:offset+3], color.Upper[:3])
+		lower[offset+3], upper[offset+3] = 0, 1 // L
+		lower[offset+4], upper[offset+4] = 0, 1 // Opacity
+	}
+
+	return &Bounds{
+		Lower: lower,
+		Upper: upper,
+		K:     k,
+	}
+}
+
 // ClampCircle clamps circle parameters to valid bounds
 func (b *Bounds) ClampCircle(c Circle) Circle {
 	return Circle{
@@ -68,6 +68,43 @@ func TestBoundsValidation(t *testing.T) {
 	}
 }
 
+func TestGrayBoundsAndDecoding(t *testing.T) {
+	bounds := NewGrayBounds(2, 80, 60)
+	if len(bounds.Lower) != 2*ParamsPerGrayCircle {
+		t.Fatalf("Expected %d lower bounds, got %d", 2*ParamsPerGrayCircle, len(bounds.Lower))
+	}
+
+	color := NewBounds(1, 80, 60)
+	for i := 0; i < 3; i++ {
+		if bounds.Lower[5+i] != color.Lower[i] || bounds.Upper[5+i] != color.Upper[i] {
+			t.Errorf("position/radius bounds[%d] = [%f, %f], want [%f, %f]",
+				i, bounds.Lower[5+i], bounds.Upper[5+i], color.Lower[i], color.Upper[i])
+		}
+	}
+	for i := 3; i < 5; i++ {
+		if bounds.Lower[5+i] != 0 || bounds.Upper[5+i] != 1 {
+			t.Errorf("luma/opacity bounds[%d] incorrect: [%f, %f]", i, bounds.Lower[5+i], bounds.Upper[5+i])
+		}
+	}
+
+	params := []float64{1, 2, 3, 0.4, 0.5, 10, 20, 30, 0.6, 0.7}
+	c := DecodeGrayCircle(params, 1)
+	if c.X != 10 || c.Y != 20 || c.R != 30 || c.CR != 0.6 || c.CG != 0.6 || c.CB != 0.6 || c.Opacity != 0.7 {
+		t.Errorf("DecodeGrayCircle = %+v", c)
+	}
+
+	expanded := GrayToColorParams(params)
+	want := []float64{1, 2, 3, 0.4, 0.4, 0.4, 0.5, 10, 20, 30, 0.6, 0.6, 0.6, 0.7}
+	if len(expanded) != len(want) {
+		t.Fatalf("GrayToColorParams length = %d, want %d", len(expanded), len(want))
+	}
+	for i := range want {
+		if expanded[i] != want[i] {
+			t.Errorf("GrayToColorParams[%d] = %f, want %f", i, expanded[i], want[i])
+		}
+	}
+}
+
 func TestClampCircle(t *testing.T) {
 	bounds := NewBounds(1, 100, 100)
 
@@ -0,0 +1,317 @@
+package fit
+
+import (
+	"fmt"
+	"image"
+	"image/color"
+	"log/slog"
+	"os"
+
+	"golang.org/x/sys/cpu"
+
+	_ "image/jpeg" // Register JPEG decoder for weight masks
+	_ "image/png"  // Register PNG decoder for weight masks
+)
+
+// Per-pixel importance-weighted SSD/SAD kernels.
+//
+// A WeightPlane holds one byte per pixel: 0 ignores the pixel, 255 gives it
+// full weight. Weighted costs are normalized so that an all-255 plane yields
+// the same value as the unweighted kernel (FastSSD / FastSAD):
+//
+//	SSDCost = Σ w (dR² + dG² + dB²) / (255 × 3 × pixels)
+//	SADCost = sadScale × Σ w v (255 + 9v) / 255,  v = |dR| + |dG| + |dB|
+//
+// The weights are multiplied inside the SIMD loop (weighted_amd64.s, and
+// weighted_avx512_amd64.s on AVX-512BW hosts), so weighted fitting runs
+// within 20% of the unweighted kernel on the same SIMD tier.
+// Sums are exact integers in every backend.
+
+// WeightPlane is a per-pixel importance map matching a reference image.
+type WeightPlane struct {
+	Width   int
+	Height  int
+	Stride  int     // bytes per row, a multiple of 8 (padding weights are 0)
+	Weights []uint8 // Stride*Height
+}
+
+// NewWeightPlane creates a plane for a width×height image with every weight set to w.
+func NewWeightPlane(width, height int, w uint8) *WeightPlane {
+	stride := (width + 7) &^ 7
+	p := &WeightPlane{
+		Width:   width,
+		Height:  height,
+		Stride:  stride,
+		Weights: make([]uint8, stride*height),
+	}
+	for y := 0; y < height; y++ {
+		row := p.Weights[y*stride : y*stride+width]
+		for x := range row {
+			row[x] = w
+		}
+	}
+	return p
+}
+
+// WeightPlaneFromImage converts a mask image into a width×height plane. The
+// mask's grey level (BT.601 luma, alpha-multiplied) is the weight; masks of a
+// different size are resampled with nearest-neighbour sampling.
+func WeightPlaneFromImage(mask image.Image, width, height int) *WeightPlane {
+	p := NewWeightPlane(width, height, 0)
+	mb := mask.Bounds()
+
+	for y := 0; y < height; y++ {
+		sy := mb.Min.Y + y*mb.Dy()/height
+		for x := 0; x < width; x++ {
+			sx := mb.Min.X + x*mb.Dx()/width
+			g := color.GrayModel.Convert(mask.At(sx, sy)).(color.Gray)
+			p.Weights[y*p.Stride+x] = g.Y
+		}
+	}
+	return p
+}
+
+// LoadWeightPlane decodes a mask image (PNG or JPEG) from path and converts it
+// into a width×height plane (see WeightPlaneFromImage).
+func LoadWeightPlane(path string, width, height int) (*WeightPlane, error) {
+	f, err := os.Open(path)
+	if err != nil {
+		return nil, fmt.Errorf("failed to open weight mask: %w", err)
+	}
+	defer f.Close()
+
+	mask, _, err := image.Decode(f)
+	if err != nil {
+		return nil, fmt.Errorf("failed to decode weight mask: %w", err)
+	}
+	return WeightPlaneFromImage(mask, width, height), nil
+}
+
+// EdgeWeightPlane derives a plane from the Sobel gradient magnitude of the
+// reference luma. Weights are scaled into [floor, 255], so flat regions still
+// count with weight floor.
+func EdgeWeightPlane(reference *image.NRGBA, floor uint8) *WeightPlane {
+	bounds := reference.Bounds()
+	width, height := bounds.Dx(), bounds.Dy()
+	p := NewWeightPlane(width, height, floor)
+
+	luma := func(x, y int) int {
+		x = min(width-1, max(0, x))
+		y = min(height-1, max(0, y))
+		i := y*reference.Stride + x*4
+		return int(lumaOf(reference.Pix[i], reference.Pix[i+1], reference.Pix[i+2]))
+	}
+
+	span := 255 - int(floor)
+	for y := 0; y < height; y++ {
+		for x := 0; x < width; x++ {
+			gx := luma(x+1, y-1) + 2*luma(x+1, y) + luma(x+1, y+1) -
+				luma(x-1, y-1) - 2*luma(x-1, y) - luma(x-1, y+1)
+			gy := luma(x-1, y+1) + 2*luma(x, y+1) + luma(x+1, y+1) -
+				luma(x-1, y-1) - 2*luma(x, y-1) - luma(x+1, y-1)
+			// |gx| + |gy| ≤ 2040; saturate at a quarter of the range so
+			// ordinary edges reach full weight
+			mag := min(abs(gx)+abs(gy), 510)
+			p.Weights[y*p.Stride+x] = uint8(int(floor) + mag*span/510)
+		}
+	}
+	return p
+}
+
+func abs(v int) int {
+	if v < 0 {
+		return -v
+	}
+	return v
+}
+
+// weightedKernel is the low-level signature shared by the weighted kernels.
+type weightedKernel func(a, b []uint8, stride int, w []uint8, wStride, width, height int) int64
+
+// fastWeightedSSD and fastWeightedSAD are set by init() from the SIMD tier.
+var (
+	fastWeightedSSD weightedKernel
+	fastWeightedSAD weightedKernel
+)
+
+func init() {
+	// NEON has no port yet
+	if activeSIMDTier >= simdTierAVX512 {
+		fastWeightedSSD = weightedSSD_AVX512
+		if cpu.X86.HasAVX512VNNI {
+			fastWeightedSSD = weightedSSD_AVX512VNNI
+		}
+		fastWeightedSAD = weightedSAD_AVX512
+		slog.Debug("Weighted kernels initialized", "backend", "AVX-512", "vnni", cpu.X86.HasAVX512VNNI)
+	} else if activeSIMDTier >= simdTierAVX2 {
+		fastWeightedSSD = weightedSSD_AVX2
+		fastWeightedSAD = weightedSAD_AVX2
+		slog.Debug("Weighted kernels initialized", "backend", "AVX2")
+	} else {
+		fastWeightedSSD = weightedSSD_Scalar
+		fastWeightedSAD = weightedSAD_Scalar
+		slog.Debug("Weighted kernels initialized", "backend", "scalar")
+	}
+}
+
+func (p *WeightPlane) check(name string, current, reference *image.NRGBA) (int, int) {
+	bounds := current.Bounds()
+	width, height := bounds.Dx(), bounds.Dy()
+
+	if width != reference.Bounds().Dx() || height != reference.Bounds().Dy() ||
+		width != p.Width || height != p.Height {
+		panic(name + ": image and weight plane dimensions must match")
+	}
+	return width, height
+}
+
+// SSDCost implements CostFunc: the weighted mean squared RGB error.
+func (p *WeightPlane) SSDCost(current, reference *image.NRGBA) float64 {
+	width, height := p.check("WeightPlane.SSDCost", current, reference)
+	if width == 0 || height == 0 {
+		return 0
+	}
+
+	sum := evalWeightedRows(fastWeightedSSD, current.Pix, reference.Pix, current.Stride, p.Weights, p.Stride, width, height)
+	return float64(sum) / float64(255*3*width*height)
+}
+
+// SADCost implements CostFunc: the weighted Delphi quadratic SAD.
+func (p *WeightPlane) SADCost(current, reference *image.NRGBA) float64 {
+	width, height := p.check("WeightPlane.SADCost", current, reference)
+	if width == 0 || height == 0 {
+		return 0
+	}
+
+	sum := evalWeightedRows(fastWeightedSAD, current.Pix, reference.Pix, current.Stride, p.Weights, p.Stride, width, height)
+	return float64(sum) * (sadScale / 255)
+}
+
+// weightedSSD_Scalar is the portable reference for the weighted SSD kernel.
+//
+// Rows shrink as they are consumed and four pixels are read through array
+// views, so the compiler drops the bounds checks; unrolled as in ssdScalar.
+func weightedSSD_Scalar(a, b []uint8, stride int, w []uint8, wStride, width, height int) int64 {
+	var total int64
+	for y := 0; y < height; y++ {
+		ra := a[y*stride : y*stride+width*4]
+		rb := b[y*stride : y*stride+width*4]
+		weights := w[y*wStride : y*wStride+width]
+
+		for len(weights) >= 4 && len(ra) >= 16 && len(rb) >= 16 {
+			pa, pb, wq := (*[16]uint8)(ra), (*[16]uint8)(rb), (*[4]uint8)(weights)
+
+			dr0 := int32(pa[0]) - int32(pb[0])
+			dg0 := int32(pa[1]) - int32(pb[1])
+			db0 := int32(pa[2]) - int32(pb[2])
+
+			dr1 := int32(pa[4]) - int32(pb[4])
+			dg1 := int32(pa[5]) - int32(pb[5])
+			db1 := int32(pa[6]) - int32(pb[6])
+
+			dr2 := int32(pa[8]) - int32(pb[8])
+			dg2 := int32(pa[9]) - int32(pb[9])
+			db2 := int32(pa[10]) - int32(pb[10])
+
+			dr3 := int32(pa[12]) - int32(pb[12])
+			dg3 := int32(pa[13]) - int32(pb[13])
+			db3 := int32(pa[14]) - int32(pb[14])
+
+			total += int64(wq[0])*int64(dr0*dr0+dg0*dg0+db0*db0) +
+				int64(wq[1])*int64(dr1*dr1+dg1*dg1+db1*db1) +
+				int64(wq[2])*int64(dr2*dr2+dg2*dg2+db2*db2) +
+				int64(wq[3])*int64(dr3*dr3+dg3*dg3+db3*db3)
+			ra, rb, weights = ra[16:], rb[16:], weights[4:]
+		}
+		for len(weights) >= 1 && len(ra) >= 4 && len(rb) >= 4 {
+			dr := int32(ra[0]) - int32(rb[0])
+			dg := int32(ra[1]) - int32(rb[1])
+			db := int32(ra[2]) - int32(rb[2])
+			total += int64(weights[0]) * int64(dr*dr+dg*dg+db*db)
+			ra, rb, weights = ra[4:], rb[4:], weights[1:]
+		}
+	}
+	return total
+}
+
+// weightedSAD_Scalar is the portable reference for the weighted SAD kernel.
+//
+// Same loop shape as weightedSSD_Scalar. The absolute differences are
+// branch-free: on near-identical images a branch would mispredict on every
+// sign change.
+func weightedSAD_Scalar(a, b []uint8, stride int, w []uint8, wStride, width, height int) int64 {
+	var total int64
+	for y := 0; y < height; y++ {
+		ra := a[y*stride : y*stride+width*4]
+		rb := b[y*stride : y*stride+width*4]
+		weights := w[y*wStride : y*wStride+width]
+
+		for len(weights) >= 4 && len(ra) >= 16 && len(rb) >= 16 {
+			pa, pb, wq := (*[16]uint8)(ra), (*[16]uint8)(rb), (*[4]uint8)(weights)
+
+			v0 := absDiff(pa[0], pb[0]) + absDiff(pa[1], pb[1]) + absDiff(pa[2], pb[2])
+			v1 := absDiff(pa[4], pb[4]) + absDiff(pa[5], pb[5]) + absDiff(pa[6], pb[6])
+			v2 := absDiff(pa[8], pb[8]) + absDiff(pa[9], pb[9]) + absDiff(pa[10], pb[10])
+			v3 := absDiff(pa[12], pb[12]) + absDiff(pa[13], pb[13]) + absDiff(pa[14], pb[14])
+
+			total += int64(wq[0])*int64(v0*(255+9*v0)) +
+				int64(wq[1])*int64(v1*(255+9*v1)) +
+				int64(wq[2])*int64(v2*(255+9*v2)) +
+				int64(wq[3])*int64(v3*(255+9*v3))
+			ra, rb, weights = ra[16:], rb[16:], weights[4:]
+		}
+		for len(weights) >= 1 && len(ra) >= 4 && len(rb) >= 4 {
+			v := absDiff(ra[0], rb[0]) + absDiff(ra[1], rb[1]) + absDiff(ra[2], rb[2])
+			total += int64(weights[0]) * int64(v*(255+9*v))
+			ra, rb, weights = ra[4:], rb[4:], weights[1:]
+		}
+	}
+	return total
+}
+
+// absDiff returns |a - b| without a branch.
+func absDiff(a, b uint8) int32 {
+	d := int32(a) - int32(b)
+	m := d >> 31
+	return (d ^ m) - m
+}
+
+// weightedSSD_AVX2 runs the AVX2 weighted SSD kernel (weighted_amd64.s).
+func weightedSSD_AVX2(a, b []uint8, stride int, w []uint8, wStride, width, height int) int64 {
+	if len(a) == 0 || len(b) == 0 || len(w) == 0 {
+		return 0
+	}
+	return weightedSSDAVX2(&a[0], &b[0], &w[0], stride, wStride, width, height)
+}
+
+// weightedSSD_AVX512 runs the AVX-512BW weighted SSD kernel (weighted_avx512_amd64.s).
+func weightedSSD_AVX512(a, b []uint8, stride int, w []uint8, wStride, width, height int) int64 {
+	if len(a) == 0 || len(b) == 0 || len(w) == 0 {
+		return 0
+	}
+	return weightedSSDAVX512(&a[0], &b[0], &w[0], stride, wStride, width, height)
+}
+
+// weightedSSD_AVX512VNNI runs the AVX512-VNNI weighted SSD kernel (weighted_avx512_amd64.s).
+func weightedSSD_AVX512VNNI(a, b []uint8, stride int, w []uint8, wStride, width, height int) int64 {
+	if len(a) == 0 || len(b) == 0 || len(w) == 0 {
+		return 0
+	}
+	return weightedSSDAVX512VNNI(&a[0], &b[0], &w[0], stride, wStride, width, height)
+}
+
+// weightedSAD_AVX512 runs the AVX-512BW weighted SAD kernel (weighted_avx512_amd64.s).
+func weightedSAD_AVX512(a, b []uint8, stride int, w []uint8, wStride, width, height int) int64 {
+	if len(a) == 0 || len(b) == 0 || len(w) == 0 {
+		return 0
+	}
+	return weightedSADAVX512(&a[0], &b[0], &w[0], stride, wStride, width, height)
+}
+
+// weightedSAD_AVX2 runs the AVX2 weighted SAD kernel (weighted_amd64.s).
+func weightedSAD_AVX2(a, b []uint8, stride int, w []uint8, wStride, width, height int) int64 {
+	if len(a) == 0 || len(b) == 0 || len(w) == 0 {
+		return 0
+	}
+	return weightedSADAVX2(&a[0], &b[0], &w[0], stride, wStride, width, height)
+}
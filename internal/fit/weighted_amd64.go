@@ -0,0 +1,47 @@
+//go:build amd64
+
+package fit
+
+// weightedSSDAVX2 computes Σ w × (dR² + dG² + dB²) using AVX2 instructions.
+//
+// Plan9 assembly (weighted_amd64.s). Same loop structure as ssdAVX2, but the
+// channels of |a-b| are split with a mask and a shuffle instead of unpacks,
+// so VPMADDWD produces per-pixel sums in pixel order, which are multiplied by
+// the zero-extended weight bytes (VPMOVZXBD + VPMULLD) inside the loop.
+//
+// Parameters:
+//   - a, b:    pointers to RGBA image data
+//   - w:       pointer to the weight plane (one byte per pixel)
+//   - stride:  image row stride in bytes
+//   - wStride: weight row stride in bytes (multiple of 8)
+//   - width, height: image size in pixels
+//
+// Returns: exact weighted sum (bit-identical to weightedSSD_Scalar)
+func weightedSSDAVX2(a, b, w *uint8, stride, wStride, width, height int) int64
+
+// weightedSSDAVX512 computes Σ w × (dR² + dG² + dB²) using AVX-512BW
+// instructions, 16 pixels per iteration.
+//
+// Plan9 assembly (weighted_avx512_amd64.s). Parameters and result as
+// weightedSSDAVX2.
+func weightedSSDAVX512(a, b, w *uint8, stride, wStride, width, height int) int64
+
+// weightedSADAVX2 computes Σ w × v(9v + 255) with v = |dR| + |dG| + |dB|
+// using AVX2 instructions (unscaled; the caller applies sadScale).
+//
+// Plan9 assembly (weighted_amd64.s). Parameters as weightedSSDAVX2.
+func weightedSADAVX2(a, b, w *uint8, stride, wStride, width, height int) int64
+
+// weightedSADAVX512 computes Σ w × v(9v + 255) like weightedSADAVX2 using
+// AVX-512BW instructions, 16 pixels per iteration.
+//
+// Plan9 assembly (weighted_avx512_amd64.s). Parameters and result as
+// weightedSSDAVX2.
+func weightedSADAVX512(a, b, w *uint8, stride, wStride, width, height int) int64
+
+// weightedSSDAVX512VNNI is weightedSSDAVX512 with the channel squares summed
+// by VPDPWSSD; requires AVX512-VNNI.
+//
+// Plan9 assembly (weighted_avx512_amd64.s). Parameters and result as
+// weightedSSDAVX2.
+func weightedSSDAVX512VNNI(a, b, w *uint8, stride, wStride, width, height int) int64
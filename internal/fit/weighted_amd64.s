@@ -0,0 +1,287 @@
+// AVX2 SIMD implementation of the importance-weighted SSD and SAD kernels
+//
+// Function signatures:
+//   func weightedSSDAVX2(a, b, w *uint8, stride, wStride, width, height int) int64
+//   func weightedSADAVX2(a, b, w *uint8, stride, wStride, width, height int) int64
+//
+// Both kernels process 8 RGBA pixels (32 bytes) and 8 weights (8 bytes) per
+// iteration and multiply by the weights inside the loop:
+//   - The per-pixel error ends up in one dword lane per pixel, in pixel order,
+//     so VPMOVZXBD of the weight bytes lines up with it directly
+//   - Row tails (width % 8) use VPMASKMOVD; the weight plane stride is padded
+//     to a multiple of 8, so the 8-byte weight load never leaves the plane
+//
+// SSD: per-pixel dR² + dG² + dB² via |a-b| bytes and two VPMADDWD, times w (VPMULLD),
+// accumulated in int32 lanes and widened every WSSD_FLUSH_ITERS iterations
+// (one iteration adds at most 255 × 195075 = 49.7M per lane). The weight stays
+// a dword multiply: w × d² has no exact split into two int16 factors for
+// VPMADDWD (251 × 251² needs 63001), and the biased VPMADDWD form needs four
+// extra uops per block to undo its bias. AVX-512 hosts run
+// weighted_avx512_amd64.s instead.
+//
+// SAD: per-pixel v = |dR| + |dG| + |dB| via VPMAXUB/VPMINUB/VPSUBB and
+// VPMADDUBSW + VPMADDWD. w × v (one VPMADDWD) and w × v² (one VPMULLD) are
+// summed separately in int32 lanes, widened every WSAD_FLUSH_ITERS
+// iterations, and combined once per image: Σ w v (255 + 9v) =
+// 255 Σ w v + 9 Σ w v². The product w × v × (9v + 255) itself would need
+// int64 multiplies per pixel.
+
+#include "textflag.h"
+
+DATA wRGBMask<>+0(SB)/4, $0x00FFFFFF
+GLOBL wRGBMask<>(SB), RODATA|NOPTR, $4
+
+DATA wEvenMask<>+0(SB)/4, $0x00FF00FF
+GLOBL wEvenMask<>(SB), RODATA|NOPTR, $4
+
+// VPSHUFB control moving G (byte 1 of every pixel) to the low byte of its
+// dword and clearing the rest, alpha included
+DATA wGreenShuf<>+0(SB)/8, $0x8080800580808001
+DATA wGreenShuf<>+8(SB)/8, $0x8080800D80808009
+GLOBL wGreenShuf<>(SB), RODATA|NOPTR, $16
+
+DATA wOnesB<>+0(SB)/4, $0x01010101
+GLOBL wOnesB<>(SB), RODATA|NOPTR, $4
+
+DATA wOnesW<>+0(SB)/4, $0x00010001
+GLOBL wOnesW<>(SB), RODATA|NOPTR, $4
+
+// Tail mask table: 8 dwords of -1 followed by 8 dwords of 0
+DATA wTailMask<>+0(SB)/8, $0xFFFFFFFFFFFFFFFF
+DATA wTailMask<>+8(SB)/8, $0xFFFFFFFFFFFFFFFF
+DATA wTailMask<>+16(SB)/8, $0xFFFFFFFFFFFFFFFF
+DATA wTailMask<>+24(SB)/8, $0xFFFFFFFFFFFFFFFF
+DATA wTailMask<>+32(SB)/8, $0x0000000000000000
+DATA wTailMask<>+40(SB)/8, $0x0000000000000000
+DATA wTailMask<>+48(SB)/8, $0x0000000000000000
+DATA wTailMask<>+56(SB)/8, $0x0000000000000000
+GLOBL wTailMask<>(SB), RODATA|NOPTR, $64
+
+// 32 iterations × 49.7M (+1 tail iteration) < 2^31
+#define WSSD_FLUSH_ITERS $32
+
+// WSSD8 accumulates w × SSD of the pixels in Y1 (a) and Y2 (b) into the int32
+// lanes of Y0, with the weights at (R10)(DI*1). Clobbers Y1-Y4.
+//
+// |a-b| is formed on bytes, so the channels can be split without unpacks:
+// (d & 0x00FF00FF) holds R and B words, and one VPSHUFB moves G into the low
+// word and drops alpha, so no separate alpha mask is needed. VPMADDWD of each
+// with itself yields pixel-ordered dwords, which line up with the weights.
+#define WSSD8 \
+    VPMAXUB   Y2, Y1, Y3 \
+    VPMINUB   Y2, Y1, Y4 \
+    VPSUBB    Y4, Y3, Y3 \
+    VPAND     Y13, Y3, Y4 \
+    VPSHUFB   Y9, Y3, Y3 \
+    VPMADDWD  Y4, Y4, Y4 \
+    VPMADDWD  Y3, Y3, Y3 \
+    VPADDD    Y4, Y3, Y3 \
+    VPMOVZXBD (R10)(DI*1), Y4 \
+    VPMULLD   Y4, Y3, Y3 \
+    VPADDD    Y3, Y0, Y0
+
+// WSSD_WIDEN adds the int32 lanes of Y0 into the int64 lanes of Y12 and
+// clears Y0. Clobbers Y5, Y6.
+#define WSSD_WIDEN \
+    VEXTRACTI128 $1, Y0, X5 \
+    VPMOVZXDQ    X0, Y6 \
+    VPMOVZXDQ    X5, Y5 \
+    VPADDQ       Y6, Y12, Y12 \
+    VPADDQ       Y5, Y12, Y12 \
+    VPXOR        Y0, Y0, Y0
+
+// func weightedSSDAVX2(a, b, w *uint8, stride, wStride, width, height int) int64
+TEXT ·weightedSSDAVX2(SB), NOSPLIT, $0-64
+    MOVQ a+0(FP), R8              // R8 = current row of a
+    MOVQ b+8(FP), R9              // R9 = current row of b
+    MOVQ w+16(FP), R10            // R10 = current weight row
+    MOVQ stride+24(FP), R11
+    MOVQ wStride+32(FP), R12
+    MOVQ width+40(FP), SI
+    MOVQ height+48(FP), AX        // AX = rows remaining
+
+    VPBROADCASTD wEvenMask<>(SB), Y13
+    VBROADCASTI128 wGreenShuf<>(SB), Y9
+    VPXOR Y12, Y12, Y12           // Y12 = int64 accumulator
+    VPXOR Y0, Y0, Y0              // Y0 = int32 accumulator
+
+    // BX = tail pixels, Y14 = dword mask enabling the first BX lanes
+    MOVQ SI, BX
+    ANDQ $7, BX
+    MOVQ $8, CX
+    SUBQ BX, CX
+    LEAQ wTailMask<>(SB), DX
+    VMOVDQU (DX)(CX*4), Y14
+
+    // SI = pixels covered by full 8-pixel blocks
+    ANDQ $-8, SI
+
+    TESTQ AX, AX
+    JLE wssd_done
+
+wssd_row:
+    XORQ DI, DI                   // DI = pixel index within row
+    MOVQ WSSD_FLUSH_ITERS, CX
+    CMPQ DI, SI
+    JGE wssd_tail
+
+wssd_loop:
+    VMOVDQU (R8)(DI*4), Y1
+    VMOVDQU (R9)(DI*4), Y2
+    WSSD8
+    ADDQ $8, DI
+    DECQ CX
+    JNZ wssd_next
+    WSSD_WIDEN
+    MOVQ WSSD_FLUSH_ITERS, CX
+
+wssd_next:
+    CMPQ DI, SI
+    JL wssd_loop
+
+wssd_tail:
+    TESTQ BX, BX
+    JZ wssd_row_done
+    VPMASKMOVD (R8)(DI*4), Y14, Y1
+    VPMASKMOVD (R9)(DI*4), Y14, Y2
+    WSSD8
+
+wssd_row_done:
+    WSSD_WIDEN
+    ADDQ R11, R8
+    ADDQ R11, R9
+    ADDQ R12, R10
+    DECQ AX
+    JNZ wssd_row
+
+wssd_done:
+    VEXTRACTI128 $1, Y12, X1
+    VPADDQ X1, X12, X1
+    VPSHUFD $0x4E, X1, X2
+    VPADDQ X2, X1, X1
+    VMOVQ X1, AX
+    VZEROUPPER
+    MOVQ AX, ret+56(FP)
+    RET
+
+// 24 iterations × 255 × 765² (+1 tail iteration) < 2^32 (lanes widen unsigned)
+#define WSAD_FLUSH_ITERS $24
+
+// WSAD8 accumulates w × v and w × v² of the pixels in Y1 (a) and Y2 (b) into
+// the int32 lanes of Y0 and Y7, with the weights at (R10)(DI*1). v and w both
+// fit the low word of their dword, so one VPMADDWD forms w × v.
+// Clobbers Y1-Y5.
+#define WSAD8 \
+    VPMAXUB    Y2, Y1, Y3 \
+    VPMINUB    Y2, Y1, Y4 \
+    VPSUBB     Y4, Y3, Y3 \
+    VPAND      Y15, Y3, Y3 \
+    VPMADDUBSW Y12, Y3, Y3 \
+    VPMADDWD   Y11, Y3, Y3 \
+    VPMOVZXBD  (R10)(DI*1), Y5 \
+    VPMADDWD   Y5, Y3, Y5 \
+    VPADDD     Y5, Y0, Y0 \
+    VPMULLD    Y3, Y5, Y5 \
+    VPADDD     Y5, Y7, Y7
+
+// WSAD_WIDEN adds the int32 lanes of Y0 and Y7 into the int64 lanes of Y9
+// and Y8 and clears them. Clobbers Y5, Y6.
+#define WSAD_WIDEN \
+    VEXTRACTI128 $1, Y0, X5 \
+    VPMOVZXDQ    X0, Y6 \
+    VPMOVZXDQ    X5, Y5 \
+    VPADDQ       Y6, Y9, Y9 \
+    VPADDQ       Y5, Y9, Y9 \
+    VEXTRACTI128 $1, Y7, X5 \
+    VPMOVZXDQ    X7, Y6 \
+    VPMOVZXDQ    X5, Y5 \
+    VPADDQ       Y6, Y8, Y8 \
+    VPADDQ       Y5, Y8, Y8 \
+    VPXOR        Y0, Y0, Y0 \
+    VPXOR        Y7, Y7, Y7
+
+// func weightedSADAVX2(a, b, w *uint8, stride, wStride, width, height int) int64
+TEXT ·weightedSADAVX2(SB), NOSPLIT, $0-64
+    MOVQ a+0(FP), R8
+    MOVQ b+8(FP), R9
+    MOVQ w+16(FP), R10
+    MOVQ stride+24(FP), R11
+    MOVQ wStride+32(FP), R12
+    MOVQ width+40(FP), SI
+    MOVQ height+48(FP), AX
+
+    VPBROADCASTD wRGBMask<>(SB), Y15
+    VPBROADCASTD wOnesB<>(SB), Y12
+    VPBROADCASTD wOnesW<>(SB), Y11
+    VPXOR Y9, Y9, Y9              // Y9 = Σ w × v (int64)
+    VPXOR Y8, Y8, Y8              // Y8 = Σ w × v² (int64)
+    VPXOR Y0, Y0, Y0              // Y0, Y7 = their int32 accumulators
+    VPXOR Y7, Y7, Y7
+
+    MOVQ SI, BX
+    ANDQ $7, BX
+    MOVQ $8, CX
+    SUBQ BX, CX
+    LEAQ wTailMask<>(SB), DX
+    VMOVDQU (DX)(CX*4), Y14
+
+    ANDQ $-8, SI
+
+    TESTQ AX, AX
+    JLE wsad_done
+
+wsad_row:
+    XORQ DI, DI
+    MOVQ WSAD_FLUSH_ITERS, CX
+    CMPQ DI, SI
+    JGE wsad_tail
+
+wsad_loop:
+    VMOVDQU (R8)(DI*4), Y1
+    VMOVDQU (R9)(DI*4), Y2
+    WSAD8
+    ADDQ $8, DI
+    DECQ CX
+    JNZ wsad_next
+    WSAD_WIDEN
+    MOVQ WSAD_FLUSH_ITERS, CX
+
+wsad_next:
+    CMPQ DI, SI
+    JL wsad_loop
+
+wsad_tail:
+    TESTQ BX, BX
+    JZ wsad_row_done
+    VPMASKMOVD (R8)(DI*4), Y14, Y1
+    VPMASKMOVD (R9)(DI*4), Y14, Y2
+    WSAD8
+
+wsad_row_done:
+    WSAD_WIDEN
+    ADDQ R11, R8
+    ADDQ R11, R9
+    ADDQ R12, R10
+    DECQ AX
+    JNZ wsad_row
+
+wsad_done:
+    // DX = Σ w × v, AX = Σ w × v²
+    VEXTRACTI128 $1, Y9, X1
+    VPADDQ X1, X9, X1
+    VPSHUFD $0x4E, X1, X2
+    VPADDQ X2, X1, X1
+    VMOVQ X1, DX
+    VEXTRACTI128 $1, Y8, X1
+    VPADDQ X1, X8, X1
+    VPSHUFD $0x4E, X1, X2
+    VPADDQ X2, X1, X1
+    VMOVQ X1, AX
+    VZEROUPPER
+
+    // Σ w × v(255 + 9v) = 255 Σ w × v + 9 Σ w × v²
+    IMULQ $255, DX
+    LEAQ (AX)(AX*8), AX
+    ADDQ DX, AX
+    MOVQ AX, ret+56(FP)
+    RET
@@ -0,0 +1,318 @@
+// AVX-512BW SIMD implementation of the importance-weighted SSD/SAD kernels
+//
+// Function signatures:
+//   func weightedSSDAVX512(a, b, w *uint8, stride, wStride, width, height int) int64
+//   func weightedSSDAVX512VNNI(a, b, w *uint8, stride, wStride, width, height int) int64
+//   func weightedSADAVX512(a, b, w *uint8, stride, wStride, width, height int) int64
+//
+// Same schemes as weighted_amd64.s on 16 pixels per iteration:
+//   - Zero-masking byte loads (K1 = 0x7777...) drop the alpha channel
+//   - Row tails load through K2 = K1 & tail mask (pixels) and K3 (weights);
+//     masked-off bytes are not read, so the 16-byte weight load never leaves
+//     the plane even though its stride is only padded to a multiple of 8
+//
+// Lane overflow bounds are identical to weighted_amd64.s.
+
+#include "textflag.h"
+
+DATA w512EvenMask<>+0(SB)/4, $0x00FF00FF
+GLOBL w512EvenMask<>(SB), RODATA|NOPTR, $4
+
+// 32 iterations of two blocks × 49.7M (+1 block, +1 tail) < 2^32 (lanes
+// widen unsigned)
+#define WSSD_FLUSH_ITERS $32
+
+// WSSD16(SQUARE) accumulates w × SSD of the pixels in Z1 (a) and Z2 (b),
+// alpha already zeroed, into the int32 lanes of Z0, with the zero-extended
+// weights in Z4. SQUARE sums the squared words of Z2 (R, B) and Z3 (G) into
+// the dwords of Z3. Clobbers Z1-Z4.
+#define WSSD16(SQUARE) \
+    VPMAXUB   Z2, Z1, Z3 \
+    VPMINUB   Z2, Z1, Z1 \
+    VPSUBB    Z1, Z3, Z3 \
+    VPANDD    Z13, Z3, Z2 \
+    VPSRLW    $8, Z3, Z3 \
+    SQUARE \
+    VPMULLD   Z4, Z3, Z3 \
+    VPADDD    Z3, Z0, Z0
+
+#define WSSD_SQUARE \
+    VPMADDWD  Z2, Z2, Z2 \
+    VPMADDWD  Z3, Z3, Z3 \
+    VPADDD    Z2, Z3, Z3
+
+// AVX512-VNNI fuses the second VPMADDWD and its VPADDD
+#define WSSD_SQUARE_VNNI \
+    VPMADDWD  Z3, Z3, Z3 \
+    VPDPWSSD  Z2, Z2, Z3
+
+// WSSD_WIDEN512 adds the 16 int32 lanes of Z0 into the 8 int64 lanes of Z12
+// and clears Z0. Clobbers Z5, Z6.
+#define WSSD_WIDEN512 \
+    VEXTRACTI64X4 $1, Z0, Y5 \
+    VPMOVZXDQ     Y0, Z6 \
+    VPMOVZXDQ     Y5, Z5 \
+    VPADDQ        Z6, Z12, Z12 \
+    VPADDQ        Z5, Z12, Z12 \
+    VPXORD        Z0, Z0, Z0
+
+// WSSD_KERNEL(SQUARE) is the body of the weighted SSD kernels below; two
+// pixel blocks per iteration keep the loop overhead off the vector ports.
+//   R8, R9 = current rows of a and b, R10 = current weight row
+//   AX = rows remaining, DI = pixel index within the row
+//   SI = pixels covered by full 16-pixel blocks, R14 by 32-pixel pairs
+//   BX = tail pixels; K1 = RGB byte mask (alpha is bit 3 of every nibble),
+//   K2 = K1 & ((1 << (BX*4)) - 1), K3 = (1 << BX) - 1
+//   Z12 = int64 accumulator, Z0 = int32 accumulator
+#define WSSD_KERNEL(SQUARE) \
+    MOVQ a+0(FP), R8 \
+    MOVQ b+8(FP), R9 \
+    MOVQ w+16(FP), R10 \
+    MOVQ stride+24(FP), R11 \
+    MOVQ wStride+32(FP), R12 \
+    MOVQ width+40(FP), SI \
+    MOVQ height+48(FP), AX \
+    \
+    VPBROADCASTD w512EvenMask<>(SB), Z13 \
+    VPXORD Z12, Z12, Z12 \
+    VPXORD Z0, Z0, Z0 \
+    \
+    MOVQ $0x7777777777777777, DX \
+    KMOVQ DX, K1 \
+    \
+    MOVQ SI, BX \
+    ANDQ $15, BX \
+    LEAQ (BX*4), CX \
+    NEGQ CX \
+    ADDQ $64, CX \
+    MOVQ $-1, R13 \
+    SHRQ CX, R13 \
+    ANDQ DX, R13 \
+    KMOVQ R13, K2 \
+    MOVQ $1, R13 \
+    MOVQ BX, CX \
+    SHLQ CX, R13 \
+    DECQ R13 \
+    KMOVW R13, K3 \
+    \
+    ANDQ $-16, SI \
+    MOVQ SI, R14 \
+    ANDQ $-32, R14 \
+    \
+    TESTQ AX, AX \
+    JLE wssd_done \
+    \
+wssd_row: \
+    XORQ DI, DI \
+    MOVQ WSSD_FLUSH_ITERS, CX \
+    CMPQ DI, R14 \
+    JGE wssd_single \
+    \
+wssd_loop: \
+    VMOVDQU8.Z (R8)(DI*4), K1, Z1 \
+    VMOVDQU8.Z (R9)(DI*4), K1, Z2 \
+    VPMOVZXBD  (R10)(DI*1), Z4 \
+    WSSD16(SQUARE) \
+    VMOVDQU8.Z 64(R8)(DI*4), K1, Z1 \
+    VMOVDQU8.Z 64(R9)(DI*4), K1, Z2 \
+    VPMOVZXBD  16(R10)(DI*1), Z4 \
+    WSSD16(SQUARE) \
+    ADDQ $32, DI \
+    DECQ CX \
+    JNZ wssd_next \
+    WSSD_WIDEN512 \
+    MOVQ WSSD_FLUSH_ITERS, CX \
+    \
+wssd_next: \
+    CMPQ DI, R14 \
+    JL wssd_loop \
+    \
+wssd_single: \
+    CMPQ DI, SI \
+    JGE wssd_tail \
+    VMOVDQU8.Z (R8)(DI*4), K1, Z1 \
+    VMOVDQU8.Z (R9)(DI*4), K1, Z2 \
+    VPMOVZXBD  (R10)(DI*1), Z4 \
+    WSSD16(SQUARE) \
+    ADDQ $16, DI \
+    \
+wssd_tail: \
+    TESTQ BX, BX \
+    JZ wssd_row_done \
+    VMOVDQU8.Z  (R8)(DI*4), K2, Z1 \
+    VMOVDQU8.Z  (R9)(DI*4), K2, Z2 \
+    VPMOVZXBD.Z (R10)(DI*1), K3, Z4 \
+    WSSD16(SQUARE) \
+    \
+wssd_row_done: \
+    WSSD_WIDEN512 \
+    ADDQ R11, R8 \
+    ADDQ R11, R9 \
+    ADDQ R12, R10 \
+    DECQ AX \
+    JNZ wssd_row \
+    \
+wssd_done: \
+    VEXTRACTI64X4 $1, Z12, Y1 \
+    VPADDQ Y1, Y12, Y1 \
+    VEXTRACTI128 $1, Y1, X2 \
+    VPADDQ X2, X1, X1 \
+    VPSHUFD $0x4E, X1, X2 \
+    VPADDQ X2, X1, X1 \
+    VMOVQ X1, AX \
+    VZEROUPPER \
+    MOVQ AX, ret+56(FP) \
+    RET
+
+// func weightedSSDAVX512(a, b, w *uint8, stride, wStride, width, height int) int64
+TEXT ·weightedSSDAVX512(SB), NOSPLIT, $0-64
+    WSSD_KERNEL(WSSD_SQUARE)
+
+// func weightedSSDAVX512VNNI(a, b, w *uint8, stride, wStride, width, height int) int64
+TEXT ·weightedSSDAVX512VNNI(SB), NOSPLIT, $0-64
+    WSSD_KERNEL(WSSD_SQUARE_VNNI)
+
+DATA w512OnesB<>+0(SB)/1, $1
+GLOBL w512OnesB<>(SB), RODATA|NOPTR, $1
+
+DATA w512OnesW<>+0(SB)/2, $1
+GLOBL w512OnesW<>(SB), RODATA|NOPTR, $2
+
+// 24 iterations × 255 × 765² (+1 tail iteration) < 2^32 (lanes widen unsigned)
+#define WSAD_FLUSH_ITERS $24
+
+// WSAD16 accumulates w × v and w × v² of the pixels in Z1 (a) and Z2 (b),
+// alpha already zeroed, into the int32 lanes of Z0 and Z7, with the
+// zero-extended weights in Z4. v and w both fit the low word of their
+// dword, so one VPMADDWD forms w × v. Clobbers Z1-Z5.
+#define WSAD16 \
+    VPMAXUB    Z2, Z1, Z3 \
+    VPMINUB    Z2, Z1, Z1 \
+    VPSUBB     Z1, Z3, Z3 \
+    VPMADDUBSW Z14, Z3, Z3 \
+    VPMADDWD   Z15, Z3, Z3 \
+    VPMADDWD   Z4, Z3, Z5 \
+    VPADDD     Z5, Z0, Z0 \
+    VPMULLD    Z3, Z5, Z5 \
+    VPADDD     Z5, Z7, Z7
+
+// WSAD_WIDEN512 adds the int32 lanes of Z0 and Z7 into the int64 lanes of
+// Z12 and Z13 and clears them. Clobbers Z5, Z6.
+#define WSAD_WIDEN512 \
+    VEXTRACTI64X4 $1, Z0, Y5 \
+    VPMOVZXDQ     Y0, Z6 \
+    VPMOVZXDQ     Y5, Z5 \
+    VPADDQ        Z6, Z12, Z12 \
+    VPADDQ        Z5, Z12, Z12 \
+    VEXTRACTI64X4 $1, Z7, Y5 \
+    VPMOVZXDQ     Y7, Z6 \
+    VPMOVZXDQ     Y5, Z5 \
+    VPADDQ        Z6, Z13, Z13 \
+    VPADDQ        Z5, Z13, Z13 \
+    VPXORD        Z0, Z0, Z0 \
+    VPXORD        Z7, Z7, Z7
+
+// func weightedSADAVX512(a, b, w *uint8, stride, wStride, width, height int) int64
+TEXT ·weightedSADAVX512(SB), NOSPLIT, $0-64
+    MOVQ a+0(FP), R8              // R8 = current row of a
+    MOVQ b+8(FP), R9              // R9 = current row of b
+    MOVQ w+16(FP), R10            // R10 = current weight row
+    MOVQ stride+24(FP), R11
+    MOVQ wStride+32(FP), R12
+    MOVQ width+40(FP), SI
+    MOVQ height+48(FP), AX        // AX = rows remaining
+
+    VPBROADCASTB w512OnesB<>(SB), Z14
+    VPBROADCASTW w512OnesW<>(SB), Z15
+    VPXORD Z12, Z12, Z12          // Z12 = Σ w × v (int64)
+    VPXORD Z13, Z13, Z13          // Z13 = Σ w × v² (int64)
+    VPXORD Z0, Z0, Z0             // Z0, Z7 = their int32 accumulators
+    VPXORD Z7, Z7, Z7
+
+    // K1 = RGB byte mask (alpha is bit 3 of every nibble)
+    MOVQ $0x7777777777777777, DX
+    KMOVQ DX, K1
+
+    // BX = tail pixels, K2 = K1 & ((1 << (BX*4)) - 1), K3 = (1 << BX) - 1
+    MOVQ SI, BX
+    ANDQ $15, BX
+    LEAQ (BX*4), CX
+    NEGQ CX
+    ADDQ $64, CX
+    MOVQ $-1, R13
+    SHRQ CX, R13
+    ANDQ DX, R13
+    KMOVQ R13, K2
+    MOVQ $1, R13
+    MOVQ BX, CX
+    SHLQ CX, R13
+    DECQ R13
+    KMOVW R13, K3
+
+    // SI = pixels covered by full 16-pixel blocks
+    ANDQ $-16, SI
+
+    TESTQ AX, AX
+    JLE wsad_done
+
+wsad_row:
+    XORQ DI, DI                   // DI = pixel index within row
+    MOVQ WSAD_FLUSH_ITERS, CX
+    CMPQ DI, SI
+    JGE wsad_tail
+
+wsad_loop:
+    VMOVDQU8.Z (R8)(DI*4), K1, Z1
+    VMOVDQU8.Z (R9)(DI*4), K1, Z2
+    VPMOVZXBD  (R10)(DI*1), Z4
+    WSAD16
+    ADDQ $16, DI
+    DECQ CX
+    JNZ wsad_next
+    WSAD_WIDEN512
+    MOVQ WSAD_FLUSH_ITERS, CX
+
+wsad_next:
+    CMPQ DI, SI
+    JL wsad_loop
+
+wsad_tail:
+    TESTQ BX, BX
+    JZ wsad_row_done
+    VMOVDQU8.Z  (R8)(DI*4), K2, Z1
+    VMOVDQU8.Z  (R9)(DI*4), K2, Z2
+    VPMOVZXBD.Z (R10)(DI*1), K3, Z4
+    WSAD16
+
+wsad_row_done:
+    WSAD_WIDEN512
+    ADDQ R11, R8
+    ADDQ R11, R9
+    ADDQ R12, R10
+    DECQ AX
+    JNZ wsad_row
+
+wsad_done:
+    // DX = Σ w × v, AX = Σ w × v²
+    VEXTRACTI64X4 $1, Z12, Y1
+    VPADDQ Y1, Y12, Y1
+    VEXTRACTI128 $1, Y1, X2
+    VPADDQ X2, X1, X1
+    VPSHUFD $0x4E, X1, X2
+    VPADDQ X2, X1, X1
+    VMOVQ X1, DX
+    VEXTRACTI64X4 $1, Z13, Y1
+    VPADDQ Y1, Y13, Y1
+    VEXTRACTI128 $1, Y1, X2
+    VPADDQ X2, X1, X1
+    VPSHUFD $0x4E, X1, X2
+    VPADDQ X2, X1, X1
+    VMOVQ X1, AX
+    VZEROUPPER
+
+    // Σ w × v(255 + 9v) = 255 Σ w × v + 9 Σ w × v²
+    IMULQ $255, DX
+    LEAQ (AX)(AX*8), AX
+    ADDQ DX, AX
+    MOVQ AX, ret+56(FP)
+    RET
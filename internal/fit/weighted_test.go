@@ -0,0 +1,273 @@
+package fit
+
+import (
+	"image"
+	"image/color"
+	"image/png"
+	"math"
+	"math/rand"
+	"os"
+	"path/filepath"
+	"testing"
+
+	"golang.org/x/sys/cpu"
+)
+
+// randomWeightPlane creates a plane with random weights
+func randomWeightPlane(width, height int, seed int64) *WeightPlane {
+	rng := rand.New(rand.NewSource(seed))
+	p := NewWeightPlane(width, height, 0)
+	for y := 0; y < height; y++ {
+		for x := 0; x < width; x++ {
+			p.Weights[y*p.Stride+x] = uint8(rng.Intn(256))
+		}
+	}
+	return p
+}
+
+// TestWeightedCost_UniformMatchesUnweighted tests that an all-255 plane
+// reproduces FastSSD/FastSAD
+func TestWeightedCost_UniformMatchesUnweighted(t *testing.T) {
+	img1 := randomNRGBA(67, 45, 1)
+	img2 := randomNRGBA(67, 45, 2)
+	p := NewWeightPlane(67, 45, 255)
+
+	if got, want := p.SSDCost(img1, img2), FastSSD(img1, img2); math.Abs(got-want) > 1e-9*want {
+		t.Errorf("SSDCost = %v, FastSSD = %v", got, want)
+	}
+	if got, want := p.SADCost(img1, img2), FastSAD(img1, img2); math.Abs(got-want) > 1e-9*want {
+		t.Errorf("SADCost = %v, FastSAD = %v", got, want)
+	}
+}
+
+// TestWeightedCost_ZeroWeightsIgnored tests that masked-out pixels do not count
+func TestWeightedCost_ZeroWeightsIgnored(t *testing.T) {
+	ref := solidColorNRGBA(32, 32, color.NRGBA{100, 100, 100, 255})
+	cur := cloneNRGBA(ref)
+	// Change only the left half
+	for y := 0; y < 32; y++ {
+		for x := 0; x < 16; x++ {
+			cur.SetNRGBA(x, y, color.NRGBA{200, 50, 0, 255})
+		}
+	}
+
+	p := NewWeightPlane(32, 32, 255)
+	for y := 0; y < 32; y++ {
+		for x := 0; x < 16; x++ {
+			p.Weights[y*p.Stride+x] = 0
+		}
+	}
+
+	if got := p.SSDCost(cur, ref); got != 0 {
+		t.Errorf("SSDCost with masked differences = %v, want 0", got)
+	}
+	if got := p.SADCost(cur, ref); got != 0 {
+		t.Errorf("SADCost with masked differences = %v, want 0", got)
+	}
+}
+
+// TestWeightedKernels_AVX2MatchesScalar tests bit-exactness for every tail
+// length, padded image strides and maximal differences
+func TestWeightedKernels_AVX2MatchesScalar(t *testing.T) {
+	if !simdTierSupported(simdTierAVX2) {
+		t.Skip("AVX2 not supported")
+	}
+
+	check := func(name string, a, b *image.NRGBA, p *WeightPlane) {
+		t.Helper()
+		w, h := p.Width, p.Height
+		if got, want := weightedSSD_AVX2(a.Pix, b.Pix, a.Stride, p.Weights, p.Stride, w, h),
+			weightedSSD_Scalar(a.Pix, b.Pix, a.Stride, p.Weights, p.Stride, w, h); got != want {
+			t.Errorf("%s: weighted SSD AVX2 = %d, scalar = %d", name, got, want)
+		}
+		if got, want := weightedSAD_AVX2(a.Pix, b.Pix, a.Stride, p.Weights, p.Stride, w, h),
+			weightedSAD_Scalar(a.Pix, b.Pix, a.Stride, p.Weights, p.Stride, w, h); got != want {
+			t.Errorf("%s: weighted SAD AVX2 = %d, scalar = %d", name, got, want)
+		}
+	}
+
+	for width := 1; width <= 40; width++ {
+		a := randomNRGBA(width, 4, int64(width))
+		b := randomNRGBA(width, 4, int64(width)+50)
+		check("tail", a, b, randomWeightPlane(width, 4, int64(width)))
+
+		big := randomNRGBA(width+5, 6, int64(width)+100)
+		sub := big.SubImage(image.Rect(3, 1, width+3, 5)).(*image.NRGBA)
+		check("padded", sub, cloneSubStride(b, sub.Stride), randomWeightPlane(width, 4, int64(width)+7))
+	}
+
+	// Worst case: 0 vs 255 on every channel with full weights over long rows,
+	// crossing several SSD flush blocks
+	width := 32*8*3 + 5
+	black := solidColorNRGBA(width, 2, color.NRGBA{0, 0, 0, 255})
+	white := solidColorNRGBA(width, 2, color.NRGBA{255, 255, 255, 255})
+	check("max-diff", black, white, NewWeightPlane(width, 2, 255))
+}
+
+// TestWeightedKernels_AVX512MatchesScalar tests bit-exactness of the AVX-512
+// kernels across 16-pixel tails, padded strides and flush blocks
+func TestWeightedKernels_AVX512MatchesScalar(t *testing.T) {
+	if !simdTierSupported(simdTierAVX512) {
+		t.Skip("AVX-512BW not supported")
+	}
+
+	check := func(name string, a, b *image.NRGBA, p *WeightPlane) {
+		t.Helper()
+		w, h := p.Width, p.Height
+		if got, want := weightedSSD_AVX512(a.Pix, b.Pix, a.Stride, p.Weights, p.Stride, w, h),
+			weightedSSD_Scalar(a.Pix, b.Pix, a.Stride, p.Weights, p.Stride, w, h); got != want {
+			t.Errorf("%s: weighted SSD AVX-512 = %d, scalar = %d", name, got, want)
+		}
+		if cpu.X86.HasAVX512VNNI {
+			if got, want := weightedSSD_AVX512VNNI(a.Pix, b.Pix, a.Stride, p.Weights, p.Stride, w, h),
+				weightedSSD_Scalar(a.Pix, b.Pix, a.Stride, p.Weights, p.Stride, w, h); got != want {
+				t.Errorf("%s: weighted SSD AVX512-VNNI = %d, scalar = %d", name, got, want)
+			}
+		}
+		if got, want := weightedSAD_AVX512(a.Pix, b.Pix, a.Stride, p.Weights, p.Stride, w, h),
+			weightedSAD_Scalar(a.Pix, b.Pix, a.Stride, p.Weights, p.Stride, w, h); got != want {
+			t.Errorf("%s: weighted SAD AVX-512 = %d, scalar = %d", name, got, want)
+		}
+	}
+
+	for width := 1; width <= 40; width++ {
+		a := randomNRGBA(width, 4, int64(width))
+		b := randomNRGBA(width, 4, int64(width)+50)
+		check("tail", a, b, randomWeightPlane(width, 4, int64(width)))
+
+		big := randomNRGBA(width+5, 6, int64(width)+100)
+		sub := big.SubImage(image.Rect(3, 1, width+3, 5)).(*image.NRGBA)
+		check("padded", sub, cloneSubStride(b, sub.Stride), randomWeightPlane(width, 4, int64(width)+7))
+	}
+
+	width := 32*16*3 + 5
+	black := solidColorNRGBA(width, 2, color.NRGBA{0, 0, 0, 255})
+	white := solidColorNRGBA(width, 2, color.NRGBA{255, 255, 255, 255})
+	check("max-diff", black, white, NewWeightPlane(width, 2, 255))
+}
+
+// cloneSubStride copies img into a buffer with the given (larger) row stride
+func cloneSubStride(img *image.NRGBA, stride int) *image.NRGBA {
+	w, h := img.Bounds().Dx(), img.Bounds().Dy()
+	out := &image.NRGBA{Pix: make([]uint8, stride*h), Stride: stride, Rect: image.Rect(0, 0, w, h)}
+	for y := 0; y < h; y++ {
+		copy(out.Pix[y*stride:y*stride+w*4], img.Pix[y*img.Stride:y*img.Stride+w*4])
+	}
+	return out
+}
+
+// TestLoadWeightPlane tests loading and resampling a mask PNG
+func TestLoadWeightPlane(t *testing.T) {
+	// 2x2 mask: left column black, right column white
+	mask := image.NewGray(image.Rect(0, 0, 2, 2))
+	mask.SetGray(1, 0, color.Gray{255})
+	mask.SetGray(1, 1, color.Gray{255})
+
+	path := filepath.Join(t.TempDir(), "mask.png")
+	f, err := os.Create(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := png.Encode(f, mask); err != nil {
+		t.Fatal(err)
+	}
+	f.Close()
+
+	p, err := LoadWeightPlane(path, 10, 4)
+	if err != nil {
+		t.Fatalf("LoadWeightPlane: %v", err)
+	}
+	if p.Width != 10 || p.Height != 4 || p.Stride%8 != 0 {
+		t.Fatalf("plane size = %dx%d stride %d", p.Width, p.Height, p.Stride)
+	}
+	for y := 0; y < 4; y++ {
+		for x := 0; x < 10; x++ {
+			want := uint8(0)
+			if x >= 5 {
+				want = 255
+			}
+			if got := p.Weights[y*p.Stride+x]; got != want {
+				t.Errorf("weight(%d,%d) = %d, want %d", x, y, got, want)
+			}
+		}
+	}
+
+	if _, err := LoadWeightPlane(filepath.Join(t.TempDir(), "missing.png"), 10, 4); err == nil {
+		t.Error("missing mask should fail")
+	}
+}
+
+// TestEdgeWeightPlane tests that edges get more weight than flat regions
+func TestEdgeWeightPlane(t *testing.T) {
+	ref := solidColorNRGBA(20, 20, color.NRGBA{0, 0, 0, 255})
+	for y := 0; y < 20; y++ {
+		for x := 10; x < 20; x++ {
+			ref.SetNRGBA(x, y, color.NRGBA{255, 255, 255, 255})
+		}
+	}
+
+	p := EdgeWeightPlane(ref, 32)
+	if flat := p.Weights[5*p.Stride+2]; flat != 32 {
+		t.Errorf("flat weight = %d, want floor 32", flat)
+	}
+	if edge := p.Weights[5*p.Stride+10]; edge != 255 {
+		t.Errorf("edge weight = %d, want 255", edge)
+	}
+}
+
+// BenchmarkWeightedSSD compares weighted and unweighted kernels (512x512)
+func BenchmarkWeightedSSD(b *testing.B) {
+	img1 := randomNRGBA(512, 512, 1)
+	img2 := randomNRGBA(512, 512, 2)
+	p := randomWeightPlane(512, 512, 3)
+
+	b.Run("FastSSD", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			FastSSD(img1, img2)
+		}
+		b.ReportMetric(BenchmarkSSDBackend(b.N, 512, 512, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+	})
+	b.Run("WeightedSSD", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			p.SSDCost(img1, img2)
+		}
+		b.ReportMetric(BenchmarkSSDBackend(b.N, 512, 512, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+	})
+	b.Run("FastSAD", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			FastSAD(img1, img2)
+		}
+		b.ReportMetric(BenchmarkSSDBackend(b.N, 512, 512, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+	})
+	b.Run("WeightedSAD", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			p.SADCost(img1, img2)
+		}
+		b.ReportMetric(BenchmarkSSDBackend(b.N, 512, 512, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+	})
+	// Scalar kernels against each other, independent of the SIMD tier
+	b.Run("FastSSD_scalar", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			fastSSD_Scalar(img1.Pix, img2.Pix, img1.Stride, 512, 512)
+		}
+		b.ReportMetric(BenchmarkSSDBackend(b.N, 512, 512, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+	})
+	b.Run("WeightedSSD_scalar", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			weightedSSD_Scalar(img1.Pix, img2.Pix, img1.Stride, p.Weights, p.Stride, 512, 512)
+		}
+		b.ReportMetric(BenchmarkSSDBackend(b.N, 512, 512, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+	})
+	b.Run("FastSAD_scalar", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			fastSAD_Scalar(img1.Pix, img2.Pix, img1.Stride, 512, 512)
+		}
+		b.ReportMetric(BenchmarkSSDBackend(b.N, 512, 512, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+	})
+	b.Run("WeightedSAD_scalar", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			weightedSAD_Scalar(img1.Pix, img2.Pix, img1.Stride, p.Weights, p.Stride, 512, 512)
+		}
+		b.ReportMetric(BenchmarkSSDBackend(b.N, 512, 512, b.Elapsed().Nanoseconds()), "Mpixels/sec")
+	})
+}
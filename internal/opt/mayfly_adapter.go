@@ -46,30 +46,112 @@ func NewMayflyOLCE(maxIters, popSize int, seed int64) Optimizer {
 
 // RunWithInitial executes optimization starting from an initial solution.
 //
-// IMPLEMENTATION NOTE: The external Mayfly library does not support custom
-// population initialization. Therefore, this implementation uses a simple
-// strategy: run the optimizer and return the better of (optimizer result, initial solution).
-//
-// This ensures we never lose progress when resuming from a checkpoint:
-//   - If the optimizer finds a better solution, we use it
-//   - If not, we keep the checkpoint solution
-//
-// Future improvement: Switch to a different optimizer library that supports
-// population seeding, or fork the Mayfly library to add this feature.
+// The external Mayfly library cannot seed its population, so resuming runs
+// the in-package seeded search (see newSeededSwarm) for maxIters
+// generations: the population is initialParams plus perturbations of
+// decreasing scale, and the search continues from initialCost instead of
+// re-converging from scratch. All variants resume with the standard
+// algorithm. The initial solution is returned if nothing better is found.
 func (m *MayflyAdapter) RunWithInitial(initialParams []float64, initialCost float64, eval func([]float64) float64, lower, upper []float64, dim int) ([]float64, float64) {
-	// Run the optimizer normally
-	bestParams, bestCost := m.Run(eval, lower, upper, dim)
+	denormalize, normalizedEval := normalizeBounds(eval, lower, upper)
+
+	// Map the initial solution into the normalized space
+	initial := make([]float64, dim)
+	for i := range initial {
+		if span := upper[i] - lower[i]; span > 0 {
+			initial[i] = clamp01((initialParams[i] - lower[i]) / span)
+		}
+	}
 
-	// Compare with initial solution and return the better one
-	if bestCost < initialCost {
-		// Optimizer found something better
-		return bestParams, bestCost
+	swarm := newSeededSwarm(initial, max(m.popSize, 2), m.seed, SerialBatch(normalizedEval))
+	for swarm.generation < m.maxIters {
+		swarm.step()
 	}
 
+	if swarm.globalBestCost < initialCost {
+		return denormalize(swarm.globalBest), swarm.globalBestCost
+	}
 	// Initial solution is still best - don't lose progress
 	return initialParams, initialCost
 }
 
+// RunSnapshots runs the in-package Mayfly search (see newRandomSwarm) from
+// a uniformly random population or continues it from snapshot. Unlike Run,
+// which uses the external library, its state can be snapshotted after every
+// generation. All variants use the standard algorithm (see
+// SnapshotsMatchRun).
+func (m *MayflyAdapter) RunSnapshots(snapshot []byte, eval func([]float64) float64, lower, upper []float64, dim int, onGeneration func(Generation)) ([]float64, float64, error) {
+	return m.RunSnapshotsBatch(snapshot, SerialBatch(eval), lower, upper, dim, onGeneration)
+}
+
+// RunSnapshotsBatch is RunSnapshots with a batched objective: the swarm hands
+// evalBatch one population per phase of a generation. Results are identical
+// to RunSnapshots with the equivalent per-candidate eval.
+func (m *MayflyAdapter) RunSnapshotsBatch(snapshot []byte, evalBatch BatchEval, lower, upper []float64, dim int, onGeneration func(Generation)) ([]float64, float64, error) {
+	denormalize, normalizedBatch := normalizeBatchBounds(evalBatch, lower, upper)
+	popSize := max(m.popSize, 2)
+
+	var swarm *mayflySwarm
+	if snapshot == nil {
+		swarm = newRandomSwarm(dim, popSize, m.seed, normalizedBatch)
+	} else {
+		var err error
+		if swarm, err = decodeSwarm(snapshot, dim, popSize, normalizedBatch); err != nil {
+			return nil, 0, err
+		}
+	}
+
+	for swarm.generation < m.maxIters {
+		swarm.step()
+		if onGeneration != nil {
+			onGeneration(Generation{
+				Index:      swarm.generation,
+				BestCost:   swarm.globalBestCost,
+				BestParams: func() []float64 { return denormalize(swarm.globalBest) },
+				Snapshot:   swarm.snapshot,
+			})
+		}
+	}
+	return denormalize(swarm.globalBest), swarm.globalBestCost, nil
+}
+
+// SnapshotsMatchRun reports whether RunSnapshots runs the same algorithm as
+// Run. Only the standard variant is ported to the in-package swarm; DESMA,
+// OLCE-MA and the other variants only run on the external library.
+func (m *MayflyAdapter) SnapshotsMatchRun() bool {
+	return m.variant == "standard"
+}
+
+// normalizeBounds maps eval onto [0,1]^dim (mayfly only supports uniform
+// bounds) and returns the inverse mapping
+func normalizeBounds(eval func([]float64) float64, lower, upper []float64) (denormalize func([]float64) []float64, normalizedEval func([]float64) float64) {
+	denormalize = func(params []float64) []float64 {
+		result := make([]float64, len(params))
+		for i := range params {
+			result[i] = lower[i] + params[i]*(upper[i]-lower[i])
+		}
+		return result
+	}
+	normalizedEval = func(normalizedParams []float64) float64 {
+		return eval(denormalize(normalizedParams))
+	}
+	return denormalize, normalizedEval
+}
+
+// normalizeBatchBounds is normalizeBounds for a batched objective
+func normalizeBatchBounds(evalBatch BatchEval, lower, upper []float64) (denormalize func([]float64) []float64, normalizedBatch BatchEval) {
+	denormalize, _ = normalizeBounds(nil, lower, upper)
+	var params [][]float64
+	normalizedBatch = func(population [][]float64, costs []float64) {
+		params = params[:0]
+		for _, normalizedParams := range population {
+			params = append(params, denormalize(normalizedParams))
+		}
+		evalBatch(params, costs)
+	}
+	return denormalize, normalizedBatch
+}
+
 // Run executes the Mayfly optimization using the external library
 func (m *MayflyAdapter) Run(eval func([]float64) float64, lower, upper []float64, dim int) ([]float64, float64) {
 	var config *mayfly.Config
@@ -93,20 +175,7 @@ func (m *MayflyAdapter) Run(eval func([]float64) float64, lower, upper []float64
 	}
 
 	// Denormalize parameters from [0,1] to actual bounds
-	// (mayfly only supports uniform bounds, so we normalize to [0,1])
-	denormalize := func(params []float64) []float64 {
-		result := make([]float64, len(params))
-		for i := range params {
-			result[i] = lower[i] + params[i]*(upper[i]-lower[i])
-		}
-		return result
-	}
-
-	// Wrap eval function to handle normalization
-	normalizedEval := func(normalizedParams []float64) float64 {
-		denormalizedParams := denormalize(normalizedParams)
-		return eval(denormalizedParams)
-	}
+	denormalize, normalizedEval := normalizeBounds(eval, lower, upper)
 
 	config.ObjectiveFunc = normalizedEval
 	config.ProblemSize = dim
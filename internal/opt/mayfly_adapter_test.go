@@ -180,3 +180,35 @@ func TestMayflyAdapter_RunWithInitial_KeepsCheckpointIfBetter(t *testing.T) {
 	t.Logf("Initial cost: %f, Final cost: %f", initialCost, cost)
 	t.Logf("Initial params: %v, Final params: %v", initialParams, best)
 }
+
+// TestMayflyAdapter_RunWithInitial_ContinuesFromCheckpoint checks that the
+// seeded population improves on the checkpoint within a few generations,
+// where a search from scratch has not yet reached its cost
+func TestMayflyAdapter_RunWithInitial_ContinuesFromCheckpoint(t *testing.T) {
+	dim := 20
+	lower := make([]float64, dim)
+	upper := make([]float64, dim)
+	initialParams := make([]float64, dim)
+	for i := 0; i < dim; i++ {
+		lower[i], upper[i] = -10, 10
+		initialParams[i] = 1
+	}
+	initialCost := sphere(initialParams) // 20
+
+	_, costFromScratch := NewMayfly(5, 20, 7).Run(sphere, lower, upper, dim)
+	resumable := NewMayfly(5, 20, 7).(ResumableOptimizer)
+	_, costResumed := resumable.RunWithInitial(initialParams, initialCost, sphere, lower, upper, dim)
+
+	if costResumed >= initialCost {
+		t.Errorf("Resume did not improve on the checkpoint: initial=%f, final=%f", initialCost, costResumed)
+	}
+	if costResumed >= costFromScratch {
+		t.Errorf("Resume (%f) no better than a search from scratch (%f)", costResumed, costFromScratch)
+	}
+
+	// Same seed, same result
+	_, again := NewMayfly(5, 20, 7).(ResumableOptimizer).RunWithInitial(initialParams, initialCost, sphere, lower, upper, dim)
+	if again != costResumed {
+		t.Errorf("Non-deterministic resume: %f vs %f", costResumed, again)
+	}
+}
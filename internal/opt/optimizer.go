@@ -34,3 +34,81 @@ type ResumableOptimizer interface {
 	//   - Iteration count may reset or continue (implementation-specific)
 	RunWithInitial(initialParams []float64, initialCost float64, eval func([]float64) float64, lower, upper []float64, dim int) ([]float64, float64)
 }
+
+// SnapshotOptimizer extends ResumableOptimizer with snapshots of the complete
+// search state (population, velocities, random number generator, generation),
+// so a run can be stopped and continued bit-identically, e.g. on another
+// machine.
+type SnapshotOptimizer interface {
+	ResumableOptimizer
+
+	// RunSnapshots runs the search from snapshot, or from scratch if it is
+	// nil, up to the optimizer's iteration limit, calling onGeneration (if
+	// not nil) after every generation. A snapshot only continues with the
+	// optimizer settings and dimension that produced it.
+	//
+	// Returns: best parameters and best cost, or an error for an invalid snapshot
+	RunSnapshots(snapshot []byte, eval func([]float64) float64, lower, upper []float64, dim int, onGeneration func(Generation)) ([]float64, float64, error)
+}
+
+// SnapshotSearch returns optimizer as a SnapshotOptimizer if its snapshot
+// search runs the same algorithm as its Run, so callers can switch to it
+// without changing results in kind. Optimizers whose snapshot search only
+// ports some of their configurations implement SnapshotsMatchRun() bool.
+func SnapshotSearch(optimizer Optimizer) (SnapshotOptimizer, bool) {
+	snapshotter, ok := optimizer.(SnapshotOptimizer)
+	if !ok {
+		return nil, false
+	}
+	if m, ok := optimizer.(interface{ SnapshotsMatchRun() bool }); ok && !m.SnapshotsMatchRun() {
+		return nil, false
+	}
+	return snapshotter, true
+}
+
+// BatchEval evaluates a whole population at once, storing the cost of
+// population[i] in costs[i] (e.g. renderer.CostBatch, which scores a
+// population with one GPU launch and readback).
+type BatchEval func(population [][]float64, costs []float64)
+
+// SerialBatch adapts eval to a BatchEval that evaluates one candidate at a time.
+func SerialBatch(eval func([]float64) float64) BatchEval {
+	return func(population [][]float64, costs []float64) {
+		for i, params := range population {
+			costs[i] = eval(params)
+		}
+	}
+}
+
+// BatchOptimizer extends SnapshotOptimizer with a batched objective, so
+// renderers that evaluate populations at once are called once per
+// population instead of once per candidate.
+type BatchOptimizer interface {
+	SnapshotOptimizer
+
+	// RunSnapshotsBatch is RunSnapshots with evalBatch as the objective.
+	RunSnapshotsBatch(snapshot []byte, evalBatch BatchEval, lower, upper []float64, dim int, onGeneration func(Generation)) ([]float64, float64, error)
+}
+
+// RunSnapshotsBatch runs optimizer on evalBatch, through its batched path when
+// it implements BatchOptimizer and one candidate per call otherwise.
+func RunSnapshotsBatch(optimizer SnapshotOptimizer, snapshot []byte, evalBatch BatchEval, lower, upper []float64, dim int, onGeneration func(Generation)) ([]float64, float64, error) {
+	if b, ok := optimizer.(BatchOptimizer); ok {
+		return b.RunSnapshotsBatch(snapshot, evalBatch, lower, upper, dim, onGeneration)
+	}
+	eval := func(params []float64) float64 {
+		var cost [1]float64
+		evalBatch([][]float64{params}, cost[:])
+		return cost[0]
+	}
+	return optimizer.RunSnapshots(snapshot, eval, lower, upper, dim, onGeneration)
+}
+
+// Generation is the progress of a SnapshotOptimizer after one generation.
+// It is only valid during the onGeneration callback.
+type Generation struct {
+	Index      int              // Completed generations
+	BestCost   float64          // Best cost so far
+	BestParams func() []float64 // Returns a copy of the best parameters so far
+	Snapshot   func() []byte    // Encodes the complete search state
+}
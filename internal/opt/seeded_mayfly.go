@@ -0,0 +1,310 @@
+package opt
+
+import (
+	"math"
+	"math/rand"
+	"sort"
+)
+
+// Seeded Mayfly search.
+//
+// The external mayfly library always starts from a uniformly random
+// population, so resuming through it discards a checkpoint's progress. This
+// is the standard Mayfly Algorithm (Zervoudakis & Tsafarakis, 2020) with the
+// same structure - males attracted to their personal and the global best or
+// dancing, females attracted to their ranked mate or flying randomly,
+// crossover offspring and mutation - but its initial population is built
+// around a given solution: the solution itself, then copies perturbed with
+// Gaussian noise whose scale shrinks geometrically from seedMaxScale to
+// seedMinScale of each range. The broad perturbations keep exploring, the
+// fine ones refine the checkpoint from its cost onwards. newRandomSwarm
+// starts the same search from a uniformly random population instead.
+//
+// The search runs on the adapter's normalized [0, 1] space. Its random
+// numbers come from a splitmix64 source, so the whole state can be encoded
+// between generations and continued exactly (see snapshot.go).
+//
+// Candidates are evaluated through a BatchEval. Every male moves towards the
+// global best including the males moved before it, as in the standard
+// algorithm, so males are evaluated one at a time. Nothing else reads the
+// global best while moving, so the initial population, the moved females,
+// and the offspring with their mutants are one call each: a batched
+// renderer (one GPU launch and readback per call) runs popSize+2 launches
+// per generation instead of 3*popSize+2, with the same results.
+
+// Standard Mayfly Algorithm coefficients
+const (
+	mayflyGravity    = 0.8  // Velocity inertia
+	mayflyA1         = 1.0  // Attraction to the personal best
+	mayflyA2         = 1.5  // Attraction to the global best / mate
+	mayflyBeta       = 2.0  // Visibility coefficient
+	mayflyDance      = 5.0  // Nuptial dance (scaled by the range below)
+	mayflyDanceDamp  = 0.8  // Dance reduction per generation
+	mayflyFlight     = 1.0  // Female random flight (scaled by the range)
+	mayflyFlightDamp = 0.99 // Flight reduction per generation
+	mayflyVelMax     = 0.1  // Velocity limit as a fraction of the range
+	mayflyMutation   = 0.01 // Fraction of genes mutated per mutant
+	mayflyMutants    = 0.05 // Mutants per generation as a fraction of the population
+	mayflyMutSigma   = 0.1  // Mutation step as a fraction of the range
+
+	seedMaxScale = 0.25  // Perturbation of the broadest seeded individual
+	seedMinScale = 0.001 // Perturbation of the finest seeded individual
+)
+
+// seededFly is one individual of the seeded search
+type seededFly struct {
+	position, velocity []float64
+	cost               float64
+	best               []float64 // Personal best position
+	bestCost           float64
+}
+
+// mayflySwarm is the state of a seeded Mayfly search
+type mayflySwarm struct {
+	dim              int
+	males, females   []seededFly
+	globalBest       []float64
+	globalBestCost   float64
+	dance, flight    float64
+	generation       int
+	src              *splitMix64 // Backs rng; its state is part of snapshots
+	rng              *rand.Rand
+	evalBatch        BatchEval
+	costs            []float64 // evalBatch output, reused across calls
+	nOffspring, nMut int
+}
+
+// newSwarm creates an empty swarm for popSize males and popSize females
+func newSwarm(dim, popSize int, seed int64, evalBatch BatchEval) *mayflySwarm {
+	src := &splitMix64{state: uint64(seed)}
+	return &mayflySwarm{
+		dim:            dim,
+		globalBestCost: math.Inf(1),
+		dance:          mayflyDance * mayflyVelMax,
+		flight:         mayflyFlight * mayflyVelMax,
+		src:            src,
+		rng:            rand.New(src),
+		evalBatch:      evalBatch,
+		nOffspring:     popSize,
+		nMut:           max(int(math.Round(mayflyMutants*float64(popSize))), 1),
+	}
+}
+
+// populate creates and evaluates the initial males and females; position(i)
+// returns the position of the i-th individual of either sex
+func (s *mayflySwarm) populate(popSize int, position func(i int) []float64) {
+	positions := make([][]float64, 0, 2*popSize)
+	for i := 0; i < popSize; i++ {
+		positions = append(positions, position(i), position(i))
+	}
+	flies := s.newFlies(positions)
+
+	s.males = make([]seededFly, popSize)
+	s.females = make([]seededFly, popSize)
+	for i := 0; i < popSize; i++ {
+		s.males[i], s.females[i] = flies[2*i], flies[2*i+1]
+	}
+}
+
+// newRandomSwarm builds a uniformly random population in [0, 1]^dim
+func newRandomSwarm(dim, popSize int, seed int64, evalBatch BatchEval) *mayflySwarm {
+	s := newSwarm(dim, popSize, seed, evalBatch)
+	s.populate(popSize, func(int) []float64 {
+		pos := make([]float64, dim)
+		for j := range pos {
+			pos[j] = s.rng.Float64()
+		}
+		return pos
+	})
+	return s
+}
+
+// newSeededSwarm builds popSize males and popSize females around initial
+// (normalized) and evaluates them
+func newSeededSwarm(initial []float64, popSize int, seed int64, evalBatch BatchEval) *mayflySwarm {
+	s := newSwarm(len(initial), popSize, seed, evalBatch)
+	rng := s.rng
+
+	// Males and females draw their own perturbations at the same scales
+	s.populate(popSize, func(i int) []float64 {
+		pos := append([]float64(nil), initial...)
+		if i == 0 {
+			return pos
+		}
+		scale := seedMaxScale
+		if popSize > 2 {
+			scale *= math.Pow(seedMinScale/seedMaxScale, float64(i-1)/float64(popSize-2))
+		}
+		for j := range pos {
+			pos[j] = clamp01(pos[j] + rng.NormFloat64()*scale)
+		}
+		return pos
+	})
+	return s
+}
+
+// evaluate computes the costs of positions with one evalBatch call and
+// observes them in order. The result is only valid until the next call.
+func (s *mayflySwarm) evaluate(positions [][]float64) []float64 {
+	if cap(s.costs) < len(positions) {
+		s.costs = make([]float64, len(positions))
+	}
+	costs := s.costs[:len(positions)]
+	s.evalBatch(positions, costs)
+	for i, position := range positions {
+		s.observe(position, costs[i])
+	}
+	return costs
+}
+
+// newFlies evaluates positions as resting individuals
+func (s *mayflySwarm) newFlies(positions [][]float64) []seededFly {
+	costs := s.evaluate(positions)
+	flies := make([]seededFly, len(positions))
+	for i, position := range positions {
+		flies[i] = seededFly{
+			position: position,
+			velocity: make([]float64, s.dim),
+			cost:     costs[i],
+			best:     append([]float64(nil), position...),
+			bestCost: costs[i],
+		}
+	}
+	return flies
+}
+
+// observe updates the global best
+func (s *mayflySwarm) observe(position []float64, cost float64) {
+	if cost < s.globalBestCost {
+		s.globalBestCost = cost
+		s.globalBest = append(s.globalBest[:0], position...)
+	}
+}
+
+// step runs one generation
+func (s *mayflySwarm) step() {
+	for i := range s.males {
+		s.moveMale(&s.males[i])
+	}
+	// Females only follow their mate, so they move first and settle at once
+	for i := range s.females {
+		s.moveFemale(&s.females[i], &s.males[i])
+	}
+	s.settle(s.females)
+
+	byCost := func(pop []seededFly) {
+		sort.SliceStable(pop, func(a, b int) bool { return pop[a].cost < pop[b].cost })
+	}
+	byCost(s.males)
+	byCost(s.females)
+
+	// Mate the ranked pairs, then mutate some offspring; mutants only copy
+	// positions, so all of them are evaluated in one batch
+	var positions [][]float64
+	for k := 0; k < s.nOffspring/2; k++ {
+		male, female := s.males[k%len(s.males)].position, s.females[k%len(s.females)].position
+		a, b := make([]float64, s.dim), make([]float64, s.dim)
+		for j := range a {
+			l := s.rng.Float64()
+			a[j] = l*male[j] + (1-l)*female[j]
+			b[j] = l*female[j] + (1-l)*male[j]
+		}
+		positions = append(positions, a, b)
+	}
+	nGenes := max(int(math.Ceil(mayflyMutation*float64(s.dim))), 1)
+	for k, n := 0, len(positions); k < s.nMut && n > 0; k++ {
+		pos := append([]float64(nil), positions[s.rng.Intn(n)]...)
+		for g := 0; g < nGenes; g++ {
+			j := s.rng.Intn(s.dim)
+			pos[j] = clamp01(pos[j] + s.rng.NormFloat64()*mayflyMutSigma)
+		}
+		positions = append(positions, pos)
+	}
+	offspring := s.newFlies(positions)
+
+	// Offspring join both sexes; the best survive
+	half := len(offspring) / 2
+	keep := len(s.males)
+	s.males = append(s.males, offspring[:half]...)
+	s.females = append(s.females, offspring[half:]...)
+	byCost(s.males)
+	byCost(s.females)
+	s.males = s.males[:keep]
+	s.females = s.females[:keep]
+
+	s.dance *= mayflyDanceDamp
+	s.flight *= mayflyFlightDamp
+	s.generation++
+}
+
+// moveMale applies the attraction or nuptial dance update to m and
+// evaluates it, so the next male sees the updated global best
+func (s *mayflySwarm) moveMale(m *seededFly) {
+	if m.cost > s.globalBestCost {
+		rp, rg := distance2(m.position, m.best), distance2(m.position, s.globalBest)
+		wp, wg := mayflyA1*math.Exp(-mayflyBeta*rp), mayflyA2*math.Exp(-mayflyBeta*rg)
+		for j := range m.velocity {
+			m.velocity[j] = mayflyGravity*m.velocity[j] +
+				wp*s.rng.Float64()*(m.best[j]-m.position[j]) +
+				wg*s.rng.Float64()*(s.globalBest[j]-m.position[j])
+		}
+	} else {
+		for j := range m.velocity {
+			m.velocity[j] = mayflyGravity*m.velocity[j] + s.dance*(2*s.rng.Float64()-1)
+		}
+	}
+	s.move(m)
+	m.cost = s.evaluate([][]float64{m.position})[0]
+	if m.cost < m.bestCost {
+		m.bestCost = m.cost
+		copy(m.best, m.position)
+	}
+}
+
+// moveFemale applies the attraction to male or random flight update to f
+func (s *mayflySwarm) moveFemale(f, male *seededFly) {
+	if f.cost > male.cost {
+		w := mayflyA2 * math.Exp(-mayflyBeta*distance2(f.position, male.position))
+		for j := range f.velocity {
+			f.velocity[j] = mayflyGravity*f.velocity[j] + w*s.rng.Float64()*(male.position[j]-f.position[j])
+		}
+	} else {
+		for j := range f.velocity {
+			f.velocity[j] = mayflyGravity*f.velocity[j] + s.flight*(2*s.rng.Float64()-1)
+		}
+	}
+	s.move(f)
+}
+
+// move applies m's (clamped) velocity; moveMale or settle evaluates the
+// new position
+func (s *mayflySwarm) move(m *seededFly) {
+	for j := range m.position {
+		m.velocity[j] = math.Max(-mayflyVelMax, math.Min(mayflyVelMax, m.velocity[j]))
+		m.position[j] = clamp01(m.position[j] + m.velocity[j])
+	}
+}
+
+// settle evaluates moved flies in one batch
+func (s *mayflySwarm) settle(flies []seededFly) {
+	positions := make([][]float64, len(flies))
+	for i := range flies {
+		positions[i] = flies[i].position
+	}
+	for i, cost := range s.evaluate(positions) {
+		flies[i].cost = cost
+	}
+}
+
+// distance2 returns the squared Euclidean distance between a and b
+func distance2(a, b []float64) float64 {
+	var d float64
+	for j := range a {
+		d += (a[j] - b[j]) * (a[j] - b[j])
+	}
+	return d
+}
+
+func clamp01(v float64) float64 {
+	return math.Max(0, math.Min(1, v))
+}
@@ -0,0 +1,144 @@
+package opt
+
+import (
+	"encoding/binary"
+	"fmt"
+	"math"
+)
+
+// Search state snapshots.
+//
+// A snapshot is the complete state of the in-package Mayfly search between
+// two generations, so a run continued from it is bit-identical to one that
+// was never interrupted. It is a flat little-endian encoding:
+//
+//	magic       [4]byte "MFS1"
+//	dim         uint32
+//	popSize     uint32  individuals per sex
+//	generation  uint32  completed generations
+//	nOffspring  uint32
+//	nMut        uint32
+//	rng         uint64  splitmix64 state
+//	dance       float64
+//	flight      float64
+//	bestCost    float64 global best cost
+//	best        dim float64
+//	males       popSize × (position, velocity, personal best: 3×dim float64; cost, best cost)
+//	females     popSize × (position, velocity: 2×dim float64; cost)
+//
+// Females never read a personal best, so none is stored. Values are kept at
+// full float64 precision: quantizing them would break bit-identical resume.
+
+// snapshotMagic identifies a search state snapshot
+var snapshotMagic = [4]byte{'M', 'F', 'S', '1'}
+
+// snapshotHeaderSize is the size of the fixed fields before the global best
+const snapshotHeaderSize = 4 + 5*4 + 8 + 3*8
+
+// splitMix64 is a math/rand source whose entire state is one uint64
+type splitMix64 struct {
+	state uint64
+}
+
+func (s *splitMix64) Uint64() uint64 {
+	s.state += 0x9e3779b97f4a7c15
+	z := s.state
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9
+	z = (z ^ (z >> 27)) * 0x94d049bb133111eb
+	return z ^ (z >> 31)
+}
+
+func (s *splitMix64) Int63() int64 {
+	return int64(s.Uint64() >> 1)
+}
+
+func (s *splitMix64) Seed(seed int64) {
+	s.state = uint64(seed)
+}
+
+// snapshotSize returns the encoded size of a swarm
+func snapshotSize(dim, popSize int) int {
+	return snapshotHeaderSize + 8*(dim+popSize*(3*dim+2)+popSize*(2*dim+1))
+}
+
+// snapshot encodes the swarm's state
+func (s *mayflySwarm) snapshot() []byte {
+	buf := make([]byte, 0, snapshotSize(s.dim, len(s.males)))
+	buf = append(buf, snapshotMagic[:]...)
+	for _, v := range []int{s.dim, len(s.males), s.generation, s.nOffspring, s.nMut} {
+		buf = binary.LittleEndian.AppendUint32(buf, uint32(v))
+	}
+	buf = binary.LittleEndian.AppendUint64(buf, s.src.state)
+
+	floats := func(values ...float64) {
+		for _, v := range values {
+			buf = binary.LittleEndian.AppendUint64(buf, math.Float64bits(v))
+		}
+	}
+	floats(s.dance, s.flight, s.globalBestCost)
+	floats(s.globalBest...)
+	for _, m := range s.males {
+		floats(m.position...)
+		floats(m.velocity...)
+		floats(m.best...)
+		floats(m.cost, m.bestCost)
+	}
+	for _, f := range s.females {
+		floats(f.position...)
+		floats(f.velocity...)
+		floats(f.cost)
+	}
+	return buf
+}
+
+// decodeSwarm restores a swarm encoded by snapshot, which must match dim and
+// popSize
+func decodeSwarm(data []byte, dim, popSize int, evalBatch BatchEval) (*mayflySwarm, error) {
+	if len(data) < snapshotHeaderSize || [4]byte(data[:4]) != snapshotMagic {
+		return nil, fmt.Errorf("not a search state snapshot")
+	}
+	header := make([]int, 5)
+	for i := range header {
+		header[i] = int(binary.LittleEndian.Uint32(data[4+4*i:]))
+	}
+	if header[0] != dim || header[1] != popSize {
+		return nil, fmt.Errorf("snapshot is for dimension %d with population %d, not %d with %d",
+			header[0], header[1], dim, popSize)
+	}
+	if len(data) != snapshotSize(dim, popSize) {
+		return nil, fmt.Errorf("snapshot has %d bytes, want %d", len(data), snapshotSize(dim, popSize))
+	}
+
+	s := newSwarm(dim, popSize, 0, evalBatch)
+	s.generation, s.nOffspring, s.nMut = header[2], header[3], header[4]
+	s.src.state = binary.LittleEndian.Uint64(data[24:])
+
+	off := 32
+	next := func() float64 {
+		v := math.Float64frombits(binary.LittleEndian.Uint64(data[off:]))
+		off += 8
+		return v
+	}
+	vector := func() []float64 {
+		v := make([]float64, dim)
+		for j := range v {
+			v[j] = next()
+		}
+		return v
+	}
+	s.dance, s.flight, s.globalBestCost = next(), next(), next()
+	s.globalBest = vector()
+	s.males = make([]seededFly, popSize)
+	for i := range s.males {
+		m := &s.males[i]
+		m.position, m.velocity, m.best = vector(), vector(), vector()
+		m.cost, m.bestCost = next(), next()
+	}
+	s.females = make([]seededFly, popSize)
+	for i := range s.females {
+		f := &s.females[i]
+		f.position, f.velocity = vector(), vector()
+		f.cost = next()
+	}
+	return s, nil
+}
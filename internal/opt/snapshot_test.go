@@ -0,0 +1,189 @@
+package opt
+
+import (
+	"bytes"
+	"math"
+	"testing"
+)
+
+// bumpy is the Rastrigin function: many local minima keep the search
+// moving for the whole run
+func bumpy(x []float64) float64 {
+	var sum float64
+	for _, v := range x {
+		sum += v*v + 10*(1-math.Cos(2*math.Pi*v))
+	}
+	return sum
+}
+
+// TestMayflyAdapter_RunSnapshots_ExactResume checks that a run continued
+// from a snapshot is bit-identical to an uninterrupted run
+func TestMayflyAdapter_RunSnapshots_ExactResume(t *testing.T) {
+	const dim, iters = 6, 12
+	lower := []float64{-5, -5, -5, -5, -5, -5}
+	upper := []float64{5, 5, 5, 5, 5, 5}
+	optimizer := NewMayfly(iters, 20, 9).(SnapshotOptimizer)
+
+	snapshots := make(map[int][]byte)
+	best, cost, err := optimizer.RunSnapshots(nil, bumpy, lower, upper, dim, func(g Generation) {
+		snapshots[g.Index] = g.Snapshot()
+		if g.BestCost != bumpy(g.BestParams()) {
+			t.Errorf("generation %d: BestCost %f does not match BestParams", g.Index, g.BestCost)
+		}
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(snapshots) != iters {
+		t.Fatalf("%d snapshots, want one per generation (%d)", len(snapshots), iters)
+	}
+	if got, want := len(snapshots[1]), snapshotSize(dim, 20); got != want {
+		t.Errorf("snapshot is %d bytes, want %d", got, want)
+	}
+
+	// Resume from generation 5 in a fresh optimizer
+	resumedSnapshots := make(map[int][]byte)
+	resumed := NewMayfly(iters, 20, 9).(SnapshotOptimizer)
+	best2, cost2, err := resumed.RunSnapshots(snapshots[5], bumpy, lower, upper, dim, func(g Generation) {
+		resumedSnapshots[g.Index] = g.Snapshot()
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if cost2 != cost {
+		t.Errorf("resumed cost %v, uninterrupted %v", cost2, cost)
+	}
+	for i := range best {
+		if best2[i] != best[i] {
+			t.Fatalf("resumed params differ at %d: %v vs %v", i, best2[i], best[i])
+		}
+	}
+	if len(resumedSnapshots) != iters-5 {
+		t.Errorf("resumed run took %d generations, want %d", len(resumedSnapshots), iters-5)
+	}
+	for gen := 6; gen <= iters; gen++ {
+		if !bytes.Equal(resumedSnapshots[gen], snapshots[gen]) {
+			t.Fatalf("state after generation %d differs from the uninterrupted run", gen)
+		}
+	}
+}
+
+func TestMayflyAdapter_RunSnapshots_RejectsMismatch(t *testing.T) {
+	lower, upper := []float64{-1, -1}, []float64{1, 1}
+	optimizer := NewMayfly(3, 20, 1).(SnapshotOptimizer)
+
+	var snapshot []byte
+	if _, _, err := optimizer.RunSnapshots(nil, sphere, lower, upper, 2, func(g Generation) {
+		snapshot = g.Snapshot()
+	}); err != nil {
+		t.Fatal(err)
+	}
+
+	cases := map[string]struct {
+		data []byte
+		dim  int
+		opt  Optimizer
+	}{
+		"truncated":  {snapshot[:len(snapshot)-1], 2, optimizer},
+		"bad magic":  {append([]byte("XXXX"), snapshot[4:]...), 2, optimizer},
+		"dimension":  {snapshot, 3, optimizer},
+		"population": {snapshot, 2, NewMayfly(3, 30, 1)},
+	}
+	for name, c := range cases {
+		l, u := make([]float64, c.dim), make([]float64, c.dim)
+		if _, _, err := c.opt.(SnapshotOptimizer).RunSnapshots(c.data, sphere, l, u, c.dim, nil); err == nil {
+			t.Errorf("%s: expected an error", name)
+		}
+	}
+}
+
+// countingBatch evaluates f in batches and counts the calls, each standing
+// for one kernel launch and readback of a batched renderer
+func countingBatch(f func([]float64) float64, calls, evals *int) BatchEval {
+	return func(population [][]float64, costs []float64) {
+		*calls++
+		*evals += len(population)
+		SerialBatch(f)(population, costs)
+	}
+}
+
+// TestMayflyAdapter_RunSnapshotsBatch_MatchesSerial checks that batched
+// evaluation gives the per-candidate result with one call per male plus two
+// (females, offspring) per generation
+func TestMayflyAdapter_RunSnapshotsBatch_MatchesSerial(t *testing.T) {
+	const dim, iters, popSize = 6, 10, 20
+	lower := []float64{-5, -5, -5, -5, -5, -5}
+	upper := []float64{5, 5, 5, 5, 5, 5}
+
+	serialEvals := 0
+	best, cost, err := NewMayfly(iters, popSize, 3).(SnapshotOptimizer).RunSnapshots(nil, func(x []float64) float64 {
+		serialEvals++
+		return bumpy(x)
+	}, lower, upper, dim, nil)
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	calls, evals := 0, 0
+	best2, cost2, err := NewMayfly(iters, popSize, 3).(BatchOptimizer).RunSnapshotsBatch(nil, countingBatch(bumpy, &calls, &evals), lower, upper, dim, nil)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if cost2 != cost {
+		t.Errorf("batched cost %v, serial %v", cost2, cost)
+	}
+	for i := range best {
+		if best2[i] != best[i] {
+			t.Fatalf("batched params differ at %d: %v vs %v", i, best2[i], best[i])
+		}
+	}
+	if evals != serialEvals {
+		t.Errorf("batched run evaluated %d candidates, serial %d", evals, serialEvals)
+	}
+	if want := 1 + (popSize+2)*iters; calls != want {
+		t.Errorf("%d batch calls, want %d (initial population + popSize+2 per generation)", calls, want)
+	}
+}
+
+// BenchmarkMayflyAdapter_BatchEval reports objective calls (kernel launches
+// and readbacks on a batched renderer) per run for per-candidate and batched
+// evaluation of the same search
+func BenchmarkMayflyAdapter_BatchEval(b *testing.B) {
+	const dim, iters, popSize = 30, 20, 30
+	lower, upper := make([]float64, dim), make([]float64, dim)
+	for i := range lower {
+		lower[i], upper[i] = -5, 5
+	}
+
+	b.Run("Serial", func(b *testing.B) {
+		calls := 0
+		for i := 0; i < b.N; i++ {
+			NewMayfly(iters, popSize, 1).(SnapshotOptimizer).RunSnapshots(nil, func(x []float64) float64 {
+				calls++
+				return bumpy(x)
+			}, lower, upper, dim, nil)
+		}
+		b.ReportMetric(float64(calls)/float64(b.N), "launches/op")
+	})
+	b.Run("Batch", func(b *testing.B) {
+		calls, evals := 0, 0
+		for i := 0; i < b.N; i++ {
+			NewMayfly(iters, popSize, 1).(BatchOptimizer).RunSnapshotsBatch(nil, countingBatch(bumpy, &calls, &evals), lower, upper, dim, nil)
+		}
+		b.ReportMetric(float64(calls)/float64(b.N), "launches/op")
+		b.ReportMetric(float64(evals)/float64(calls), "candidates/launch")
+	})
+}
+
+// TestSnapshotSearch_OnlyStandardMayfly checks that only the standard variant
+// offers its snapshot search in place of Run
+func TestSnapshotSearch_OnlyStandardMayfly(t *testing.T) {
+	if _, ok := SnapshotSearch(NewMayfly(10, 10, 1)); !ok {
+		t.Error("standard Mayfly has no snapshot search")
+	}
+	for _, variant := range []Optimizer{NewMayflyDESMA(10, 10, 1), NewMayflyOLCE(10, 10, 1)} {
+		if _, ok := SnapshotSearch(variant); ok {
+			t.Errorf("%s runs the standard snapshot search", variant.(*MayflyAdapter).variant)
+		}
+	}
+}
@@ -0,0 +1,301 @@
+package server
+
+import (
+	"context"
+	"encoding/json"
+	"fmt"
+	"log/slog"
+	"net/http"
+	"runtime"
+	"sort"
+	"strings"
+	"sync"
+	"time"
+
+	"github.com/cwbudde/mayflycirclefit/internal/store"
+	"github.com/google/uuid"
+)
+
+// Batches.
+//
+// A batch fits one reference image with several job configurations (a
+// parameter sweep over modes, circle counts, seeds, costs...). The reference
+// is decoded once and its planes, weight masks and cost functions are shared
+// by every job (see jobResources); up to Workers jobs run concurrently, each
+// with its own single-threaded optimizer and renderer. The batch summary
+// ranks the variants by best cost.
+
+// BatchRequest describes a batch of jobs on one reference image
+type BatchRequest struct {
+	RefPath string      `json:"refPath"`
+	Jobs    []JobConfig `json:"jobs"`              // Variants; RefPath defaults to the batch's
+	Workers int         `json:"workers,omitempty"` // Concurrent jobs (default: GOMAXPROCS)
+}
+
+// Batch is a group of jobs created by one BatchRequest
+type Batch struct {
+	ID        string          `json:"id"`
+	RefPath   string          `json:"refPath"`
+	JobIDs    []string        `json:"jobIds"`
+	Workers   int             `json:"workers"`
+	StartTime time.Time       `json:"startTime"`
+	EndTime   *time.Time      `json:"endTime,omitempty"`
+	elapsed   []time.Duration // Run time per job (excludes queueing), by JobIDs index
+}
+
+// BatchResult is one variant's row in a batch summary
+type BatchResult struct {
+	Rank        int      `json:"rank,omitempty"` // 1 = lowest best cost; 0 until completed
+	JobID       string   `json:"jobId"`
+	State       JobState `json:"state"`
+	Mode        string   `json:"mode"`
+	Circles     int      `json:"circles"`
+	Iters       int      `json:"iters"`
+	PopSize     int      `json:"popSize"`
+	Seed        int64    `json:"seed"`
+	Cost        string   `json:"cost,omitempty"`
+	InitialCost float64  `json:"initialCost"`
+	BestCost    float64  `json:"bestCost"`
+	Improvement float64  `json:"improvement"` // Percent below the initial cost
+	Elapsed     float64  `json:"elapsedSeconds"`
+	Error       string   `json:"error,omitempty"`
+}
+
+// BatchSummary compares the jobs of a batch
+type BatchSummary struct {
+	ID        string        `json:"id"`
+	RefPath   string        `json:"refPath"`
+	State     JobState      `json:"state"` // Running until every job has finished
+	Workers   int           `json:"workers"`
+	StartTime time.Time     `json:"startTime"`
+	EndTime   *time.Time    `json:"endTime,omitempty"`
+	Results   []BatchResult `json:"results"` // In submission order
+}
+
+// createBatch validates req, loads the shared reference and creates the
+// batch's pending jobs
+func (jm *JobManager) createBatch(req BatchRequest) (*Batch, *jobResources, error) {
+	if req.RefPath == "" {
+		return nil, nil, fmt.Errorf("refPath is required")
+	}
+	if len(req.Jobs) == 0 {
+		return nil, nil, fmt.Errorf("at least one job is required")
+	}
+
+	configs := make([]JobConfig, len(req.Jobs))
+	for i, config := range req.Jobs {
+		if config.RefPath == "" {
+			config.RefPath = req.RefPath
+		}
+		if config.RefPath != req.RefPath {
+			return nil, nil, fmt.Errorf("job %d: refPath differs from the batch's", i)
+		}
+		if err := prepareJobConfig(&config); err != nil {
+			return nil, nil, fmt.Errorf("job %d: %w", i, err)
+		}
+		configs[i] = config
+	}
+
+	res, err := loadJobResources(req.RefPath)
+	if err != nil {
+		return nil, nil, err
+	}
+
+	workers := req.Workers
+	if workers <= 0 {
+		workers = runtime.GOMAXPROCS(0)
+	}
+	workers = min(workers, len(configs))
+
+	batch := &Batch{
+		ID:        uuid.New().String(),
+		RefPath:   req.RefPath,
+		Workers:   workers,
+		StartTime: time.Now(),
+		elapsed:   make([]time.Duration, len(configs)),
+	}
+	for _, config := range configs {
+		batch.JobIDs = append(batch.JobIDs, jm.CreateJob(config).ID)
+	}
+
+	jm.mu.Lock()
+	jm.batches[batch.ID] = batch
+	jm.mu.Unlock()
+	return batch, res, nil
+}
+
+// runBatch runs the batch's jobs on res, at most batch.Workers at a time and
+// in submission order, and returns when all have finished
+func runBatch(ctx context.Context, jm *JobManager, checkpointStore store.Store, batch *Batch, res *jobResources) {
+	slog.Info("Starting batch", "batch_id", batch.ID, "jobs", len(batch.JobIDs), "workers", batch.Workers)
+
+	sem := make(chan struct{}, batch.Workers)
+	var wg sync.WaitGroup
+	for i, jobID := range batch.JobIDs {
+		select {
+		case sem <- struct{}{}:
+		case <-ctx.Done():
+			markJobCancelled(jm, jobID)
+			continue
+		}
+		wg.Add(1)
+		go func(i int, jobID string) {
+			defer func() { <-sem; wg.Done() }()
+			start := time.Now()
+			runJobWith(ctx, jm, checkpointStore, jobID, res)
+			jm.mu.Lock()
+			batch.elapsed[i] = time.Since(start)
+			jm.mu.Unlock()
+		}(i, jobID)
+	}
+	wg.Wait()
+
+	endTime := time.Now()
+	jm.mu.Lock()
+	batch.EndTime = &endTime
+	jm.mu.Unlock()
+	slog.Info("Batch finished", "batch_id", batch.ID, "elapsed", endTime.Sub(batch.StartTime))
+}
+
+// RunBatch creates a batch on jm and runs it to completion, for in-process
+// sweeps without the HTTP server
+func RunBatch(ctx context.Context, jm *JobManager, checkpointStore store.Store, req BatchRequest) (*BatchSummary, error) {
+	batch, res, err := jm.createBatch(req)
+	if err != nil {
+		return nil, err
+	}
+	runBatch(ctx, jm, checkpointStore, batch, res)
+	summary, _ := jm.BatchSummary(batch.ID)
+	return summary, nil
+}
+
+// BatchSummary returns the comparative summary of a batch
+func (jm *JobManager) BatchSummary(id string) (*BatchSummary, bool) {
+	jm.mu.RLock()
+	defer jm.mu.RUnlock()
+
+	batch, exists := jm.batches[id]
+	if !exists {
+		return nil, false
+	}
+	return jm.summarize(batch), true
+}
+
+// ListBatchSummaries returns the summaries of all batches, oldest first
+func (jm *JobManager) ListBatchSummaries() []*BatchSummary {
+	jm.mu.RLock()
+	defer jm.mu.RUnlock()
+
+	summaries := make([]*BatchSummary, 0, len(jm.batches))
+	for _, batch := range jm.batches {
+		summaries = append(summaries, jm.summarize(batch))
+	}
+	sort.Slice(summaries, func(i, j int) bool {
+		return summaries[i].StartTime.Before(summaries[j].StartTime)
+	})
+	return summaries
+}
+
+// summarize builds a batch summary. Callers hold jm.mu.
+func (jm *JobManager) summarize(batch *Batch) *BatchSummary {
+	summary := &BatchSummary{
+		ID:        batch.ID,
+		RefPath:   batch.RefPath,
+		State:     StateCompleted,
+		Workers:   batch.Workers,
+		StartTime: batch.StartTime,
+		EndTime:   batch.EndTime,
+		Results:   make([]BatchResult, len(batch.JobIDs)),
+	}
+	if batch.EndTime == nil {
+		summary.State = StateRunning
+	}
+
+	var completed []*BatchResult
+	for i, jobID := range batch.JobIDs {
+		job := jm.jobs[jobID]
+		result := &summary.Results[i]
+		*result = BatchResult{
+			JobID:       jobID,
+			State:       job.State,
+			Mode:        job.Config.Mode,
+			Circles:     job.Config.Circles,
+			Iters:       job.Config.Iters,
+			PopSize:     job.Config.PopSize,
+			Seed:        job.Config.Seed,
+			Cost:        job.Config.Cost,
+			InitialCost: job.InitialCost,
+			BestCost:    job.BestCost,
+			Elapsed:     batch.elapsed[i].Seconds(),
+			Error:       job.Error,
+		}
+		if job.InitialCost > 0 {
+			result.Improvement = (job.InitialCost - job.BestCost) / job.InitialCost * 100
+		}
+		if job.State == StateCompleted {
+			completed = append(completed, result)
+		}
+	}
+
+	sort.SliceStable(completed, func(i, j int) bool {
+		return completed[i].BestCost < completed[j].BestCost
+	})
+	for rank, result := range completed {
+		result.Rank = rank + 1
+	}
+	return summary
+}
+
+// handleBatches handles /api/v1/batches
+func (s *Server) handleBatches(w http.ResponseWriter, r *http.Request) {
+	switch r.Method {
+	case http.MethodPost:
+		s.handleCreateBatch(w, r)
+	case http.MethodGet:
+		w.Header().Set("Content-Type", "application/json")
+		json.NewEncoder(w).Encode(s.jobManager.ListBatchSummaries())
+	default:
+		http.Error(w, "Method not allowed", http.StatusMethodNotAllowed)
+	}
+}
+
+// handleCreateBatch handles POST /api/v1/batches
+func (s *Server) handleCreateBatch(w http.ResponseWriter, r *http.Request) {
+	var req BatchRequest
+	if err := json.NewDecoder(r.Body).Decode(&req); err != nil {
+		http.Error(w, fmt.Sprintf("Invalid JSON: %v", err), http.StatusBadRequest)
+		return
+	}
+
+	batch, res, err := s.jobManager.createBatch(req)
+	if err != nil {
+		http.Error(w, err.Error(), http.StatusBadRequest)
+		return
+	}
+
+	// Run the jobs in background with checkpoint store
+	go runBatch(s.ctx, s.jobManager, s.store, batch, res)
+
+	summary, _ := s.jobManager.BatchSummary(batch.ID)
+	w.Header().Set("Content-Type", "application/json")
+	w.WriteHeader(http.StatusCreated)
+	json.NewEncoder(w).Encode(summary)
+}
+
+// handleGetBatch handles GET /api/v1/batches/:id
+func (s *Server) handleGetBatch(w http.ResponseWriter, r *http.Request) {
+	if r.Method != http.MethodGet {
+		http.Error(w, "Method not allowed", http.StatusMethodNotAllowed)
+		return
+	}
+
+	batchID := strings.Trim(strings.TrimPrefix(r.URL.Path, "/api/v1/batches/"), "/")
+	summary, exists := s.jobManager.BatchSummary(batchID)
+	if !exists {
+		http.Error(w, "Batch not found", http.StatusNotFound)
+		return
+	}
+
+	w.Header().Set("Content-Type", "application/json")
+	json.NewEncoder(w).Encode(summary)
+}
@@ -0,0 +1,153 @@
+package server
+
+import (
+	"bytes"
+	"context"
+	"encoding/json"
+	"net/http"
+	"net/http/httptest"
+	"path/filepath"
+	"testing"
+	"time"
+)
+
+func TestServer_CreateBatch(t *testing.T) {
+	tmpDir := t.TempDir()
+	imgPath := filepath.Join(tmpDir, "test.png")
+	createSimpleTestImage(t, imgPath)
+
+	s := NewServer(":8080", nil)
+
+	req := BatchRequest{
+		RefPath: imgPath,
+		Jobs: []JobConfig{
+			{Mode: "joint", Circles: 2, Iters: 5, PopSize: 10, Seed: 1},
+			{Mode: "joint", Circles: 3, Iters: 5, PopSize: 10, Seed: 2},
+			{Mode: "sequential", Circles: 2, Iters: 5, PopSize: 10, Seed: 3, Cost: "ycbcr"},
+		},
+		Workers: 2,
+	}
+	body, _ := json.Marshal(req)
+	w := httptest.NewRecorder()
+	s.handleBatches(w, httptest.NewRequest(http.MethodPost, "/api/v1/batches", bytes.NewReader(body)))
+	if w.Code != http.StatusCreated {
+		t.Fatalf("Expected status 201, got %d: %s", w.Code, w.Body.String())
+	}
+
+	var created BatchSummary
+	if err := json.NewDecoder(w.Body).Decode(&created); err != nil {
+		t.Fatalf("Failed to decode response: %v", err)
+	}
+	if created.Workers != 2 || len(created.Results) != 3 {
+		t.Fatalf("Expected 2 workers and 3 results, got %d and %d", created.Workers, len(created.Results))
+	}
+
+	// Poll until every job has finished
+	var summary BatchSummary
+	deadline := time.Now().Add(30 * time.Second)
+	for {
+		w := httptest.NewRecorder()
+		s.handleGetBatch(w, httptest.NewRequest(http.MethodGet, "/api/v1/batches/"+created.ID, nil))
+		if w.Code != http.StatusOK {
+			t.Fatalf("Expected status 200, got %d", w.Code)
+		}
+		if err := json.NewDecoder(w.Body).Decode(&summary); err != nil {
+			t.Fatalf("Failed to decode summary: %v", err)
+		}
+		if summary.State == StateCompleted {
+			break
+		}
+		if time.Now().After(deadline) {
+			t.Fatal("Batch did not finish")
+		}
+		time.Sleep(50 * time.Millisecond)
+	}
+
+	ranks := map[int]bool{}
+	for i, result := range summary.Results {
+		if result.State != StateCompleted {
+			t.Fatalf("Job %d: state %s (%s)", i, result.State, result.Error)
+		}
+		if result.Circles != req.Jobs[i].Circles || result.Seed != req.Jobs[i].Seed {
+			t.Errorf("Job %d: results out of submission order", i)
+		}
+		ranks[result.Rank] = true
+	}
+	for rank := 1; rank <= 3; rank++ {
+		if !ranks[rank] {
+			t.Errorf("Missing rank %d", rank)
+		}
+	}
+	for _, a := range summary.Results {
+		for _, b := range summary.Results {
+			if a.Rank < b.Rank && a.BestCost > b.BestCost {
+				t.Errorf("Rank %d (cost %g) worse than rank %d (cost %g)", a.Rank, a.BestCost, b.Rank, b.BestCost)
+			}
+		}
+	}
+}
+
+func TestServer_CreateBatch_Invalid(t *testing.T) {
+	tmpDir := t.TempDir()
+	imgPath := filepath.Join(tmpDir, "test.png")
+	createSimpleTestImage(t, imgPath)
+
+	s := NewServer(":8080", nil)
+	for name, req := range map[string]BatchRequest{
+		"no jobs":      {RefPath: imgPath},
+		"missing ref":  {RefPath: filepath.Join(tmpDir, "missing.png"), Jobs: []JobConfig{{}}},
+		"unknown cost": {RefPath: imgPath, Jobs: []JobConfig{{Cost: "no-such-cost"}}},
+		"other ref":    {RefPath: imgPath, Jobs: []JobConfig{{RefPath: "other.png"}}},
+	} {
+		body, _ := json.Marshal(req)
+		w := httptest.NewRecorder()
+		s.handleBatches(w, httptest.NewRequest(http.MethodPost, "/api/v1/batches", bytes.NewReader(body)))
+		if w.Code != http.StatusBadRequest {
+			t.Errorf("%s: expected status 400, got %d", name, w.Code)
+		}
+	}
+	if jobs := s.jobManager.ListJobs(); len(jobs) != 0 {
+		t.Errorf("Invalid batches created %d jobs", len(jobs))
+	}
+}
+
+// TestRunBatch_SharesResources checks that jobs with the same cost and mask
+// share one cost function
+func TestRunBatch_SharesResources(t *testing.T) {
+	tmpDir := t.TempDir()
+	imgPath := filepath.Join(tmpDir, "test.png")
+	createSimpleTestImage(t, imgPath)
+
+	res, err := loadJobResources(imgPath)
+	if err != nil {
+		t.Fatal(err)
+	}
+	first, _, err := res.costFunc("ssim", "")
+	if err != nil {
+		t.Fatal(err)
+	}
+	second, _, _ := res.costFunc("ssim", "")
+	if len(res.costs) != 1 || first == nil || second == nil {
+		t.Errorf("Expected one cached cost function, got %d", len(res.costs))
+	}
+
+	jm := NewJobManager()
+	summary, err := RunBatch(context.Background(), jm, nil, BatchRequest{
+		RefPath: imgPath,
+		Jobs: []JobConfig{
+			{Circles: 2, Iters: 3, PopSize: 8, Seed: 1, Cost: "ssim"},
+			{Circles: 2, Iters: 3, PopSize: 8, Seed: 2, Cost: "ssim"},
+		},
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if summary.State != StateCompleted || summary.EndTime == nil {
+		t.Errorf("Expected completed batch, got %s", summary.State)
+	}
+	for _, result := range summary.Results {
+		if result.State != StateCompleted || result.Rank == 0 || result.Elapsed <= 0 {
+			t.Errorf("Unexpected result %+v", result)
+		}
+	}
+}
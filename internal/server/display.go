@@ -0,0 +1,104 @@
+package server
+
+import (
+	"image"
+	"sync"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit/renderer"
+)
+
+// displayCacheLimit is the number of jobs whose display renderer is kept
+const displayCacheLimit = 8
+
+// displayCache keeps one display renderer (see newDisplayRenderer) and one
+// frame pool per job, so image handlers and checkpoint artifacts render into
+// pooled frames with RenderInto instead of loading the reference and building
+// a renderer per call. Renderers are not safe for concurrent use; each entry
+// serializes its renders, which never touch the optimizer's renderer.
+type displayCache struct {
+	mu      sync.Mutex
+	entries map[string]*displayEntry
+	order   []string // Job IDs, least recently used first
+}
+
+type displayEntry struct {
+	mu     sync.Mutex
+	config JobConfig
+	ref    *image.NRGBA
+	rend   renderer.Renderer
+	frames *renderer.FramePool
+}
+
+func newDisplayCache() *displayCache {
+	return &displayCache{entries: make(map[string]*displayEntry)}
+}
+
+// render draws params for job into a pooled frame. The caller owns the frame
+// until it calls release; ref is the job's reference image (read-only).
+func (c *displayCache) render(job *Job, params []float64) (frame, ref *image.NRGBA, release func(), err error) {
+	entry, err := c.entry(job)
+	if err != nil {
+		return nil, nil, nil, err
+	}
+
+	frame = entry.frames.Get()
+	entry.mu.Lock()
+	// Sequential and batch jobs may stop early with fewer circles
+	if s, ok := entry.rend.(interface{ SetCircles(k int) }); ok {
+		s.SetCircles(len(params) / renderer.ParamsPerCircle(entry.rend))
+	}
+	renderer.RenderInto(entry.rend, frame, params)
+	entry.mu.Unlock()
+
+	return frame, entry.ref, func() { entry.frames.Put(frame) }, nil
+}
+
+// entry returns the cached entry for job, creating it when missing or when
+// the job's configuration changed.
+func (c *displayCache) entry(job *Job) (*displayEntry, error) {
+	c.mu.Lock()
+	if e, ok := c.entries[job.ID]; ok && e.config == job.Config {
+		c.touch(job.ID)
+		c.mu.Unlock()
+		return e, nil
+	}
+	c.mu.Unlock()
+
+	// Load outside the lock: reading the reference can be slow
+	ref, err := loadReferenceImage(job.Config.RefPath)
+	if err != nil {
+		return nil, err
+	}
+	bounds := ref.Bounds()
+	e := &displayEntry{
+		config: job.Config,
+		ref:    ref,
+		rend:   newDisplayRenderer(ref, job.Config),
+		frames: renderer.NewFramePool(bounds.Dx(), bounds.Dy()),
+	}
+
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if existing, ok := c.entries[job.ID]; ok && existing.config == job.Config {
+		c.touch(job.ID)
+		return existing, nil // Created concurrently
+	}
+	c.entries[job.ID] = e
+	c.touch(job.ID)
+	for len(c.order) > displayCacheLimit {
+		delete(c.entries, c.order[0])
+		c.order = c.order[1:]
+	}
+	return e, nil
+}
+
+// touch moves id to the most recently used end of the order
+func (c *displayCache) touch(id string) {
+	for i, other := range c.order {
+		if other == id {
+			c.order = append(c.order[:i], c.order[i+1:]...)
+			break
+		}
+	}
+	c.order = append(c.order, id)
+}
@@ -0,0 +1,88 @@
+package server
+
+import (
+	"bytes"
+	"path/filepath"
+	"sync"
+	"testing"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit/renderer"
+)
+
+// TestDisplayCache_ReusesRendererAndFrames checks that repeated renders of a
+// job share one cached entry and match a freshly built display renderer
+func TestDisplayCache_ReusesRendererAndFrames(t *testing.T) {
+	imgPath := filepath.Join(t.TempDir(), "test.png")
+	createSimpleTestImage(t, imgPath)
+
+	jm := NewJobManager()
+	job := jm.CreateJob(JobConfig{RefPath: imgPath, Mode: "joint", Circles: 2})
+	params := []float64{25, 25, 10, 0, 0, 1, 0.8, 10, 12, 6, 1, 0, 0, 0.5}
+
+	ref, err := loadReferenceImage(imgPath)
+	if err != nil {
+		t.Fatal(err)
+	}
+	want := append([]uint8(nil), newDisplayRenderer(ref, job.Config).Render(params).Pix...)
+
+	first, _, release, err := jm.display.render(job, params)
+	if err != nil {
+		t.Fatalf("render: %v", err)
+	}
+	if !bytes.Equal(first.Pix, want) {
+		t.Error("cached display render differs from a fresh renderer")
+	}
+	entry := jm.display.entries[job.ID]
+	release()
+
+	// Fewer circles than configured (early convergence) must still render
+	second, _, release, err := jm.display.render(job, params[:7])
+	if err != nil {
+		t.Fatalf("render: %v", err)
+	}
+	release()
+	if jm.display.entries[job.ID] != entry {
+		t.Error("second render rebuilt the display entry")
+	}
+	if bytes.Equal(second.Pix, want) {
+		t.Error("one-circle render matches the two-circle render")
+	}
+}
+
+// TestDisplayCache_ConcurrentRenders renders one job from several goroutines;
+// every caller must get its own, correct frame
+func TestDisplayCache_ConcurrentRenders(t *testing.T) {
+	imgPath := filepath.Join(t.TempDir(), "test.png")
+	createSimpleTestImage(t, imgPath)
+
+	jm := NewJobManager()
+	job := jm.CreateJob(JobConfig{RefPath: imgPath, Mode: "joint", Circles: 1})
+	ref, err := loadReferenceImage(imgPath)
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	var wg sync.WaitGroup
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func(g int) {
+			defer wg.Done()
+			params := []float64{float64(10 + g*4), 25, 8, 0, 0, 0, 1}
+			want := append([]uint8(nil), renderer.NewCPURenderer(ref, 1).Render(params).Pix...)
+			for i := 0; i < 10; i++ {
+				frame, _, release, err := jm.display.render(job, params)
+				if err != nil {
+					t.Error(err)
+					return
+				}
+				ok := bytes.Equal(frame.Pix, want)
+				release()
+				if !ok {
+					t.Errorf("goroutine %d got another caller's frame", g)
+					return
+				}
+			}
+		}(g)
+	}
+	wg.Wait()
+}
@@ -33,6 +33,22 @@ func loadReferenceImage(path string) (*image.NRGBA, error) {
 	return ref, nil
 }
 
+// referenceSize returns the dimensions of the image at path from its header,
+// without decoding the pixels
+func referenceSize(path string) (width, height int, err error) {
+	f, err := os.Open(path)
+	if err != nil {
+		return 0, 0, fmt.Errorf("failed to open image: %w", err)
+	}
+	defer f.Close()
+
+	config, _, err := image.DecodeConfig(f)
+	if err != nil {
+		return 0, 0, fmt.Errorf("failed to decode image: %w", err)
+	}
+	return config.Width, config.Height, nil
+}
+
 // computeDiffImage creates a false-color difference image
 func computeDiffImage(ref, best *image.NRGBA) *image.NRGBA {
 	bounds := ref.Bounds()
@@ -25,30 +25,37 @@ type JobConfig = store.JobConfig
 
 // Job represents an optimization job
 type Job struct {
-	ID          string     `json:"id"`
-	State       JobState   `json:"state"`
-	Config      JobConfig  `json:"config"`
-	BestParams  []float64  `json:"bestParams,omitempty"`
-	BestCost    float64    `json:"bestCost"`
-	InitialCost float64    `json:"initialCost"`
-	Iterations  int        `json:"iterations"`
-	StartTime   time.Time  `json:"startTime"`
-	EndTime     *time.Time `json:"endTime,omitempty"`
-	Error       string     `json:"error,omitempty"`
+	ID             string               `json:"id"`
+	State          JobState             `json:"state"`
+	Config         JobConfig            `json:"config"`
+	BestParams     []float64            `json:"bestParams,omitempty"`
+	BestCost       float64              `json:"bestCost"`
+	InitialCost    float64              `json:"initialCost"`
+	Iterations     int                  `json:"iterations"`
+	Pipeline       *store.PipelineState `json:"pipeline,omitempty"`      // Sequential/batch progress
+	OptimizerState []byte               `json:"-"`                       // Joint search snapshot (see opt.SnapshotOptimizer)
+	Culled         uint64               `json:"culledCircles,omitempty"` // Circles skipped by occlusion culling
+	StartTime      time.Time            `json:"startTime"`
+	EndTime        *time.Time           `json:"endTime,omitempty"`
+	Error          string               `json:"error,omitempty"`
 }
 
 // JobManager manages the lifecycle of jobs
 type JobManager struct {
 	mu          sync.RWMutex
 	jobs        map[string]*Job
+	batches     map[string]*Batch
 	broadcaster *EventBroadcaster
+	display     *displayCache // Renderers for best/diff images and checkpoint artifacts
 }
 
 // NewJobManager creates a new JobManager
 func NewJobManager() *JobManager {
 	return &JobManager{
 		jobs:        make(map[string]*Job),
+		batches:     make(map[string]*Batch),
 		broadcaster: NewEventBroadcaster(),
+		display:     newDisplayCache(),
 	}
 }
 
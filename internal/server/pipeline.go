@@ -0,0 +1,68 @@
+package server
+
+import (
+	"fmt"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit/renderer"
+	"github.com/cwbudde/mayflycirclefit/internal/opt"
+	"github.com/cwbudde/mayflycirclefit/internal/store"
+)
+
+// pipelineBatchSize is the number of circles batch mode adds per pass
+const pipelineBatchSize = 5
+
+// RunPipeline runs config's sequential or batch pipeline on rend, continuing
+// from from (nil = from scratch) and reporting every committed step to
+// onStep (optional)
+func RunPipeline(rend renderer.Renderer, optimizer opt.Optimizer, config JobConfig, from *renderer.PipelineState, onStep func(renderer.PipelineState)) (*renderer.OptimizationResult, error) {
+	hooks := renderer.PipelineHooks{From: from, OnStep: onStep}
+	convergenceConfig := buildConvergenceConfig(config)
+
+	switch config.Mode {
+	case "sequential":
+		return renderer.OptimizeSequentialFrom(rend, optimizer, config.Circles, convergenceConfig, hooks), nil
+	case "batch":
+		passes := (config.Circles + pipelineBatchSize - 1) / pipelineBatchSize
+		return renderer.OptimizeBatchFrom(rend, optimizer, pipelineBatchSize, passes, convergenceConfig, hooks), nil
+	default:
+		return nil, fmt.Errorf("mode %s has no pipeline", config.Mode)
+	}
+}
+
+// CheckpointPipelineState converts a pipeline's progress for checkpoints
+// (the committed parameters are stored as the checkpoint's best params)
+func CheckpointPipelineState(state renderer.PipelineState, perCircle int) *store.PipelineState {
+	return &store.PipelineState{
+		Circles:         len(state.Params) / perCircle,
+		Pass:            state.Pass,
+		Converged:       state.Converged,
+		CostHistory:     state.Tracker.History,
+		LastSignificant: state.Tracker.LastSignificant,
+		StaleCount:      state.Tracker.StaleCount,
+	}
+}
+
+// ResumePipelineState returns the state to continue config's pipeline from,
+// given the committed circles params and their checkpointed state. A nil
+// state (checkpoints written before pipelines recorded it) continues after
+// params with a fresh convergence tracker.
+func ResumePipelineState(config JobConfig, params []float64, state *store.PipelineState) *renderer.PipelineState {
+	if state == nil {
+		circles := len(params) / config.ParamsPerCircle()
+		pass := circles
+		if config.Mode == "batch" {
+			pass = circles / pipelineBatchSize
+		}
+		return &renderer.PipelineState{Params: params, Pass: pass}
+	}
+	return &renderer.PipelineState{
+		Params:    params,
+		Pass:      state.Pass,
+		Converged: state.Converged,
+		Tracker: renderer.TrackerState{
+			History:         state.CostHistory,
+			LastSignificant: state.LastSignificant,
+			StaleCount:      state.StaleCount,
+		},
+	}
+}
@@ -0,0 +1,80 @@
+package server
+
+import (
+	"image"
+	"log/slog"
+	"sync"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
+	"github.com/cwbudde/mayflycirclefit/internal/fit/renderer"
+)
+
+// jobResources holds the read-only data derived from one reference image:
+// the decoded image with its planar/luma planes (renderer.SharedReference),
+// loaded weight masks and built cost functions. A single job creates its own;
+// the jobs of a batch share one, so a sweep of N variants decodes the image,
+// loads each mask and precomputes each cost (perceptual planes, SSIM tables)
+// once instead of N times. Safe for concurrent use.
+type jobResources struct {
+	shared *renderer.SharedReference
+
+	mu      sync.Mutex
+	weights map[string]*fit.WeightPlane
+	costs   map[costKey]fit.CostFunc
+}
+
+// costKey identifies a cost function built for the shared reference
+type costKey struct {
+	name       string
+	weightMask string
+}
+
+// loadJobResources decodes the reference image at refPath
+func loadJobResources(refPath string) (*jobResources, error) {
+	ref, err := loadReferenceImage(refPath)
+	if err != nil {
+		return nil, err
+	}
+	return newJobResources(ref), nil
+}
+
+func newJobResources(ref *image.NRGBA) *jobResources {
+	return &jobResources{
+		shared:  renderer.NewSharedReference(ref),
+		weights: make(map[string]*fit.WeightPlane),
+		costs:   make(map[costKey]fit.CostFunc),
+	}
+}
+
+// costFunc returns the named cost, weighted by the mask at weightMaskPath if
+// set, and the weight plane (nil without a mask). Both are built once.
+func (res *jobResources) costFunc(name, weightMaskPath string) (fit.CostFunc, *fit.WeightPlane, error) {
+	res.mu.Lock()
+	defer res.mu.Unlock()
+
+	var weights *fit.WeightPlane
+	if weightMaskPath != "" {
+		weights = res.weights[weightMaskPath]
+		if weights == nil {
+			bounds := res.shared.Reference().Bounds()
+			w, err := fit.LoadWeightPlane(weightMaskPath, bounds.Dx(), bounds.Dy())
+			if err != nil {
+				return nil, nil, err
+			}
+			slog.Info("Loaded weight mask", "mask", weightMaskPath)
+			res.weights[weightMaskPath] = w
+			weights = w
+		}
+	}
+
+	key := costKey{name: name, weightMask: weightMaskPath}
+	if cost, ok := res.costs[key]; ok {
+		return cost, weights, nil
+	}
+	cost, err := fit.NewCostFunc(name, res.shared.Reference(), weights)
+	if err != nil {
+		return nil, nil, err
+	}
+	res.costs[key] = cost
+	return cost, weights, nil
+}
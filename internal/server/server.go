@@ -11,6 +11,7 @@ import (
 	"strings"
 	"time"
 
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
 	"github.com/cwbudde/mayflycirclefit/internal/fit/renderer"
 	"github.com/cwbudde/mayflycirclefit/internal/store"
 )
@@ -50,6 +51,8 @@ func (s *Server) Start() error {
 	// Register API routes
 	mux.HandleFunc("/api/v1/jobs", s.handleJobs)
 	mux.HandleFunc("/api/v1/jobs/", s.handleJobsWithID)
+	mux.HandleFunc("/api/v1/batches", s.handleBatches)
+	mux.HandleFunc("/api/v1/batches/", s.handleGetBatch)
 
 	// Register pprof routes for profiling
 	mux.HandleFunc("/debug/pprof/", pprof.Index)
@@ -110,22 +113,8 @@ func (s *Server) checkpointRunningJobs(ctx context.Context) {
 
 	for _, job := range runningJobs {
 		go func(j *Job) {
-			// Load reference image to create renderer
-			ref, err := loadReferenceImage(j.Config.RefPath)
-			if err != nil {
-				slog.Error("Failed to load reference for checkpoint",
-					"job_id", j.ID,
-					"error", err,
-				)
-				results <- checkpointResult{jobID: j.ID, err: err}
-				return
-			}
-
-			// Create renderer
-			renderer := renderer.NewCPURenderer(ref, j.Config.Circles)
-
 			// Save checkpoint
-			err = saveCheckpoint(s.jobManager, s.store, renderer, j.ID)
+			err := saveCheckpoint(s.jobManager, s.store, j.ID)
 
 			// Re-fetch job to get updated values after potential checkpoint
 			job, exists := s.jobManager.GetJob(j.ID)
@@ -212,6 +201,8 @@ func (s *Server) handleJobsWithID(w http.ResponseWriter, r *http.Request) {
 		s.handleGetJobStatus(w, r, jobID)
 	} else if parts[1] == "best.png" {
 		s.handleGetBestImage(w, r, jobID)
+	} else if parts[1] == "best.svg" || parts[1] == "best.mfc" {
+		s.handleExportBest(w, r, jobID, parts[1])
 	} else if parts[1] == "diff.png" {
 		s.handleGetDiffImage(w, r, jobID)
 	} else if parts[1] == "ref.png" {
@@ -234,10 +225,28 @@ func (s *Server) handleCreateJob(w http.ResponseWriter, r *http.Request) {
 	}
 
 	// Validate config
-	if config.RefPath == "" {
-		http.Error(w, "refPath is required", http.StatusBadRequest)
+	if err := prepareJobConfig(&config); err != nil {
+		http.Error(w, err.Error(), http.StatusBadRequest)
 		return
 	}
+
+	// Create job
+	job := s.jobManager.CreateJob(config)
+
+	// Start worker in background with checkpoint store
+	go runJob(s.ctx, s.jobManager, s.store, job.ID)
+
+	// Return job
+	w.Header().Set("Content-Type", "application/json")
+	w.WriteHeader(http.StatusCreated)
+	json.NewEncoder(w).Encode(job)
+}
+
+// prepareJobConfig fills in defaults for unset fields and validates config
+func prepareJobConfig(config *JobConfig) error {
+	if config.RefPath == "" {
+		return fmt.Errorf("refPath is required")
+	}
 	if config.Circles <= 0 {
 		config.Circles = 10
 	}
@@ -250,17 +259,13 @@ func (s *Server) handleCreateJob(w http.ResponseWriter, r *http.Request) {
 	if config.Mode == "" {
 		config.Mode = "joint"
 	}
-
-	// Create job
-	job := s.jobManager.CreateJob(config)
-
-	// Start worker in background with checkpoint store
-	go runJob(s.ctx, s.jobManager, s.store, job.ID)
-
-	// Return job
-	w.Header().Set("Content-Type", "application/json")
-	w.WriteHeader(http.StatusCreated)
-	json.NewEncoder(w).Encode(job)
+	if err := fit.ValidateCost(config.Cost); err != nil {
+		return err
+	}
+	if _, err := renderer.ParsePrecision(config.Precision); err != nil {
+		return err
+	}
+	return nil
 }
 
 // handleListJobs handles GET /api/v1/jobs
@@ -296,17 +301,18 @@ func (s *Server) handleGetJobStatus(w http.ResponseWriter, r *http.Request, jobI
 
 	// Create response
 	response := map[string]interface{}{
-		"id":          job.ID,
-		"state":       job.State,
-		"config":      job.Config,
-		"bestCost":    job.BestCost,
-		"initialCost": job.InitialCost,
-		"iterations":  job.Iterations,
-		"elapsed":     elapsed.Seconds(),
-		"cps":         cps,
-		"startTime":   job.StartTime,
-		"endTime":     job.EndTime,
-		"error":       job.Error,
+		"id":            job.ID,
+		"state":         job.State,
+		"config":        job.Config,
+		"bestCost":      job.BestCost,
+		"initialCost":   job.InitialCost,
+		"iterations":    job.Iterations,
+		"elapsed":       elapsed.Seconds(),
+		"cps":           cps,
+		"culledCircles": job.Culled,
+		"startTime":     job.StartTime,
+		"endTime":       job.EndTime,
+		"error":         job.Error,
 	}
 
 	w.Header().Set("Content-Type", "application/json")
@@ -327,16 +333,13 @@ func (s *Server) handleGetBestImage(w http.ResponseWriter, r *http.Request, jobI
 		return
 	}
 
-	// Load reference image to get dimensions
-	ref, err := loadReferenceImage(job.Config.RefPath)
+	// Render best image into a pooled frame
+	img, _, release, err := s.jobManager.display.render(job, job.BestParams)
 	if err != nil {
 		http.Error(w, fmt.Sprintf("Failed to load reference: %v", err), http.StatusInternalServerError)
 		return
 	}
-
-	// Render best image
-	renderer := renderer.NewCPURenderer(ref, job.Config.Circles)
-	img := renderer.Render(job.BestParams)
+	defer release()
 
 	// Set headers
 	w.Header().Set("Content-Type", "image/png")
@@ -348,6 +351,46 @@ func (s *Server) handleGetBestImage(w http.ResponseWriter, r *http.Request, jobI
 	}
 }
 
+// handleExportBest handles GET /api/v1/jobs/:id/best.svg and best.mfc: the
+// best parameters streamed as SVG or a binary circle list, without rendering.
+// best.mfc, and best.svg with ?download, are sent as attachments.
+func (s *Server) handleExportBest(w http.ResponseWriter, r *http.Request, jobID, name string) {
+	job, exists := s.jobManager.GetJob(jobID)
+	if !exists {
+		http.Error(w, "Job not found", http.StatusNotFound)
+		return
+	}
+
+	// Check if job has results
+	params := job.BestParams
+	if len(params) == 0 {
+		http.Error(w, "No results yet", http.StatusNotFound)
+		return
+	}
+
+	// Only the reference's header is read, for the image size
+	width, height, err := referenceSize(job.Config.RefPath)
+	if err != nil {
+		http.Error(w, fmt.Sprintf("Failed to load reference: %v", err), http.StatusInternalServerError)
+		return
+	}
+
+	write := fit.WriteSVG
+	w.Header().Set("Content-Type", "image/svg+xml")
+	if name == "best.mfc" {
+		write = fit.WriteCircles
+		w.Header().Set("Content-Type", "application/octet-stream")
+	}
+	if name == "best.mfc" || r.URL.Query().Has("download") {
+		w.Header().Set("Content-Disposition", fmt.Sprintf("attachment; filename=%q", jobID+"-"+name))
+	}
+	w.Header().Set("Cache-Control", "no-cache")
+
+	if err := write(w, params, job.Config.ParamsPerCircle(), width, height); err != nil {
+		slog.Error("Failed to export circles", "job_id", jobID, "error", err)
+	}
+}
+
 // handleGetDiffImage handles GET /api/v1/jobs/:id/diff.png
 func (s *Server) handleGetDiffImage(w http.ResponseWriter, r *http.Request, jobID string) {
 	job, exists := s.jobManager.GetJob(jobID)
@@ -362,16 +405,13 @@ func (s *Server) handleGetDiffImage(w http.ResponseWriter, r *http.Request, jobI
 		return
 	}
 
-	// Load reference image
-	ref, err := loadReferenceImage(job.Config.RefPath)
+	// Render best image into a pooled frame
+	best, ref, release, err := s.jobManager.display.render(job, job.BestParams)
 	if err != nil {
 		http.Error(w, fmt.Sprintf("Failed to load reference: %v", err), http.StatusInternalServerError)
 		return
 	}
-
-	// Render best image
-	renderer := renderer.NewCPURenderer(ref, job.Config.Circles)
-	best := renderer.Render(job.BestParams)
+	defer release()
 
 	// Compute difference image (simple visualization for now)
 	diff := computeDiffImage(ref, best)
@@ -475,6 +515,8 @@ func (s *Server) handleResumeJob(w http.ResponseWriter, r *http.Request, jobID s
 		j.BestCost = checkpoint.BestCost
 		j.InitialCost = checkpoint.InitialCost
 		j.Iterations = checkpoint.Iteration
+		j.Pipeline = checkpoint.Pipeline
+		j.OptimizerState = checkpoint.OptimizerState
 	})
 
 	// Start worker in background with checkpoint store
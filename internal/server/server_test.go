@@ -16,6 +16,7 @@ import (
 	"testing"
 	"time"
 
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
 	"github.com/cwbudde/mayflycirclefit/internal/store"
 )
 
@@ -62,6 +63,47 @@ func TestServer_CreateJob(t *testing.T) {
 	}
 }
 
+func TestServer_CreateJob_UnknownCost(t *testing.T) {
+	s := NewServer(":8080", nil)
+
+	config := JobConfig{
+		RefPath: "test.png",
+		Cost:    "no-such-cost",
+	}
+
+	body, _ := json.Marshal(config)
+	req := httptest.NewRequest(http.MethodPost, "/api/v1/jobs", bytes.NewReader(body))
+	w := httptest.NewRecorder()
+
+	s.handleCreateJob(w, req)
+
+	if w.Code != http.StatusBadRequest {
+		t.Errorf("Expected status 400, got %d", w.Code)
+	}
+	if len(s.jobManager.ListJobs()) != 0 {
+		t.Error("No job should be created for an unknown cost")
+	}
+}
+
+func TestServer_CreateJob_UnknownPrecision(t *testing.T) {
+	s := NewServer(":8080", nil)
+
+	config := JobConfig{
+		RefPath:   "test.png",
+		Precision: "float16",
+	}
+
+	body, _ := json.Marshal(config)
+	req := httptest.NewRequest(http.MethodPost, "/api/v1/jobs", bytes.NewReader(body))
+	w := httptest.NewRecorder()
+
+	s.handleCreateJob(w, req)
+
+	if w.Code != http.StatusBadRequest {
+		t.Errorf("Expected status 400, got %d", w.Code)
+	}
+}
+
 func TestServer_ListJobs(t *testing.T) {
 	tmpDir := t.TempDir()
 	imgPath := filepath.Join(tmpDir, "test.png")
@@ -172,6 +214,47 @@ func TestServer_GetBestImage(t *testing.T) {
 	}
 }
 
+func TestServer_ExportBest(t *testing.T) {
+	tmpDir := t.TempDir()
+	imgPath := filepath.Join(tmpDir, "test.png")
+	createSimpleTestImage(t, imgPath)
+
+	s := NewServer(":8080", nil)
+
+	job := s.jobManager.CreateJob(JobConfig{RefPath: imgPath, Mode: "joint", Circles: 3, Iters: 5, PopSize: 20, Seed: 42})
+	if err := runJob(context.Background(), s.jobManager, nil, job.ID); err != nil {
+		t.Fatalf("Job failed: %v", err)
+	}
+
+	// SVG, inline
+	w := httptest.NewRecorder()
+	s.handleJobsWithID(w, httptest.NewRequest(http.MethodGet, fmt.Sprintf("/api/v1/jobs/%s/best.svg", job.ID), nil))
+	if w.Code != http.StatusOK || w.Header().Get("Content-Type") != "image/svg+xml" {
+		t.Fatalf("Expected SVG, got %d %q", w.Code, w.Header().Get("Content-Type"))
+	}
+	if w.Header().Get("Content-Disposition") != "" {
+		t.Error("SVG without ?download should be inline")
+	}
+	if !containsString(w.Body.String(), `width="50" height="50"`) {
+		t.Errorf("SVG should have the reference size:\n%s", w.Body.String())
+	}
+
+	// Binary circle list, as a download
+	w = httptest.NewRecorder()
+	s.handleJobsWithID(w, httptest.NewRequest(http.MethodGet, fmt.Sprintf("/api/v1/jobs/%s/best.mfc", job.ID), nil))
+	if w.Code != http.StatusOK || w.Header().Get("Content-Disposition") == "" {
+		t.Fatalf("Expected circle list attachment, got %d", w.Code)
+	}
+	params, ppc, width, height, err := fit.ReadCircles(w.Body)
+	if err != nil {
+		t.Fatalf("Response should be a circle list: %v", err)
+	}
+	updated, _ := s.jobManager.GetJob(job.ID)
+	if ppc != 7 || width != 50 || height != 50 || len(params) != len(updated.BestParams) {
+		t.Errorf("Unexpected circle list: ppc %d, %dx%d, %d params", ppc, width, height, len(params))
+	}
+}
+
 func TestServer_Integration(t *testing.T) {
 	// Skip in short mode
 	if testing.Short() {
@@ -16,6 +16,7 @@ type ProgressEvent struct {
 	Iterations int       `json:"iterations"`
 	BestCost   float64   `json:"bestCost"`
 	CPS        float64   `json:"cps"`
+	Culled     uint64    `json:"culledCircles,omitempty"`
 	Timestamp  time.Time `json:"timestamp"`
 }
 
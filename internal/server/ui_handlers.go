@@ -147,6 +147,7 @@ func (s *Server) handleCreatePagePost(w http.ResponseWriter, r *http.Request) {
 	convergenceEnabledStr := r.FormValue("convergenceEnabled")
 	convergencePatienceStr := r.FormValue("convergencePatience")
 	convergenceThresholdStr := r.FormValue("convergenceThreshold")
+	grayscale := r.FormValue("grayscale") == "on"
 
 	// Validate required fields
 	if refPath == "" {
@@ -221,6 +222,7 @@ func (s *Server) handleCreatePagePost(w http.ResponseWriter, r *http.Request) {
 		Iters:                iters,
 		PopSize:              popSize,
 		Seed:                 seed,
+		Grayscale:            grayscale,
 		ConvergenceEnabled:   convergenceEnabled,
 		ConvergencePatience:  convergencePatience,
 		ConvergenceThreshold: convergenceThreshold,
@@ -10,6 +10,7 @@ import (
 	"path/filepath"
 	"time"
 
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
 	"github.com/cwbudde/mayflycirclefit/internal/fit/renderer"
 	"github.com/cwbudde/mayflycirclefit/internal/opt"
 	"github.com/cwbudde/mayflycirclefit/internal/store"
@@ -43,6 +44,12 @@ func buildConvergenceConfig(config store.JobConfig) renderer.ConvergenceConfig {
 // runJob executes an optimization job in the background.
 // If checkpointStore is not nil and job has checkpointInterval > 0, periodic checkpoints are saved.
 func runJob(ctx context.Context, jm *JobManager, checkpointStore store.Store, jobID string) error {
+	return runJobWith(ctx, jm, checkpointStore, jobID, nil)
+}
+
+// runJobWith runs a job on preloaded reference resources, which batches share
+// between their jobs. A nil res loads the job's reference image.
+func runJobWith(ctx context.Context, jm *JobManager, checkpointStore store.Store, jobID string, res *jobResources) error {
 	// Get the job
 	job, exists := jm.GetJob(jobID)
 	if !exists {
@@ -60,33 +67,37 @@ func runJob(ctx context.Context, jm *JobManager, checkpointStore store.Store, jo
 	slog.Info("Starting job", "job_id", jobID, "ref", job.Config.RefPath)
 
 	// Load reference image
-	f, err := os.Open(job.Config.RefPath)
-	if err != nil {
-		markJobFailed(jm, jobID, fmt.Errorf("failed to open reference: %w", err))
-		return err
+	if res == nil {
+		res, err = loadJobResources(job.Config.RefPath)
+		if err != nil {
+			markJobFailed(jm, jobID, fmt.Errorf("failed to load reference: %w", err))
+			return err
+		}
 	}
-	defer f.Close()
+	ref := res.shared.Reference()
+	bounds := ref.Bounds()
 
-	img, _, err := image.Decode(f)
+	slog.Info("Loaded reference image", "job_id", jobID, "width", bounds.Dx(), "height", bounds.Dy())
+
+	// Select the cost function, weighted by the importance mask if specified
+	costFunc, weights, err := res.costFunc(job.Config.Cost, job.Config.WeightMaskPath)
 	if err != nil {
-		markJobFailed(jm, jobID, fmt.Errorf("failed to decode image: %w", err))
+		markJobFailed(jm, jobID, err)
 		return err
 	}
 
-	// Convert to NRGBA
-	bounds := img.Bounds()
-	ref := image.NewNRGBA(bounds)
-	for y := bounds.Min.Y; y < bounds.Max.Y; y++ {
-		for x := bounds.Min.X; x < bounds.Max.X; x++ {
-			ref.Set(x, y, img.At(x, y))
-		}
+	// Grayscale fitting has its own renderer and only supports plain MSE
+	if job.Config.Grayscale && (job.Config.CanvasPath != "" || weights != nil || !fit.IsMSECost(job.Config.Cost)) {
+		err := fmt.Errorf("grayscale mode does not support canvas, weight mask or cost %q", job.Config.Cost)
+		markJobFailed(jm, jobID, err)
+		return err
 	}
 
-	slog.Info("Loaded reference image", "job_id", jobID, "width", bounds.Dx(), "height", bounds.Dy())
-
 	// Load canvas image if specified
 	var rend renderer.Renderer
-	if job.Config.CanvasPath != "" {
+	if job.Config.Grayscale {
+		rend = res.shared.NewGrayRenderer(job.Config.Circles)
+	} else if job.Config.CanvasPath != "" {
 		slog.Info("Loading canvas image", "job_id", jobID, "canvas", job.Config.CanvasPath)
 
 		canvasFile, err := os.Open(job.Config.CanvasPath)
@@ -111,11 +122,24 @@ func runJob(ctx context.Context, jm *JobManager, checkpointStore store.Store, jo
 		}
 
 		// Create renderer with canvas
-		rend = renderer.NewCPURendererWithCanvas(ref, canvasNRGBA, job.Config.Circles)
+		cpu := renderer.NewCPURendererWithCanvas(ref, canvasNRGBA, job.Config.Circles)
+		cpu.SetCostFunc(costFunc)
+		rend = cpu
 		slog.Info("Loaded canvas image", "job_id", jobID, "width", canvasNRGBA.Bounds().Dx(), "height", canvasNRGBA.Bounds().Dy())
+	} else if weights == nil && fit.IsMSECost(job.Config.Cost) {
+		// Plain MSE on a white background: planar renderer (identical results)
+		rend = res.shared.NewPlanarRenderer(job.Config.Circles)
 	} else {
 		// Create renderer with white background
-		rend = renderer.NewCPURenderer(ref, job.Config.Circles)
+		cpu := res.shared.NewCPURenderer(job.Config.Circles)
+		cpu.SetCostFunc(costFunc)
+		rend = cpu
+	}
+
+	// Select compositing precision, span tables and anti-aliasing
+	if err := ApplyRenderOptions(rend, job.Config); err != nil {
+		markJobFailed(jm, jobID, err)
+		return err
 	}
 
 	// Create optimizer
@@ -134,7 +158,7 @@ func runJob(ctx context.Context, jm *JobManager, checkpointStore store.Store, jo
 			"previous_iterations", job.Iterations,
 		)
 	} else {
-		initialParams := make([]float64, job.Config.Circles*7)
+		initialParams := make([]float64, job.Config.Circles*job.Config.ParamsPerCircle())
 		initialCost = rend.Cost(initialParams)
 		jm.UpdateJob(jobID, func(j *Job) {
 			j.InitialCost = initialCost
@@ -177,7 +201,7 @@ func runJob(ctx context.Context, jm *JobManager, checkpointStore store.Store, jo
 
 	// Start progress monitoring goroutine
 	progressDone := make(chan struct{})
-	go monitorProgress(ctx, jm, jobID, start, progressDone)
+	go monitorProgress(ctx, jm, rend, jobID, start, progressDone)
 
 	// Start trace monitoring goroutine if enabled
 	traceDone := make(chan struct{})
@@ -192,13 +216,44 @@ func runJob(ctx context.Context, jm *JobManager, checkpointStore store.Store, jo
 	checkpointDone := make(chan struct{})
 	checkpointEnabled := checkpointStore != nil && job.Config.CheckpointInterval > 0
 	if checkpointEnabled {
-		go monitorCheckpoints(ctx, jm, checkpointStore, rend, jobID, checkpointDone)
+		go monitorCheckpoints(ctx, jm, checkpointStore, jobID, checkpointDone)
 	} else {
 		close(checkpointDone) // No checkpointing, close immediately
 	}
 
+	// Sequential and batch pipelines publish every committed step, so
+	// checkpoints taken mid-run hold the pipeline state
+	perCircle := job.Config.ParamsPerCircle()
+	onStep := func(state renderer.PipelineState) {
+		jm.UpdateJob(jobID, func(j *Job) {
+			j.BestParams = state.Params
+			j.BestCost = state.Cost
+			j.Pipeline = CheckpointPipelineState(state, perCircle)
+		})
+	}
+	isPipeline := job.Config.Mode == "sequential" || job.Config.Mode == "batch"
+
 	// If resuming, use optimizer with initial params
-	if isResume {
+	if isResume && isPipeline {
+		// Continue the pipeline after the committed circles
+		from := ResumePipelineState(job.Config, job.BestParams, job.Pipeline)
+		result, _ = RunPipeline(rend, optimizer, job.Config, from, onStep) // Mode checked above
+		result.Iterations = job.Iterations
+	} else if snapshotter, ok := optimizer.(opt.SnapshotOptimizer); ok && isResume && job.OptimizerState != nil {
+		// Continue the search exactly where the checkpoint left it
+		result, err = runJointSnapshots(jm, jobID, rend, snapshotter, job.Config, initialCost, job.OptimizerState)
+		if err != nil {
+			slog.Warn("Optimizer state not usable, resuming from best params", "job_id", jobID, "error", err)
+			lower, upper := rend.Bounds()
+			bestParams, bestCost := snapshotter.RunWithInitial(job.BestParams, job.BestCost, rend.Cost, lower, upper, rend.Dim())
+			result = &renderer.OptimizationResult{
+				BestParams:  bestParams,
+				BestCost:    bestCost,
+				InitialCost: initialCost,
+				Iterations:  job.Config.Iters + job.Iterations, // Cumulative
+			}
+		}
+	} else if isResume {
 		resumable, ok := optimizer.(opt.ResumableOptimizer)
 		if !ok {
 			err := fmt.Errorf("optimizer does not support resume")
@@ -238,16 +293,14 @@ func runJob(ctx context.Context, jm *JobManager, checkpointStore store.Store, jo
 
 		switch job.Config.Mode {
 		case "joint":
-			result = renderer.OptimizeJoint(rend, optimizer, job.Config.Circles, convergenceConfig)
-		case "sequential":
-			result = renderer.OptimizeSequential(rend, optimizer, job.Config.Circles, convergenceConfig)
-		case "batch":
-			batchSize := 5
-			passes := job.Config.Circles / batchSize
-			if job.Config.Circles%batchSize != 0 {
-				passes++
+			if snapshotter, ok := opt.SnapshotSearch(optimizer); ok && checkpointEnabled {
+				// Same search as OptimizeJoint, publishing its snapshots
+				result, _ = runJointSnapshots(jm, jobID, rend, snapshotter, job.Config, initialCost, nil) // No snapshot to reject
+			} else {
+				result = renderer.OptimizeJoint(rend, optimizer, job.Config.Circles, convergenceConfig)
 			}
-			result = renderer.OptimizeBatch(rend, optimizer, batchSize, passes, convergenceConfig)
+		case "sequential", "batch":
+			result, _ = RunPipeline(rend, optimizer, job.Config, nil, onStep)
 		default:
 			err := fmt.Errorf("unknown mode: %s", job.Config.Mode)
 			markJobFailed(jm, jobID, err)
@@ -289,6 +342,8 @@ func runJob(ctx context.Context, jm *JobManager, checkpointStore store.Store, jo
 		j.BestCost = result.BestCost
 		j.InitialCost = result.InitialCost
 		j.Iterations = result.Iterations
+		j.OptimizerState = nil // The search is finished
+		j.Culled = renderer.CulledCircles(rend)
 		j.EndTime = &endTime
 	})
 
@@ -307,6 +362,7 @@ func runJob(ctx context.Context, jm *JobManager, checkpointStore store.Store, jo
 		"initial_cost", result.InitialCost,
 		"best_cost", result.BestCost,
 		"circles_per_second", cps,
+		"circles_culled", renderer.CulledCircles(rend),
 	)
 
 	// Broadcast final completion event
@@ -316,14 +372,58 @@ func runJob(ctx context.Context, jm *JobManager, checkpointStore store.Store, jo
 		Iterations: result.Iterations,
 		BestCost:   result.BestCost,
 		CPS:        cps,
+		Culled:     renderer.CulledCircles(rend),
 		Timestamp:  time.Now(),
 	})
 
 	return nil
 }
 
+// runJointSnapshots runs a joint job on optimizer from snapshot (nil = from
+// scratch). Once per checkpoint interval (every generation if it is 0) the
+// job's best params, cost, iteration count and optimizer state are
+// published together, so a checkpoint continues the search exactly.
+func runJointSnapshots(jm *JobManager, jobID string, rend renderer.Renderer, optimizer opt.SnapshotOptimizer, config JobConfig, initialCost float64, snapshot []byte) (*renderer.OptimizationResult, error) {
+	dim := config.Circles * config.ParamsPerCircle()
+	lower, upper := rend.Bounds()
+	interval := time.Duration(config.CheckpointInterval) * time.Second
+	lastPublished := time.Now()
+
+	// Populations go to the renderer in one batch (one kernel launch and
+	// readback on the OpenCL backend)
+	evals := 0
+	evalBatch := func(population [][]float64, costs []float64) {
+		evals += len(population)
+		renderer.CostBatch(rend, population, costs)
+	}
+	bestParams, bestCost, err := opt.RunSnapshotsBatch(optimizer, snapshot, evalBatch, lower[:dim], upper[:dim], dim, func(g opt.Generation) {
+		if time.Since(lastPublished) < interval {
+			return
+		}
+		lastPublished = time.Now()
+		params, state := g.BestParams(), g.Snapshot()
+		jm.UpdateJob(jobID, func(j *Job) {
+			j.BestParams = params
+			j.BestCost = g.BestCost
+			j.Iterations = g.Index
+			j.OptimizerState = state
+		})
+	})
+	if err != nil {
+		return nil, err
+	}
+
+	return &renderer.OptimizationResult{
+		BestParams:  bestParams,
+		BestCost:    bestCost,
+		InitialCost: initialCost,
+		Iterations:  config.Iters,
+		Evaluations: evals,
+	}, nil
+}
+
 // monitorProgress periodically broadcasts progress events during optimization
-func monitorProgress(ctx context.Context, jm *JobManager, jobID string, startTime time.Time, done chan struct{}) {
+func monitorProgress(ctx context.Context, jm *JobManager, rend renderer.Renderer, jobID string, startTime time.Time, done chan struct{}) {
 	ticker := time.NewTicker(500 * time.Millisecond) // Throttle to 2 updates per second
 	defer ticker.Stop()
 
@@ -358,6 +458,7 @@ func monitorProgress(ctx context.Context, jm *JobManager, jobID string, startTim
 				Iterations: job.Iterations,
 				BestCost:   job.BestCost,
 				CPS:        cps,
+				Culled:     renderer.CulledCircles(rend),
 				Timestamp:  time.Now(),
 			})
 		}
@@ -386,7 +487,7 @@ func markJobCancelled(jm *JobManager, jobID string) {
 }
 
 // monitorCheckpoints periodically saves checkpoints during optimization
-func monitorCheckpoints(ctx context.Context, jm *JobManager, checkpointStore store.Store, rend renderer.Renderer, jobID string, done chan struct{}) {
+func monitorCheckpoints(ctx context.Context, jm *JobManager, checkpointStore store.Store, jobID string, done chan struct{}) {
 	job, exists := jm.GetJob(jobID)
 	if !exists {
 		return
@@ -404,15 +505,53 @@ func monitorCheckpoints(ctx context.Context, jm *JobManager, checkpointStore sto
 			return
 		case <-ticker.C:
 			// Save checkpoint
-			if err := saveCheckpoint(jm, checkpointStore, rend, jobID); err != nil {
+			if err := saveCheckpoint(jm, checkpointStore, jobID); err != nil {
 				slog.Error("Failed to save checkpoint", "job_id", jobID, "error", err)
 			}
 		}
 	}
 }
 
-// saveCheckpoint saves a checkpoint for the given job
-func saveCheckpoint(jm *JobManager, checkpointStore store.Store, rend renderer.Renderer, jobID string) error {
+// newDisplayRenderer creates the renderer used to draw a job's parameters
+// (best image, diff, checkpoint artifacts) in the job's parameter layout.
+// The job's precision, span table and anti-aliasing are applied so images
+// match what the optimizer scored.
+func newDisplayRenderer(ref *image.NRGBA, config JobConfig) renderer.Renderer {
+	var rend renderer.Renderer
+	if config.Grayscale {
+		rend = renderer.NewGrayRenderer(ref, config.Circles)
+	} else {
+		rend = renderer.NewCPURenderer(ref, config.Circles)
+	}
+	// The job renderer accepted the same options, and the CPU and gray
+	// renderers support all of them
+	_ = ApplyRenderOptions(rend, config)
+	return rend
+}
+
+// ApplyRenderOptions applies config's compositing precision, span table and
+// anti-aliasing to rend. It fails if the name is invalid or rend does not
+// support a requested option.
+func ApplyRenderOptions(rend renderer.Renderer, config JobConfig) error {
+	precision, err := renderer.ParsePrecision(config.Precision)
+	if err != nil {
+		return err
+	}
+	if !renderer.SetPrecision(rend, precision) {
+		return fmt.Errorf("precision %s not supported by renderer %T", precision, rend)
+	}
+	if config.SpanTable && !renderer.SetSpanTable(rend, renderer.DefaultSpanTable()) {
+		return fmt.Errorf("span tables not supported by renderer %T", rend)
+	}
+	if !renderer.SetAntialias(rend, config.Antialias) {
+		return fmt.Errorf("anti-aliasing not supported by renderer %T", rend)
+	}
+	return nil
+}
+
+// saveCheckpoint saves a checkpoint for the given job. Artifacts are drawn by
+// the job's display renderer, never the renderer the optimizer is using.
+func saveCheckpoint(jm *JobManager, checkpointStore store.Store, jobID string) error {
 	// Get current job state
 	job, exists := jm.GetJob(jobID)
 	if !exists {
@@ -434,6 +573,8 @@ func saveCheckpoint(jm *JobManager, checkpointStore store.Store, rend renderer.R
 		job.Iterations,
 		job.Config,
 	)
+	checkpoint.Pipeline = job.Pipeline
+	checkpoint.OptimizerState = job.OptimizerState
 
 	// Save checkpoint metadata
 	if err := checkpointStore.SaveCheckpoint(jobID, checkpoint); err != nil {
@@ -447,7 +588,12 @@ func saveCheckpoint(jm *JobManager, checkpointStore store.Store, rend renderer.R
 	)
 
 	// Save checkpoint artifacts (best.png, diff.png)
-	if err := saveCheckpointArtifacts(checkpointStore, rend, jobID, job.BestParams); err != nil {
+	best, ref, release, err := jm.display.render(job, job.BestParams)
+	if err == nil {
+		err = saveCheckpointArtifacts(checkpointStore, jobID, ref, best)
+		release()
+	}
+	if err != nil {
 		slog.Warn("Failed to save checkpoint artifacts", "job_id", jobID, "error", err)
 		// Don't fail the checkpoint if artifacts fail - metadata is most important
 	}
@@ -456,16 +602,13 @@ func saveCheckpoint(jm *JobManager, checkpointStore store.Store, rend renderer.R
 }
 
 // saveCheckpointArtifacts saves best.png and diff.png to the checkpoint directory
-func saveCheckpointArtifacts(checkpointStore store.Store, rend renderer.Renderer, jobID string, bestParams []float64) error {
-	// We need to access the filesystem directly since Store interface doesn't expose artifact paths
-	// This assumes FSStore with ./data/jobs/<jobID>/ structure
-	// TODO: Consider adding GetJobDir() to Store interface if we need different store implementations
-
-	// For now, assume FSStore with ./data base directory
+func saveCheckpointArtifacts(checkpointStore store.Store, jobID string, ref, bestImg *image.NRGBA) error {
+	// We need to access the filesystem directly since Store interface doesn't expose artifact paths.
+	// Stores with a job directory (FSStore) provide it; otherwise assume ./data/jobs/<jobID>/
 	jobDir := filepath.Join("./data", "jobs", jobID)
-
-	// Render best image
-	bestImg := rend.Render(bestParams)
+	if dirStore, ok := checkpointStore.(interface{ JobDir(string) string }); ok {
+		jobDir = dirStore.JobDir(jobID)
+	}
 
 	// Save best.png
 	bestPath := filepath.Join(jobDir, "best.png")
@@ -480,7 +623,6 @@ func saveCheckpointArtifacts(checkpointStore store.Store, rend renderer.Renderer
 	}
 
 	// Compute and save diff.png
-	ref := rend.Reference()
 	diffImg := computeDiffImage(ref, bestImg)
 
 	diffPath := filepath.Join(jobDir, "diff.png")
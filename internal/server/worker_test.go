@@ -9,6 +9,9 @@ import (
 	"path/filepath"
 	"testing"
 	"time"
+
+	"github.com/cwbudde/mayflycirclefit/internal/opt"
+	"github.com/cwbudde/mayflycirclefit/internal/store"
 )
 
 func TestRunJob_Success(t *testing.T) {
@@ -53,6 +56,41 @@ func TestRunJob_Success(t *testing.T) {
 	// For now, just verify the job completed successfully
 }
 
+func TestRunJob_Grayscale(t *testing.T) {
+	tmpDir := t.TempDir()
+	imgPath := filepath.Join(tmpDir, "test.png")
+	createTestImage(t, imgPath)
+
+	jm := NewJobManager()
+	job := jm.CreateJob(JobConfig{
+		RefPath:   imgPath,
+		Mode:      "sequential",
+		Grayscale: true,
+		Circles:   2,
+		Iters:     10,
+		PopSize:   20,
+		Seed:      42,
+	})
+
+	if err := runJob(context.Background(), jm, nil, job.ID); err != nil {
+		t.Fatalf("runJob should succeed: %v", err)
+	}
+
+	updated, _ := jm.GetJob(job.ID)
+	if updated.State != StateCompleted {
+		t.Errorf("Job should be completed, got %s", updated.State)
+	}
+	if len(updated.BestParams) != 10 { // 2 circles * 5 params
+		t.Errorf("Expected 10 params, got %d", len(updated.BestParams))
+	}
+
+	// Grayscale jobs reject colour-only features
+	bad := jm.CreateJob(JobConfig{RefPath: imgPath, Mode: "joint", Grayscale: true, Cost: "ssim", Circles: 1, Iters: 1, PopSize: 2})
+	if err := runJob(context.Background(), jm, nil, bad.ID); err == nil {
+		t.Error("grayscale job with ssim cost should fail")
+	}
+}
+
 func TestRunJob_InvalidImage(t *testing.T) {
 	jm := NewJobManager()
 	config := JobConfig{
@@ -127,6 +165,163 @@ func TestRunJob_Cancellation(t *testing.T) {
 	}
 }
 
+// TestRunJob_ResumeSequential checks that a sequential job resumed from its
+// committed circles continues the pipeline instead of a joint search
+func TestRunJob_ResumeSequential(t *testing.T) {
+	tmpDir := t.TempDir()
+	imgPath := filepath.Join(tmpDir, "test.png")
+	createTestImage(t, imgPath)
+
+	jm := NewJobManager()
+	config := JobConfig{
+		RefPath: imgPath,
+		Mode:    "sequential",
+		Circles: 4,
+		Iters:   5,
+		PopSize: 20,
+		Seed:    42,
+	}
+
+	full := jm.CreateJob(config)
+	if err := runJob(context.Background(), jm, nil, full.ID); err != nil {
+		t.Fatalf("runJob should succeed: %v", err)
+	}
+	done, _ := jm.GetJob(full.ID)
+	if done.Pipeline == nil || done.Pipeline.Circles != 4 || done.Pipeline.Pass != 4 {
+		t.Fatalf("Expected pipeline state after 4 circles, got %+v", done.Pipeline)
+	}
+
+	// Resume after the first two circles, as a checkpoint would
+	resumed := jm.CreateJob(config)
+	jm.UpdateJob(resumed.ID, func(j *Job) {
+		j.BestParams = done.BestParams[:2*7]
+		j.BestCost = 1 // Checkpointed cost of the prefix (not used by the pipeline)
+		j.InitialCost = done.InitialCost
+		j.Pipeline = &store.PipelineState{Circles: 2, Pass: 2}
+	})
+	if err := runJob(context.Background(), jm, nil, resumed.ID); err != nil {
+		t.Fatalf("resumed runJob should succeed: %v", err)
+	}
+
+	updated, _ := jm.GetJob(resumed.ID)
+	if len(updated.BestParams) != len(done.BestParams) || updated.BestCost != done.BestCost {
+		t.Fatalf("Resumed job ended with %d params at cost %f, uninterrupted %d at %f",
+			len(updated.BestParams), updated.BestCost, len(done.BestParams), done.BestCost)
+	}
+	for i := range done.BestParams {
+		if updated.BestParams[i] != done.BestParams[i] {
+			t.Fatalf("Resumed params differ at %d", i)
+		}
+	}
+}
+
+// TestRunJob_ResumeJointSnapshot checks that a joint job resumed from an
+// optimizer snapshot finishes exactly like the uninterrupted search
+func TestRunJob_ResumeJointSnapshot(t *testing.T) {
+	tmpDir := t.TempDir()
+	imgPath := filepath.Join(tmpDir, "test.png")
+	createTestImage(t, imgPath)
+
+	config := JobConfig{
+		RefPath: imgPath,
+		Mode:    "joint",
+		Circles: 2,
+		Iters:   8,
+		PopSize: 20,
+		Seed:    42,
+	}
+
+	// Uninterrupted search on the renderer the worker uses, snapshotted
+	// after generation 3
+	res, err := loadJobResources(imgPath)
+	if err != nil {
+		t.Fatal(err)
+	}
+	rend := res.shared.NewPlanarRenderer(config.Circles)
+	lower, upper := rend.Bounds()
+	dim := rend.Dim()
+	var state []byte
+	var stateParams []float64
+	var stateCost float64
+	optimizer := opt.NewMayfly(config.Iters, config.PopSize, config.Seed).(opt.SnapshotOptimizer)
+	best, cost, err := optimizer.RunSnapshots(nil, rend.Cost, lower[:dim], upper[:dim], dim, func(g opt.Generation) {
+		if g.Index == 3 {
+			state, stateParams, stateCost = g.Snapshot(), g.BestParams(), g.BestCost
+		}
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	jm := NewJobManager()
+	resumed := jm.CreateJob(config)
+	jm.UpdateJob(resumed.ID, func(j *Job) {
+		j.BestParams = stateParams
+		j.BestCost = stateCost
+		j.InitialCost = rend.Cost(make([]float64, dim))
+		j.Iterations = 3
+		j.OptimizerState = state
+	})
+	if err := runJob(context.Background(), jm, nil, resumed.ID); err != nil {
+		t.Fatalf("resumed runJob should succeed: %v", err)
+	}
+
+	updated, _ := jm.GetJob(resumed.ID)
+	if updated.BestCost != cost {
+		t.Fatalf("Resumed job ended at cost %v, uninterrupted %v", updated.BestCost, cost)
+	}
+	for i := range best {
+		if updated.BestParams[i] != best[i] {
+			t.Fatalf("Resumed params differ at %d", i)
+		}
+	}
+	if updated.OptimizerState != nil {
+		t.Error("A finished job should not keep its optimizer state")
+	}
+}
+
+// TestRunJob_JointCheckpointParity tests that a checkpoint interval does not
+// change the joint search: checkpointed and plain jobs end identically
+func TestRunJob_JointCheckpointParity(t *testing.T) {
+	tmpDir := t.TempDir()
+	imgPath := filepath.Join(tmpDir, "test.png")
+	createTestImage(t, imgPath)
+
+	checkpoints, err := createTestStore(filepath.Join(tmpDir, "data"))
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	run := func(interval int) *Job {
+		t.Helper()
+		jm := NewJobManager()
+		job := jm.CreateJob(JobConfig{
+			RefPath:            imgPath,
+			Mode:               "joint",
+			Circles:            2,
+			Iters:              6,
+			PopSize:            12,
+			Seed:               7,
+			CheckpointInterval: interval,
+		})
+		if err := runJob(context.Background(), jm, checkpoints, job.ID); err != nil {
+			t.Fatalf("runJob (checkpoint interval %d) failed: %v", interval, err)
+		}
+		updated, _ := jm.GetJob(job.ID)
+		return updated
+	}
+
+	plain, checkpointed := run(0), run(1)
+	if plain.BestCost != checkpointed.BestCost {
+		t.Fatalf("checkpointed job ended at cost %v, plain job at %v", checkpointed.BestCost, plain.BestCost)
+	}
+	for i := range plain.BestParams {
+		if plain.BestParams[i] != checkpointed.BestParams[i] {
+			t.Fatalf("params differ at %d", i)
+		}
+	}
+}
+
 // Helper function to create a simple test image
 func createTestImage(t *testing.T, path string) {
 	img := image.NewNRGBA(image.Rect(0, 0, 50, 50))
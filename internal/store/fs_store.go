@@ -1,6 +1,8 @@
 package store
 
 import (
+	"crypto/sha256"
+	"encoding/hex"
 	"encoding/json"
 	"fmt"
 	"log/slog"
@@ -36,13 +38,45 @@ func (fs *FSStore) jobDir(jobID string) string {
 	return filepath.Join(fs.baseDir, "jobs", jobID)
 }
 
+// JobDir returns the directory holding a job's checkpoint and artifacts.
+func (fs *FSStore) JobDir(jobID string) string {
+	return fs.jobDir(jobID)
+}
+
 // checkpointPath returns the path to the checkpoint.json file for a job.
 func (fs *FSStore) checkpointPath(jobID string) string {
 	return filepath.Join(fs.jobDir(jobID), "checkpoint.json")
 }
 
+// optimizerStatePath returns the path to the binary optimizer state of a job.
+func (fs *FSStore) optimizerStatePath(jobID string) string {
+	return filepath.Join(fs.jobDir(jobID), "optimizer.bin")
+}
+
+// optimizerStateHash returns the hex SHA-256 of an optimizer state snapshot.
+func optimizerStateHash(state []byte) string {
+	sum := sha256.Sum256(state)
+	return hex.EncodeToString(sum[:])
+}
+
+// writeAtomic writes data to path through a temp file and rename.
+func writeAtomic(path string, data []byte) error {
+	tempPath := path + ".tmp"
+	if err := os.WriteFile(tempPath, data, 0644); err != nil {
+		return fmt.Errorf("failed to write temp file: %w", err)
+	}
+	if err := os.Rename(tempPath, path); err != nil {
+		// Clean up temp file on failure
+		os.Remove(tempPath)
+		return fmt.Errorf("failed to rename temp file: %w", err)
+	}
+	return nil
+}
+
 // SaveCheckpoint atomically saves a checkpoint for the given job.
-// Uses temp file + rename pattern to ensure atomicity.
+// Uses temp file + rename pattern to ensure atomicity. The optimizer state
+// is written first and checkpoint.json records its hash, so a crash between
+// the two writes leaves a snapshot that LoadCheckpoint rejects.
 func (fs *FSStore) SaveCheckpoint(jobID string, checkpoint *Checkpoint) error {
 	if jobID == "" {
 		return fmt.Errorf("jobID cannot be empty")
@@ -57,24 +91,29 @@ func (fs *FSStore) SaveCheckpoint(jobID string, checkpoint *Checkpoint) error {
 		return fmt.Errorf("failed to create job directory: %w", err)
 	}
 
-	// Serialize checkpoint to JSON
+	// Serialize checkpoint to JSON, binding it to its optimizer state
+	checkpoint.OptimizerStateHash = ""
+	if checkpoint.OptimizerState != nil {
+		checkpoint.OptimizerStateHash = optimizerStateHash(checkpoint.OptimizerState)
+	}
 	data, err := json.MarshalIndent(checkpoint, "", "  ")
 	if err != nil {
 		return fmt.Errorf("failed to serialize checkpoint: %w", err)
 	}
 
-	// Write to temporary file first (atomic pattern)
-	tempPath := fs.checkpointPath(jobID) + ".tmp"
-	if err := os.WriteFile(tempPath, data, 0644); err != nil {
-		return fmt.Errorf("failed to write temp checkpoint file: %w", err)
+	// Binary optimizer state, or none for this checkpoint
+	statePath := fs.optimizerStatePath(jobID)
+	if checkpoint.OptimizerState != nil {
+		if err := writeAtomic(statePath, checkpoint.OptimizerState); err != nil {
+			return fmt.Errorf("failed to save optimizer state: %w", err)
+		}
+	} else if err := os.Remove(statePath); err != nil && !os.IsNotExist(err) {
+		return fmt.Errorf("failed to remove stale optimizer state: %w", err)
 	}
 
-	// Atomic rename to final location
 	finalPath := fs.checkpointPath(jobID)
-	if err := os.Rename(tempPath, finalPath); err != nil {
-		// Clean up temp file on failure
-		os.Remove(tempPath)
-		return fmt.Errorf("failed to rename checkpoint file: %w", err)
+	if err := writeAtomic(finalPath, data); err != nil {
+		return fmt.Errorf("failed to save checkpoint file: %w", err)
 	}
 
 	slog.Debug("Checkpoint saved", "jobID", jobID, "path", finalPath)
@@ -108,6 +147,21 @@ func (fs *FSStore) LoadCheckpoint(jobID string) (*Checkpoint, error) {
 		return nil, fmt.Errorf("failed to deserialize checkpoint: %w", err)
 	}
 
+	// Binary optimizer state, if the checkpoint has one. A snapshot whose
+	// hash does not match was written for another checkpoint (interrupted
+	// save) and is dropped; resume then seeds from BestParams.
+	if checkpoint.OptimizerStateHash != "" {
+		state, err := os.ReadFile(fs.optimizerStatePath(jobID))
+		switch {
+		case err == nil && optimizerStateHash(state) == checkpoint.OptimizerStateHash:
+			checkpoint.OptimizerState = state
+		case err == nil || os.IsNotExist(err):
+			slog.Warn("Optimizer state does not match checkpoint, ignoring it", "jobID", jobID)
+		default:
+			return nil, fmt.Errorf("failed to read optimizer state: %w", err)
+		}
+	}
+
 	slog.Debug("Checkpoint loaded", "jobID", jobID, "path", path)
 	return &checkpoint, nil
 }
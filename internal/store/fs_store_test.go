@@ -1,6 +1,7 @@
 package store
 
 import (
+	"bytes"
 	"fmt"
 	"os"
 	"path/filepath"
@@ -170,6 +171,74 @@ func TestLoadCheckpoint(t *testing.T) {
 	}
 }
 
+func TestLoadCheckpoint_OptimizerState(t *testing.T) {
+	store, tempDir := setupTestStore(t)
+
+	jobID := "test-job-state"
+	checkpoint := createTestCheckpoint(jobID)
+	checkpoint.OptimizerState = []byte("MFS1\x00\x01binary state")
+	if err := store.SaveCheckpoint(jobID, checkpoint); err != nil {
+		t.Fatalf("SaveCheckpoint failed: %v", err)
+	}
+
+	// Stored as raw bytes next to the JSON, not inside it
+	statePath := filepath.Join(tempDir, "jobs", jobID, "optimizer.bin")
+	raw, err := os.ReadFile(statePath)
+	if err != nil || !bytes.Equal(raw, checkpoint.OptimizerState) {
+		t.Fatalf("optimizer.bin = %q (%v), want the state", raw, err)
+	}
+	if data, _ := os.ReadFile(filepath.Join(tempDir, "jobs", jobID, "checkpoint.json")); bytes.Contains(data, []byte("binary state")) {
+		t.Error("optimizer state was embedded in checkpoint.json")
+	}
+
+	loaded, err := store.LoadCheckpoint(jobID)
+	if err != nil {
+		t.Fatalf("LoadCheckpoint failed: %v", err)
+	}
+	if !bytes.Equal(loaded.OptimizerState, checkpoint.OptimizerState) {
+		t.Errorf("OptimizerState mismatch: got %q", loaded.OptimizerState)
+	}
+
+	// A later checkpoint without state must not pick up the old snapshot
+	checkpoint.OptimizerState = nil
+	if err := store.SaveCheckpoint(jobID, checkpoint); err != nil {
+		t.Fatalf("SaveCheckpoint failed: %v", err)
+	}
+	if _, err := os.Stat(statePath); !os.IsNotExist(err) {
+		t.Error("stale optimizer.bin was kept")
+	}
+	loaded, _ = store.LoadCheckpoint(jobID)
+	if loaded.OptimizerState != nil {
+		t.Error("loaded a stale optimizer state")
+	}
+}
+
+// TestLoadCheckpoint_MismatchedOptimizerState simulates a crash after the
+// next checkpoint's optimizer.bin was written but before its JSON was
+func TestLoadCheckpoint_MismatchedOptimizerState(t *testing.T) {
+	store, tempDir := setupTestStore(t)
+
+	jobID := "test-job-torn"
+	checkpoint := createTestCheckpoint(jobID)
+	checkpoint.OptimizerState = []byte("MFS1 generation 3")
+	if err := store.SaveCheckpoint(jobID, checkpoint); err != nil {
+		t.Fatalf("SaveCheckpoint failed: %v", err)
+	}
+
+	statePath := filepath.Join(tempDir, "jobs", jobID, "optimizer.bin")
+	if err := os.WriteFile(statePath, []byte("MFS1 generation 4"), 0644); err != nil {
+		t.Fatal(err)
+	}
+
+	loaded, err := store.LoadCheckpoint(jobID)
+	if err != nil {
+		t.Fatalf("LoadCheckpoint failed: %v", err)
+	}
+	if loaded.OptimizerState != nil {
+		t.Errorf("loaded optimizer state %q that does not belong to the checkpoint", loaded.OptimizerState)
+	}
+}
+
 func TestLoadCheckpoint_NotFound(t *testing.T) {
 	store, _ := setupTestStore(t)
 
@@ -31,6 +31,7 @@ type Store interface {
 	// DeleteCheckpoint removes the checkpoint and all associated artifacts
 	// for the given job. This includes:
 	//   - checkpoint.json
+	//   - optimizer.bin
 	//   - best.png
 	//   - diff.png
 	//   - trace.jsonl
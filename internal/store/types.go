@@ -3,6 +3,8 @@ package store
 import (
 	"fmt"
 	"time"
+
+	"github.com/cwbudde/mayflycirclefit/internal/fit"
 )
 
 // JobConfig holds configuration for an optimization job (checkpoint copy).
@@ -10,6 +12,12 @@ import (
 type JobConfig struct {
 	RefPath            string  `json:"refPath"`
 	CanvasPath         string  `json:"canvasPath,omitempty"`         // Optional: path to existing canvas image to continue from (empty = blank canvas)
+	Grayscale          bool    `json:"grayscale,omitempty"`          // Fit 5-parameter gray circles (X, Y, R, L, Opacity) to the reference luma
+	Cost               string  `json:"cost,omitempty"`               // Cost function name (see fit.CostNames; empty = fit.DefaultCost)
+	WeightMaskPath     string  `json:"weightMaskPath,omitempty"`     // Optional: path to a grey-level importance mask (empty = uniform weights)
+	Precision          string  `json:"precision,omitempty"`          // Compositing precision: float64 (default) or float32
+	SpanTable          bool    `json:"spanTable,omitempty"`          // Rasterize through the shared span table (circles snapped to 1/8 pixel)
+	Antialias          bool    `json:"antialias,omitempty"`          // Anti-aliased circle edges (smooth cost surface)
 	Mode               string  `json:"mode"`                         // joint, sequential, batch
 	Circles            int     `json:"circles"`
 	Iters              int     `json:"iters"`
@@ -22,49 +30,51 @@ type JobConfig struct {
 	ConvergenceThreshold float64 `json:"convergenceThreshold,omitempty"` // Minimum relative improvement required (default: 0.001 = 0.1%)
 }
 
+// ParamsPerCircle returns the number of parameters per circle for this config:
+// 5 (X, Y, R, L, Opacity) in grayscale mode, otherwise 7 (X, Y, R, CR, CG, CB, Opacity).
+func (c JobConfig) ParamsPerCircle() int {
+	if c.Grayscale {
+		return 5
+	}
+	return 7
+}
+
 // Checkpoint represents a saved optimization state that can be resumed later.
-// All fields are serialized to JSON for persistence.
+// All fields except OptimizerState are serialized to JSON for persistence.
 //
 // Optimizer State Handling:
 //
-// The checkpoint saves the BEST PARAMETERS found so far, but does NOT save
-// the internal optimizer state (population, velocities, etc.). This design choice
-// has important implications for resumption:
-//
 // SAVED STATE:
 //   - BestParams: The circle parameters that achieved the lowest cost
 //   - BestCost: The cost value achieved by BestParams
 //   - InitialCost: Starting cost for improvement tracking
 //   - Iteration: How many iterations have been completed
 //   - Config: Job configuration (reference image, mode, circles, etc.)
-//
-// REINITIALIZED ON RESUME:
-//   - Optimizer population: New random population is generated
-//   - Optimizer internal state: Velocities, positions, etc. are reset
-//   - Random seed: Can be set to same value for reproducibility
+//   - Pipeline: Sequential/batch progress (committed circles, completed
+//     passes, convergence tracker); BestParams then holds only the
+//     committed circles and resume continues the pipeline after them
+//   - OptimizerState: Binary snapshot of a joint search (population,
+//     velocities, RNG state, generation; see opt.SnapshotOptimizer),
+//     stored next to the JSON as optimizer.bin
 //
 // RESUME STRATEGY:
-// When resuming, the optimizer is restarted with a fresh population, but we can:
-//   1. Seed the population with the best parameters + random variations
-//   2. Continue iteration count from checkpoint (or reset to 0)
-//   3. Use the same random seed if deterministic behavior is desired
-//
-// IMPLICATIONS:
-//   - Resume is not a perfect continuation - there will be some divergence
-//   - The best cost should never get worse (we keep best params)
-//   - Convergence speed may differ slightly from non-interrupted runs
-//   - For most use cases, this is acceptable and keeps implementation simple
+//   - With OptimizerState, the search continues from the snapshot and ends
+//     bit-identically to an uninterrupted run
+//   - Without it, the optimizer is restarted with a population seeded from
+//     BestParams plus random variations (opt.ResumableOptimizer); the best
+//     cost never gets worse, but the run diverges from an uninterrupted one
+//   - Pipelines resume at the step after the last committed circle/batch;
+//     every step starts a fresh optimizer run, so no search state is needed
 //
-// ALTERNATIVES NOT IMPLEMENTED:
-//   - Saving full population would require optimizer-specific serialization
-//   - Different optimizers have different internal state structures
-//   - Would significantly increase checkpoint size
-//   - Would tie checkpoint format to specific optimizer implementations
+// Snapshots are optimizer-specific and as large as the population
+// (roughly 40 bytes per parameter per individual), so they are only written
+// for optimizers that implement opt.SnapshotOptimizer.
 type Checkpoint struct {
 	// JobID is the unique identifier for this optimization job
 	JobID string `json:"jobId"`
 
-	// BestParams contains the circle parameters (7 per circle: X, Y, R, CR, CG, CB, Opacity)
+	// BestParams contains the circle parameters (7 per circle: X, Y, R, CR, CG, CB, Opacity;
+	// 5 per circle in grayscale mode: X, Y, R, L, Opacity)
 	// that produced the best (lowest) cost so far
 	BestParams []float64 `json:"bestParams"`
 
@@ -83,6 +93,37 @@ type Checkpoint struct {
 	// Config holds the job configuration, needed for validation during resume.
 	// We ensure that resumed jobs use compatible settings (same image, mode, etc.)
 	Config JobConfig `json:"config"`
+
+	// Pipeline is the progress of a sequential or batch job (nil for joint
+	// jobs and for checkpoints written before it was recorded)
+	Pipeline *PipelineState `json:"pipeline,omitempty"`
+
+	// OptimizerState is the optimizer's binary search state snapshot (nil if
+	// none); FSStore keeps it in optimizer.bin rather than the JSON
+	OptimizerState []byte `json:"-"`
+
+	// OptimizerStateHash is the hex SHA-256 of OptimizerState, set by FSStore
+	// so a snapshot that does not belong to this checkpoint is rejected
+	OptimizerStateHash string `json:"optimizerStateHash,omitempty"`
+}
+
+// PipelineState is the progress of a sequential or batch pipeline (checkpoint
+// copy of renderer.PipelineState without the parameters, which are the
+// checkpoint's BestParams).
+type PipelineState struct {
+	// Circles is the number of committed circles
+	Circles int `json:"circles"`
+
+	// Pass is the number of completed steps: circles (sequential) or batches (batch)
+	Pass int `json:"pass"`
+
+	// Converged is set when convergence detection stopped the pipeline
+	Converged bool `json:"converged,omitempty"`
+
+	// CostHistory, LastSignificant and StaleCount are the convergence tracker's state
+	CostHistory     []float64 `json:"costHistory,omitempty"`
+	LastSignificant float64   `json:"lastSignificant,omitempty"`
+	StaleCount      int       `json:"staleCount,omitempty"`
 }
 
 // CheckpointInfo contains metadata about a checkpoint without the full parameter data.
@@ -149,9 +190,10 @@ func (c *Checkpoint) Validate() error {
 	if len(c.BestParams) == 0 {
 		return &ValidationError{Field: "BestParams", Reason: "cannot be empty"}
 	}
-	// BestParams should be a multiple of 7 (7 params per circle)
-	if len(c.BestParams)%7 != 0 {
-		return &ValidationError{Field: "BestParams", Reason: "length must be multiple of 7"}
+	// BestParams should be a multiple of the params per circle (7, or 5 in grayscale mode)
+	perCircle := c.Config.ParamsPerCircle()
+	if len(c.BestParams)%perCircle != 0 {
+		return &ValidationError{Field: "BestParams", Reason: fmt.Sprintf("length must be multiple of %d", perCircle)}
 	}
 	if c.BestCost < 0 {
 		return &ValidationError{Field: "BestCost", Reason: "cannot be negative"}
@@ -180,8 +222,11 @@ func (c *Checkpoint) Validate() error {
 	if c.Config.PopSize <= 0 {
 		return &ValidationError{Field: "Config.PopSize", Reason: "must be positive"}
 	}
+	if c.Pipeline != nil {
+		return c.validatePipeline(perCircle)
+	}
 	// Verify BestParams length matches expected circles
-	expectedParams := c.Config.Circles * 7
+	expectedParams := c.Config.Circles * perCircle
 	if len(c.BestParams) != expectedParams {
 		return &ValidationError{
 			Field:  "BestParams",
@@ -191,6 +236,24 @@ func (c *Checkpoint) Validate() error {
 	return nil
 }
 
+// validatePipeline checks the pipeline state against BestParams, which holds
+// the committed circles
+func (c *Checkpoint) validatePipeline(perCircle int) error {
+	if c.Config.Mode != "sequential" && c.Config.Mode != "batch" {
+		return &ValidationError{Field: "Pipeline", Reason: fmt.Sprintf("not supported for mode %s", c.Config.Mode)}
+	}
+	if c.Pipeline.Pass < 0 || c.Pipeline.StaleCount < 0 {
+		return &ValidationError{Field: "Pipeline", Reason: "pass and stale count cannot be negative"}
+	}
+	if len(c.BestParams) != c.Pipeline.Circles*perCircle {
+		return &ValidationError{
+			Field:  "BestParams",
+			Reason: fmt.Sprintf("length mismatch: expected %d params for %d committed circles", c.Pipeline.Circles*perCircle, c.Pipeline.Circles),
+		}
+	}
+	return nil
+}
+
 // ValidationError represents a checkpoint validation error.
 type ValidationError struct {
 	Field  string
@@ -218,6 +281,20 @@ func (c *Checkpoint) IsCompatible(config JobConfig) error {
 			Actual:   config.Mode,
 		}
 	}
+	if c.Config.Grayscale != config.Grayscale {
+		return &CompatibilityError{
+			Field:    "Grayscale",
+			Expected: fmt.Sprintf("%t", c.Config.Grayscale),
+			Actual:   fmt.Sprintf("%t", config.Grayscale),
+		}
+	}
+	if !sameCost(c.Config.Cost, config.Cost) {
+		return &CompatibilityError{
+			Field:    "Cost",
+			Expected: c.Config.Cost,
+			Actual:   config.Cost,
+		}
+	}
 	if c.Config.Circles != config.Circles {
 		return &CompatibilityError{
 			Field:    "Circles",
@@ -228,6 +305,18 @@ func (c *Checkpoint) IsCompatible(config JobConfig) error {
 	return nil
 }
 
+// sameCost reports whether two cost names select the same cost function
+// ("" and "fast-mse" are the same default; names are case-insensitive).
+// Unregistered names only match themselves.
+func sameCost(a, b string) bool {
+	ca, errA := fit.CanonicalCost(a)
+	cb, errB := fit.CanonicalCost(b)
+	if errA != nil || errB != nil {
+		return a == b
+	}
+	return ca == cb
+}
+
 // CompatibilityError represents a checkpoint compatibility error.
 type CompatibilityError struct {
 	Field    string
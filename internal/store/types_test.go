@@ -136,6 +136,67 @@ func TestCheckpoint_Validate_Valid(t *testing.T) {
 	}
 }
 
+func TestCheckpoint_Validate_Pipeline(t *testing.T) {
+	checkpoint := &Checkpoint{
+		JobID:       "sequential-job",
+		BestParams:  []float64{100, 50, 25, 0.8, 0.2, 0.1, 0.9, 10, 20, 5, 0.1, 0.2, 0.3, 0.5},
+		BestCost:    0.1,
+		InitialCost: 0.5,
+		Timestamp:   time.Now(),
+		Config: JobConfig{
+			RefPath: "test.png",
+			Mode:    "sequential",
+			Circles: 10,
+			Iters:   100,
+			PopSize: 30,
+		},
+		Pipeline: &PipelineState{Circles: 2, Pass: 2, CostHistory: []float64{0.3, 0.1}, LastSignificant: 0.1},
+	}
+	if err := checkpoint.Validate(); err != nil {
+		t.Errorf("Partial sequential checkpoint should be valid: %v", err)
+	}
+
+	checkpoint.Pipeline.Circles = 3
+	if err := checkpoint.Validate(); err == nil {
+		t.Error("Expected error for committed circles not matching BestParams")
+	}
+
+	checkpoint.Pipeline.Circles = 2
+	checkpoint.Config.Mode = "joint"
+	if err := checkpoint.Validate(); err == nil {
+		t.Error("Expected error for pipeline state on a joint checkpoint")
+	}
+}
+
+func TestCheckpoint_Validate_Grayscale(t *testing.T) {
+	checkpoint := &Checkpoint{
+		JobID:       "gray-job",
+		BestParams:  []float64{100, 50, 25, 0.8, 0.9, 10, 20, 5, 0.1, 0.5},
+		BestCost:    0.1,
+		InitialCost: 0.5,
+		Iteration:   100,
+		Timestamp:   time.Now(),
+		Config: JobConfig{
+			RefPath:   "test.png",
+			Mode:      "joint",
+			Grayscale: true,
+			Circles:   2,
+			Iters:     1000,
+			PopSize:   30,
+		},
+	}
+
+	if err := checkpoint.Validate(); err != nil {
+		t.Errorf("Valid grayscale checkpoint should not have validation error: %v", err)
+	}
+
+	// 10 params are not a whole number of colour circles
+	checkpoint.Config.Grayscale = false
+	if err := checkpoint.Validate(); err == nil {
+		t.Error("Expected validation error for 10 params in colour mode")
+	}
+}
+
 func TestCheckpoint_Validate_EmptyJobID(t *testing.T) {
 	checkpoint := &Checkpoint{
 		JobID:       "",
@@ -405,6 +466,70 @@ func TestCheckpoint_IsCompatible_DifferentMode(t *testing.T) {
 	}
 }
 
+func TestCheckpoint_IsCompatible_DifferentCost(t *testing.T) {
+	checkpoint := &Checkpoint{
+		Config: JobConfig{
+			RefPath: "test.png",
+			Mode:    "joint",
+			Cost:    "sad",
+			Circles: 10,
+		},
+	}
+
+	config := JobConfig{
+		RefPath: "test.png",
+		Mode:    "joint",
+		Cost:    "ssim",
+		Circles: 10,
+	}
+
+	err := checkpoint.IsCompatible(config)
+	if err == nil {
+		t.Fatal("Expected compatibility error for different Cost")
+	}
+}
+
+// TestCheckpoint_IsCompatible_DefaultCost checks that cost names selecting
+// the same cost function are compatible
+func TestCheckpoint_IsCompatible_DefaultCost(t *testing.T) {
+	for _, names := range [][2]string{
+		{"", "fast-mse"},
+		{"fast-mse", ""},
+		{"", "FAST-MSE"},
+		{"SAD", "sad"},
+	} {
+		checkpoint := &Checkpoint{
+			Config: JobConfig{RefPath: "test.png", Mode: "joint", Cost: names[0], Circles: 10},
+		}
+		config := JobConfig{RefPath: "test.png", Mode: "joint", Cost: names[1], Circles: 10}
+		if err := checkpoint.IsCompatible(config); err != nil {
+			t.Errorf("checkpoint cost %q, resume cost %q: %v", names[0], names[1], err)
+		}
+	}
+}
+
+func TestCheckpoint_IsCompatible_DifferentGrayscale(t *testing.T) {
+	checkpoint := &Checkpoint{
+		Config: JobConfig{
+			RefPath:   "test.png",
+			Mode:      "joint",
+			Grayscale: true,
+			Circles:   10,
+		},
+	}
+
+	config := JobConfig{
+		RefPath: "test.png",
+		Mode:    "joint",
+		Circles: 10,
+	}
+
+	err := checkpoint.IsCompatible(config)
+	if err == nil {
+		t.Fatal("Expected compatibility error for different Grayscale")
+	}
+}
+
 func TestCheckpoint_IsCompatible_DifferentCircles(t *testing.T) {
 	checkpoint := &Checkpoint{
 		Config: JobConfig{
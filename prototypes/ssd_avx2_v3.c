@@ -0,0 +1,236 @@
+/*
+ * AVX2 SSD (Sum of Squared Differences) Kernel Prototype v3
+ *
+ * Fully vectorized version. Unlike ssd_avx2.c and ssd_avx2_v2.c, nothing is
+ * spilled to the stack and no RGB value is recomputed with scalar code:
+ *
+ *   - Alpha is cleared with a single VPAND (mask 0x00FFFFFF per pixel) before
+ *     widening, so it contributes 0 to every VPMADDWD pair
+ *   - Bytes are widened to int16 with VPUNPCK{L,H}BW against zero; lane order
+ *     does not matter because all lanes are summed at the end
+ *   - VPMADDWD squares the int16 differences and adds adjacent pairs into int32
+ *   - int32 lanes are widened to int64 (VPMOVZXDQ) once per row or every
+ *     SSD_FLUSH_ITERS iterations, well before they can overflow
+ *   - Row tails (width % 8) use VPMASKMOVD: every NRGBA pixel is one dword, so
+ *     a dword mask loads exactly the remaining pixels and zeroes the rest
+ *   - The horizontal reduction happens once per image
+ *
+ * This prototype is the source of internal/fit/ssd_amd64.s.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <immintrin.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+/*
+ * Per iteration each int32 lane receives two VPMADDWD results, each at most
+ * 2 * 255^2 = 130050, so one iteration adds at most 260100 per lane.
+ * 4096 iterations (32768 pixels) keep the lane below 1.07e9 < 2^31.
+ */
+#define SSD_FLUSH_ITERS 4096
+
+/* Get high-resolution time in nanoseconds */
+static inline uint64_t get_nanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Dword lane masks for the tail: load 8 dwords starting at tail_mask + 8 - n */
+static const int32_t tail_mask[16] = {
+    -1, -1, -1, -1, -1, -1, -1, -1,
+     0,  0,  0,  0,  0,  0,  0,  0,
+};
+
+/*
+ * ssd_scalar - Reference scalar implementation
+ */
+double ssd_scalar(const uint8_t* a, const uint8_t* b, int stride, int width, int height) {
+    double sum = 0.0;
+
+    for (int y = 0; y < height; y++) {
+        int row_start = y * stride;
+        for (int x = 0; x < width; x++) {
+            int i = row_start + x * 4;
+            int32_t dr = (int32_t)a[i+0] - (int32_t)b[i+0];
+            int32_t dg = (int32_t)a[i+1] - (int32_t)b[i+1];
+            int32_t db = (int32_t)a[i+2] - (int32_t)b[i+2];
+            sum += (double)(dr*dr + dg*dg + db*db);
+        }
+    }
+
+    return sum;
+}
+
+/* ssd8 - squared RGB differences of 8 pixels, accumulated into int32 lanes */
+static inline __m256i ssd8(__m256i acc, __m256i va, __m256i vb, __m256i rgb_mask) {
+    const __m256i zero = _mm256_setzero_si256();
+
+    va = _mm256_and_si256(va, rgb_mask);
+    vb = _mm256_and_si256(vb, rgb_mask);
+
+    __m256i d_lo = _mm256_sub_epi16(_mm256_unpacklo_epi8(va, zero), _mm256_unpacklo_epi8(vb, zero));
+    __m256i d_hi = _mm256_sub_epi16(_mm256_unpackhi_epi8(va, zero), _mm256_unpackhi_epi8(vb, zero));
+
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(d_lo, d_lo));
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(d_hi, d_hi));
+    return acc;
+}
+
+/* widen - add the 8 int32 lanes of acc32 into the 4 int64 lanes of acc64 */
+static inline __m256i widen(__m256i acc64, __m256i acc32) {
+    acc64 = _mm256_add_epi64(acc64, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(acc32)));
+    acc64 = _mm256_add_epi64(acc64, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(acc32, 1)));
+    return acc64;
+}
+
+/*
+ * ssd_avx2_v3 - Fully vectorized AVX2 implementation
+ */
+double ssd_avx2_v3(const uint8_t* a, const uint8_t* b, int stride, int width, int height) {
+    const __m256i rgb_mask = _mm256_set1_epi32(0x00FFFFFF);
+    __m256i acc64 = _mm256_setzero_si256();
+
+    int simd_width = width & ~7;
+    int tail = width & 7;
+    __m256i tmask = _mm256_loadu_si256((const __m256i*)&tail_mask[8 - tail]);
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* pa = a + (size_t)y * stride;
+        const uint8_t* pb = b + (size_t)y * stride;
+        __m256i acc32 = _mm256_setzero_si256();
+        int iters = 0;
+
+        for (int x = 0; x < simd_width; x += 8) {
+            __m256i va = _mm256_loadu_si256((const __m256i*)(pa + x * 4));
+            __m256i vb = _mm256_loadu_si256((const __m256i*)(pb + x * 4));
+            acc32 = ssd8(acc32, va, vb, rgb_mask);
+
+            if (++iters == SSD_FLUSH_ITERS) {
+                acc64 = widen(acc64, acc32);
+                acc32 = _mm256_setzero_si256();
+                iters = 0;
+            }
+        }
+
+        if (tail) {
+            __m256i va = _mm256_maskload_epi32((const int*)(pa + simd_width * 4), tmask);
+            __m256i vb = _mm256_maskload_epi32((const int*)(pb + simd_width * 4), tmask);
+            acc32 = ssd8(acc32, va, vb, rgb_mask);
+        }
+
+        acc64 = widen(acc64, acc32);
+    }
+
+    /* Single horizontal reduction per image */
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(acc64), _mm256_extracti128_si256(acc64, 1));
+    s = _mm_add_epi64(s, _mm_unpackhi_epi64(s, s));
+    return (double)_mm_cvtsi128_si64(s);
+}
+
+static int check(const char* name, int width, int height, int stride) {
+    size_t img_size = (size_t)stride * height;
+    uint8_t* a = (uint8_t*)malloc(img_size);
+    uint8_t* b = (uint8_t*)malloc(img_size);
+    for (size_t i = 0; i < img_size; i++) {
+        a[i] = rand() % 256;
+        b[i] = rand() % 256;
+    }
+    double want = ssd_scalar(a, b, stride, width, height);
+    double got = ssd_avx2_v3(a, b, stride, width, height);
+    free(a);
+    free(b);
+    if (want != got) {
+        printf("  ✗ %-10s %5dx%-5d stride=%-6d scalar=%.0f v3=%.0f\n", name, width, height, stride, want, got);
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    printf("AVX2 SSD Kernel Prototype v3 (fully vectorized)\n");
+    printf("===============================================\n\n");
+
+    srand(42);
+
+    /* Correctness: every tail length, padded strides, rows longer than one flush block */
+    printf("Correctness Test:\n");
+    int failures = 0;
+    for (int w = 1; w <= 40; w++) {
+        failures += check("tail", w, 3, w * 4);
+        failures += check("padded", w, 3, w * 4 + 12);
+    }
+    failures += check("flush", SSD_FLUSH_ITERS * 8 * 2 + 5, 2, (SSD_FLUSH_ITERS * 8 * 2 + 5) * 4);
+    {
+        /* Worst case magnitude: 0 vs 255 on every channel across a long row */
+        int w = SSD_FLUSH_ITERS * 8 * 3 + 3, h = 2, stride = w * 4;
+        uint8_t* a = (uint8_t*)calloc((size_t)stride * h, 1);
+        uint8_t* b = (uint8_t*)malloc((size_t)stride * h);
+        memset(b, 255, (size_t)stride * h);
+        double want = ssd_scalar(a, b, stride, w, h);
+        double got = ssd_avx2_v3(a, b, stride, w, h);
+        if (want != got) {
+            printf("  ✗ max-diff scalar=%.0f v3=%.0f\n", want, got);
+            failures++;
+        }
+        free(a);
+        free(b);
+    }
+    if (failures) {
+        printf("  ✗ FAIL (%d cases)\n", failures);
+        return 1;
+    }
+    printf("  ✓ PASS (bit-exact for all widths 1..40, padded strides, long rows)\n\n");
+
+    const int width = 256;
+    const int height = 256;
+    const int stride = width * 4;
+    const size_t img_size = stride * height;
+
+    uint8_t* img_a = (uint8_t*)aligned_alloc(32, img_size);
+    uint8_t* img_b = (uint8_t*)aligned_alloc(32, img_size);
+    for (size_t i = 0; i < img_size; i++) {
+        img_a[i] = rand() % 256;
+        img_b[i] = rand() % 256;
+    }
+
+    // Warm-up
+    for (int i = 0; i < 100; i++) {
+        ssd_scalar(img_a, img_b, stride, width, height);
+        ssd_avx2_v3(img_a, img_b, stride, width, height);
+    }
+
+    printf("Performance Benchmark (%d iterations, %dx%d):\n", 1000, width, height);
+    const int iters = 1000;
+    volatile double sink = 0;
+
+    uint64_t start = get_nanos();
+    for (int i = 0; i < iters; i++) {
+        sink += ssd_scalar(img_a, img_b, stride, width, height);
+    }
+    uint64_t end = get_nanos();
+    double scalar_ns = (double)(end - start) / iters;
+
+    start = get_nanos();
+    for (int i = 0; i < iters; i++) {
+        sink += ssd_avx2_v3(img_a, img_b, stride, width, height);
+    }
+    end = get_nanos();
+    double avx2_ns = (double)(end - start) / iters;
+
+    printf("  Scalar: %.2f μs, %.1f Mpixels/sec\n", scalar_ns / 1000.0, (width * height / 1e6) / (scalar_ns / 1e9));
+    printf("  AVX2:   %.2f μs, %.1f Mpixels/sec\n", avx2_ns / 1000.0, (width * height / 1e6) / (avx2_ns / 1e9));
+
+    double speedup = scalar_ns / avx2_ns;
+    printf("  Speedup: %.2fx\n\n", speedup);
+
+    free(img_a);
+    free(img_b);
+
+    return (speedup >= 1.5) ? 0 : 1;
+}
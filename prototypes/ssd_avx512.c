@@ -0,0 +1,198 @@
+/*
+ * AVX-512 SSD (Sum of Squared Differences) Kernel Prototype
+ *
+ * 512-bit version of ssd_avx2_v3.c for AVX-512BW CPUs (Ice Lake, Sapphire Rapids):
+ *
+ *   - Process 16 RGBA pixels (64 bytes) per iteration
+ *   - Alpha is dropped by a zero-masking byte load (k-mask 0x7777...), so no
+ *     separate VPAND is needed
+ *   - Row tails reuse the same load with the alpha mask ANDed with a tail mask;
+ *     masked-off bytes are never touched, so reading past the row is safe
+ *   - VPMADDWD squares int16 differences into int32 lanes, widened to int64
+ *     once per row (or every SSD_FLUSH_ITERS iterations)
+ *   - One horizontal reduction per image
+ *
+ * This prototype is the source of internal/fit/ssd_avx512_amd64.s.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <immintrin.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+/* Same lane bound as the AVX2 kernel: 4096 * 260100 < 2^31 */
+#define SSD_FLUSH_ITERS 4096
+
+/* Byte mask selecting R, G, B of every pixel (bit 3 of each nibble = alpha) */
+#define RGB_KMASK 0x7777777777777777ULL
+
+static inline uint64_t get_nanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+double ssd_scalar(const uint8_t* a, const uint8_t* b, int stride, int width, int height) {
+    double sum = 0.0;
+
+    for (int y = 0; y < height; y++) {
+        int row_start = y * stride;
+        for (int x = 0; x < width; x++) {
+            int i = row_start + x * 4;
+            int32_t dr = (int32_t)a[i+0] - (int32_t)b[i+0];
+            int32_t dg = (int32_t)a[i+1] - (int32_t)b[i+1];
+            int32_t db = (int32_t)a[i+2] - (int32_t)b[i+2];
+            sum += (double)(dr*dr + dg*dg + db*db);
+        }
+    }
+
+    return sum;
+}
+
+/* ssd16 - squared RGB differences of 16 pixels (alpha already zeroed) */
+static inline __m512i ssd16(__m512i acc, __m512i va, __m512i vb) {
+    const __m512i zero = _mm512_setzero_si512();
+
+    __m512i d_lo = _mm512_sub_epi16(_mm512_unpacklo_epi8(va, zero), _mm512_unpacklo_epi8(vb, zero));
+    __m512i d_hi = _mm512_sub_epi16(_mm512_unpackhi_epi8(va, zero), _mm512_unpackhi_epi8(vb, zero));
+
+    acc = _mm512_add_epi32(acc, _mm512_madd_epi16(d_lo, d_lo));
+    acc = _mm512_add_epi32(acc, _mm512_madd_epi16(d_hi, d_hi));
+    return acc;
+}
+
+static inline __m512i widen(__m512i acc64, __m512i acc32) {
+    acc64 = _mm512_add_epi64(acc64, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(acc32)));
+    acc64 = _mm512_add_epi64(acc64, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(acc32, 1)));
+    return acc64;
+}
+
+double ssd_avx512(const uint8_t* a, const uint8_t* b, int stride, int width, int height) {
+    const __mmask64 rgb = RGB_KMASK;
+    __m512i acc64 = _mm512_setzero_si512();
+
+    int simd_width = width & ~15;
+    int tail = width & 15;
+    __mmask64 tail_rgb = tail ? (rgb & ((1ULL << (tail * 4)) - 1)) : 0;
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* pa = a + (size_t)y * stride;
+        const uint8_t* pb = b + (size_t)y * stride;
+        __m512i acc32 = _mm512_setzero_si512();
+        int iters = 0;
+
+        for (int x = 0; x < simd_width; x += 16) {
+            __m512i va = _mm512_maskz_loadu_epi8(rgb, pa + x * 4);
+            __m512i vb = _mm512_maskz_loadu_epi8(rgb, pb + x * 4);
+            acc32 = ssd16(acc32, va, vb);
+
+            if (++iters == SSD_FLUSH_ITERS) {
+                acc64 = widen(acc64, acc32);
+                acc32 = _mm512_setzero_si512();
+                iters = 0;
+            }
+        }
+
+        if (tail) {
+            __m512i va = _mm512_maskz_loadu_epi8(tail_rgb, pa + simd_width * 4);
+            __m512i vb = _mm512_maskz_loadu_epi8(tail_rgb, pb + simd_width * 4);
+            acc32 = ssd16(acc32, va, vb);
+        }
+
+        acc64 = widen(acc64, acc32);
+    }
+
+    return (double)_mm512_reduce_add_epi64(acc64);
+}
+
+static int check(const char* name, int width, int height, int stride) {
+    size_t img_size = (size_t)stride * height;
+    uint8_t* a = (uint8_t*)malloc(img_size);
+    uint8_t* b = (uint8_t*)malloc(img_size);
+    for (size_t i = 0; i < img_size; i++) {
+        a[i] = rand() % 256;
+        b[i] = rand() % 256;
+    }
+    double want = ssd_scalar(a, b, stride, width, height);
+    double got = ssd_avx512(a, b, stride, width, height);
+    free(a);
+    free(b);
+    if (want != got) {
+        printf("  ✗ %-10s %5dx%-5d stride=%-6d scalar=%.0f avx512=%.0f\n", name, width, height, stride, want, got);
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    printf("AVX-512 SSD Kernel Prototype\n");
+    printf("============================\n\n");
+
+    if (!__builtin_cpu_supports("avx512bw")) {
+        printf("AVX-512BW not supported on this CPU, skipping\n");
+        return 0;
+    }
+
+    srand(42);
+
+    printf("Correctness Test:\n");
+    int failures = 0;
+    for (int w = 1; w <= 48; w++) {
+        failures += check("tail", w, 3, w * 4);
+        failures += check("padded", w, 3, w * 4 + 12);
+    }
+    failures += check("flush", SSD_FLUSH_ITERS * 16 * 2 + 5, 2, (SSD_FLUSH_ITERS * 16 * 2 + 5) * 4);
+    if (failures) {
+        printf("  ✗ FAIL (%d cases)\n", failures);
+        return 1;
+    }
+    printf("  ✓ PASS (bit-exact for all widths 1..48, padded strides, long rows)\n\n");
+
+    const int width = 256;
+    const int height = 256;
+    const int stride = width * 4;
+    const size_t img_size = stride * height;
+
+    uint8_t* img_a = (uint8_t*)aligned_alloc(64, img_size);
+    uint8_t* img_b = (uint8_t*)aligned_alloc(64, img_size);
+    for (size_t i = 0; i < img_size; i++) {
+        img_a[i] = rand() % 256;
+        img_b[i] = rand() % 256;
+    }
+
+    for (int i = 0; i < 100; i++) {
+        ssd_scalar(img_a, img_b, stride, width, height);
+        ssd_avx512(img_a, img_b, stride, width, height);
+    }
+
+    printf("Performance Benchmark (%d iterations, %dx%d):\n", 1000, width, height);
+    const int iters = 1000;
+    volatile double sink = 0;
+
+    uint64_t start = get_nanos();
+    for (int i = 0; i < iters; i++) {
+        sink += ssd_scalar(img_a, img_b, stride, width, height);
+    }
+    uint64_t end = get_nanos();
+    double scalar_ns = (double)(end - start) / iters;
+
+    start = get_nanos();
+    for (int i = 0; i < iters; i++) {
+        sink += ssd_avx512(img_a, img_b, stride, width, height);
+    }
+    end = get_nanos();
+    double simd_ns = (double)(end - start) / iters;
+
+    printf("  Scalar:  %.2f μs, %.1f Mpixels/sec\n", scalar_ns / 1000.0, (width * height / 1e6) / (scalar_ns / 1e9));
+    printf("  AVX-512: %.2f μs, %.1f Mpixels/sec\n", simd_ns / 1000.0, (width * height / 1e6) / (simd_ns / 1e9));
+    printf("  Speedup: %.2fx\n\n", scalar_ns / simd_ns);
+
+    free(img_a);
+    free(img_b);
+
+    return 0;
+}